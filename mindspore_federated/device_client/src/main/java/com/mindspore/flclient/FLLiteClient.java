@@ -17,6 +17,7 @@
 package com.mindspore.flclient;
 
 import com.mindspore.flclient.common.FLLoggerGenerater;
+import com.mindspore.flclient.compression.EncodeExecutor;
 import com.mindspore.flclient.model.Client;
 import com.mindspore.flclient.model.ClientManager;
 import com.mindspore.flclient.model.CommonUtils;
@@ -107,6 +108,11 @@ public class FLLiteClient {
         float uploadSparseRate = flJob.uploadSparseRate();
         LOGGER.info("[startFLJob] [compression] uploadSparseRate: " + uploadSparseRate);
         localFLParameter.setUploadSparseRatio(uploadSparseRate);
+        // Servers which don't advertise the sparse mask version only decode the Lehmer mask.
+        int sparseMaskVersion = flJob.sparseMaskVersion() >= EncodeExecutor.SPARSE_MASK_COUNTER ?
+                EncodeExecutor.SPARSE_MASK_COUNTER : EncodeExecutor.SPARSE_MASK_LEHMER;
+        LOGGER.info("[startFLJob] [compression] sparseMaskVersion: " + sparseMaskVersion);
+        localFLParameter.setSparseMaskVersion(sparseMaskVersion);
         int seed = flJob.iteration();
         LOGGER.info("[startFLJob] [compression] seed: " + seed);
         localFLParameter.setSeed(seed);
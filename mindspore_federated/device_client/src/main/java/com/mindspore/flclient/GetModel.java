@@ -141,7 +141,7 @@ public class GetModel {
             }
             int pre = curPos++;
             CompressFeatureMap cmpfeatureMap = responseDataBuf.compressFeatureMap(pre);
-            return DecodeExecutor.quantDeCompress(cmpfeatureMap);
+            return DecodeExecutor.quantDeCompress(responseDataBuf.downloadCompressType(), cmpfeatureMap);
         }
     }
 
@@ -152,6 +152,8 @@ public class GetModel {
                 LOGGER.info("[FeatureGeneratorCtr] Compress type:" + compressType);
                 return new NormalFeatureGenerator(responseDataBuf);
             case CompressType.QUANT:
+            case CompressType.QUANT_4BIT:
+            case CompressType.QUANT_2BIT:
                 LOGGER.info("[FeatureGeneratorCtr] Compress type:" + compressType);
                 return new QuatFeatureGenerator(responseDataBuf);
             default:
@@ -72,6 +72,7 @@ public class LocalFLParameter {
     private byte uploadCompressType = 0;
     private int seed = 0;
     private float uploadSparseRatio = 0.08f;
+    private int sparseMaskVersion = 0;
 
     // default DeviceType:DT_CPU -> 0
     private int deviceType = 0;
@@ -255,4 +256,12 @@ public class LocalFLParameter {
     public void setUploadSparseRatio(float uploadSparseRatio) {
         this.uploadSparseRatio = uploadSparseRatio;
     }
+
+    public int getSparseMaskVersion() {
+        return sparseMaskVersion;
+    }
+
+    public void setSparseMaskVersion(int sparseMaskVersion) {
+        this.sparseMaskVersion = sparseMaskVersion;
+    }
 }
@@ -185,7 +185,7 @@ public class StartFLJob {
             }
             int pre = curPos++;
             CompressFeatureMap cmpfeatureMap = responseDataBuf.compressFeatureMap(pre);
-            return DecodeExecutor.quantDeCompress(cmpfeatureMap);
+            return DecodeExecutor.quantDeCompress(responseDataBuf.downloadCompressType(), cmpfeatureMap);
         }
     }
 
@@ -196,6 +196,8 @@ public class StartFLJob {
             case CompressType.NO_COMPRESS:
                 return new NormalFeatureGenerator(responseDataBuf);
             case CompressType.QUANT:
+            case CompressType.QUANT_4BIT:
+            case CompressType.QUANT_2BIT:
                 return new QuatFeatureGenerator(responseDataBuf);
             default:
                 LOGGER.severe("[FeatureGeneratorCtr] Unsupported compress type:" + compressType);
@@ -158,6 +158,7 @@ public class UpdateModel {
         private int iteration = 0;
         private byte uploadCompressType = 0;
         private float uploadSparseRate = 0.0f;
+        private int sparseMaskVersion = EncodeExecutor.SPARSE_MASK_LEHMER;
         private EncryptLevel encryptLevel = EncryptLevel.NOT_ENCRYPT;
         private float uploadLossOffset = 0.0f;
         // evaluate acc
@@ -411,7 +412,9 @@ public class UpdateModel {
             for (String featureName : updateFeatureName) {
                 totalMaskLen += client.getPreFeature(featureName).length;
             }
-            boolean[] maskArray = EncodeExecutor.getInstance().constructMaskArray(totalMaskLen);
+            this.sparseMaskVersion = localFLParameter.getSparseMaskVersion();
+            boolean[] maskArray = EncodeExecutor.getInstance().constructMaskArray(totalMaskLen,
+                    this.sparseMaskVersion);
             int maskedLen = 0;
             int index = 0;
             int[] compFmOffsets = new int[updateFeatureName.size()];
@@ -543,6 +546,7 @@ public class UpdateModel {
             RequestUpdateModel.addCompressFeatureMap(builder, this.compFmOffset);
             RequestUpdateModel.addUploadCompressType(builder, this.uploadCompressType);
             RequestUpdateModel.addUploadSparseRate(builder, this.uploadSparseRate);
+            RequestUpdateModel.addSparseMaskVersion(builder, this.sparseMaskVersion);
             RequestUpdateModel.addNameVec(builder, this.nameVecOffset);
             RequestUpdateModel.addFeatureMap(builder, this.fmOffset);
             RequestUpdateModel.addSignature(builder, this.signDataOffset);
@@ -21,6 +21,8 @@ import java.util.Map;
 
 import static mindspore.fl.schema.CompressType.NO_COMPRESS;
 import static mindspore.fl.schema.CompressType.QUANT;
+import static mindspore.fl.schema.CompressType.QUANT_2BIT;
+import static mindspore.fl.schema.CompressType.QUANT_4BIT;
 
 /**
  * The compress mod.
@@ -35,6 +37,8 @@ public class CompressMode {
     static {
         COMPRESS_TYPE_MAP.put(NO_COMPRESS, -1);
         COMPRESS_TYPE_MAP.put(QUANT, 8);
+        COMPRESS_TYPE_MAP.put(QUANT_4BIT, 4);
+        COMPRESS_TYPE_MAP.put(QUANT_2BIT, 2);
     }
 
 }
\ No newline at end of file
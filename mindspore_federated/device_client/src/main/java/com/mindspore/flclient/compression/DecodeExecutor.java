@@ -100,23 +100,45 @@ public class DecodeExecutor {
     }
 
     static public FeatureMap quantDeCompress(CompressFeatureMap compressFeature) {
-        int num_bits = CompressMode.COMPRESS_TYPE_MAP.get(QUANT);
-        float temp1 = (float) (Math.pow(2, num_bits) - 1);
-        float temp2 = (float) Math.pow(2, num_bits - 1);
+        return quantDeCompress(QUANT, compressFeature);
+    }
+
+    /**
+     * Decode the min max quantization of the compress type. QUANT_4BIT and QUANT_2BIT pack the codes from the low
+     * bits of each byte, and every blockSize elements have their own min and max values.
+     *
+     * @param compressType the download compress type.
+     * @param compressFeature the compressed weight.
+     * @return the decoded weight.
+     */
+    static public FeatureMap quantDeCompress(byte compressType, CompressFeatureMap compressFeature) {
+        int num_bits = CompressMode.COMPRESS_TYPE_MAP.get(compressType);
+        int codesPerByte = 8 / num_bits;
+        int codeMask = (1 << num_bits) - 1;
+        int codeOffset = num_bits == 8 ? (1 << (num_bits - 1)) : 0;
+        float temp1 = (float) codeMask;
 
         String weightName = compressFeature.weightFullname();
         int compressDataLength = compressFeature.compressDataLength();
-        List<Byte> compressWeightList = new ArrayList<>();
-        for (int j = 0; j < compressDataLength; j++) {
-            compressWeightList.add(compressFeature.compressData(j));
-        }
-        float minVal = compressFeature.minVal();
-        float maxVal = compressFeature.maxVal();
-        float scale_value = (float) ((maxVal - minVal) / temp1 + 1e-10);
-        float[] params = new float[compressWeightList.size()];
-        for (int j = 0; j < params.length; j++) {
-            float val = (compressWeightList.get(j).intValue() + temp2) * scale_value + minVal;
-            params[j] = val;
+        int dataSize = compressFeature.dataSize() > 0 ? compressFeature.dataSize() : compressDataLength * codesPerByte;
+        boolean hasBlock = compressFeature.blockSize() > 0 && compressFeature.blockMinValLength() > 0;
+        int blockSize = hasBlock ? compressFeature.blockSize() : dataSize;
+        float[] params = new float[dataSize];
+        int blockIndex = -1;
+        float minVal = 0.0f;
+        float scale_value = 0.0f;
+        for (int j = 0; j < dataSize; j++) {
+            if (j / blockSize != blockIndex) {
+                blockIndex = j / blockSize;
+                minVal = hasBlock ? compressFeature.blockMinVal(blockIndex) : compressFeature.minVal();
+                float maxVal = hasBlock ? compressFeature.blockMaxVal(blockIndex) : compressFeature.maxVal();
+                scale_value = (float) ((maxVal - minVal) / temp1 + 1e-10);
+            }
+            int shift = (j % codesPerByte) * num_bits;
+            int code = ((compressFeature.compressData(j / codesPerByte) & 0xFF) >> shift) & codeMask;
+            // 8 bits codes are stored minus 128 as int8.
+            code = (code + codeOffset) & codeMask;
+            params[j] = code * scale_value + minVal;
         }
         FlatBufferBuilder builder = new FlatBufferBuilder(0);
         int weightFullnameOffset = builder.createString(weightName);
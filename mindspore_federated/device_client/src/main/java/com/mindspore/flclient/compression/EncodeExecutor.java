@@ -53,6 +53,52 @@ public class EncodeExecutor {
     private static final double increment = 4294967294.0;
     private static final int modulo = 48271;
 
+    /**
+     * The first uploadSparseRatio * paramNum elements are retained and shuffled sequentially.
+     */
+    public static final int SPARSE_MASK_LEHMER = 0;
+
+    /**
+     * Each element is retained independently, which lets the server compute the mask in parallel.
+     */
+    public static final int SPARSE_MASK_COUNTER = 1;
+
+    private static final long SPLIT_MIX_GAMMA = 0x9E3779B97F4A7C15L;
+
+    private static long splitMix64(long value) {
+        long z = value;
+        z = (z ^ (z >>> 30)) * 0xBF58476D1CE4E5B9L;
+        z = (z ^ (z >>> 27)) * 0x94D049BB133111EBL;
+        return z ^ (z >>> 31);
+    }
+
+    /**
+     * Construct the mask of random sparse, which must be the same as the server of the sparse mask version.
+     *
+     * @param paramNum number of parameters.
+     * @param version sparse mask version, SPARSE_MASK_LEHMER or SPARSE_MASK_COUNTER.
+     * @return whether each parameter is retained.
+     */
+    public boolean[] constructMaskArray(int paramNum, int version) {
+        if (version == SPARSE_MASK_COUNTER) {
+            return constructCounterMaskArray(paramNum);
+        }
+        return constructMaskArray(paramNum);
+    }
+
+    private boolean[] constructCounterMaskArray(int paramNum) {
+        int seed = localFLParameter.getSeed();
+        float uploadSparseRatio = localFLParameter.getUploadSparseRatio();
+        long key = splitMix64((long) seed & 0xFFFFFFFFL);
+        long threshold = (long) ((double) uploadSparseRatio * 4294967296.0);
+        boolean[] maskArray = new boolean[paramNum];
+        for (int i = 0; i < paramNum; ++i) {
+            long rand = splitMix64(key + (long) (i + 1) * SPLIT_MIX_GAMMA);
+            maskArray[i] = (rand >>> 32) < threshold;
+        }
+        return maskArray;
+    }
+
     public boolean[] constructMaskArray(int paramNum) {
         int seed = localFLParameter.getSeed();
         float uploadSparseRatio = localFLParameter.getUploadSparseRatio();
@@ -32,6 +32,7 @@ namespace fl {
 namespace psi {
 
 constexpr size_t LENGTH_12 = 12;
+constexpr size_t LENGTH_16 = 16;
 constexpr size_t LENGTH_32 = 32;
 constexpr size_t LENGTH_33 = 33;
 constexpr size_t STAT_SEC_PARA = 40;
@@ -61,6 +62,19 @@ using BigNumPtr = std::unique_ptr<BIGNUM, BNFree>;
 using ECGroupPtr = std::unique_ptr<EC_GROUP, ECGroupFree>;
 using ECPointPtr = std::unique_ptr<EC_POINT, ECPointFree>;
 
+// Uses the given BN_CTX if it is not null, otherwise a temporary one. Batch callers pass one BN_CTX for all the items
+// of a task, so that it's not allocated per operation.
+struct ScopedBnCtx {
+  explicit ScopedBnCtx(BN_CTX *bn_ctx) : owned_ctx(bn_ctx == nullptr ? BN_CTX_new() : nullptr) {
+    ctx = bn_ctx == nullptr ? owned_ctx.get() : bn_ctx;
+  }
+
+  BN_CTX *get() const { return ctx; }
+
+  BnCtxPtr owned_ctx;
+  BN_CTX *ctx;
+};
+
 struct BigNumClass {
   BigNumClass() : bn_ptr(BN_new()) {}
 
@@ -93,10 +107,10 @@ struct BigNumClass {
     }
   }
 
-  void FromString(const std::string &id_string, const BigNumClass &p) const {
-    BigNumClass bn_id(id_string);
-    BnCtxPtr bn_ctx(BN_CTX_new());
-    BN_nnmod(bn_ptr.get(), bn_id.get(), p.get(), bn_ctx.get());
+  void FromString(const std::string &id_string, const BigNumClass &p, BN_CTX *bn_ctx = nullptr) const {
+    FromString(id_string);
+    ScopedBnCtx scoped_ctx(bn_ctx);
+    BN_nnmod(bn_ptr.get(), bn_ptr.get(), p.get(), scoped_ctx.get());
   }
 
   BigNumPtr bn_ptr;
@@ -120,6 +134,8 @@ struct ECGroupClass {
   ECGroupPtr group_ptr;
 };
 
+// The methods taking a BN_CTX use a temporary one if it is null. Points can be reused for many items, the methods
+// ending with To/From overwrite the point or the output buffer in place.
 struct ECPointClass {
   explicit ECPointClass(const ECGroupClass &ec_group)
       : this_group(ec_group), point_ptr(EC_POINT_new(this_group.get())) {}
@@ -138,99 +154,130 @@ struct ECPointClass {
   // HashToCurve
   // if add_or_rehash is true, we'll use +1 method to solve the problem that is not on the curve.
   static ECPointClass GenPointFromString(const ECGroupClass &group, const std::string &id_string, bool add_or_rehash) {
-    BnCtxPtr bn_ctx(BN_CTX_new());
     ECPointClass point(group);
-    BigNumClass bn_x(id_string, group.bn_p);
+    point.FromHashString(id_string, add_or_rehash);
+    return point;
+  }
+
+  void FromHashString(const std::string &id_string, bool add_or_rehash, BN_CTX *bn_ctx = nullptr) {
+    ScopedBnCtx scoped_ctx(bn_ctx);
+    BN_CTX_start(scoped_ctx.get());
+    BIGNUM *bn_x = BN_CTX_get(scoped_ctx.get());
+    if (bn_x == nullptr) {
+      MS_LOG(ERROR) << "Hash_To_Curve Failed, BN_CTX_get failed.";
+      BN_CTX_end(scoped_ctx.get());
+      return;
+    }
+    if (id_string.size() != LENGTH_32) {
+      MS_LOG(ERROR) << "ERROR, input string length is " << id_string.size() << ", not equal to " << LENGTH_32;
+      BN_zero(bn_x);
+    } else {
+      BN_bin2bn((const uint8_t *)id_string.data(), LENGTH_32, bn_x);
+      BN_nnmod(bn_x, bn_x, this_group.bn_p.get(), scoped_ctx.get());
+    }
     size_t try_times = 0;
     constexpr size_t MAX_TRY_TIMES = 1000;
+    uint8_t bn_x_bytes[LENGTH_32];
     while (true) {
       // try to get y by using x, then do (x,y)->point
-      int has_y = EC_POINT_set_compressed_coordinates(group.get(), point.get(), bn_x.get(), 0, bn_ctx.get());
+      int has_y = EC_POINT_set_compressed_coordinates(this_group.get(), point_ptr.get(), bn_x, 0, scoped_ctx.get());
       if (has_y == 1) break;
       if (try_times++ >= MAX_TRY_TIMES) {
         MS_LOG(ERROR) << "Try times >= MAX_TRY_TIMES, Hash_To_Curve Failed.";
         break;
       }
       if (add_or_rehash) {
-        BN_add_word(bn_x.get(), 1);
-        BN_mod(bn_x.get(), bn_x.get(), group.bn_p.get(), bn_ctx.get());
+        BN_add_word(bn_x, 1);
+        BN_mod(bn_x, bn_x, this_group.bn_p.get(), scoped_ctx.get());
       } else {
         // reHash
-        std::string bn_x_string = bn_x.ToString();
-        std::string hash_result(LENGTH_32, '\0');
-        SHA256((const uint8_t *)bn_x_string.data(), bn_x_string.size(), (uint8_t *)hash_result.data());
-        bn_x.FromString(hash_result, group.bn_p);
+        uint8_t hash_result[LENGTH_32];
+        BN_bn2binpad(bn_x, bn_x_bytes, LENGTH_32);
+        SHA256(bn_x_bytes, LENGTH_32, hash_result);
+        BN_bin2bn(hash_result, LENGTH_32, bn_x);
+        BN_nnmod(bn_x, bn_x, this_group.bn_p.get(), scoped_ctx.get());
       }
     }
-    return point;
+    BN_CTX_end(scoped_ctx.get());
   }
 
   std::string CompressToString(size_t compress_length) {
+    std::string compress_p_a(compress_length, '\0');
+    if (!CompressTo(compress_length, reinterpret_cast<uint8_t *>(compress_p_a.data()))) {
+      return "";
+    }
+    return compress_p_a;
+  }
+
+  // Writes compress_length bytes to output.
+  bool CompressTo(size_t compress_length, uint8_t *output, BN_CTX *bn_ctx = nullptr) const {
+    ScopedBnCtx scoped_ctx(bn_ctx);
     if (compress_length == LENGTH_33) {
-      return CompressToStringByOpenssl();
+      return EC_POINT_point2oct(this_group.get(), point_ptr.get(), POINT_CONVERSION_COMPRESSED, output, LENGTH_33,
+                                scoped_ctx.get()) == LENGTH_33;
     } else if (compress_length == LENGTH_32) {
-      return CompressToStringByX();
+      BN_CTX_start(scoped_ctx.get());
+      BIGNUM *bn_x = BN_CTX_get(scoped_ctx.get());
+      bool ret = bn_x != nullptr &&
+                 EC_POINT_get_affine_coordinates(this_group.get(), point_ptr.get(), bn_x, nullptr, scoped_ctx.get()) ==
+                   1 &&
+                 BN_bn2binpad(bn_x, output, LENGTH_32) == static_cast<int>(LENGTH_32);
+      BN_CTX_end(scoped_ctx.get());
+      return ret;
     } else {
       MS_LOG(ERROR) << "Compress length option is ERROR!, input value is " << compress_length;
-      return NULL;
+      return false;
     }
   }
 
-  std::string CompressToStringByOpenssl() {
-    BnCtxPtr bn_ctx(BN_CTX_new());
-    std::string compress_p_a(LENGTH_33, '\0');
-    EC_POINT_point2oct(this_group.get(), point_ptr.get(), POINT_CONVERSION_COMPRESSED,
-                       reinterpret_cast<uint8_t *>(compress_p_a.data()), LENGTH_33, bn_ctx.get());
-    return compress_p_a;
-  }
-
-  std::string CompressToStringByX() {
-    BnCtxPtr bn_ctx(BN_CTX_new());
-    BigNumClass bn_x;
-    BigNumClass bn_y;
-    EC_POINT_get_affine_coordinates(this_group.get(), point_ptr.get(), bn_x.get(), bn_y.get(), bn_ctx.get());
-    auto compress_p_a = bn_x.ToString();
-    return compress_p_a;
-  }
-
-  void DecompressToPoint(const std::string &compress_p_a, size_t compress_length) {
+  void DecompressToPoint(const std::string &compress_p_a, size_t compress_length, BN_CTX *bn_ctx = nullptr) {
     if (compress_length == LENGTH_33) {
-      DecompressToPointByOpenssl(compress_p_a);
+      DecompressToPointByOpenssl(compress_p_a, bn_ctx);
     } else if (compress_length == LENGTH_32) {
-      DecompressToPointByX(compress_p_a);
+      DecompressToPointByX(compress_p_a, bn_ctx);
     } else {
       MS_LOG(ERROR) << "Compress length option is ERROR!, input value is " << compress_length;
     }
   }
 
-  void DecompressToPointByOpenssl(const std::string &compress_p_a) {
+  void DecompressToPointByOpenssl(const std::string &compress_p_a, BN_CTX *bn_ctx = nullptr) {
     if (compress_p_a.length() != LENGTH_33) {
       MS_LOG(ERROR) << "Decompress length option is ERROR!, input value is " << compress_p_a.length()
                     << ", not equal to " << LENGTH_33;
       return;
     }
-    BnCtxPtr bn_ctx(BN_CTX_new());
+    ScopedBnCtx scoped_ctx(bn_ctx);
     EC_POINT_oct2point(this_group.get(), point_ptr.get(), reinterpret_cast<const uint8_t *>(compress_p_a.data()),
-                       LENGTH_33, bn_ctx.get());
+                       LENGTH_33, scoped_ctx.get());
   }
 
-  void DecompressToPointByX(const std::string &compress_p_a) {
+  void DecompressToPointByX(const std::string &compress_p_a, BN_CTX *bn_ctx = nullptr) {
     if (compress_p_a.length() != LENGTH_32) {
       MS_LOG(ERROR) << "Input length is " << compress_p_a.length() << ", not equal to" << LENGTH_32;
       return;
     }
-    BnCtxPtr bn_ctx(BN_CTX_new());
-    BigNumClass bn_x(compress_p_a);
-    EC_POINT_set_compressed_coordinates(this_group.get(), point_ptr.get(), bn_x.get(), 0, bn_ctx.get());
+    ScopedBnCtx scoped_ctx(bn_ctx);
+    BN_CTX_start(scoped_ctx.get());
+    BIGNUM *bn_x = BN_CTX_get(scoped_ctx.get());
+    if (bn_x != nullptr) {
+      BN_bin2bn(reinterpret_cast<const uint8_t *>(compress_p_a.data()), LENGTH_32, bn_x);
+      EC_POINT_set_compressed_coordinates(this_group.get(), point_ptr.get(), bn_x, 0, scoped_ctx.get());
+    }
+    BN_CTX_end(scoped_ctx.get());
   }
 
-  ECPointClass BNMul(const BigNumClass &bn_key) {
-    BnCtxPtr bn_ctx(BN_CTX_new());
+  ECPointClass BNMul(const BigNumClass &bn_key) const {
     ECPointClass r_point(this_group);
-    EC_POINT_mul(this_group.get(), r_point.get(), nullptr, point_ptr.get(), bn_key.get(), bn_ctx.get());
+    r_point.MulFrom(*this, bn_key);
     return r_point;
   }
 
+  // this = point * bn_key
+  void MulFrom(const ECPointClass &point, const BigNumClass &bn_key, BN_CTX *bn_ctx = nullptr) {
+    ScopedBnCtx scoped_ctx(bn_ctx);
+    EC_POINT_mul(this_group.get(), point_ptr.get(), nullptr, point.get(), bn_key.get(), scoped_ctx.get());
+  }
+
   EC_POINT *get() const { return point_ptr.get(); }
 
   const ECGroupClass &this_group;
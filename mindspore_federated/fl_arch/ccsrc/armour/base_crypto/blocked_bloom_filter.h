@@ -0,0 +1,223 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_FEDERATED_BLOCKED_BLOOM_FILTER_H
+#define MINDSPORE_FEDERATED_BLOCKED_BLOOM_FILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/parallel_for.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+// Cache line blocked Bloom filter, used by psi_type "blocked_filter_ecdh".
+//
+// The filter is an array of 512 bits blocks, each of 8 uint64 words. An item selects blocks_per_key_ blocks and sets
+// one bit in every word of each selected block, so a look up reads blocks_per_key_ cache lines instead of one random
+// byte per hash function, and compares each block with its mask word by word without branches. Bits are set with
+// atomic or, so items are inserted in parallel without an intermediate byte array.
+//
+// Wire format, integers are little endian:
+//   magic "BBF1", uint32 blocks_per_key, uint64 input_num, uint64 block_num, block_num * 8 uint64 words.
+// Since the sizes are carried in the data, the peer doesn't need to compute the same parameters.
+struct BlockedBloomFilter {
+  static constexpr size_t kWordsPerBlock = 8;
+  static constexpr size_t kBitsPerWord = 64;
+  static constexpr size_t kBitsPerBlock = kWordsPerBlock * kBitsPerWord;
+  static constexpr size_t kMaxBlocksPerKey = 64;
+  static constexpr size_t kHeaderSize = 24;
+  static constexpr char kMagic[] = "BBF1";
+  static constexpr size_t kMagicSize = 4;
+
+  BlockedBloomFilter() = default;
+
+  // neg_log_fp_rate = -log2(fp_rate), the filter is sized for a false positive rate no more than 2^-neg_log_fp_rate.
+  explicit BlockedBloomFilter(const std::vector<std::string> &input_vct, int neg_log_fp_rate = 40,
+                              size_t thread_num = 0) {
+    time_t time_start;
+    time_t time_end;
+    time(&time_start);
+    input_num_ = input_vct.size();
+    // Every block sets 8 bits, so about neg_log_fp_rate bits are checked in total.
+    blocks_per_key_ = std::min(kMaxBlocksPerKey, std::max<size_t>(1, (neg_log_fp_rate + kWordsPerBlock - 1) /
+                                                                          kWordsPerBlock));
+    double bits_per_item = BitsPerItem(neg_log_fp_rate, blocks_per_key_);
+    block_num_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(input_num_ * bits_per_item / kBitsPerBlock)));
+    block_num_ = std::min<size_t>(block_num_, UINT32_MAX);
+    words_.assign(block_num_ * kWordsPerBlock, 0);
+
+    ParallelSync parallel_sync(thread_num);
+    parallel_sync.parallel_for(0, input_num_, 1, [&](size_t beg, size_t end) {
+      uint64_t mask[kWordsPerBlock];
+      for (size_t i = beg; i < end; i++) {
+        uint64_t hash = HashKey(input_vct[i]);
+        for (size_t j = 0; j < blocks_per_key_; j++) {
+          uint64_t *block = &words_[BlockMask(hash, j, mask) * kWordsPerBlock];
+          for (size_t w = 0; w < kWordsPerBlock; w++) {
+            (void)__atomic_fetch_or(&block[w], mask[w], __ATOMIC_RELAXED);
+          }
+        }
+      }
+    });
+    time(&time_end);
+    MS_LOG(INFO) << "Build blocked bloom filter, time cost: " << difftime(time_end, time_start) << " s.";
+    MS_LOG(INFO) << "Blocked bloom filter size is: " << DataByteLen() << " bytes, " << bits_per_item
+                 << " bits per item.";
+  }
+
+  // Parses the data generated by GetData, returns false if it is invalid.
+  bool Parse(const std::string &data) {
+    if (data.size() < kHeaderSize || data.compare(0, kMagicSize, kMagic) != 0) {
+      MS_LOG(ERROR) << "Invalid blocked bloom filter data, size is " << data.size();
+      return false;
+    }
+    auto bytes = reinterpret_cast<const uint8_t *>(data.data());
+    uint64_t blocks_per_key = LoadLittleEndian(bytes + kMagicSize, sizeof(uint32_t));
+    uint64_t input_num = LoadLittleEndian(bytes + kMagicSize + sizeof(uint32_t), sizeof(uint64_t));
+    uint64_t block_num = LoadLittleEndian(bytes + kMagicSize + sizeof(uint32_t) + sizeof(uint64_t), sizeof(uint64_t));
+    if (blocks_per_key == 0 || blocks_per_key > kMaxBlocksPerKey || block_num == 0 || block_num > UINT32_MAX ||
+        data.size() != kHeaderSize + block_num * kWordsPerBlock * sizeof(uint64_t)) {
+      MS_LOG(ERROR) << "Invalid blocked bloom filter data, blocks per key " << blocks_per_key << ", block num "
+                    << block_num << ", size " << data.size();
+      return false;
+    }
+    blocks_per_key_ = static_cast<size_t>(blocks_per_key);
+    input_num_ = static_cast<size_t>(input_num);
+    block_num_ = static_cast<size_t>(block_num);
+    words_.resize(block_num_ * kWordsPerBlock);
+    for (size_t i = 0; i < words_.size(); i++) {
+      words_[i] = LoadLittleEndian(bytes + kHeaderSize + i * sizeof(uint64_t), sizeof(uint64_t));
+    }
+    return true;
+  }
+
+  bool LookUp(const std::string &key) const {
+    uint64_t hash = HashKey(key);
+    uint64_t mask[kWordsPerBlock];
+    for (size_t j = 0; j < blocks_per_key_; j++) {
+      const uint64_t *block = &words_[BlockMask(hash, j, mask) * kWordsPerBlock];
+      uint64_t miss = 0;
+      for (size_t w = 0; w < kWordsPerBlock; w++) {
+        miss |= mask[w] & ~block[w];
+      }
+      if (miss != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t DataByteLen() const { return kHeaderSize + words_.size() * sizeof(uint64_t); }
+
+  std::string GetData() const {
+    std::string ret(DataByteLen(), '\0');
+    auto bytes = reinterpret_cast<uint8_t *>(&ret[0]);
+    (void)std::copy(kMagic, kMagic + kMagicSize, bytes);
+    StoreLittleEndian(blocks_per_key_, sizeof(uint32_t), bytes + kMagicSize);
+    StoreLittleEndian(input_num_, sizeof(uint64_t), bytes + kMagicSize + sizeof(uint32_t));
+    StoreLittleEndian(block_num_, sizeof(uint64_t), bytes + kMagicSize + sizeof(uint32_t) + sizeof(uint64_t));
+    for (size_t i = 0; i < words_.size(); i++) {
+      StoreLittleEndian(words_[i], sizeof(uint64_t), bytes + kHeaderSize + i * sizeof(uint64_t));
+    }
+    return ret;
+  }
+
+  // Smallest number of bits per item, in steps of 1/4 bit, whose false positive rate is no more than
+  // 2^-neg_log_fp_rate. The items of a block follow a Poisson distribution, and each word of a block is a Bloom filter
+  // with one hash function.
+  static double BitsPerItem(int neg_log_fp_rate, size_t blocks_per_key) {
+    constexpr double kStep = 0.25;
+    constexpr double kMaxBitsPerItem = 1024;
+    double target = std::pow(2.0, -neg_log_fp_rate);
+    double bits_per_item = std::max(1.0, neg_log_fp_rate / M_LN2);
+    for (; bits_per_item < kMaxBitsPerItem; bits_per_item += kStep) {
+      double lambda = kBitsPerBlock / bits_per_item * blocks_per_key;
+      double prob = std::exp(-lambda);
+      double block_fp_rate = 0;
+      for (size_t c = 0; c < static_cast<size_t>(lambda * 6) + 60; c++) {
+        if (c > 0) {
+          prob *= lambda / c;
+        }
+        block_fp_rate += prob * std::pow(1 - std::pow(1 - 1.0 / kBitsPerWord, c), kWordsPerBlock);
+      }
+      if (std::pow(block_fp_rate, blocks_per_key) <= target) {
+        break;
+      }
+    }
+    return bits_per_item;
+  }
+
+  size_t input_num_ = 0;
+  size_t blocks_per_key_ = 1;
+  size_t block_num_ = 0;
+  std::vector<uint64_t> words_;
+
+ private:
+  static constexpr uint64_t kGolden = 0x9E3779B97F4A7C15ULL;
+  static constexpr size_t kByteBits = 8;
+  static constexpr size_t kBitIndexBits = 6;
+  static constexpr size_t kUint32Bits = 32;
+
+  static uint64_t SplitMix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  static uint64_t LoadLittleEndian(const uint8_t *bytes, size_t len) {
+    uint64_t ret = 0;
+    for (size_t i = 0; i < len; i++) {
+      ret |= static_cast<uint64_t>(bytes[i]) << (i * kByteBits);
+    }
+    return ret;
+  }
+
+  static void StoreLittleEndian(uint64_t value, size_t len, uint8_t *bytes) {
+    for (size_t i = 0; i < len; i++) {
+      bytes[i] = static_cast<uint8_t>(value >> (i * kByteBits));
+    }
+  }
+
+  // Independent of the byte order of the host, so that both peers compute the same bits.
+  static uint64_t HashKey(const std::string &key) {
+    auto bytes = reinterpret_cast<const uint8_t *>(key.data());
+    uint64_t hash = SplitMix64(key.size());
+    for (size_t i = 0; i < key.size(); i += sizeof(uint64_t)) {
+      hash = SplitMix64(hash ^ LoadLittleEndian(bytes + i, std::min(sizeof(uint64_t), key.size() - i)));
+    }
+    return hash;
+  }
+
+  // Returns the j-th block of the item and fills the bit of each word.
+  size_t BlockMask(uint64_t hash, size_t j, uint64_t *mask) const {
+    uint64_t block_hash = SplitMix64(hash + (j + 1) * kGolden);
+    uint64_t bits = SplitMix64(block_hash);
+    for (size_t w = 0; w < kWordsPerBlock; w++) {
+      mask[w] = static_cast<uint64_t>(1) << ((bits >> (w * kBitIndexBits)) & (kBitsPerWord - 1));
+    }
+    return static_cast<size_t>(((block_hash >> kUint32Bits) * block_num_) >> kUint32Bits);
+  }
+};
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
+
+#endif  // MINDSPORE_FEDERATED_BLOCKED_BLOOM_FILTER_H
@@ -0,0 +1,210 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_FEDERATED_DIGEST_HASH_SET_H
+#define MINDSPORE_FEDERATED_DIGEST_HASH_SET_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/parallel_for.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+// Open addressing hash set of fixed width digests, used to intersect the ECDH compare strings and the SHA256 digests
+// of ids without sorting them or comparing std::string.
+//
+// Keys are copied into kWidth bytes and padded with zeros, so the keys of a set must all have the same length, or be
+// uniformly distributed digests longer than kWidth, which are truncated. The table is split into partitions by the
+// high bits of the hash. Each partition is a linear probing table with a load factor below 2/3, which is built by a
+// single task, so the set is built in parallel without atomics. An all zero slot is empty.
+template <size_t kWidth>
+class DigestHashSet {
+ public:
+  static_assert(kWidth > 0 && kWidth % sizeof(uint64_t) == 0, "Width of digest must be a multiple of 8 bytes.");
+  using Digest = std::array<uint8_t, kWidth>;
+
+  DigestHashSet(const std::vector<std::string> &keys, size_t thread_num, size_t chunk_size) {
+    size_t key_num = keys.size();
+    while (partition_bits_ < kMaxPartitionBits && (key_num >> partition_bits_) > kPartitionKeyNum) {
+      partition_bits_++;
+    }
+    size_t partition_num = static_cast<size_t>(1) << partition_bits_;
+    ParallelSync parallel_sync(thread_num);
+    std::vector<uint64_t> hashes(key_num);
+    parallel_sync.parallel_for(0, key_num, chunk_size, [&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; i++) {
+        hashes[i] = Hash(ToDigest(keys[i]));
+      }
+    });
+
+    // Group key indexes by partition. Each block of keys counts its keys of every partition, then writes them to its
+    // own range of the partition.
+    size_t block_num = parallel_sync.get_thread_num();
+    size_t block_size = (key_num + block_num - 1) / block_num;
+    std::vector<size_t> block_counts(block_num * partition_num, 0);
+    parallel_sync.parallel_for(0, block_num, 1, [&](size_t beg, size_t end) {
+      for (size_t block = beg; block < end; block++) {
+        size_t *counts = &block_counts[block * partition_num];
+        for (size_t i = block * block_size; i < std::min(key_num, (block + 1) * block_size); i++) {
+          counts[Partition(hashes[i])]++;
+        }
+      }
+    });
+    std::vector<size_t> key_offsets(partition_num + 1, 0);
+    offsets_.assign(partition_num + 1, 0);
+    for (size_t partition = 0; partition < partition_num; partition++) {
+      size_t pos = key_offsets[partition];
+      for (size_t block = 0; block < block_num; block++) {
+        size_t count = block_counts[block * partition_num + partition];
+        block_counts[block * partition_num + partition] = pos;
+        pos += count;
+      }
+      key_offsets[partition + 1] = pos;
+      size_t partition_key_num = pos - key_offsets[partition];
+      offsets_[partition + 1] = offsets_[partition] + partition_key_num + partition_key_num / 2 + 1;
+    }
+    std::vector<size_t> key_indexes(key_num);
+    parallel_sync.parallel_for(0, block_num, 1, [&](size_t beg, size_t end) {
+      for (size_t block = beg; block < end; block++) {
+        size_t *positions = &block_counts[block * partition_num];
+        for (size_t i = block * block_size; i < std::min(key_num, (block + 1) * block_size); i++) {
+          key_indexes[positions[Partition(hashes[i])]++] = i;
+        }
+      }
+    });
+
+    slots_.resize(offsets_[partition_num]);
+    std::vector<size_t> partition_sizes(partition_num, 0);
+    parallel_sync.parallel_for(0, partition_num, 1, [&](size_t beg, size_t end) {
+      for (size_t partition = beg; partition < end; partition++) {
+        for (size_t i = key_offsets[partition]; i < key_offsets[partition + 1]; i++) {
+          size_t key_index = key_indexes[i];
+          if (Insert(ToDigest(keys[key_index]), hashes[key_index], partition)) {
+            partition_sizes[partition]++;
+          }
+        }
+      }
+    });
+    for (auto partition_size : partition_sizes) {
+      size_ += partition_size;
+    }
+  }
+
+  bool Contains(const std::string &key) const { return Contains(ToDigest(key)); }
+
+  bool Contains(const Digest &digest) const {
+    if (IsEmpty(digest)) {
+      return has_zero_;
+    }
+    uint64_t hash = Hash(digest);
+    size_t partition = Partition(hash);
+    size_t begin = offsets_[partition];
+    size_t capacity = offsets_[partition + 1] - begin;
+    for (size_t index = SlotIndex(hash, capacity);; index = (index + 1 == capacity) ? 0 : index + 1) {
+      const Digest &slot = slots_[begin + index];
+      if (slot == digest) {
+        return true;
+      }
+      if (IsEmpty(slot)) {
+        return false;
+      }
+    }
+  }
+
+  // Number of distinct keys.
+  size_t size() const { return size_; }
+
+  static Digest ToDigest(const std::string &key) {
+    Digest digest{};
+    (void)memcpy(digest.data(), key.data(), std::min(key.size(), kWidth));
+    return digest;
+  }
+
+ private:
+  static constexpr size_t kMaxPartitionBits = 12;
+  static constexpr size_t kPartitionKeyNum = 1 << 16;
+  static constexpr uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ULL;
+  static constexpr uint64_t kUint32Bits = 32;
+
+  static uint64_t Hash(const Digest &digest) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < kWidth; i += sizeof(uint64_t)) {
+      uint64_t word;
+      (void)memcpy(&word, digest.data() + i, sizeof(uint64_t));
+      hash = (hash ^ word) * kHashMultiplier;
+      hash ^= hash >> kUint32Bits;
+    }
+    return hash;
+  }
+
+  static bool IsEmpty(const Digest &digest) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < kWidth; i += sizeof(uint64_t)) {
+      uint64_t word;
+      (void)memcpy(&word, digest.data() + i, sizeof(uint64_t));
+      bits |= word;
+    }
+    return bits == 0;
+  }
+
+  // Partitions use the high bits of the hash and slots use the low 32 bits.
+  size_t Partition(uint64_t hash) const {
+    return partition_bits_ == 0 ? 0 : static_cast<size_t>(hash >> (sizeof(uint64_t) * 8 - partition_bits_));
+  }
+
+  static size_t SlotIndex(uint64_t hash, size_t capacity) {
+    return static_cast<size_t>(((hash & UINT32_MAX) * capacity) >> kUint32Bits);
+  }
+
+  // Returns false if the key is already in the set.
+  bool Insert(const Digest &digest, uint64_t hash, size_t partition) {
+    if (IsEmpty(digest)) {
+      bool inserted = !has_zero_;
+      has_zero_ = true;
+      return inserted;
+    }
+    size_t begin = offsets_[partition];
+    size_t capacity = offsets_[partition + 1] - begin;
+    for (size_t index = SlotIndex(hash, capacity);; index = (index + 1 == capacity) ? 0 : index + 1) {
+      Digest &slot = slots_[begin + index];
+      if (slot == digest) {
+        return false;
+      }
+      if (IsEmpty(slot)) {
+        slot = digest;
+        return true;
+      }
+    }
+  }
+
+  // Slots of partition i are [offsets_[i], offsets_[i + 1]).
+  std::vector<Digest> slots_;
+  std::vector<size_t> offsets_;
+  size_t partition_bits_ = 0;
+  size_t size_ = 0;
+  bool has_zero_ = false;
+};
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
+
+#endif  // MINDSPORE_FEDERATED_DIGEST_HASH_SET_H
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <string>
 
 #include "armour/base_crypto/ecc.h"
@@ -21,24 +22,54 @@
 namespace mindspore {
 namespace fl {
 namespace psi {
+namespace {
+// Objects reused by all the items of a task, so that no BN_CTX or EC_POINT is allocated per item.
+struct ECWorkspace {
+  explicit ECWorkspace(const ECGroupClass &group) : bn_ctx(BN_CTX_new()), point(group), result(group) {}
+
+  BnCtxPtr bn_ctx;
+  ECPointClass point;
+  ECPointClass result;
+  uint8_t compress_buf[LENGTH_33] = {0};
+};
+
+// outputs[i] = (point of item i) * bn_key, compressed to compress_length bytes and truncated to compare_length bytes.
+// load_point(i, workspace) sets workspace->point to the point of item i.
+template <class LoadPoint>
+std::vector<std::string> MulBatch(const ECGroupClass &group, const BigNumClass &bn_key, size_t input_num,
+                                  size_t compress_length, size_t compare_length, size_t thread_num, size_t chunk_size,
+                                  const LoadPoint &load_point) {
+  std::vector<std::string> outputs(input_num);
+  size_t output_length = std::min(compress_length, compare_length);
+  ParallelSync parallel_sync(thread_num);
+  parallel_sync.parallel_for(0, input_num, chunk_size, [&](size_t beg, size_t end) {
+    ECWorkspace workspace(group);
+    for (size_t i = beg; i < end; i++) {
+      load_point(i, &workspace);
+      workspace.result.MulFrom(workspace.point, bn_key, workspace.bn_ctx.get());
+      if (!workspace.result.CompressTo(compress_length, workspace.compress_buf, workspace.bn_ctx.get())) {
+        MS_LOG(ERROR) << "Compress point failed, index is " << i;
+        continue;
+      }
+      outputs[i].assign(reinterpret_cast<const char *>(workspace.compress_buf), output_length);
+    }
+  });
+  return outputs;
+}
+}  // namespace
+
 std::vector<std::string> ECC::HashToCurveAndMul(const std::vector<std::string> &hash_inputs, size_t compress_length,
                                                 size_t compare_length) {
   time_t time_start;
   time_t time_end;
   time(&time_start);
 
-  std::vector<std::string> p_k_vct(hash_inputs.size());
   ECGroupClass group(nid_);
   BigNumClass bn_priv_Key(std::string(private_key_, private_key_ + LENGTH_32), group.bn_n);
-  ParallelSync parallel_sync(thread_num_);
-  parallel_sync.parallel_for(0, hash_inputs.size(), chunk_size_, [&](size_t beg, size_t end) {
-    for (size_t i = beg; i < end; i++) {
-      p_k_vct[i] = ECPointClass::GenPointFromString(group, hash_inputs[i], true)
-                     .BNMul(bn_priv_Key)
-                     .CompressToString(compress_length)
-                     .substr(0, compare_length);
-    }
-  });
+  auto p_k_vct = MulBatch(group, bn_priv_Key, hash_inputs.size(), compress_length, compare_length, thread_num_,
+                          chunk_size_, [&hash_inputs](size_t i, ECWorkspace *workspace) {
+                            workspace->point.FromHashString(hash_inputs[i], true, workspace->bn_ctx.get());
+                          });
 
   time(&time_end);
   MS_LOG(INFO) << "Compute p^k, time cost: " << difftime(time_end, time_start) << " s.";
@@ -51,17 +82,13 @@ std::vector<std::string> ECC::DcpsAndMul(const std::vector<std::string> &compres
   time_t time_end;
   time(&time_start);
 
-  size_t input_num = compress_vct.size();
-  std::vector<std::string> p_a_b_vector(input_num);
   ECGroupClass group(nid_);
   BigNumClass bn_priv_Key(std::string(private_key_, private_key_ + LENGTH_32), group.bn_n);
-  ParallelSync parallel_sync(thread_num_);
-  parallel_sync.parallel_for(0, input_num, chunk_size_, [&](size_t beg, size_t end) {
-    for (size_t i = beg; i < end; i++) {
-      ECPointClass decompress_point(group, compress_vct[i], compress_length);
-      p_a_b_vector[i] = decompress_point.BNMul(bn_priv_Key).CompressToString(compress_length).substr(0, compare_length);
-    }
-  });
+  auto p_a_b_vector = MulBatch(group, bn_priv_Key, compress_vct.size(), compress_length, compare_length, thread_num_,
+                               chunk_size_, [&compress_vct, compress_length](size_t i, ECWorkspace *workspace) {
+                                 workspace->point.DecompressToPoint(compress_vct[i], compress_length,
+                                                                    workspace->bn_ctx.get());
+                               });
 
   time(&time_end);
   MS_LOG(INFO) << "Bob decompress and compute p1^a^b, time cost: " << difftime(time_end, time_start) << " s.";
@@ -74,18 +101,14 @@ std::vector<std::string> ECC::DcpsAndInverseMul(const std::vector<std::string> &
   time_t time_end;
   time(&time_start);
 
-  size_t input_num = compress_vct.size();
-  std::vector<std::string> p_a_b_bI_vector(input_num);
   ECGroupClass group(nid_);
   BigNumClass bn_priv_Key(std::string(private_key_, private_key_ + LENGTH_32), group.bn_n);
   BigNumClass bn_priv_Key_I = bn_priv_Key.Inverse(group.bn_n);
-  ParallelSync parallel_sync(thread_num_);
-  parallel_sync.parallel_for(0, input_num, chunk_size_, [&](size_t beg, size_t end) {
-    for (size_t i = beg; i < end; i++) {
-      ECPointClass decompress_point(group, compress_vct[i], compress_length);
-      p_a_b_bI_vector[i] = decompress_point.BNMul(bn_priv_Key_I).CompressToString(LENGTH_32).substr(0, compare_length);
-    }
-  });
+  auto p_a_b_bI_vector = MulBatch(group, bn_priv_Key_I, compress_vct.size(), LENGTH_32, compare_length, thread_num_,
+                                  chunk_size_, [&compress_vct, compress_length](size_t i, ECWorkspace *workspace) {
+                                    workspace->point.DecompressToPoint(compress_vct[i], compress_length,
+                                                                       workspace->bn_ctx.get());
+                                  });
 
   time(&time_end);
   MS_LOG(INFO) << "Bob decompress and compute p1^a^b^(b^-1), time cost: " << difftime(time_end, time_start) << " s.";
@@ -15,6 +15,8 @@
  */
 
 #include "armour/cipher/cipher_meta_storage.h"
+#include <algorithm>
+#include <chrono>
 #include <unordered_map>
 #include "distributed_cache/client_infos.h"
 #include "distributed_cache/instance_context.h"
@@ -148,30 +150,67 @@ void CipherMetaStorage::GetClientIVsFromServer(
   }
 }
 
-bool CipherMetaStorage::GetClientNoisesFromServer(std::vector<float> *cur_public_noise) {
-  if (cur_public_noise == nullptr) {
-    MS_LOG(ERROR) << "input cur_public_noise is nullptr";
+bool CipherMetaStorage::GetClientNoisesFromServer(size_t noises_size,
+                                                  const fl::cache::ClientInfos::ClientNoisesCallback &callback) {
+  uint64_t server_noises_size = 0;
+  auto ret = fl::cache::ClientInfos::GetInstance().GetClientNoisesSize(&server_noises_size);
+  if (!ret.IsSuccess()) {
+    MS_LOG(WARNING) << "GetClientNoisesFromServer failed, the client noises are not updated";
     return false;
   }
-  fl::ClientNoises noises;
-  constexpr int count_threshold = 1000;
-  constexpr int register_time = 500;
-  for (int count = 0; count < count_threshold; count++) {
-    (void)fl::cache::ClientInfos::GetInstance().GetClientNoises(&noises);
-    if (noises.has_one_client_noises()) {
-      break;
-    }
-    std::this_thread::sleep_for(std::chrono::milliseconds(register_time));
+  if (server_noises_size != noises_size) {
+    MS_LOG(WARNING) << "The size of client noises is " << server_noises_size << ", however " << noises_size
+                    << " is required";
+    return false;
   }
-  if (!noises.has_one_client_noises()) {
+  ret = fl::cache::ClientInfos::GetInstance().GetClientNoises(server_noises_size, callback);
+  if (!ret.IsSuccess()) {
     MS_LOG(WARNING) << "GetClientNoisesFromServer failed";
     return false;
   }
-  auto &noises_data = noises.one_client_noises().noise();
-  cur_public_noise->assign(noises_data.begin(), noises_data.end());
   return true;
 }
 
+bool CipherMetaStorage::WaitClientNoisesFromServer(uint64_t *noises_size) {
+  // The noises are usually updated after the unmask starts. Wait for the notification, and check the shared server
+  // again every few seconds in case the notification is lost.
+  constexpr auto check_interval = std::chrono::seconds(5);
+  constexpr auto wait_timeout = std::chrono::seconds(500);
+  auto deadline = std::chrono::steady_clock::now() + wait_timeout;
+  {
+    std::lock_guard<std::mutex> lock(noises_ready_mutex_);
+    noises_ready_ = false;
+  }
+  while (true) {
+    auto ret = fl::cache::ClientInfos::GetInstance().GetClientNoisesSize(noises_size);
+    if (ret.IsSuccess()) {
+      return true;
+    }
+    if (!ret.IsNil()) {
+      MS_LOG(WARNING) << "GetClientNoisesFromServer failed";
+      return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      break;
+    }
+    std::unique_lock<std::mutex> lock(noises_ready_mutex_);
+    (void)noises_ready_cond_.wait_until(lock, std::min(now + check_interval, deadline),
+                                        [this]() { return noises_ready_; });
+    noises_ready_ = false;
+  }
+  MS_LOG(WARNING) << "GetClientNoisesFromServer failed, the client noises are not updated";
+  return false;
+}
+
+void CipherMetaStorage::OnClientNoisesReady() {
+  {
+    std::lock_guard<std::mutex> lock(noises_ready_mutex_);
+    noises_ready_ = true;
+  }
+  noises_ready_cond_.notify_all();
+}
+
 bool CipherMetaStorage::GetPrimeFromServer(uint8_t *prime) {
   if (prime == nullptr) {
     MS_LOG(ERROR) << "input prime is nullptr";
@@ -326,10 +365,12 @@ bool CipherMetaStorage::UpdateStableClientKeyToServer(const schema::RequestExcha
 
 bool CipherMetaStorage::UpdateClientNoiseToServer(const std::vector<float> &cur_public_noise) {
   // update new item to memory server.
-  fl::ClientNoises noises_pb;
-  *(noises_pb.mutable_one_client_noises()->mutable_noise()) = {cur_public_noise.begin(), cur_public_noise.end()};
-  auto ret = fl::cache::ClientInfos::GetInstance().SetClientNoises(noises_pb);
-  return ret.IsSuccess();
+  auto ret = fl::cache::ClientInfos::GetInstance().SetClientNoises(cur_public_noise);
+  if (!ret.IsSuccess()) {
+    return false;
+  }
+  OnClientNoisesReady();
+  return true;
 }
 
 bool CipherMetaStorage::UpdateClientReconstructShareToServer(
@@ -24,11 +24,14 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <mutex>
+#include <condition_variable>
 #include "common/utils/log_adapter.h"
 #include "armour/secure_protocol/secret_sharing.h"
 #include "schema/fl_job_generated.h"
 #include "schema/cipher_generated.h"
 #include "common/common.h"
+#include "distributed_cache/client_infos.h"
 
 #define IND_IV_INDEX 0
 #define PW_IV_INDEX 1
@@ -86,8 +89,13 @@ class CipherMetaStorage {
   // Get stable secure aggregation's client key from shared server.
   void GetStableClientKeysFromServer(std::map<std::string, std::vector<std::vector<uint8_t>>> *clients_keys_list);
   void GetClientIVsFromServer(std::map<std::string, std::vector<std::vector<uint8_t>>> *clients_ivs_list);
-  // Get client noises from shared server.
-  bool GetClientNoisesFromServer(std::vector<float> *cur_public_noise);
+  // Wait until the client noises are updated to shared server by any server, and get the size of them.
+  bool WaitClientNoisesFromServer(uint64_t *noises_size);
+  // Get client noises from shared server chunk by chunk, which fails if they are not updated yet. The size of the
+  // noises is checked to be noises_size before any chunk is passed to the callback.
+  bool GetClientNoisesFromServer(size_t noises_size, const fl::cache::ClientInfos::ClientNoisesCallback &callback);
+  // Wake up GetClientNoisesFromServer when the client noises are updated to shared server by any server.
+  void OnClientNoisesReady();
   // Update client key with signature to shared server.
   bool UpdateClientKeyToServer(const schema::RequestExchangeKeys *exchange_keys_req);
   // Update stable secure aggregation's client key to shared server.
@@ -110,6 +118,10 @@ class CipherMetaStorage {
   bool UpdateClientShareToServerInner(const std::string &fl_id,
                                       const flatbuffers::Vector<flatbuffers::Offset<schema::ClientShare>> *shares,
                                       SharesPb *shares_pb);
+
+  std::mutex noises_ready_mutex_;
+  std::condition_variable noises_ready_cond_;
+  bool noises_ready_ = false;
 };
 }  // namespace armour
 }  // namespace fl
@@ -24,19 +24,61 @@
 namespace mindspore {
 namespace fl {
 namespace armour {
-bool CipherReconStruct::CombineMask(std::vector<Share *> *shares_tmp,
-                                    std::map<std::string, std::vector<float>> *client_noise,
+namespace {
+constexpr size_t kMaskThreadNum = 8;
+// Elements of the noise sum guarded by one lock, masks of different tasks are added to different stripes at a time.
+constexpr size_t kNoiseSumStripeSize = 16384;
+}  // namespace
+
+bool CipherReconStruct::CombineMask(std::vector<MaskTask> *mask_tasks,
                                     const std::vector<std::string> &clients_share_list,
                                     const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
                                     const std::map<std::string, std::vector<clientshare_str>> &reconstruct_secret_list,
                                     const std::vector<std::string> &client_list,
                                     const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs) {
-  bool retcode = true;
-  if (shares_tmp == nullptr || client_noise == nullptr) {
-    MS_LOG(ERROR) << "shares_tmp or client_noise is nullptr.";
+  if (mask_tasks == nullptr) {
+    MS_LOG(ERROR) << "mask_tasks is nullptr.";
     return false;
   }
+  // the secrets of all the clients are combined in one batch, the clients with the same share indices share the
+  // lagrange coefficients.
+  std::vector<std::vector<ShareView>> share_groups;
   for (auto iter = reconstruct_secret_list.begin(); iter != reconstruct_secret_list.end(); ++iter) {
+    if (iter->second.size() < cipher_init_->secrets_minnums_) {
+      MS_LOG(ERROR) << "reconstruct secret failed: the number of secret shares for fl_id: " << iter->first
+                    << " is not enough";
+      MS_LOG(ERROR) << "get " << iter->second.size()
+                    << "shares, however the secrets_minnums_ required is: " << cipher_init_->secrets_minnums_;
+      return false;
+    }
+    std::vector<ShareView> share_group;
+    for (size_t i = 0; i < cipher_init_->secrets_minnums_; ++i) {
+      auto &share = (iter->second)[i];
+      share_group.push_back({static_cast<unsigned int>(share.index), share.share.data(), share.share.size()});
+    }
+    share_groups.push_back(std::move(share_group));
+  }
+  BIGNUM *prime = BN_new();
+  if (prime == nullptr) {
+    return false;
+  }
+  auto publicparam_ = CipherInit::GetInstance().GetPublicParams();
+  (void)BN_bin2bn(publicparam_->prime, PRIME_MAX_LEN, prime);
+  SecretSharing combine(prime);
+  BN_clear_free(prime);
+  std::vector<std::vector<uint8_t>> secrets;
+  bool retcode = combine.BatchCombine(cipher_init_->secrets_minnums_, share_groups, &secrets) == 0;
+  if (retcode) {
+    MS_LOG(INFO) << "combine secrets shares of " << secrets.size() << " clients Success.";
+  } else {
+    MS_LOG(ERROR) << "combine secrets shares failed.";
+  }
+
+  // public keys of the peers, shared by the pairwise masks of all dropped clients.
+  std::map<std::string, std::shared_ptr<PublicKey>> public_keys;
+  size_t secret_index = 0;
+  for (auto iter = reconstruct_secret_list.begin(); iter != reconstruct_secret_list.end() && retcode;
+       ++iter, ++secret_index) {
     // define flag_share: judge we need b or s
     bool flag_share = true;
     const std::string fl_id = iter->first;
@@ -45,76 +87,49 @@ bool CipherReconStruct::CombineMask(std::vector<Share *> *shares_tmp,
       flag_share = false;
     }
     MS_LOG(INFO) << "fl_id_src : " << fl_id;
-    BIGNUM *prime = BN_new();
-    if (prime == nullptr) {
-      return false;
+    auto &combined_secret = secrets[secret_index];
+    uint8_t secret[SECRET_MAX_LEN] = {0};
+    size_t length = SECRET_MAX_LEN;
+    if (combined_secret.size() > SECRET_MAX_LEN ||
+        (!combined_secret.empty() &&
+         memcpy_s(secret, SECRET_MAX_LEN, combined_secret.data(), combined_secret.size()) != 0)) {
+      MS_LOG(ERROR) << "copy secret of client " << fl_id << " failed, secret size: " << combined_secret.size();
+      retcode = false;
+      break;
     }
-    auto publicparam_ = CipherInit::GetInstance().GetPublicParams();
-    (void)BN_bin2bn(publicparam_->prime, PRIME_MAX_LEN, prime);
-    if (iter->second.size() >= cipher_init_->secrets_minnums_) {  // combine private key seed.
-      MS_LOG(INFO) << "start assign secrets shares to public shares ";
-      for (int i = 0; i < static_cast<int>(cipher_init_->secrets_minnums_); ++i) {
-        shares_tmp->at(i)->index = (iter->second)[i].index;
-        shares_tmp->at(i)->len = (iter->second)[i].share.size();
-        if (memcpy_s(shares_tmp->at(i)->data, IntToSize(SHARE_MAX_SIZE), (iter->second)[i].share.data(),
-                     shares_tmp->at(i)->len) != 0) {
-          MS_LOG(ERROR) << "shares_tmp copy failed";
-          retcode = false;
-        }
-      }
-      MS_LOG(INFO) << "end assign secrets shares to public shares ";
 
-      size_t length;
-      uint8_t secret[SECRET_MAX_LEN] = {0};
-      SecretSharing combine(prime);
-      if (combine.Combine(cipher_init_->secrets_minnums_, *shares_tmp, secret, &length) < 0) retcode = false;
-      length = SECRET_MAX_LEN;
-      MS_LOG(INFO) << "combine secrets shares Success.";
-
-      if (flag_share) {
-        // reconstruct pairwise noise
-        MS_LOG(INFO) << "start reconstruct pairwise noise.";
-        std::vector<float> noise(cipher_init_->featuremap_, 0.0);
-        if (GetSuvNoise(clients_share_list, record_public_keys, client_ivs, fl_id, &noise, secret, length) == false) {
-          MS_LOG(ERROR) << "GetSuvNoise failed";
-          BN_clear_free(prime);
-          if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-            MS_LOG(EXCEPTION) << "Memset failed.";
-          }
-          return false;
-        }
-        (void)client_noise->emplace(std::pair<std::string, std::vector<float>>(fl_id, noise));
+    if (flag_share) {
+      // reconstruct pairwise noise, the private key is parsed once and shared by the masks of all the peers.
+      MS_LOG(INFO) << "start reconstruct pairwise noise.";
+      std::shared_ptr<PrivateKey> private_key(KeyAgreement::FromPrivateBytes(secret, length));
+      if (private_key == nullptr) {
+        MS_LOG(ERROR) << "create privKey failed";
+        retcode = false;
       } else {
-        // reconstruct individual noise
-        MS_LOG(INFO) << "start reconstruct individual noise.";
-        std::vector<float> noise;
-
-        std::vector<uint8_t> ind_iv = GetIndiIV(fl_id, client_ivs);
-
-        if (Masking::GetMasking(&noise, SizeToInt(cipher_init_->featuremap_), (const uint8_t *)secret, SECRET_MAX_LEN,
-                                ind_iv.data(), SizeToInt(ind_iv.size())) < 0) {
-          MS_LOG(ERROR) << "Get Masking failed";
-          if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-            MS_LOG(EXCEPTION) << "Memset failed.";
-          }
-          BN_clear_free(prime);
-          return false;
-        }
-        for (size_t index_noise = 0; index_noise < cipher_init_->featuremap_; index_noise++) {
-          noise[index_noise] *= -1;
-        }
-        (void)client_noise->emplace(std::pair<std::string, std::vector<float>>(fl_id, noise));
-      }
-      BN_clear_free(prime);
-      if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
-        MS_LOG(EXCEPTION) << "Memset failed.";
+        retcode = GetSuvMaskTasks(clients_share_list, record_public_keys, client_ivs, fl_id, private_key,
+                                  &public_keys, mask_tasks);
       }
     } else {
-      MS_LOG(ERROR) << "reconstruct secret failed: the number of secret shares for fl_id: " << fl_id
-                    << " is not enough";
-      MS_LOG(ERROR) << "get " << iter->second.size()
-                    << "shares, however the secrets_minnums_ required is: " << cipher_init_->secrets_minnums_;
-      return false;
+      // reconstruct individual noise
+      MS_LOG(INFO) << "start reconstruct individual noise.";
+      MaskTask mask_task;
+      mask_task.seed.assign(secret, secret + length);
+      mask_task.iv = GetIndiIV(fl_id, client_ivs);
+      mask_task.sign = -1.0f;
+      retcode = !mask_task.iv.empty();
+      mask_tasks->push_back(std::move(mask_task));
+    }
+    if (memset_s(secret, SECRET_MAX_LEN, 0, length) != 0) {
+      MS_LOG(EXCEPTION) << "Memset failed.";
+    }
+    if (!retcode) {
+      MS_LOG(ERROR) << "Get mask of client " << fl_id << " failed";
+    }
+  }
+  for (auto &combined_secret : secrets) {
+    if (!combined_secret.empty() &&
+        memset_s(combined_secret.data(), combined_secret.size(), 0, combined_secret.size()) != 0) {
+      MS_LOG(EXCEPTION) << "Memset failed.";
     }
   }
   return retcode;
@@ -170,25 +185,23 @@ bool CipherReconStruct::ReconstructSecretsGenNoise(const std::vector<std::string
     MS_LOG(INFO) << "fl_id: " << iter->first;
     MS_LOG(INFO) << "share size: " << iter->second.size();
   }
-  std::vector<Share *> shares_tmp;
-  if (!MallocShares(&shares_tmp, (SizeToInt)(cipher_init_->secrets_minnums_))) {
-    MS_LOG(ERROR) << "Reconstruct malloc shares_tmp invalid.";
-    DeleteShares(&shares_tmp);
-    return false;
-  }
-
   MS_LOG(INFO) << "Reconstruct secrets shares: ";
-  std::map<std::string, std::vector<float>> client_noise;
-  retcode = CombineMask(&shares_tmp, &client_noise, clients_share_list, record_public_keys, reconstruct_secret_list,
-                        client_list, client_ivs);
-  DeleteShares(&shares_tmp);
-  if (retcode) {
-    std::vector<float> noise;
-    if (!GetNoiseMasksSum(&noise, client_noise)) {
-      MS_LOG(ERROR) << " GetNoiseMasksSum failed";
-      return false;
+  std::vector<MaskTask> mask_tasks;
+  retcode = CombineMask(&mask_tasks, clients_share_list, record_public_keys, reconstruct_secret_list, client_list,
+                        client_ivs);
+  std::vector<float> noise;
+  if (retcode && !GetNoiseMasksSum(&noise, mask_tasks)) {
+    MS_LOG(ERROR) << " GetNoiseMasksSum failed";
+    retcode = false;
+  }
+  for (auto &mask_task : mask_tasks) {
+    if (!mask_task.seed.empty() &&
+        memset_s(mask_task.seed.data(), mask_task.seed.size(), 0, mask_task.seed.size()) != 0) {
+      MS_LOG(EXCEPTION) << "Memset failed.";
     }
-    client_noise.clear();
+  }
+  mask_tasks.clear();
+  if (retcode) {
     MS_LOG(INFO) << " ReconstructSecretsGenNoise updata noise to server";
 
     if (!cipher_init_->cipher_meta_storage_.UpdateClientNoiseToServer(noise)) {
@@ -279,20 +292,31 @@ bool CipherReconStruct::ReconstructSecrets(const int cur_iterator, const std::st
   return true;
 }
 
-bool CipherReconStruct::GetNoiseMasksSum(std::vector<float> *result,
-                                         const std::map<std::string, std::vector<float>> &client_noise) {
-  std::vector<float> sum(cipher_init_->featuremap_, 0.0);
-  for (auto iter = client_noise.begin(); iter != client_noise.end(); iter++) {
-    if (iter->second.size() != cipher_init_->featuremap_) {
-      return false;
-    }
-    for (size_t i = 0; i < cipher_init_->featuremap_; i++) {
-      sum[i] += iter->second[i];
-    }
+bool CipherReconStruct::GetNoiseMasksSum(std::vector<float> *result, const std::vector<MaskTask> &mask_tasks) {
+  if (result == nullptr) {
+    return false;
   }
-  for (size_t i = 0; i < cipher_init_->featuremap_; i++) {
-    result->push_back(sum[i]);
+  std::vector<float> sum(cipher_init_->featuremap_, 0.0f);
+  auto get_task = [this, &mask_tasks](size_t index, Masking::MaskingTask *task) {
+    auto &mask_task = mask_tasks[index];
+    if (mask_task.private_key == nullptr) {
+      task->secret = mask_task.seed;
+    } else {
+      task->secret.resize(SECRET_MAX_LEN);
+      if (!GetPairwiseSeed(mask_task, task->secret.data())) {
+        return false;
+      }
+    }
+    task->ivec = mask_task.iv;
+    task->scale = mask_task.sign;
+    return true;
+  };
+  if (Masking::SumMaskings(sum.data(), sum.size(), mask_tasks.size(), get_task, kMaskThreadNum, kNoiseSumStripeSize) !=
+      0) {
+    MS_LOG(ERROR) << "Get Masking failed";
+    return false;
   }
+  *result = std::move(sum);
   return true;
 }
 
@@ -311,73 +335,59 @@ void CipherReconStruct::BuildReconstructSecretsRsp(const std::shared_ptr<FBBuild
   return;
 }
 
-bool CipherReconStruct::GetSuvNoise(const std::vector<std::string> &clients_share_list,
-                                    const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
-                                    const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs,
-                                    const std::string &fl_id, std::vector<float> *noise, const uint8_t *secret,
-                                    size_t length) {
+bool CipherReconStruct::GetSuvMaskTasks(
+  const std::vector<std::string> &clients_share_list,
+  const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
+  const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs, const std::string &fl_id,
+  const std::shared_ptr<PrivateKey> &private_key, std::map<std::string, std::shared_ptr<PublicKey>> *public_keys,
+  std::vector<MaskTask> *mask_tasks) {
   for (auto p_key = clients_share_list.begin(); p_key != clients_share_list.end(); ++p_key) {
-    if (*p_key != fl_id) {
-      PrivateKey *privKey = KeyAgreement::FromPrivateBytes(secret, length);
-      if (privKey == NULL) {
-        MS_LOG(ERROR) << "create privKey failed\n";
-        return false;
-      }
-      std::vector<uint8_t> public_key = record_public_keys.at(*p_key)[1];
-      std::string iv_fl_id;
-      if (fl_id < *p_key) {
-        iv_fl_id = fl_id;
-      } else {
-        iv_fl_id = *p_key;
-      }
-      auto iter = client_ivs.find(iv_fl_id);
-      if (iter == client_ivs.end()) {
-        MS_LOG(ERROR) << "cannot get ivs for client: " << iv_fl_id;
-        delete privKey;
-        return false;
-      }
-      if (iter->second.size() != IV_NUM) {
-        MS_LOG(ERROR) << "get " << iter->second.size() << " ivs, the iv num required is: " << IV_NUM;
-        return false;
-      }
-      std::vector<uint8_t> pw_iv = iter->second[PW_IV_INDEX];
-      std::vector<uint8_t> pw_salt = iter->second[PW_SALT_INDEX];
-      PublicKey *pubKey = KeyAgreement::FromPublicBytes(public_key.data(), public_key.size());
-      if (pubKey == NULL) {
-        MS_LOG(ERROR) << "create pubKey failed\n";
-        return false;
-      }
-      MS_LOG(INFO) << "private_key fl_id : " << fl_id << " public_key fl_id : " << *p_key;
-      uint8_t secret1[SECRET_MAX_LEN] = {0};
-      int ret = KeyAgreement::ComputeSharedKey(privKey, pubKey, SECRET_MAX_LEN, pw_salt.data(),
-                                               SizeToInt(pw_salt.size()), secret1);
-      delete privKey;
-      delete pubKey;
-      if (ret < 0) {
-        MS_LOG(ERROR) << "ComputeSharedKey failed\n";
+    if (*p_key == fl_id) {
+      continue;
+    }
+    auto &public_key = (*public_keys)[*p_key];
+    if (public_key == nullptr) {
+      auto key_iter = record_public_keys.find(*p_key);
+      if (key_iter == record_public_keys.end() || key_iter->second.size() <= 1) {
+        MS_LOG(ERROR) << "cannot get public key for client: " << *p_key;
         return false;
       }
-
-      std::vector<float> noise_tmp;
-      if (Masking::GetMasking(&noise_tmp, SizeToInt(cipher_init_->featuremap_), (const uint8_t *)secret1,
-                              SECRET_MAX_LEN, pw_iv.data(), pw_iv.size()) < 0) {
-        MS_LOG(ERROR) << "Get Masking failed\n";
+      auto &public_key_bytes = key_iter->second[1];
+      public_key.reset(KeyAgreement::FromPublicBytes(public_key_bytes.data(), public_key_bytes.size()));
+      if (public_key == nullptr) {
+        MS_LOG(ERROR) << "create pubKey failed";
         return false;
       }
-      bool symbol_noise = GetSymbol(fl_id, *p_key);
-      size_t index = 0;
-      size_t size_noise = noise_tmp.size();
-      if (symbol_noise == false) {
-        for (; index < size_noise; ++index) {
-          noise_tmp[index] = noise_tmp[index] * -1;
-          noise->at(index) += noise_tmp[index];
-        }
-      } else {
-        for (; index < size_noise; ++index) {
-          noise->at(index) += noise_tmp[index];
-        }
-      }
     }
+    const std::string &iv_fl_id = fl_id < *p_key ? fl_id : *p_key;
+    auto iter = client_ivs.find(iv_fl_id);
+    if (iter == client_ivs.end()) {
+      MS_LOG(ERROR) << "cannot get ivs for client: " << iv_fl_id;
+      return false;
+    }
+    if (iter->second.size() != IV_NUM) {
+      MS_LOG(ERROR) << "get " << iter->second.size() << " ivs, the iv num required is: " << IV_NUM;
+      return false;
+    }
+    MS_LOG(INFO) << "private_key fl_id : " << fl_id << " public_key fl_id : " << *p_key;
+    MaskTask mask_task;
+    mask_task.private_key = private_key;
+    mask_task.peer_public_key = public_key;
+    mask_task.salt = iter->second[PW_SALT_INDEX];
+    mask_task.iv = iter->second[PW_IV_INDEX];
+    mask_task.sign = GetSymbol(fl_id, *p_key) ? 1.0f : -1.0f;
+    mask_tasks->push_back(std::move(mask_task));
+  }
+  return true;
+}
+
+bool CipherReconStruct::GetPairwiseSeed(const MaskTask &mask_task, uint8_t *seed) const {
+  int ret = KeyAgreement::ComputeSharedKey(mask_task.private_key.get(), mask_task.peer_public_key.get(),
+                                           SECRET_MAX_LEN, mask_task.salt.data(), SizeToInt(mask_task.salt.size()),
+                                           seed);
+  if (ret < 0) {
+    MS_LOG(ERROR) << "ComputeSharedKey failed";
+    return false;
   }
   return true;
 }
@@ -414,42 +424,6 @@ bool CipherReconStruct::ConvertSharesToShares(const std::map<std::string, std::v
   }
   return true;
 }
-
-bool CipherReconStruct::MallocShares(std::vector<Share *> *shares_tmp, size_t shares_size) {
-  if (shares_tmp == nullptr) return false;
-  for (size_t i = 0; i < shares_size; ++i) {
-    Share *share_i = new (std::nothrow) Share();
-    if (share_i == nullptr) {
-      MS_LOG(ERROR) << "new Share failed.";
-      return false;
-    }
-    share_i->data = new uint8_t[SHARE_MAX_SIZE];
-    if (share_i->data == nullptr) {
-      MS_LOG(ERROR) << "malloc memory failed.";
-      delete share_i;
-      return false;
-    }
-    share_i->index = 0;
-    share_i->len = SHARE_MAX_SIZE;
-    shares_tmp->push_back(share_i);
-  }
-  return true;
-}
-
-void CipherReconStruct::DeleteShares(std::vector<Share *> *shares_tmp) {
-  if (shares_tmp == nullptr) return;
-  if (shares_tmp->size() != 0) {
-    for (size_t i = 0; i < shares_tmp->size(); ++i) {
-      if (shares_tmp->at(i) != nullptr && shares_tmp->at(i)->data != nullptr) {
-        delete[](shares_tmp->at(i)->data);
-        shares_tmp->at(i)->data = nullptr;
-      }
-      delete shares_tmp->at(i);
-      shares_tmp->at(i) = nullptr;
-    }
-  }
-  return;
-}
 }  // namespace armour
 }  // namespace fl
 }  // namespace mindspore
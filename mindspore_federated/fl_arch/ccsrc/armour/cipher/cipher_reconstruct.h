@@ -23,6 +23,7 @@
 #include <map>
 #include <utility>
 #include "armour/secure_protocol/secret_sharing.h"
+#include "armour/secure_protocol/key_agreement.h"
 #include "common/utils/log_adapter.h"
 #include "armour/cipher/cipher_init.h"
 #include "armour/cipher/cipher_meta_storage.h"
@@ -57,27 +58,37 @@ class CipherReconStruct {
   bool ReconstructSecretsGenNoise(const std::vector<std::string> &client_list);
 
  private:
+  // A signed mask of the noise sum: the individual mask of an online client, or the pairwise mask of a dropped client
+  // and one of its peers, whose seed is agreed by the private key of the dropped client and the public key of the peer.
+  struct MaskTask {
+    std::vector<uint8_t> seed;  // seed of the individual mask
+    std::shared_ptr<PrivateKey> private_key;
+    std::shared_ptr<PublicKey> peer_public_key;
+    std::vector<uint8_t> salt;
+    std::vector<uint8_t> iv;
+    float sign = 1.0f;
+  };
+
   CipherInit *cipher_init_;  // the parameter of the secure aggregation
   // get mask symbol by comparing str1 and str2.
   bool GetSymbol(const std::string &str1, const std::string &str2) const;
-  // get suv noise by computing shares result.
-  bool GetSuvNoise(const std::vector<std::string> &clients_share_list,
-                   const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
-                   const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs, const std::string &fl_id,
-                   std::vector<float> *noise, const uint8_t *secret, size_t length);
-  // malloc shares.
-  bool MallocShares(std::vector<Share *> *shares_tmp, size_t shares_size);
-  // delete shares.
-  void DeleteShares(std::vector<Share *> *shares_tmp);
+  // get the pairwise mask tasks of a dropped client and every peer in clients_share_list.
+  bool GetSuvMaskTasks(const std::vector<std::string> &clients_share_list,
+                       const std::map<std::string, std::vector<std::vector<uint8_t>>> &record_public_keys,
+                       const std::map<std::string, std::vector<std::vector<uint8_t>>> &client_ivs,
+                       const std::string &fl_id, const std::shared_ptr<PrivateKey> &private_key,
+                       std::map<std::string, std::shared_ptr<PublicKey>> *public_keys,
+                       std::vector<MaskTask> *mask_tasks);
+  // compute the seed of the pairwise mask of a task, whose size is SECRET_MAX_LEN.
+  bool GetPairwiseSeed(const MaskTask &mask_task, uint8_t *seed) const;
   // convert shares from receiving clients to sending clients.
   bool ConvertSharesToShares(const std::map<std::string, std::vector<clientshare_str>> &src,
                              std::map<std::string, std::vector<clientshare_str>> *des);
-  // get noise masks sum.
-  bool GetNoiseMasksSum(std::vector<float> *result, const std::map<std::string, std::vector<float>> &client_noise);
+  // get noise masks sum, masks are generated stripe by stripe by a thread pool and added to the sum directly.
+  bool GetNoiseMasksSum(std::vector<float> *result, const std::vector<MaskTask> &mask_tasks);
 
-  // combine noise mask.
-  bool CombineMask(std::vector<Share *> *shares_tmp, std::map<std::string, std::vector<float>> *client_noise,
-                   const std::vector<std::string> &clients_share_list,
+  // combine the secrets of clients, and get the mask tasks of them.
+  bool CombineMask(std::vector<MaskTask> *mask_tasks, const std::vector<std::string> &clients_share_list,
                    const std::map<std::string, std::vector<std::vector<unsigned char>>> &record_public_keys,
                    const std::map<std::string, std::vector<clientshare_str>> &reconstruct_secret_list,
                    const std::vector<std::string> &client_list,
@@ -15,46 +15,72 @@
  */
 
 #include "armour/cipher/cipher_unmask.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
 #include "common/common.h"
 #include "server/local_meta_store.h"
 #include "armour/cipher/cipher_meta_storage.h"
+#include "armour/cipher/unmask_segment.h"
 
 namespace mindspore {
 namespace fl {
 namespace armour {
-bool CipherUnmask::UnMask(const ModelItemPtr &model) {
-  MS_LOG(INFO) << "CipherMgr::UnMask START";
-  clock_t start_time = clock();
-  std::vector<float> noise;
-
-  bool ret = cipher_init_->cipher_meta_storage_.GetClientNoisesFromServer(&noise);
-  if (!ret || noise.size() != cipher_init_->featuremap_) {
-    MS_LOG(WARNING) << "Client noises is not ready";
+bool CipherUnmask::WaitClientNoises() {
+  uint64_t noises_size = 0;
+  if (!cipher_init_->cipher_meta_storage_.WaitClientNoisesFromServer(&noises_size)) {
+    return false;
+  }
+  if (noises_size != cipher_init_->featuremap_) {
+    MS_LOG(WARNING) << "The size of client noises " << noises_size << " is not equal to feature_map "
+                    << cipher_init_->featuremap_;
     return false;
   }
+  return true;
+}
 
+bool CipherUnmask::UnMask(const ModelItemPtr &model) {
+  MS_LOG(INFO) << "CipherMgr::UnMask START";
+  auto start_time = std::chrono::steady_clock::now();
   size_t data_size = fl::server::LocalMetaStore::GetInstance().value<size_t>(kCtxFedAvgTotalDataSize);
   if (data_size == 0) {
     MS_LOG(ERROR) << "FedAvgTotalDataSize equals to 0";
     return false;
   }
+  // The weights are copied before written if they are shared, so get all the addresses before the noise chunks are
+  // added by several threads.
+  std::vector<UnmaskSegment> segments;
   size_t sum_size = 0;
-  auto weight_data = model->weight_data.data();
   for (auto &feature : model->weight_items) {
-    auto in_data = reinterpret_cast<float *>(weight_data + feature.second.offset);
+    auto in_data = reinterpret_cast<float *>(model->mutable_weight_addr(feature.first));
+    MS_ERROR_IF_NULL_W_RET_VAL(in_data, false);
     size_t elems_count = feature.second.size / sizeof(float);
-    for (size_t i = 0; i < elems_count; ++i) {
-      in_data[i] = in_data[i] + noise[i + sum_size] / data_size;
-    }
+    segments.push_back({in_data, sum_size, elems_count});
     sum_size += elems_count;
-    for (size_t i = 0; i < std::min(3ul, elems_count); ++i) {
-      MS_LOG(INFO) << " index : " << i << " in_data unmask: " << in_data[i] * data_size;
-    }
   }
   MS_LOG(INFO) << "CipherMgr::UnMask sum_size : " << sum_size;
   MS_LOG(INFO) << "CipherMgr::UnMask feature_map : " << cipher_init_->featuremap_;
-  clock_t end_time = clock();
-  double duration = static_cast<double>((end_time - start_time) * 1.0 / CLOCKS_PER_SEC);
+  if (sum_size > cipher_init_->featuremap_) {
+    MS_LOG(ERROR) << "The size of the model is larger than feature_map";
+    return false;
+  }
+
+  // Each chunk of the noises is added to the weights it overlaps as soon as it is read, the chunks are disjoint so
+  // the threads never write the same weight elements. If a chunk fails, the iteration is dropped with the model.
+  const float scale = 1.0f / data_size;
+  auto unmask_chunk = [&segments, scale](size_t offset, const float *noises, size_t size) {
+    AddNoisesToSegments(segments, offset, noises, size, scale);
+  };
+  if (!cipher_init_->cipher_meta_storage_.GetClientNoisesFromServer(cipher_init_->featuremap_, unmask_chunk)) {
+    MS_LOG(WARNING) << "Client noises is not ready";
+    return false;
+  }
+  for (auto &segment : segments) {
+    for (size_t i = 0; i < std::min<size_t>(3, segment.size); ++i) {
+      MS_LOG(INFO) << " index : " << i << " in_data unmask: " << segment.data[i] * data_size;
+    }
+  }
+  double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
   MS_LOG(INFO) << "Unmask success time is : " << duration;
   return true;
 }
@@ -34,7 +34,9 @@ class CipherUnmask {
   // initialize: get cipher_init_
   CipherUnmask() { cipher_init_ = &CipherInit::GetInstance(); }
   ~CipherUnmask() = default;
-  // unmask the data by secret mask.
+  // wait until the client noises of the iteration are updated to shared server, which may take long.
+  bool WaitClientNoises();
+  // unmask the data by secret mask, the client noises should be ready, see WaitClientNoises.
   bool UnMask(const ModelItemPtr &model);
 
  private:
@@ -0,0 +1,42 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "armour/cipher/unmask_segment.h"
+#include <algorithm>
+#include "common/utils/simd_kernels.h"
+
+namespace mindspore {
+namespace fl {
+namespace armour {
+void AddNoisesToSegments(const std::vector<UnmaskSegment> &segments, size_t offset, const float *noises, size_t size,
+                         float scale) {
+  size_t end = offset + size;
+  auto iter = std::upper_bound(segments.begin(), segments.end(), offset,
+                               [](size_t value, const UnmaskSegment &segment) { return value < segment.offset; });
+  if (iter != segments.begin()) {
+    --iter;
+  }
+  for (; iter != segments.end() && iter->offset < end; ++iter) {
+    size_t begin = std::max(offset, iter->offset);
+    size_t stop = std::min(end, iter->offset + iter->size);
+    if (begin < stop) {
+      simd::AddScaled(iter->data + (begin - iter->offset), noises + (begin - offset), scale, stop - begin);
+    }
+  }
+}
+}  // namespace armour
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,41 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_ARMOUR_CIPHER_UNMASK_SEGMENT_H
+#define MINDSPORE_CCSRC_ARMOUR_CIPHER_UNMASK_SEGMENT_H
+
+#include <cstddef>
+#include <vector>
+
+namespace mindspore {
+namespace fl {
+namespace armour {
+// A weight of the model and the offset of it in the noises.
+struct UnmaskSegment {
+  float *data;
+  size_t offset;
+  size_t size;
+};
+
+// Adds the noises [offset, offset + size) multiplied by scale to the weights they overlap, the noises beyond the
+// weights are ignored. The segments are sorted by offset and don't overlap, so chunks of the noises which don't overlap
+// can be added by several threads at the same time.
+void AddNoisesToSegments(const std::vector<UnmaskSegment> &segments, size_t offset, const float *noises, size_t size,
+                         float scale);
+}  // namespace armour
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_ARMOUR_CIPHER_UNMASK_SEGMENT_H
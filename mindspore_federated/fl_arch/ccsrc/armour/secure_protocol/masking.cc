@@ -15,40 +15,171 @@
  */
 
 #include "armour/secure_protocol/masking.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include "common/parallel_for.h"
+#include "common/utils/convert_utils_base.h"
+#include "common/utils/simd_kernels.h"
 
 namespace mindspore {
 namespace fl {
 namespace armour {
-int Masking::GetMasking(std::vector<float> *noise, int noise_len, const uint8_t *secret, int secret_len,
-                        const uint8_t *ivec, int ivec_size) {
-  if ((secret_len != KEY_LENGTH_16 && secret_len != KEY_LENGTH_32) || secret == NULL) {
+namespace {
+// Number of int32 values of the key stream generated by one EVP call, 16KB stays in the L1 or L2 cache.
+constexpr size_t kMaskingChunkSize = 4096;
+constexpr size_t kValuesPerBlock = AES_IV_SIZE / sizeof(int32_t);
+constexpr size_t kByteBits = 8;
+constexpr uint64_t kByteMask = 0xFF;
+
+// Adds block_num to the counter, which is the 128 bits big endian number incremented by AES-CTR for each block.
+void AddCounter(uint8_t *counter, uint64_t block_num) {
+  for (size_t i = AES_IV_SIZE; i > 0 && block_num != 0; i--) {
+    uint64_t sum = counter[i - 1] + (block_num & kByteMask);
+    counter[i - 1] = static_cast<uint8_t>(sum);
+    block_num = (block_num >> kByteBits) + (sum >> kByteBits);
+  }
+}
+
+// Generates values [offset, offset + noise_len) of the mask, and calls func(index, values, num) for each chunk, where
+// index is the position of values[0] relative to offset.
+template <class F>
+int ForEachMaskingChunk(size_t offset, size_t noise_len, const uint8_t *secret, int secret_len, const uint8_t *ivec,
+                        int ivec_size, const F &func) {
+  if ((secret_len != KEY_LENGTH_16 && secret_len != KEY_LENGTH_32) || secret == nullptr) {
     MS_LOG(ERROR) << "secret is invalid!";
     return -1;
   }
-  if (noise == NULL || noise_len <= 0) {
-    MS_LOG(ERROR) << "noise is invalid!";
+  if (ivec == nullptr || ivec_size != AES_IV_SIZE) {
+    MS_LOG(ERROR) << "ivec is invalid!";
     return -1;
   }
-  if (ivec == NULL || ivec_size != AES_IV_SIZE) {
-    MS_LOG(ERROR) << "ivec is invalid!";
+  if (noise_len == 0) {
+    return 0;
+  }
+  // Start from the block of the first value, since the counter of CTR mode can be moved to any block.
+  uint8_t counter[AES_IV_SIZE];
+  (void)std::copy(ivec, ivec + AES_IV_SIZE, counter);
+  AddCounter(counter, offset / kValuesPerBlock);
+  size_t skip = offset % kValuesPerBlock;
+
+  std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)> ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+  if (ctx == nullptr) {
+    MS_LOG(ERROR) << "new cipher ctx failed!";
     return -1;
   }
-  int size = noise_len * sizeof(int);
-  std::vector<uint8_t> data(size, 0);
-  std::vector<uint8_t> encrypt_data(size, 0);
-  int encrypt_len = 0;
-  AESEncrypt encrypt(secret, secret_len, ivec, AES_IV_SIZE, AES_CTR);
-  if (encrypt.EncryptData(data.data(), size, encrypt_data.data(), &encrypt_len) != 0) {
+  const EVP_CIPHER *cipher = secret_len == KEY_LENGTH_16 ? EVP_aes_128_ctr() : EVP_aes_256_ctr();
+  if (EVP_EncryptInit_ex(ctx.get(), cipher, nullptr, secret, counter) != 1) {
     MS_LOG(ERROR) << "call AES-CTR failed!";
     return -1;
   }
+  // The key stream is the encryption of zeros.
+  static const uint8_t zeros[kMaskingChunkSize * sizeof(int32_t)] = {0};
+  int32_t stream[kMaskingChunkSize];
+  float values[kMaskingChunkSize];
+  size_t index = 0;
+  while (index < noise_len) {
+    size_t num = std::min(kMaskingChunkSize, skip + noise_len - index);
+    int out_len = 0;
+    if (EVP_EncryptUpdate(ctx.get(), reinterpret_cast<uint8_t *>(stream), &out_len, zeros,
+                          static_cast<int>(num * sizeof(int32_t))) != 1 ||
+        static_cast<size_t>(out_len) != num * sizeof(int32_t)) {
+      MS_LOG(ERROR) << "call AES-CTR failed!";
+      return -1;
+    }
+    for (size_t i = skip; i < num; i++) {
+      values[i - skip] = static_cast<float>(stream[i]) / INT32_MAX;
+    }
+    func(index, values, num - skip);
+    index += num - skip;
+    skip = 0;
+  }
+  return 0;
+}
+}  // namespace
 
-  for (int i = 0; i < noise_len; i++) {
-    auto value = *(reinterpret_cast<int32_t *>(encrypt_data.data()) + i);
-    (void)noise->emplace_back(static_cast<float>(value) / INT32_MAX);
+int Masking::GetMasking(std::vector<float> *noise, int noise_len, const uint8_t *secret, int secret_len,
+                        const uint8_t *ivec, int ivec_size) {
+  if (noise == NULL || noise_len <= 0) {
+    MS_LOG(ERROR) << "noise is invalid!";
+    return -1;
+  }
+  size_t old_size = noise->size();
+  noise->resize(old_size + IntToSize(noise_len));
+  if (GetMasking(noise->data() + old_size, 0, IntToSize(noise_len), secret, secret_len, ivec, ivec_size) != 0) {
+    noise->resize(old_size);
+    return -1;
   }
   return 0;
 }
+
+int Masking::GetMasking(float *noise, size_t offset, size_t noise_len, const uint8_t *secret, int secret_len,
+                        const uint8_t *ivec, int ivec_size) {
+  if (noise == nullptr) {
+    MS_LOG(ERROR) << "noise is invalid!";
+    return -1;
+  }
+  return ForEachMaskingChunk(offset, noise_len, secret, secret_len, ivec, ivec_size,
+                             [noise](size_t index, const float *values, size_t num) {
+                               (void)std::copy(values, values + num, noise + index);
+                             });
+}
+
+int Masking::AccumulateMasking(float *noise, size_t offset, size_t noise_len, float scale, const uint8_t *secret,
+                               int secret_len, const uint8_t *ivec, int ivec_size) {
+  if (noise == nullptr) {
+    MS_LOG(ERROR) << "noise is invalid!";
+    return -1;
+  }
+  return ForEachMaskingChunk(offset, noise_len, secret, secret_len, ivec, ivec_size,
+                             [noise, scale](size_t index, const float *values, size_t num) {
+                               simd::AddScaled(noise + index, values, scale, num);
+                             });
+}
+
+int Masking::SumMaskings(float *sum, size_t noise_len, size_t task_num, const MaskingTaskGetter &get_task,
+                         size_t thread_num, size_t stripe_size) {
+  if (sum == nullptr || get_task == nullptr || stripe_size == 0) {
+    MS_LOG(ERROR) << "sum, get_task or stripe_size is invalid!";
+    return -1;
+  }
+  if (noise_len == 0) {
+    return 0;
+  }
+  size_t stripe_num = (noise_len + stripe_size - 1) / stripe_size;
+  std::vector<std::mutex> stripe_locks(stripe_num);
+  std::atomic_bool success(true);
+  ParallelSync parallel_sync(thread_num);
+  parallel_sync.parallel_for(0, task_num, 1, [&](size_t beg, size_t end) {
+    std::vector<float> mask(std::min(stripe_size, noise_len));
+    MaskingTask task;
+    for (size_t i = beg; i < end && success; i++) {
+      if (!get_task(i, &task)) {
+        success = false;
+        break;
+      }
+      for (size_t k = 0; k < stripe_num && success; k++) {
+        size_t stripe = (i + k) % stripe_num;
+        size_t offset = stripe * stripe_size;
+        size_t len = std::min(stripe_size, noise_len - offset);
+        if (GetMasking(mask.data(), offset, len, task.secret.data(), SizeToInt(task.secret.size()), task.ivec.data(),
+                       SizeToInt(task.ivec.size())) != 0) {
+          success = false;
+          break;
+        }
+        std::lock_guard<std::mutex> lock(stripe_locks[stripe]);
+        simd::AddScaled(sum + offset, mask.data(), task.scale, len);
+      }
+    }
+    // Run by the worker threads, so errors are returned instead of thrown.
+    if (!task.secret.empty() && memset_s(task.secret.data(), task.secret.size(), 0, task.secret.size()) != EOK) {
+      MS_LOG(ERROR) << "Memset failed.";
+      success = false;
+    }
+  });
+  return success ? 0 : -1;
+}
 }  // namespace armour
 }  // namespace fl
 }  // namespace mindspore
@@ -17,6 +17,8 @@
 #ifndef MINDSPORE_ARMOUR_RANDOM_H
 #define MINDSPORE_ARMOUR_RANDOM_H
 
+#include <cstddef>
+#include <functional>
 #include <random>
 #include <vector>
 #include "armour/secure_protocol/encrypt.h"
@@ -28,6 +30,29 @@ class MS_EXPORT Masking {
  public:
   static int GetMasking(std::vector<float> *noise, int noise_len, const uint8_t *secret, int secret_len,
                         const uint8_t *ivec, int ivec_size);
+  // The mask is the AES-CTR key stream of the secret and ivec read as int32 values and scaled by 1 / INT32_MAX. The
+  // two functions below generate values [offset, offset + noise_len) of the mask chunk by chunk, without buffers of
+  // the whole mask, so a mask can be split into stripes and generated by several threads.
+  // Writes the values to noise[0, noise_len).
+  static int GetMasking(float *noise, size_t offset, size_t noise_len, const uint8_t *secret, int secret_len,
+                        const uint8_t *ivec, int ivec_size);
+  // Adds the values multiplied by scale to noise[0, noise_len).
+  static int AccumulateMasking(float *noise, size_t offset, size_t noise_len, float scale, const uint8_t *secret,
+                               int secret_len, const uint8_t *ivec, int ivec_size);
+
+  // Secret, ivec and scale of one of the masks summed by SumMaskings.
+  struct MaskingTask {
+    std::vector<uint8_t> secret;
+    std::vector<uint8_t> ivec;
+    float scale = 1.0f;
+  };
+  // Fills the task of an index, called by the threads of SumMaskings.
+  using MaskingTaskGetter = std::function<bool(size_t index, MaskingTask *task)>;
+  // Adds the scaled masks of task_num tasks to sum[0, noise_len) by thread_num threads. The masks are generated stripe
+  // by stripe of stripe_size values and added under the lock of the stripe, and the tasks start from different
+  // stripes, so the threads seldom wait for each other and no thread holds a buffer of the whole mask.
+  static int SumMaskings(float *sum, size_t noise_len, size_t task_num, const MaskingTaskGetter &get_task,
+                         size_t thread_num, size_t stripe_size);
 };
 }  // namespace armour
 }  // namespace fl
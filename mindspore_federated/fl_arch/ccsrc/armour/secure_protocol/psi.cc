@@ -14,11 +14,17 @@
  * limitations under the License.
  */
 
+#include <fstream>
+#include <future>
 #include <random>
 #include <vector>
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include "armour/base_crypto/blocked_bloom_filter.h"
+#include "armour/base_crypto/digest_hash_set.h"
 #include "armour/base_crypto/hash.h"
 #include "armour/util/io_util.h"
 #include "armour/secure_protocol/psi.h"
@@ -28,24 +34,25 @@ namespace mindspore {
 namespace fl {
 namespace psi {
 
-std::vector<std::string> Align(std::vector<std::string> *alice_vct, const std::vector<std::string> &bob_vct,
-                               const PsiCtx &psi_ctx) {
-  MS_LOG(INFO) << "Bob start doing align.";
+namespace {
+// Compare strings of the same length up to kWidth bytes are looked up in a hash set instead of sorted.
+template <size_t kWidth>
+std::vector<std::string> AlignByHashSet(const std::vector<std::string> &alice_vct,
+                                        const std::vector<std::string> &bob_vct, const PsiCtx &psi_ctx) {
   time_t time_start;
   time_t time_end;
   time(&time_start);
-
-  std::sort(alice_vct->begin(), alice_vct->end());
+  DigestHashSet<kWidth> alice_set(alice_vct, psi_ctx.thread_num, psi_ctx.chunk_size);
   time(&time_end);
-  MS_LOG(INFO) << "Sort alice's data, time cost: " << difftime(time_end, time_start) << " s.";
+  MS_LOG(INFO) << "Build hash set of alice's data, time cost: " << difftime(time_end, time_start) << " s.";
 
   time(&time_start);
-  std::vector<std::string> align_results_vector(std::min(alice_vct->size(), bob_vct.size()));
+  std::vector<std::string> align_results_vector(std::min(alice_vct.size(), bob_vct.size()));
   std::atomic<size_t> idx(0);
   ParallelSync parallel_sync(psi_ctx.thread_num);
   parallel_sync.parallel_for(0, bob_vct.size(), psi_ctx.chunk_size, [&](size_t beg, size_t end) {
     for (size_t i = beg; i < end; i++) {
-      if (std::binary_search(alice_vct->begin(), alice_vct->end(), bob_vct[i])) {
+      if (alice_set.Contains(bob_vct[i])) {
         align_results_vector[idx++] = psi_ctx.input_vct[i];
       }
     }
@@ -54,12 +61,23 @@ std::vector<std::string> Align(std::vector<std::string> *alice_vct, const std::v
   time(&time_end);
   MS_LOG(INFO) << "Do align, time cost: " << difftime(time_end, time_start) << " s.";
   MS_LOG(INFO) << "PSI num is: " << align_results_vector.size();
-
   return align_results_vector;
 }
 
-std::vector<std::string> Align(const std::vector<std::string> &p_b_a_bI_vct, const BloomFilter &bf,
-                               const PsiCtx &psi_ctx) {
+// Returns the common length of all strings, or 0 if they have different lengths.
+size_t CommonLength(const std::vector<std::string> &alice_vct, const std::vector<std::string> &bob_vct) {
+  size_t length = alice_vct.empty() ? (bob_vct.empty() ? 0 : bob_vct[0].size()) : alice_vct[0].size();
+  auto same_length = [length](const std::string &item) { return item.size() == length; };
+  if (!std::all_of(alice_vct.begin(), alice_vct.end(), same_length) ||
+      !std::all_of(bob_vct.begin(), bob_vct.end(), same_length)) {
+    return 0;
+  }
+  return length;
+}
+
+template <class Filter>
+std::vector<std::string> AlignByFilter(const std::vector<std::string> &p_b_a_bI_vct, const Filter &bf,
+                                       const PsiCtx &psi_ctx) {
   MS_LOG(INFO) << "Bob start doing filter_align";
   time_t time_start;
   time_t time_end;
@@ -83,6 +101,129 @@ std::vector<std::string> Align(const std::vector<std::string> &p_b_a_bI_vct, con
                << static_cast<int>((align_results_vector.size() - psi_ctx.input_vct.size() / 2));
   return align_results_vector;
 }
+}  // namespace
+
+std::vector<std::string> Align(std::vector<std::string> *alice_vct, const std::vector<std::string> &bob_vct,
+                               const PsiCtx &psi_ctx) {
+  MS_LOG(INFO) << "Bob start doing align.";
+  size_t compare_length = CommonLength(*alice_vct, bob_vct);
+  if (compare_length > 0 && compare_length <= LENGTH_16) {
+    return AlignByHashSet<LENGTH_16>(*alice_vct, bob_vct, psi_ctx);
+  }
+  if (compare_length > 0 && compare_length <= LENGTH_32) {
+    return AlignByHashSet<LENGTH_32>(*alice_vct, bob_vct, psi_ctx);
+  }
+  time_t time_start;
+  time_t time_end;
+  time(&time_start);
+
+  std::sort(alice_vct->begin(), alice_vct->end());
+  time(&time_end);
+  MS_LOG(INFO) << "Sort alice's data, time cost: " << difftime(time_end, time_start) << " s.";
+
+  time(&time_start);
+  std::vector<std::string> align_results_vector(std::min(alice_vct->size(), bob_vct.size()));
+  std::atomic<size_t> idx(0);
+  ParallelSync parallel_sync(psi_ctx.thread_num);
+  parallel_sync.parallel_for(0, bob_vct.size(), psi_ctx.chunk_size, [&](size_t beg, size_t end) {
+    for (size_t i = beg; i < end; i++) {
+      if (std::binary_search(alice_vct->begin(), alice_vct->end(), bob_vct[i])) {
+        align_results_vector[idx++] = psi_ctx.input_vct[i];
+      }
+    }
+  });
+  align_results_vector.resize(idx);
+  time(&time_end);
+  MS_LOG(INFO) << "Do align, time cost: " << difftime(time_end, time_start) << " s.";
+  MS_LOG(INFO) << "PSI num is: " << align_results_vector.size();
+
+  return align_results_vector;
+}
+
+std::vector<std::string> Align(const std::vector<std::string> &p_b_a_bI_vct, const BloomFilter &bf,
+                               const PsiCtx &psi_ctx) {
+  return AlignByFilter(p_b_a_bI_vct, bf, psi_ctx);
+}
+
+std::vector<std::string> Align(const std::vector<std::string> &p_b_a_bI_vct, const BlockedBloomFilter &bf,
+                               const PsiCtx &psi_ctx) {
+  return AlignByFilter(p_b_a_bI_vct, bf, psi_ctx);
+}
+
+namespace {
+// Bloom filter of alice's p1^a sent to bob, in the format of psi_type.
+std::string BuildFilterData(const std::vector<std::string> &p_a_vct, const PsiCtx &psi_ctx) {
+  if (psi_ctx.psi_type == "blocked_filter_ecdh") {
+    return BlockedBloomFilter(p_a_vct, psi_ctx.neg_log_fp_rate, psi_ctx.thread_num).GetData();
+  }
+  BloomFilter bf_alice(p_a_vct, psi_ctx.neg_log_fp_rate);
+  MS_LOG(INFO) << "Bloom filter bit array size is: " << bf_alice.bitArrayByteLen() << "Bytes.";
+  return bf_alice.GetData();
+}
+
+std::vector<std::string> AlignWithFilterData(const std::vector<std::string> &p_b_a_bI_vct,
+                                             const std::string &filter_data, const PsiCtx &psi_ctx) {
+  if (psi_ctx.psi_type == "blocked_filter_ecdh") {
+    BlockedBloomFilter bf_alice_recv;
+    // An empty result would be taken as no intersection by the peer, so the round fails instead.
+    if (!bf_alice_recv.Parse(filter_data)) {
+      MS_LOG(EXCEPTION) << "Failed to parse the blocked bloom filter of size " << filter_data.size()
+                        << " received from the peer, bin id is " << psi_ctx.bin_id;
+    }
+    return Align(p_b_a_bI_vct, bf_alice_recv, psi_ctx);
+  }
+  BloomFilter bf_alice_recv(filter_data, psi_ctx.peer_num, psi_ctx.neg_log_fp_rate);
+  return Align(p_b_a_bI_vct, bf_alice_recv, psi_ctx);
+}
+
+void StartVerticalCommunicator(const std::string &http_server_address, const std::string &remote_server_address) {
+  VFLContext::instance()->set_http_server_address(http_server_address);
+  VFLContext::instance()->set_remote_server_address(remote_server_address);
+  auto &verticalServer = VerticalServer::GetInstance();
+  verticalServer.StartVerticalCommunicator();
+}
+
+// Exchanges the bin id, psi type and dataset sizes with the peer, and decides the role of this party.
+bool InitPsiCtx(const std::string &COM_role, PsiCtx *psi_ctx) {
+  auto &verticalServer = VerticalServer::GetInstance();
+  if (COM_role == "client") {
+    MS_LOG(INFO) << "-------------------------- 1. client send clientPsiInit -----------------------";
+    ClientPSIInit client_psi_init(psi_ctx->bin_id, psi_ctx->psi_type, psi_ctx->self_num);
+    verticalServer.Send(client_psi_init);
+    MS_LOG(INFO) << "-------------------------- 4. client recv serverPsiInit -----------------------";
+    ServerPSIInit server_psi_init_recv;
+    verticalServer.Receive(&server_psi_init_recv);
+    psi_ctx->SetRole(server_psi_init_recv.self_role());
+    psi_ctx->peer_num = server_psi_init_recv.self_size();
+  } else if (COM_role == "server") {
+    MS_LOG(INFO) << "-------------------------- 2. server recv clientPsiInit -----------------------";
+    ClientPSIInit client_psi_init_recv;
+    verticalServer.Receive(&client_psi_init_recv);
+    if (client_psi_init_recv.bin_id() != psi_ctx->bin_id) {
+      MS_LOG(ERROR) << "The bin_id is not same, please check bin_id: " << client_psi_init_recv.bin_id();
+      return false;
+    }
+    if (psi_ctx->psi_type != client_psi_init_recv.psi_type()) {
+      MS_LOG(WARNING) << "Context psi_type is not same! use " << client_psi_init_recv.psi_type();
+      psi_ctx->psi_type = client_psi_init_recv.psi_type();
+    }
+    psi_ctx->SetRole(client_psi_init_recv.self_size());
+    MS_LOG(INFO) << "-------------------------- 3. server send serverPsiInit -----------------------";
+    ServerPSIInit server_psi_init(psi_ctx->bin_id, psi_ctx->self_num, psi_ctx->role);
+    verticalServer.Send(server_psi_init);
+  } else {
+    MS_LOG(ERROR) << "Unknown communication role, wrong input role is " << COM_role;
+    return false;
+  }
+
+  if (!psi_ctx->CheckPsiCtxOK()) {
+    MS_LOG(ERROR) << "Set PSI CTX ERROR!";
+    return false;
+  }
+  MS_LOG(INFO) << "Set PSI_CTX over, start computing...";
+  return true;
+}
+}  // namespace
 
 void FindWrong(const PsiCtx &psi_ctx, const std::vector<std::string> &align_result, std::vector<std::string> *wrong_vct,
                std::vector<std::string> *fix_vct) {
@@ -91,15 +232,21 @@ void FindWrong(const PsiCtx &psi_ctx, const std::vector<std::string> &align_resu
   time_t time_end;
   time(&time_start);
 
+  // Ids are compared by the first 16 bytes of their SHA256 digests, which collide with a negligible probability.
+  const std::vector<std::string> *alice_hash_vct = &psi_ctx.input_hash_vct;
+  std::vector<std::string> hash_vct;
+  if (psi_ctx.input_hash_vct.size() != psi_ctx.self_num) {
+    std::vector<std::string> alice_vct(psi_ctx.input_vct.begin(), psi_ctx.input_vct.begin() + psi_ctx.self_num);
+    hash_vct = HashInputs(alice_vct, psi_ctx.thread_num, psi_ctx.chunk_size);
+    alice_hash_vct = &hash_vct;
+  }
+  DigestHashSet<LENGTH_16> alice_set(*alice_hash_vct, psi_ctx.thread_num, psi_ctx.chunk_size);
+
   std::vector<unsigned char> flag_vct(align_result.size(), 0);
   ParallelSync parallel_sync(psi_ctx.thread_num);
-  parallel_sync.parallel_for(0, psi_ctx.self_num, psi_ctx.chunk_size, [&](size_t beg, size_t end) {
+  parallel_sync.parallel_for(0, align_result.size(), psi_ctx.chunk_size, [&](size_t beg, size_t end) {
     for (size_t i = beg; i < end; i++) {
-      size_t index = distance(align_result.begin(),
-                              std::lower_bound(align_result.begin(), align_result.end(), psi_ctx.input_vct[i]));
-      if (index < align_result.size() && align_result[index] == psi_ctx.input_vct[i]) {
-        flag_vct[index] = 1;
-      }
+      flag_vct[i] = alice_set.Contains(HashInput(align_result[i])) ? 1 : 0;
     }
   });
   for (size_t i = 0; i < flag_vct.size(); i++) {
@@ -123,16 +270,28 @@ void DelWrong(std::vector<std::string> *align_results_vector, const std::vector<
   time_t time_start;
   time_t time_end;
   time(&time_start);
-  size_t del_num = 0;
+  // Each wrong id deletes its first occurrence, so count the ids and compact the kept results in a single pass.
+  std::unordered_map<std::string, size_t> wrong_counts;
+  wrong_counts.reserve(recv_wrong_vct.size());
   for (const auto &item : recv_wrong_vct) {
-    for (auto iter = align_results_vector->begin(); iter != align_results_vector->end(); iter++) {
-      if (*iter == item) {
-        align_results_vector->erase(iter);
-        del_num++;
-        break;
-      }
+    wrong_counts[item]++;
+  }
+  size_t del_num = 0;
+  size_t keep_num = 0;
+  for (size_t i = 0; i < align_results_vector->size(); i++) {
+    auto &item = (*align_results_vector)[i];
+    auto iter = del_num < recv_wrong_vct.size() ? wrong_counts.find(item) : wrong_counts.end();
+    if (iter != wrong_counts.end() && iter->second > 0) {
+      iter->second--;
+      del_num++;
+      continue;
+    }
+    if (keep_num != i) {
+      (*align_results_vector)[keep_num] = std::move(item);
     }
+    keep_num++;
   }
+  align_results_vector->resize(keep_num);
   if (del_num != recv_wrong_vct.size()) {
     MS_LOG(ERROR) << "Bob receives some id that Bob doesn't have.";
   }
@@ -219,8 +378,7 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx_alice, co
   MS_LOG(INFO) << "[outline] Alice start computing p1^a...";
   auto p_a_vct =
     psi_ctx_alice.ecc->HashToCurveAndMul(psi_ctx_alice.input_hash_vct, LENGTH_32, psi_ctx_alice.compare_length);
-  BloomFilter bf_alice(p_a_vct, psi_ctx_alice.neg_log_fp_rate);
-  MS_LOG(INFO) << "Bloom filter bit array size is: " << bf_alice.bitArrayByteLen() << "Bytes.";
+  auto bf_alice_data = BuildFilterData(p_a_vct, psi_ctx_alice);
 
   MS_LOG(INFO) << "Alice start decompress and compute p2^b^a ";
   //  -------------------------- 2. alice recv bob_p_b -----------------------
@@ -230,7 +388,7 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx_alice, co
     psi_ctx_alice.ecc->DcpsAndMul(bob_p_b_recv.p_b_vct(), psi_ctx_alice.compress_length, psi_ctx_alice.compress_length);
 
   //  -------------------------- 3. alice send AlicePbaAndBFProto -----------------------
-  AlicePbaAndBF alice_p_b_a_bf(psi_ctx_alice.bin_id, p_b_a_vct, bf_alice.GetData());
+  AlicePbaAndBF alice_p_b_a_bf(psi_ctx_alice.bin_id, p_b_a_vct, bf_alice_data);
   Send(alice_p_b_a_bf);
 
   // bob
@@ -241,8 +399,7 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx_alice, co
   auto p_b_a_bI_vct =
     psi_ctx_bob.ecc->DcpsAndInverseMul(alice_p_b_a_bf_recv.p_b_a_vct(), LENGTH_32, psi_ctx_bob.compare_length);
 
-  BloomFilter bf_alice_recv(alice_p_b_a_bf_recv.bf_alice(), psi_ctx_bob.peer_num, psi_ctx_bob.neg_log_fp_rate);
-  auto align_results_vector = Align(p_b_a_bI_vct, bf_alice_recv, psi_ctx_bob);
+  auto align_results_vector = AlignWithFilterData(p_b_a_bI_vct, alice_p_b_a_bf_recv.bf_alice(), psi_ctx_bob);
   MS_LOG(INFO) << "Number of false positive cases: "
                << static_cast<int>(align_results_vector.size() - psi_ctx_bob.input_vct.size() / 2);
 
@@ -363,7 +520,7 @@ std::vector<std::string> RunPSIDemo(const std::vector<std::string> &alice_input,
     MS_LOG(WARNING) << "Context role set ERROR, please check!";
   }
   MS_LOG(INFO) << "SET PSI_CTX over";
-  if (psi_ctx_alice.psi_type == "filter_ecdh") {
+  if (psi_ctx_alice.psi_type == "filter_ecdh" || psi_ctx_alice.psi_type == "blocked_filter_ecdh") {
     ret = RunInverseFilterEcdhPsi(psi_ctx_alice, psi_ctx_bob);
   } else {
     MS_LOG(INFO) << "The psi protocol is not supported currently.";
@@ -371,13 +528,17 @@ std::vector<std::string> RunPSIDemo(const std::vector<std::string> &alice_input,
   return ret;
 }
 
-std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx) {
+// p_k_vct is p^k of the inputs compressed to LENGTH_32 bytes if it is computed in advance, otherwise it is empty.
+std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx, std::vector<std::string> p_k_vct) {
   std::vector<std::string> align_results_vector;
   auto &verticalServer = VerticalServer::GetInstance();
   if (psi_ctx.role == "alice") {
     MS_LOG(INFO) << "[outline] Alice start computing p1^a...";
-    auto p_a_vct = psi_ctx.ecc->HashToCurveAndMul(psi_ctx.input_hash_vct, psi_ctx.compress_length, LENGTH_32);
-    BloomFilter bf_alice(p_a_vct, psi_ctx.neg_log_fp_rate);
+    auto p_a_vct = std::move(p_k_vct);
+    if (p_a_vct.empty()) {
+      p_a_vct = psi_ctx.ecc->HashToCurveAndMul(psi_ctx.input_hash_vct, psi_ctx.compress_length, LENGTH_32);
+    }
+    auto bf_alice_data = BuildFilterData(p_a_vct, psi_ctx);
 
     MS_LOG(INFO) << "----------------------- 2. alice recv bob_p_b -----------------------";
     BobPb bob_p_b_recv;
@@ -386,7 +547,7 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx) {
     auto p_b_a_vct = psi_ctx.ecc->DcpsAndMul(bob_p_b_recv.p_b_vct(), psi_ctx.compress_length, psi_ctx.compress_length);
 
     MS_LOG(INFO) << " -------------------------- 3. alice send AlicePbaAndBFProto ------------------------";
-    AlicePbaAndBF alice_p_b_a_bf(psi_ctx.bin_id, p_b_a_vct, bf_alice.GetData());
+    AlicePbaAndBF alice_p_b_a_bf(psi_ctx.bin_id, std::move(p_b_a_vct), std::move(bf_alice_data));
     verticalServer.Send(alice_p_b_a_bf);
 
     MS_LOG(INFO) << "-------------------------- 6. alice recv align -----------------------";
@@ -397,15 +558,19 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx) {
     FindWrong(psi_ctx, bob_align_result_recv.align_result(), &wrong_vct, &fix_vct);
 
     MS_LOG(INFO) << "-------------------------- 7. alice send wrong_id -----------------------";
-    AliceCheck alice_check(psi_ctx.bin_id, wrong_vct.size(), wrong_vct);
+    size_t wrong_num = wrong_vct.size();
+    AliceCheck alice_check(psi_ctx.bin_id, wrong_num, std::move(wrong_vct));
     verticalServer.Send(alice_check);
     return fix_vct;
   } else {
     MS_LOG(INFO) << "[outline] Bob start computing p2^b...";
-    auto p_b_vct =
-      psi_ctx.ecc->HashToCurveAndMul(psi_ctx.input_hash_vct, psi_ctx.compress_length, psi_ctx.compress_length);
+    auto p_b_vct = std::move(p_k_vct);
+    if (p_b_vct.empty()) {
+      p_b_vct =
+        psi_ctx.ecc->HashToCurveAndMul(psi_ctx.input_hash_vct, psi_ctx.compress_length, psi_ctx.compress_length);
+    }
     MS_LOG(INFO) << "-------------------------- 1. bob send bobPb -----------------------";
-    BobPb bob_p_b(psi_ctx.bin_id, p_b_vct);
+    BobPb bob_p_b(psi_ctx.bin_id, std::move(p_b_vct));
     verticalServer.Send(bob_p_b);
 
     MS_LOG(INFO) << "-------------------------- 4. bob recv alice_p_b_a_bf -----------------------";
@@ -414,8 +579,7 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx) {
     MS_LOG(INFO) << "Bob start decompress and compute p2^b^a^(b^-1) --------------------------";
     auto p_b_a_bI_vct =
       psi_ctx.ecc->DcpsAndInverseMul(alice_p_b_a_bf_recv.p_b_a_vct(), psi_ctx.compress_length, LENGTH_32);
-    BloomFilter bf_alice_recv(alice_p_b_a_bf_recv.bf_alice(), psi_ctx.peer_num, psi_ctx.neg_log_fp_rate);
-    align_results_vector = Align(p_b_a_bI_vct, bf_alice_recv, psi_ctx);
+    align_results_vector = AlignWithFilterData(p_b_a_bI_vct, alice_p_b_a_bf_recv.bf_alice(), psi_ctx);
 
     time_t time_start;
     time_t time_end;
@@ -438,61 +602,99 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx) {
 
 std::vector<std::string> RunPSI(const std::vector<std::string> &input_vct, const std::string &COM_role,
                                 const std::string &http_server_address, const std::string &remote_server_address,
-                                size_t thread_num, size_t bin_id) {
+                                size_t thread_num, size_t bin_id, const std::string &psi_type) {
   std::vector<std::string> ret;
-  VFLContext::instance()->set_http_server_address(http_server_address);
-  VFLContext::instance()->set_remote_server_address(remote_server_address);
-  auto &verticalServer = VerticalServer::GetInstance();
-  verticalServer.StartVerticalCommunicator();
+  StartVerticalCommunicator(http_server_address, remote_server_address);
 
   MS_LOG(INFO) << "Start RunPSICommunicateTest, init psi context...";
   PsiCtx psi_ctx;
   psi_ctx.bin_id = bin_id;
   psi_ctx.thread_num = thread_num;
+  psi_ctx.psi_type = psi_type;
   psi_ctx.input_vct = input_vct;
   psi_ctx.self_num = psi_ctx.input_vct.size();
   psi_ctx.ecc = std::make_unique<ECC>(psi_ctx.curve_name, psi_ctx.thread_num, psi_ctx.chunk_size);
   MS_LOG(INFO) << "Start hash input...";
   psi_ctx.input_hash_vct = HashInputs(psi_ctx.input_vct, psi_ctx.thread_num, psi_ctx.chunk_size);
 
-  if (COM_role == "client") {
-    MS_LOG(INFO) << "-------------------------- 1. client send clientPsiInit -----------------------";
-    ClientPSIInit client_psi_init(psi_ctx.bin_id, psi_ctx.psi_type, psi_ctx.self_num);
-    verticalServer.Send(client_psi_init);
-    MS_LOG(INFO) << "-------------------------- 4. client recv serverPsiInit -----------------------";
-    ServerPSIInit server_psi_init_recv;
-    verticalServer.Receive(&server_psi_init_recv);
-    psi_ctx.SetRole(server_psi_init_recv.self_role());
-  } else if (COM_role == "server") {
-    MS_LOG(INFO) << "-------------------------- 2. server recv clientPsiInit -----------------------";
-    ClientPSIInit client_psi_init_recv;
-    verticalServer.Receive(&client_psi_init_recv);
-    if (client_psi_init_recv.bin_id() != psi_ctx.bin_id) {
-      MS_LOG(ERROR) << "The bin_id is not same, please check bin_id: " << client_psi_init_recv.bin_id();
-      return ret;
-    }
-    psi_ctx.SetRole(client_psi_init_recv.self_size());
-    MS_LOG(INFO) << "-------------------------- 3. server send serverPsiInit -----------------------";
-    ServerPSIInit server_psi_init(psi_ctx.bin_id, psi_ctx.self_num, psi_ctx.role);
-    verticalServer.Send(server_psi_init);
-  } else {
-    MS_LOG(ERROR) << "Unknown communication role, wrong input role is " << COM_role;
-    return ret;
-  }
-
-  if (!psi_ctx.CheckPsiCtxOK()) {
-    MS_LOG(ERROR) << "Set PSI CTX ERROR!";
+  if (!InitPsiCtx(COM_role, &psi_ctx)) {
     return ret;
-  } else {
-    MS_LOG(INFO) << "Set PSI_CTX over, start computing...";
   }
-  if (psi_ctx.psi_type == "filter_ecdh") {
-    ret = RunInverseFilterEcdhPsi(psi_ctx);
+  if (psi_ctx.psi_type == "filter_ecdh" || psi_ctx.psi_type == "blocked_filter_ecdh") {
+    ret = RunInverseFilterEcdhPsi(psi_ctx, std::vector<std::string>());
   } else {
     MS_LOG(INFO) << "The psi protocol is not supported currently.";
   }
   return ret;
 }
+
+size_t RunStreamingPSI(const std::string &input_path, const std::string &output_path, const std::string &COM_role,
+                       const std::string &http_server_address, const std::string &remote_server_address,
+                       size_t thread_num, size_t bin_num, const std::string &psi_type) {
+  size_t intersection_num = 0;
+  MappedIdFile input_file;
+  if (!input_file.Open(input_path, bin_num)) {
+    MS_LOG(ERROR) << "Failed to start streaming PSI, input file is " << input_path << ", bin num is " << bin_num;
+    return intersection_num;
+  }
+  std::ofstream output_file(output_path, std::ios::out);
+  if (!output_file.is_open()) {
+    MS_LOG(ERROR) << "Failed to open output file " << output_path;
+    return intersection_num;
+  }
+  StartVerticalCommunicator(http_server_address, remote_server_address);
+
+  PsiCtx default_ctx;
+  auto ecc = std::make_shared<ECC>(default_ctx.curve_name, thread_num, default_ctx.chunk_size);
+  // Hashing the ids to the curve doesn't depend on the role or the peer, so the next bin is computed by another thread
+  // while the current bin is exchanged with the peer. At most two bins are in memory.
+  struct PsiBin {
+    std::vector<std::string> input_vct;
+    std::vector<std::string> input_hash_vct;
+    std::vector<std::string> p_k_vct;
+  };
+  auto prepare_bin = [&input_file, &ecc, thread_num, chunk_size = default_ctx.chunk_size](size_t bin_id) {
+    PsiBin bin;
+    bin.input_vct = input_file.ReadBin(bin_id);
+    bin.input_hash_vct = HashInputs(bin.input_vct, thread_num, chunk_size);
+    bin.p_k_vct = ecc->HashToCurveAndMul(bin.input_hash_vct, LENGTH_32, LENGTH_32);
+    return bin;
+  };
+  auto next_bin = std::async(std::launch::async, prepare_bin, 0);
+  for (size_t bin_id = 0; bin_id < bin_num; bin_id++) {
+    PsiBin bin = next_bin.get();
+    if (bin_id + 1 < bin_num) {
+      next_bin = std::async(std::launch::async, prepare_bin, bin_id + 1);
+    }
+    MS_LOG(INFO) << "Start streaming PSI of bin " << bin_id << ", input size is " << bin.input_vct.size();
+    PsiCtx psi_ctx;
+    psi_ctx.bin_id = bin_id;
+    psi_ctx.thread_num = thread_num;
+    psi_ctx.psi_type = psi_type;
+    psi_ctx.ecc = ecc;
+    psi_ctx.input_vct = std::move(bin.input_vct);
+    psi_ctx.input_hash_vct = std::move(bin.input_hash_vct);
+    psi_ctx.self_num = psi_ctx.input_vct.size();
+    if (!InitPsiCtx(COM_role, &psi_ctx)) {
+      return intersection_num;
+    }
+    // Both parties know both sizes after InitPsiCtx, so they skip the same bins.
+    if (psi_ctx.self_num == 0 || psi_ctx.peer_num == 0) {
+      MS_LOG(INFO) << "Skip bin " << bin_id << ", self size is " << psi_ctx.self_num << ", peer size is "
+                   << psi_ctx.peer_num;
+      continue;
+    }
+    auto result = RunInverseFilterEcdhPsi(psi_ctx, std::move(bin.p_k_vct));
+    for (const auto &item : result) {
+      output_file << item << '\n';
+    }
+    intersection_num += result.size();
+    MS_LOG(INFO) << "Streaming PSI of bin " << bin_id << " is over, intersection size is " << result.size();
+  }
+  output_file.close();
+  MS_LOG(INFO) << "Streaming PSI is over, intersection size is " << intersection_num;
+  return intersection_num;
+}
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
@@ -23,6 +23,7 @@
 
 #include "armour/base_crypto/ecc.h"
 #include "armour/base_crypto/bloom_filter.h"
+#include "armour/base_crypto/blocked_bloom_filter.h"
 
 #include "common/utils/visible.h"
 
@@ -82,6 +83,10 @@ struct PsiCtx {
       ret = false;
       MS_LOG(INFO) << "If use filter ecdh, compare length must be 32, but get " << compare_length << ".";
     }
+    if (psi_type != "filter_ecdh" && psi_type != "blocked_filter_ecdh") {
+      ret = false;
+      MS_LOG(INFO) << "Psi_type can only be set to filter_ecdh or blocked_filter_ecdh, but get " << psi_type << ".";
+    }
     if (role == peer_role) {
       ret = false;
       MS_LOG(INFO) << "Server and Client hava the same role: " << role << ".";
@@ -124,7 +129,16 @@ std::vector<std::string> RunInverseFilterEcdhPsi(const PsiCtx &psi_ctx_alice, co
 
 MS_EXPORT std::vector<std::string> RunPSI(const std::vector<std::string> &input_vct, const std::string &COM_role,
                                           const std::string &http_server_address,
-                                          const std::string &remote_server_address, size_t thread_num, size_t bin_id);
+                                          const std::string &remote_server_address, size_t thread_num, size_t bin_id,
+                                          const std::string &psi_type = "filter_ecdh");
+
+// PSI of the ids in input_path, one id per line, which are partitioned into bin_num bins by the hash of the id and
+// intersected bin by bin with the peer, so the memory used depends on the size of a bin instead of the whole dataset.
+// The intersection is written to output_path, one id per line, and its size is returned.
+MS_EXPORT size_t RunStreamingPSI(const std::string &input_path, const std::string &output_path,
+                                 const std::string &COM_role, const std::string &http_server_address,
+                                 const std::string &remote_server_address, size_t thread_num, size_t bin_num,
+                                 const std::string &psi_type = "filter_ecdh");
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
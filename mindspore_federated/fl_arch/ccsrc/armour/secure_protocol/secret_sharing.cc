@@ -15,6 +15,8 @@
  */
 
 #include "armour/secure_protocol/secret_sharing.h"
+#include <algorithm>
+#include <map>
 
 namespace mindspore {
 namespace fl {
@@ -247,6 +249,147 @@ int SecretSharing::Combine(size_t k, const std::vector<Share *> &shares, uint8_t
   FreeBNVector(nums);
   return ret;
 }
+
+bool SecretSharing::GetLagrangeCoefficients(const std::vector<unsigned int> &indices,
+                                            std::vector<BIGNUM *> *coefficients, BN_CTX *ctx) {
+  size_t k = indices.size();
+  coefficients->assign(k, nullptr);
+  std::vector<BIGNUM *> denses(k, nullptr);
+  std::vector<BIGNUM *> prefixes(k, nullptr);  // prefixes[j] = denses[0] * ... * denses[j]
+  BIGNUM *inverse = BN_new();
+  bool ret = inverse != nullptr;
+  // The indices are small, so the products are computed by word multiplications and reduced once in a while.
+  const int reduce_bits = BN_num_bits(this->bn_prim_) * 2;
+  for (size_t j = 0; j < k && ret; j++) {
+    BIGNUM *nums_j = BN_new();
+    (*coefficients)[j] = nums_j;
+    denses[j] = BN_new();
+    prefixes[j] = BN_new();
+    if (nums_j == nullptr || denses[j] == nullptr || prefixes[j] == nullptr || BN_one(nums_j) != 1 ||
+        BN_one(denses[j]) != 1) {
+      MS_LOG(ERROR) << "new bn object failed";
+      ret = false;
+      break;
+    }
+    // nums_j = prod(x_m), denses_j = prod(x_m - x_j), m != j
+    bool negative = false;
+    for (size_t m = 0; m < k && ret; m++) {
+      if (m == j) {
+        continue;
+      }
+      if (indices[m] == indices[j]) {
+        MS_LOG(ERROR) << "duplicate share index " << indices[j];
+        ret = false;
+        break;
+      }
+      negative = negative != (indices[m] < indices[j]);
+      BN_ULONG diff = indices[m] > indices[j] ? indices[m] - indices[j] : indices[j] - indices[m];
+      ret = BN_mul_word(nums_j, indices[m]) == 1 && BN_mul_word(denses[j], diff) == 1;
+      if (ret && BN_num_bits(nums_j) > reduce_bits) {
+        ret = BN_nnmod(nums_j, nums_j, this->bn_prim_, ctx) == 1;
+      }
+      if (ret && BN_num_bits(denses[j]) > reduce_bits) {
+        ret = BN_nnmod(denses[j], denses[j], this->bn_prim_, ctx) == 1;
+      }
+    }
+    ret = ret && BN_nnmod(nums_j, nums_j, this->bn_prim_, ctx) == 1 &&
+          BN_nnmod(denses[j], denses[j], this->bn_prim_, ctx) == 1;
+    if (ret && negative) {
+      ret = BN_sub(denses[j], this->bn_prim_, denses[j]) == 1;
+    }
+    if (ret) {
+      ret = j == 0 ? BN_copy(prefixes[j], denses[j]) != nullptr
+                   : BN_mod_mul(prefixes[j], prefixes[j - 1], denses[j], this->bn_prim_, ctx) == 1;
+    }
+  }
+  // Montgomery's trick: invert the product of all the denses once, and get the inverse of each dense from it.
+  if (ret && k > 0 && BN_mod_inverse(inverse, prefixes[k - 1], this->bn_prim_, ctx) == nullptr) {
+    MS_LOG(ERROR) << "compute the inverse of lagrange denses failed";
+    ret = false;
+  }
+  for (size_t j = k; j > 0 && ret; j--) {
+    // inverse = 1 / (denses[0] * ... * denses[j - 1]), the inverse of denses[j - 1] is put into prefixes[j - 1].
+    BIGNUM *inverse_j = prefixes[j - 1];
+    ret = (j == 1 ? BN_copy(inverse_j, inverse) != nullptr
+                  : BN_mod_mul(inverse_j, inverse, prefixes[j - 2], this->bn_prim_, ctx) == 1) &&
+          BN_mod_mul(inverse, inverse, denses[j - 1], this->bn_prim_, ctx) == 1 &&
+          BN_mod_mul((*coefficients)[j - 1], (*coefficients)[j - 1], inverse_j, this->bn_prim_, ctx) == 1;
+  }
+  ReleaseNum(inverse);
+  FreeBNVector(denses);
+  FreeBNVector(prefixes);
+  return ret;
+}
+
+int SecretSharing::BatchCombine(size_t k, const std::vector<std::vector<ShareView>> &share_groups,
+                                std::vector<std::vector<uint8_t>> *secrets) {
+  if (secrets == nullptr || k < 1 || this->bn_prim_ == nullptr) {
+    return -1;
+  }
+  BN_CTX *ctx = BN_CTX_new();
+  BIGNUM *sum = BN_new();
+  BIGNUM *y = BN_new();
+  BIGNUM *term = BN_new();
+  int ret = 0;
+  if (ctx == nullptr || sum == nullptr || y == nullptr || term == nullptr) {
+    MS_LOG(ERROR) << "new bn object failed";
+    ret = -1;
+  }
+  // Lagrange coefficients of each set of sorted share indices.
+  std::map<std::vector<unsigned int>, std::vector<BIGNUM *>> coefficients_map;
+  std::vector<const ShareView *> shares(k);
+  std::vector<unsigned int> indices(k);
+  secrets->assign(share_groups.size(), {});
+  for (size_t i = 0; i < share_groups.size() && ret == 0; i++) {
+    auto &group = share_groups[i];
+    if (group.size() < k) {
+      MS_LOG(ERROR) << "share group " << i << " has " << group.size() << " shares, less than " << k;
+      ret = -1;
+      break;
+    }
+    for (size_t j = 0; j < k; j++) {
+      shares[j] = &group[j];
+    }
+    std::sort(shares.begin(), shares.end(), [](const ShareView *a, const ShareView *b) { return a->index < b->index; });
+    for (size_t j = 0; j < k; j++) {
+      indices[j] = shares[j]->index;
+    }
+    auto iter = coefficients_map.find(indices);
+    if (iter == coefficients_map.end()) {
+      std::vector<BIGNUM *> coefficients;
+      if (!GetLagrangeCoefficients(indices, &coefficients, ctx)) {
+        FreeBNVector(coefficients);
+        ret = -1;
+        break;
+      }
+      iter = coefficients_map.emplace(indices, std::move(coefficients)).first;
+    }
+    // secret = sum(coefficients_j * y_j) mod prime, reduced once after all the products are added.
+    BN_zero(sum);
+    for (size_t j = 0; j < k && ret == 0; j++) {
+      if (BN_bin2bn(shares[j]->data, SizeToInt(shares[j]->len), y) == nullptr ||
+          BN_mul(term, iter->second[j], y, ctx) != 1 || BN_add(sum, sum, term) != 1) {
+        ret = -1;
+      }
+    }
+    if (ret == 0 && BN_nnmod(sum, sum, this->bn_prim_, ctx) != 1) {
+      ret = -1;
+    }
+    if (ret == 0) {
+      auto &secret = (*secrets)[i];
+      secret.resize(IntToSize(BN_num_bytes(sum)));
+      (void)BN_bn2bin(sum, secret.data());
+    }
+  }
+  for (auto &item : coefficients_map) {
+    FreeBNVector(item.second);
+  }
+  ReleaseNum(sum);
+  ReleaseNum(y);
+  ReleaseNum(term);
+  BN_CTX_free(ctx);
+  return ret;
+}
 }  // namespace armour
 }  // namespace fl
 }  // namespace mindspore
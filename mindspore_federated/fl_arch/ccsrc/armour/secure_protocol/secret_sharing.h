@@ -32,6 +32,13 @@ struct Share {
   ~Share();
 };
 
+// A share whose data is owned by the caller.
+struct ShareView {
+  unsigned int index;
+  const uint8_t *data;
+  size_t len;
+};
+
 void secure_zero(uint8_t *s, size_t);
 int GetPrime(BIGNUM *prim);
 
@@ -43,6 +50,12 @@ class SecretSharing {
   int Split(int n, const int k, const char *secret, size_t length, const std::vector<Share *> &shares);
   // reconstruct the secret from multiple shares
   int Combine(size_t k, const std::vector<Share *> &shares, uint8_t *secret, size_t *length);
+  // reconstruct the secrets of many share groups, (*secrets)[i] is the secret of the first k shares of
+  // share_groups[i], in the same big endian format as Combine. The Lagrange coefficients are computed once for each
+  // set of share indices, with one modular inversion for all of them, so the groups sharing the indices only cost a
+  // multiply-accumulate each.
+  int BatchCombine(size_t k, const std::vector<std::vector<ShareView>> &share_groups,
+                   std::vector<std::vector<uint8_t>> *secrets);
   int CheckShares(Share *share_i, BIGNUM *x_i, BIGNUM *y_i, BIGNUM *denses_i, BIGNUM *nums_i);
   int CheckSum(BIGNUM *sum) const;
   int LagrangeCal(BIGNUM *nums_j, BIGNUM *x_m, BIGNUM *x_j, BIGNUM *denses_j, BIGNUM *tmp, BN_CTX *ctx);
@@ -60,6 +73,9 @@ class SecretSharing {
   // convert secret sharing from Share type to BIGNUM type
   bool GetShare(BIGNUM *x, BIGNUM *share, Share *s_share);
   void FreeBNVector(std::vector<BIGNUM *> bns);
+  // Lagrange coefficients at x = 0 of the distinct share indices
+  bool GetLagrangeCoefficients(const std::vector<unsigned int> &indices, std::vector<BIGNUM *> *coefficients,
+                               BN_CTX *ctx);
 };
 }  // namespace armour
 }  // namespace fl
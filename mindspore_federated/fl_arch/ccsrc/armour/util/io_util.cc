@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
 #include <fstream>
 #include <cstring>
 #include <sstream>
@@ -22,6 +27,7 @@
 #include <string>
 #include <vector>
 #include <random>
+#include <utility>
 
 #include "armour/util/io_util.h"
 #include "armour/base_crypto/bloom_filter.h"
@@ -59,38 +65,30 @@ std::vector<std::string> ReadFileAndDeserialize(const std::string &csv_path, con
   MS_LOG(INFO) << "Start read";
   MS_LOG(INFO) << "Per item length is " << item_length;
 
-  std::string flatten_str;
-  flatten_str.reserve(input_num * item_length);
-  std::ifstream input(csv_path);
-  std::ostringstream tmp;
-  tmp << input.rdbuf();
-  flatten_str = tmp.str();
-  if (input_num * item_length != flatten_str.length()) {
-    MS_LOG(INFO) << "length error, read length is " << flatten_str.length() << ", but should be "
-                 << input_num * item_length;
+  // Read every item into its own string, without a copy of the whole file.
+  std::ifstream input(csv_path, std::ios::binary);
+  std::vector<std::string> ret(input_num, std::string(item_length, '\0'));
+  size_t read_length = 0;
+  for (auto &item : ret) {
+    (void)input.read(&item[0], static_cast<std::streamsize>(item_length));
+    read_length += static_cast<size_t>(input.gcount());
   }
-  std::vector<std::string> ret;
-  ret.reserve(input_num);
-  for (size_t i = 0; i < input_num; i++) {
-    ret.push_back(flatten_str.substr(i * item_length, item_length));
+  if (input_num * item_length != read_length || input.peek() != std::ifstream::traits_type::eof()) {
+    MS_LOG(INFO) << "length error, read length is " << read_length << ", but should be " << input_num * item_length;
   }
-
   return ret;
 }
 
 void FlattenAndWriteFile(const std::string &out_path, const std::vector<std::string> &in_data) {
   MS_LOG(INFO) << "Start write";
-  size_t input_num = in_data.size();
-  size_t item_length = in_data[0].length();
-  std::string ret;
-  ret.reserve(input_num * item_length);
-  for (size_t i = 0; i < input_num; i++) {
-    ret.append(in_data[i]);
-  }
   std::ofstream out_file;
-  out_file.open(out_path);
-  out_file << ret;
-  MS_LOG(INFO) << "Start write over, length is " << ret.length();
+  out_file.open(out_path, std::ios::binary);
+  size_t length = 0;
+  for (const auto &item : in_data) {
+    (void)out_file.write(item.data(), static_cast<std::streamsize>(item.size()));
+    length += item.size();
+  }
+  MS_LOG(INFO) << "Start write over, length is " << length;
 }
 
 BloomFilter ReadFileAndBuildFilter(const std::string &csv_path, const size_t &input_num, const int &neg_log_fp_rate) {
@@ -144,6 +142,89 @@ void GenDataSet() {
   }
 }
 
+MappedIdFile::~MappedIdFile() { Close(); }
+
+void MappedIdFile::Close() {
+  if (addr_ != nullptr) {
+    (void)munmap(addr_, size_);
+    addr_ = nullptr;
+  }
+  size_ = 0;
+  bin_num_ = 0;
+}
+
+bool MappedIdFile::Open(const std::string &csv_path, size_t bin_num) {
+  Close();
+  if (bin_num == 0) {
+    MS_LOG(ERROR) << "The bin num of input file " << csv_path << " should be positive";
+    return false;
+  }
+  int fd = open(csv_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    MS_LOG(ERROR) << "Failed to open input file " << csv_path << ", errno: " << errno;
+    return false;
+  }
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0) {
+    MS_LOG(ERROR) << "Failed to get the size of input file " << csv_path << ", errno: " << errno;
+    (void)close(fd);
+    return false;
+  }
+  // An empty file has no ids and can't be mapped.
+  if (file_stat.st_size == 0) {
+    (void)close(fd);
+    bin_num_ = bin_num;
+    return true;
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  (void)close(fd);
+  if (addr == MAP_FAILED) {
+    MS_LOG(ERROR) << "Failed to map input file " << csv_path << ", errno: " << errno;
+    return false;
+  }
+  // Every bin scans the file from the beginning to the end.
+  (void)madvise(addr, size, MADV_SEQUENTIAL);
+  addr_ = addr;
+  size_ = size;
+  bin_num_ = bin_num;
+  MS_LOG(INFO) << "Map input file " << csv_path << ", size is " << size_ << ", bin num is " << bin_num_;
+  return true;
+}
+
+std::vector<std::string> MappedIdFile::ReadBin(size_t bin_id) const {
+  std::vector<std::string> ret;
+  if (bin_id >= bin_num_) {
+    return ret;
+  }
+  auto data = reinterpret_cast<const char *>(addr_);
+  size_t line_begin = 0;
+  while (line_begin < size_) {
+    auto line_end_ptr = static_cast<const char *>(memchr(data + line_begin, '\n', size_ - line_begin));
+    size_t line_end = line_end_ptr == nullptr ? size_ : static_cast<size_t>(line_end_ptr - data);
+    size_t line_len = line_end - line_begin;
+    if (line_len > 0 && data[line_end - 1] == '\r') {
+      line_len--;
+    }
+    if (line_len > 0 && BinOf(data + line_begin, line_len, bin_num_) == bin_id) {
+      ret.emplace_back(data + line_begin, line_len);
+    }
+    line_begin = line_end + 1;
+  }
+  return ret;
+}
+
+size_t MappedIdFile::BinOf(const char *id, size_t len, size_t bin_num) {
+  // 64 bits FNV-1a.
+  constexpr uint64_t kFnvOffsetBasis = 0xCBF29CE484222325ULL;
+  constexpr uint64_t kFnvPrime = 0x100000001B3ULL;
+  uint64_t hash = kFnvOffsetBasis;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<uint8_t>(id[i])) * kFnvPrime;
+  }
+  return bin_num <= 1 ? 0 : static_cast<size_t>(hash % bin_num);
+}
+
 bool Send(const ClientPSIInit &client_psi_init) {
   std::shared_ptr<datajoin::ClientPSIInitProto> client_init_proto_ptr =
     std::make_shared<datajoin::ClientPSIInitProto>();
@@ -207,11 +288,11 @@ void Recv(BobPb *bob_p_b) {
   bob_p_b_proto.ParseFromArray(bin_array.data(), static_cast<int>(bin_array.size()));
   bob_p_b->set_bin_id(bob_p_b_proto.bin_id());
   std::vector<std::string> p_b_vct;
-  int p_b_vct_size = bob_p_b_proto.p_b_vct_size();
-  for (int i = 0; i < p_b_vct_size; i++) {
-    p_b_vct.push_back(bob_p_b_proto.p_b_vct(i));
+  p_b_vct.reserve(bob_p_b_proto.p_b_vct_size());
+  for (auto &item : *bob_p_b_proto.mutable_p_b_vct()) {
+    p_b_vct.push_back(std::move(item));
   }
-  bob_p_b->set_p_b_vct(p_b_vct);
+  bob_p_b->set_p_b_vct(std::move(p_b_vct));
   MS_LOG(INFO) << "bob_p_b, bin_id is " << bob_p_b->bin_id();
   MS_LOG(INFO) << "bob_p_b size is " << bob_p_b->p_b_vct().size();
 }
@@ -233,12 +314,12 @@ void Recv(AlicePbaAndBF *alice_p_b_a_bf) {
   alice_p_b_a_bf_proto.ParseFromArray(bin_array.data(), static_cast<int>(bin_array.size()));
   alice_p_b_a_bf->set_bin_id(alice_p_b_a_bf_proto.bin_id());
   std::vector<std::string> p_b_vct;
-  int p_b_a_vct_size = alice_p_b_a_bf_proto.p_b_a_vct_size();
-  for (int i = 0; i < p_b_a_vct_size; i++) {
-    p_b_vct.push_back(alice_p_b_a_bf_proto.p_b_a_vct(i));
+  p_b_vct.reserve(alice_p_b_a_bf_proto.p_b_a_vct_size());
+  for (auto &item : *alice_p_b_a_bf_proto.mutable_p_b_a_vct()) {
+    p_b_vct.push_back(std::move(item));
   }
-  alice_p_b_a_bf->set_p_b_a_vct(p_b_vct);
-  alice_p_b_a_bf->set_bf_alice(alice_p_b_a_bf_proto.bf_alice());
+  alice_p_b_a_bf->set_p_b_a_vct(std::move(p_b_vct));
+  alice_p_b_a_bf->set_bf_alice(std::move(*alice_p_b_a_bf_proto.mutable_bf_alice()));
   MS_LOG(INFO) << "alice_pba_bf, bin_id is " << alice_p_b_a_bf->bin_id();
   MS_LOG(INFO) << "alice_p_b_a size is " << alice_p_b_a_bf->p_b_a_vct().size();
   MS_LOG(INFO) << "bf_alice byte length is " << alice_p_b_a_bf->bf_alice().size();
@@ -261,11 +342,11 @@ void Recv(BobAlignResult *bob_align_result) {
   bob_align_result_proto.ParseFromArray(bin_array.data(), static_cast<int>(bin_array.size()));
   bob_align_result->set_bin_id(bob_align_result_proto.bin_id());
   std::vector<std::string> align_result;
-  int align_result_size = bob_align_result_proto.align_result_size();
-  for (int i = 0; i < align_result_size; i++) {
-    align_result.push_back(bob_align_result_proto.align_result(i));
+  align_result.reserve(bob_align_result_proto.align_result_size());
+  for (auto &item : *bob_align_result_proto.mutable_align_result()) {
+    align_result.push_back(std::move(item));
   }
-  bob_align_result->set_align_resul(align_result);
+  bob_align_result->set_align_resul(std::move(align_result));
   MS_LOG(INFO) << "bob_align_result, bin_id is " << bob_align_result->bin_id();
   MS_LOG(INFO) << "bob_align_result size is " << bob_align_result->align_result().size();
 }
@@ -287,11 +368,11 @@ void Recv(AliceCheck *alice_check) {
   alice_check->set_bin_id(alice_check_proto.bin_id());
   alice_check->set_wrong_num(alice_check_proto.wrong_num());
   std::vector<std::string> wrong_id_vct;
-  int wrong_id_size = alice_check_proto.wrong_id_size();
-  for (int i = 0; i < wrong_id_size; i++) {
-    wrong_id_vct.push_back(alice_check_proto.wrong_id(i));
+  wrong_id_vct.reserve(alice_check_proto.wrong_id_size());
+  for (auto &item : *alice_check_proto.mutable_wrong_id()) {
+    wrong_id_vct.push_back(std::move(item));
   }
-  alice_check->set_wrong_id(wrong_id_vct);
+  alice_check->set_wrong_id(std::move(wrong_id_vct));
   MS_LOG(INFO) << "alice_check, bin_id is " << alice_check->bin_id();
   MS_LOG(INFO) << "alice_check, wrong_id size is " << alice_check->wrong_id().size();
 }
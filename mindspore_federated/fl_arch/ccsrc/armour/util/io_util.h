@@ -23,6 +23,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "armour/base_crypto/bloom_filter.h"
@@ -51,18 +52,45 @@ std::vector<std::string> CreateFakeDataset(size_t begin, size_t size);
 
 void GenDataSet();
 
+// Input file of ids mapped into memory, one id per line. A trailing '\r' is stripped and blank lines are skipped. Ids
+// are put into bins by a hash of the id which doesn't depend on the host, so both parties put the same id into the same
+// bin. Reading a bin scans the whole mapping and copies only the ids of that bin, so nothing but the bin being read is
+// held in memory, whatever the size of the file.
+class MappedIdFile {
+ public:
+  MappedIdFile() = default;
+  ~MappedIdFile();
+  MappedIdFile(const MappedIdFile &) = delete;
+  MappedIdFile &operator=(const MappedIdFile &) = delete;
+
+  bool Open(const std::string &csv_path, size_t bin_num);
+  void Close();
+
+  size_t bin_num() const { return bin_num_; }
+
+  // Ids of the bin in the order of the file, bin_id is in [0, bin_num).
+  std::vector<std::string> ReadBin(size_t bin_id) const;
+
+  static size_t BinOf(const char *id, size_t len, size_t bin_num);
+
+ private:
+  void *addr_ = nullptr;
+  size_t size_ = 0;
+  size_t bin_num_ = 0;
+};
+
 struct ClientPSIInit {
  public:
   ~ClientPSIInit() = default;
   ClientPSIInit() = default;
-  ClientPSIInit(const size_t &bin_id, const std::string &psi_type, const size_t &self_size)
-      : bin_id_(bin_id), psi_type_(psi_type), self_size_(self_size) {}
+  ClientPSIInit(const size_t &bin_id, std::string psi_type, const size_t &self_size)
+      : bin_id_(bin_id), psi_type_(std::move(psi_type)), self_size_(self_size) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
 
-  void set_psi_type(const std::string &psi_type_string) { psi_type_ = psi_type_string; }
-  std::string psi_type() const { return psi_type_; }
+  void set_psi_type(std::string psi_type_string) { psi_type_ = std::move(psi_type_string); }
+  const std::string &psi_type() const { return psi_type_; }
 
   void set_self_size(const size_t &self_size_input) { self_size_ = self_size_input; }
   size_t self_size() const { return self_size_; }
@@ -81,8 +109,8 @@ struct ServerPSIInit {
  public:
   ~ServerPSIInit() = default;
   ServerPSIInit() = default;
-  ServerPSIInit(const size_t &bin_id, const size_t &self_size, const std::string &self_role)
-      : bin_id_(bin_id), self_size_(self_size), self_role_(self_role) {}
+  ServerPSIInit(const size_t &bin_id, const size_t &self_size, std::string self_role)
+      : bin_id_(bin_id), self_size_(self_size), self_role_(std::move(self_role)) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
@@ -90,8 +118,8 @@ struct ServerPSIInit {
   void set_self_size(const size_t &self_size_input) { self_size_ = self_size_input; }
   size_t self_size() const { return self_size_; }
 
-  void set_self_role(const std::string &self_role_string) { self_role_ = self_role_string; }
-  std::string self_role() const { return self_role_; }
+  void set_self_role(std::string self_role_string) { self_role_ = std::move(self_role_string); }
+  const std::string &self_role() const { return self_role_; }
 
  private:
   size_t bin_id_ = 0;
@@ -107,13 +135,13 @@ struct BobPb {
  public:
   ~BobPb() = default;
   BobPb() = default;
-  BobPb(const size_t &bin_id, const std::vector<std::string> &p_b_vct) : bin_id_(bin_id) { p_b_vct_ = p_b_vct; }
+  BobPb(const size_t &bin_id, std::vector<std::string> p_b_vct) : bin_id_(bin_id), p_b_vct_(std::move(p_b_vct)) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
 
-  void set_p_b_vct(const std::vector<std::string> &p_b_vct) { p_b_vct_ = p_b_vct; }
-  std::vector<std::string> p_b_vct() const { return p_b_vct_; }
+  void set_p_b_vct(std::vector<std::string> p_b_vct) { p_b_vct_ = std::move(p_b_vct); }
+  const std::vector<std::string> &p_b_vct() const { return p_b_vct_; }
 
  private:
   size_t bin_id_ = 0;
@@ -128,19 +156,17 @@ struct AlicePbaAndBF {
  public:
   ~AlicePbaAndBF() = default;
   AlicePbaAndBF() = default;
-  AlicePbaAndBF(const size_t &bin_id, const std::vector<std::string> &p_b_a_vct, const std::string &bf_alice)
-      : bin_id_(bin_id), bf_alice_(bf_alice) {
-    p_b_a_vct_ = p_b_a_vct;
-  }
+  AlicePbaAndBF(const size_t &bin_id, std::vector<std::string> p_b_a_vct, std::string bf_alice)
+      : bin_id_(bin_id), p_b_a_vct_(std::move(p_b_a_vct)), bf_alice_(std::move(bf_alice)) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
 
-  void set_p_b_a_vct(const std::vector<std::string> &p_b_a_vct) { p_b_a_vct_ = p_b_a_vct; }
-  std::vector<std::string> p_b_a_vct() const { return p_b_a_vct_; }
+  void set_p_b_a_vct(std::vector<std::string> p_b_a_vct) { p_b_a_vct_ = std::move(p_b_a_vct); }
+  const std::vector<std::string> &p_b_a_vct() const { return p_b_a_vct_; }
 
-  void set_bf_alice(const std::string &bf_alice) { bf_alice_ = bf_alice; }
-  std::string bf_alice() const { return bf_alice_; }
+  void set_bf_alice(std::string bf_alice) { bf_alice_ = std::move(bf_alice); }
+  const std::string &bf_alice() const { return bf_alice_; }
 
  private:
   size_t bin_id_ = 0;
@@ -156,15 +182,14 @@ struct BobAlignResult {
  public:
   ~BobAlignResult() = default;
   BobAlignResult() = default;
-  BobAlignResult(const size_t &bin_id, const std::vector<std::string> &align_result) : bin_id_(bin_id) {
-    align_result_ = align_result;
-  }
+  BobAlignResult(const size_t &bin_id, std::vector<std::string> align_result)
+      : bin_id_(bin_id), align_result_(std::move(align_result)) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
 
-  void set_align_resul(const std::vector<std::string> &align_result) { align_result_ = align_result; }
-  std::vector<std::string> align_result() const { return align_result_; }
+  void set_align_resul(std::vector<std::string> align_result) { align_result_ = std::move(align_result); }
+  const std::vector<std::string> &align_result() const { return align_result_; }
 
  private:
   size_t bin_id_ = 0;
@@ -179,10 +204,8 @@ struct AliceCheck {
  public:
   ~AliceCheck() = default;
   AliceCheck() = default;
-  AliceCheck(const size_t &bin_id, const size_t &wrong_num, const std::vector<std::string> &wrong_id)
-      : bin_id_(bin_id), wrong_num_(wrong_num) {
-    wrong_id_ = wrong_id;
-  }
+  AliceCheck(const size_t &bin_id, const size_t &wrong_num, std::vector<std::string> wrong_id)
+      : bin_id_(bin_id), wrong_num_(wrong_num), wrong_id_(std::move(wrong_id)) {}
 
   void set_bin_id(const size_t &bin_id) { bin_id_ = bin_id; }
   size_t bin_id() const { return bin_id_; }
@@ -190,8 +213,8 @@ struct AliceCheck {
   void set_wrong_num(const size_t &wrong_num) { wrong_num_ = wrong_num; }
   size_t wrong_num() const { return wrong_num_; }
 
-  void set_wrong_id(const std::vector<std::string> &wrong_id) { wrong_id_ = wrong_id; }
-  std::vector<std::string> wrong_id() const { return wrong_id_; }
+  void set_wrong_id(std::vector<std::string> wrong_id) { wrong_id_ = std::move(wrong_id); }
+  const std::vector<std::string> &wrong_id() const { return wrong_id_; }
 
  private:
   size_t bin_id_ = 0;
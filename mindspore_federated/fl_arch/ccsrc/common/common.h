@@ -17,6 +17,7 @@
 #ifndef MINDSPORE_CCSRC_FL_COMMON_COMMON_H_
 #define MINDSPORE_CCSRC_FL_COMMON_COMMON_H_
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <numeric>
@@ -25,6 +26,7 @@
 #include <functional>
 #include <iomanip>
 #include <vector>
+#include <utility>
 #include "common/protos/fl.pb.h"
 #include "schema/fl_job_generated.h"
 #include "schema/cipher_generated.h"
@@ -51,6 +53,55 @@ struct InputWeight {
   std::vector<size_t> shape;
   std::string type;
   bool require_aggr = true;
+  // If set, data is kept valid by the owner and is used in place by the model rather than copied, so it should be
+  // privately writable, e.g. a MAP_PRIVATE mapping of a checkpoint file.
+  std::shared_ptr<void> data_owner = nullptr;
+};
+
+// Bytes of weights, which are either owned or borrowed from a buffer kept alive by its owner. A copy always owns its
+// bytes.
+class WeightBuffer {
+ public:
+  WeightBuffer() = default;
+  explicit WeightBuffer(size_t size) : owned_(size) {}
+  WeightBuffer(uint8_t *data, size_t size, std::shared_ptr<void> owner)
+      : borrowed_(data), borrowed_size_(size), owner_(std::move(owner)) {}
+  WeightBuffer(const WeightBuffer &other) : owned_(other.data(), other.data() + other.size()) {}
+  WeightBuffer(WeightBuffer &&other) = default;
+  WeightBuffer &operator=(const WeightBuffer &other) {
+    if (this != &other) {
+      owned_.assign(other.data(), other.data() + other.size());
+      ResetBorrowed();
+    }
+    return *this;
+  }
+  WeightBuffer &operator=(WeightBuffer &&other) = default;
+  ~WeightBuffer() = default;
+
+  uint8_t *data() { return owner_ != nullptr ? borrowed_ : owned_.data(); }
+  const uint8_t *data() const { return owner_ != nullptr ? borrowed_ : owned_.data(); }
+  size_t size() const { return owner_ != nullptr ? borrowed_size_ : owned_.size(); }
+  bool empty() const { return size() == 0; }
+  // The buffer owns its bytes after resizing, the borrowed bytes are copied.
+  void resize(size_t size) {
+    if (owner_ != nullptr) {
+      owned_.assign(borrowed_, borrowed_ + std::min(size, borrowed_size_));
+      ResetBorrowed();
+    }
+    owned_.resize(size);
+  }
+
+ private:
+  void ResetBorrowed() {
+    borrowed_ = nullptr;
+    borrowed_size_ = 0;
+    owner_ = nullptr;
+  }
+
+  std::vector<uint8_t> owned_;
+  uint8_t *borrowed_ = nullptr;
+  size_t borrowed_size_ = 0;
+  std::shared_ptr<void> owner_ = nullptr;
 };
 
 struct WeightItem {
@@ -63,10 +114,45 @@ struct WeightItem {
 };
 
 struct ModelItem {
-  std::vector<uint8_t> weight_data;
+  // Data of the weights which require aggregation, laid out back to back in the order of weight names.
+  WeightBuffer weight_data;
+  // Total byte size of all weights.
   size_t model_size = 0;
   std::map<std::string, WeightItem> weight_items;
-  bool empty() const { return model_size == 0 || weight_data.empty() || weight_items.empty(); }
+  // Data of the weights which don't require aggregation. They are not changed by aggregation, so the models of
+  // different iterations share them and copy one only before writing it, see mutable_weight_addr.
+  std::map<std::string, std::shared_ptr<WeightBuffer>> shared_weights;
+  bool empty() const { return model_size == 0 || weight_items.empty(); }
+
+  // Returns the data address of the weight, or nullptr if the weight data is missing.
+  const uint8_t *weight_addr(const WeightItem &item) const {
+    if (item.require_aggr) {
+      return item.offset + item.size <= weight_data.size() ? weight_data.data() + item.offset : nullptr;
+    }
+    auto it = shared_weights.find(item.name);
+    if (it == shared_weights.end() || it->second == nullptr || it->second->size() < item.size) {
+      return nullptr;
+    }
+    return it->second->data();
+  }
+  uint8_t *weight_addr(const WeightItem &item) {
+    return const_cast<uint8_t *>(static_cast<const ModelItem *>(this)->weight_addr(item));
+  }
+
+  // Returns the data address of the weight for writing. A shared weight is copied first if other models use it.
+  uint8_t *mutable_weight_addr(const std::string &name) {
+    auto item_it = weight_items.find(name);
+    if (item_it == weight_items.end()) {
+      return nullptr;
+    }
+    if (!item_it->second.require_aggr) {
+      auto it = shared_weights.find(name);
+      if (it != shared_weights.end() && it->second != nullptr && it->second.use_count() > 1) {
+        it->second = std::make_shared<WeightBuffer>(*it->second);
+      }
+    }
+    return weight_addr(item_it->second);
+  }
 };
 
 using ModelItemPtr = std::shared_ptr<ModelItem>;
@@ -152,6 +152,7 @@ constexpr int64_t kThousandYear = 1000;
 constexpr int64_t kBaseYear = 1900;
 constexpr int64_t kMinWarningTime = 7;
 constexpr int64_t kMaxWarningTime = 180;
+constexpr int64_t kMaxAggregationShardNum = 64;
 
 constexpr int64_t kLength = 100;
 constexpr int64_t kMaxPort = 65535;
@@ -167,6 +168,13 @@ constexpr char kDSEncryptType[] = "SIGNDS";
 constexpr char kNoCompressType[] = "NO_COMPRESS";
 constexpr auto kDiffSparseQuant = "DIFF_SPARSE_QUANT";
 constexpr auto kQuant = "QUANT";
+constexpr auto kQuant4Bit = "QUANT_4BIT";
+constexpr auto kQuant2Bit = "QUANT_2BIT";
+constexpr auto kAllReduceAuto = "AUTO";
+constexpr auto kAllReduceRing = "RING";
+constexpr auto kAllReduceReduceBroadcast = "REDUCE_BROADCAST";
+constexpr auto kAllReduceHalvingDoubling = "HALVING_DOUBLING";
+constexpr auto kAllReduceTree = "TREE";
 
 constexpr auto kUpdateModelKernel = "updateModel";
 
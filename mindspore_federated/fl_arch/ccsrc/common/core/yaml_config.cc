@@ -32,6 +32,7 @@ void YamlConfig::Load(const std::unordered_map<std::string, YamlConfigItem> &ite
     InitSummaryConfig();
     InitEncryptConfig();
     InitCompressionConfig();
+    InitAggregationConfig();
     InitClientVerifyConfig();
     InitClientConfig();
     CheckYamlConfig();
@@ -156,10 +157,18 @@ void YamlConfig::InitCompressionConfig() {
       {kNoCompressType, kDiffSparseQuant});
   Get("compression.upload_sparse_rate", &compression_config.upload_sparse_rate, false, CheckFloat(0, 1, INC_RIGHT));
   Get("compression.download_compress_type", &compression_config.download_compress_type, false,
-      {kNoCompressType, kQuant});
+      {kNoCompressType, kQuant, kQuant4Bit, kQuant2Bit});
   FLContext::instance()->set_compression_config(compression_config);
 }
 
+void YamlConfig::InitAggregationConfig() {
+  AggregationConfig aggregation_config;
+  Get("aggregation.shard_num", &aggregation_config.shard_num, false, CheckInt(1, kMaxAggregationShardNum, INC_BOTH));
+  Get("aggregation.allreduce_algorithm", &aggregation_config.allreduce_algorithm, false,
+      {kAllReduceAuto, kAllReduceRing, kAllReduceReduceBroadcast, kAllReduceHalvingDoubling, kAllReduceTree});
+  FLContext::instance()->set_aggregation_config(aggregation_config);
+}
+
 void YamlConfig::InitClientVerifyConfig() {
   ClientVerifyConfig http_config;
   Get("client_verify.pki_verify", &http_config.pki_verify, false);
@@ -159,6 +159,7 @@ class YamlConfig {
   void InitSummaryConfig();
   void InitEncryptConfig();
   void InitCompressionConfig();
+  void InitAggregationConfig();
   void InitSslConfig();
   void InitClientVerifyConfig();
   void InitClientConfig();
@@ -15,17 +15,32 @@
  */
 
 #include "distributed_cache/client_infos.h"
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
 #include "distributed_cache/redis_keys.h"
 #include "distributed_cache/timer.h"
+#include "distributed_cache/server.h"
 #include "common/fl_context.h"
 #include "distributed_cache/common.h"
+#include "common/parallel_for.h"
 
 namespace mindspore {
 namespace fl {
 namespace cache {
+namespace {
+// The same as the default size of the redis client pool.
+constexpr size_t kClientNoisesThreadNum = 4;
+// The value of the size field is "<size>:<writer>", the chunks of the writer are in the fields "<writer>:<index>".
+constexpr char kClientNoisesSizeField[] = "size";
+constexpr char kClientNoisesSeparator = ':';
+
+std::string ClientNoisesChunkField(const std::string &writer, size_t chunk_index) {
+  return writer + kClientNoisesSeparator + std::to_string(chunk_index);
+}
+}  // namespace
+
 std::shared_ptr<RedisClientBase> ClientInfos::GetOneClient() {
   return DistributedCacheLoader::Instance().GetOneClient();
 }
@@ -41,14 +56,11 @@ CacheStatus ClientInfos::AddPbItem(const std::string &name, const std::string &f
   if (client == nullptr) {
     THROW_CACHE_UNAVAILABLE;
   }
-  auto ret = client->HSetNx(name, fl_id, value);
+  auto ret = client->HSetNxExpire(name, fl_id, value, Timer::iteration_expire_time_in_seconds());
   if (ret == kCacheNetErr) {
     THROW_CACHE_UNAVAILABLE;
   }
-  if (!ret.IsSuccess()) {
-    return ret;
-  }
-  return client->Expire(name, Timer::iteration_expire_time_in_seconds());
+  return ret;
 }
 
 bool ClientInfos::HasPbItem(const std::string &name, const std::string &fl_id) {
@@ -114,14 +126,11 @@ CacheStatus ClientInfos::AddFlItem(const std::string &name, const std::string &f
   if (client == nullptr) {
     THROW_CACHE_UNAVAILABLE;
   }
-  auto ret = client->SAdd(name, fl_id);
+  auto ret = client->SAddExpire(name, fl_id, Timer::iteration_expire_time_in_seconds());
   if (ret == kCacheNetErr) {
     THROW_CACHE_UNAVAILABLE;
   }
-  if (!ret.IsSuccess()) {
-    return ret;
-  }
-  return client->Expire(name, Timer::iteration_expire_time_in_seconds());
+  return ret;
 }
 
 bool ClientInfos::HasFlItem(const std::string &name, const std::string &fl_id) {
@@ -365,14 +374,133 @@ bool ClientInfos::HasReconstructClient(const std::string &fl_id) {
   return HasFlItem(key, fl_id);
 }
 
-CacheStatus ClientInfos::SetClientNoises(const ClientNoises &noises) {
-  auto key = RedisKeys::GetInstance().ClientNoisesString();
-  return SetPbValue(key, noises);
+CacheStatus ClientInfos::SetClientNoises(const std::vector<float> &noises) {
+  auto key = RedisKeys::GetInstance().ClientNoisesHash();
+  // Several servers may reconstruct the noises at the same time. Each server writes the chunks under its own node id,
+  // and the first one which writes the size field publishes its chunks, so that the chunks of different servers are
+  // never mixed, and the noises are published as long as any of the servers finishes writing.
+  auto node_id = Server::Instance().node_id();
+  size_t chunk_num = (noises.size() + kClientNoisesChunkSize - 1) / kClientNoisesChunkSize;
+  std::vector<CacheStatus> rets(chunk_num);
+  ParallelSync parallel_sync(kClientNoisesThreadNum);
+  parallel_sync.parallel_for(0, chunk_num, 1, [&](size_t beg, size_t end) {
+    for (size_t i = beg; i < end; i++) {
+      auto client = GetOneClient();
+      if (client == nullptr) {
+        rets[i] = kCacheNetErr;
+        continue;
+      }
+      auto chunk_begin = noises.begin() + i * kClientNoisesChunkSize;
+      auto chunk_end = noises.begin() + std::min(noises.size(), (i + 1) * kClientNoisesChunkSize);
+      OneClientNoises chunk;
+      *(chunk.mutable_noise()) = {chunk_begin, chunk_end};
+      rets[i] = client->HSetNxExpire(key, ClientNoisesChunkField(node_id, i), chunk.SerializeAsString(),
+                                     Timer::iteration_expire_time_in_seconds());
+    }
+  });
+  for (auto &ret : rets) {
+    if (ret == kCacheNetErr) {
+      THROW_CACHE_UNAVAILABLE;
+    }
+    if (!ret.IsSuccess() && ret != kCacheExist) {
+      return ret;
+    }
+  }
+  auto ret = AddPbItem(key, kClientNoisesSizeField, std::to_string(noises.size()) + kClientNoisesSeparator + node_id);
+  if (ret != kCacheExist) {
+    return ret;
+  }
+  uint64_t published_size = 0;
+  std::string writer;
+  ret = GetClientNoisesWriter(&published_size, &writer);
+  if (!ret.IsSuccess() || writer == node_id) {
+    return ret;
+  }
+  // The chunks of this server are never read.
+  MS_LOG_INFO << "The client noises are published by server " << writer;
+  auto client = GetOneClient();
+  if (client != nullptr) {
+    for (size_t i = 0; i < chunk_num; i++) {
+      (void)client->HDel(key, ClientNoisesChunkField(node_id, i));
+    }
+  }
+  return kCacheSuccess;
 }
 
-CacheStatus ClientInfos::GetClientNoises(ClientNoises *noises) {
-  auto key = RedisKeys::GetInstance().ClientNoisesString();
-  return GetPbValue(key, noises);
+CacheStatus ClientInfos::GetClientNoisesSize(uint64_t *noises_size) {
+  std::string writer;
+  return GetClientNoisesWriter(noises_size, &writer);
+}
+
+CacheStatus ClientInfos::GetClientNoisesWriter(uint64_t *noises_size, std::string *writer) {
+  if (noises_size == nullptr || writer == nullptr) {
+    return kCacheInnerErr;
+  }
+  auto key = RedisKeys::GetInstance().ClientNoisesHash();
+  std::string value;
+  auto ret = GetPbItem(key, kClientNoisesSizeField, &value);
+  if (!ret.IsSuccess()) {
+    return ret;
+  }
+  auto pos = value.find(kClientNoisesSeparator);
+  if (pos == std::string::npos || !Str2Uint64(value.substr(0, pos), noises_size)) {
+    MS_LOG_ERROR << "Parse the size of client noises failed, value: " << value;
+    return kCacheTypeErr;
+  }
+  *writer = value.substr(pos + 1);
+  return kCacheSuccess;
+}
+
+CacheStatus ClientInfos::GetClientNoises(uint64_t noises_size, const ClientNoisesCallback &callback) {
+  if (callback == nullptr) {
+    return kCacheInnerErr;
+  }
+  uint64_t published_size = 0;
+  std::string writer;
+  auto ret = GetClientNoisesWriter(&published_size, &writer);
+  if (!ret.IsSuccess()) {
+    return ret;
+  }
+  if (published_size != noises_size) {
+    MS_LOG_ERROR << "The size of client noises is " << published_size << ", however " << noises_size << " is read";
+    return kCacheInnerErr;
+  }
+  auto key = RedisKeys::GetInstance().ClientNoisesHash();
+  size_t chunk_num = (noises_size + kClientNoisesChunkSize - 1) / kClientNoisesChunkSize;
+  std::vector<CacheStatus> rets(chunk_num);
+  ParallelSync parallel_sync(kClientNoisesThreadNum);
+  parallel_sync.parallel_for(0, chunk_num, 1, [&](size_t beg, size_t end) {
+    for (size_t i = beg; i < end; i++) {
+      auto client = GetOneClient();
+      if (client == nullptr) {
+        rets[i] = kCacheNetErr;
+        continue;
+      }
+      std::string value;
+      rets[i] = client->HGet(key, ClientNoisesChunkField(writer, i), &value);
+      if (!rets[i].IsSuccess()) {
+        continue;
+      }
+      OneClientNoises chunk;
+      size_t offset = i * kClientNoisesChunkSize;
+      size_t chunk_size = std::min<size_t>(noises_size - offset, kClientNoisesChunkSize);
+      if (!chunk.ParseFromString(value) || static_cast<size_t>(chunk.noise_size()) != chunk_size) {
+        MS_LOG_ERROR << "Parse chunk " << i << " of client noises failed";
+        rets[i] = kCacheInnerErr;
+        continue;
+      }
+      callback(offset, chunk.noise().data(), chunk_size);
+    }
+  });
+  for (auto &chunk_ret : rets) {
+    if (chunk_ret == kCacheNetErr) {
+      THROW_CACHE_UNAVAILABLE;
+    }
+    if (!chunk_ret.IsSuccess()) {
+      return chunk_ret;
+    }
+  }
+  return kCacheSuccess;
 }
 
 bool ClientInfos::ResetOnNewIteration() {
@@ -391,9 +519,7 @@ bool ClientInfos::ResetOnNewIteration() {
     return false;
   }
   constexpr uint64_t rel_time_in_seconds = 60;  // 60sec release time
-  for (auto &item : del_keys) {
-    client->Expire(item, rel_time_in_seconds);
-  }
+  (void)client->Expire(del_keys, rel_time_in_seconds);
   return true;
 }
 }  // namespace cache
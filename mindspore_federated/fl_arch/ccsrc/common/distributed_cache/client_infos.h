@@ -23,6 +23,7 @@
 #include <set>
 #include <vector>
 #include <utility>
+#include <functional>
 #include "common/protos/fl.pb.h"
 #include "distributed_cache/cache_status.h"
 #include "common/common.h"
@@ -91,12 +92,23 @@ class ClientInfos {
   CacheStatus AddReconstructClient(const std::string &fl_id);
   bool HasReconstructClient(const std::string &fl_id);
 
-  CacheStatus SetClientNoises(const ClientNoises &noises);
-  CacheStatus GetClientNoises(ClientNoises *noises);
+  // The noises are stored in chunks of 1M elements in a hash, which are written and read by several redis clients
+  // in parallel. The size of the noises is written after all the chunks, and kCacheNil is returned before it. The
+  // size also names the server whose chunks are read, so a server which stops halfway never blocks the others.
+  static constexpr size_t kClientNoisesChunkSize = 1 << 20;
+  CacheStatus SetClientNoises(const std::vector<float> &noises);
+  CacheStatus GetClientNoisesSize(uint64_t *noises_size);
+  // Called with each chunk of the noises and its offset as soon as the chunk is read, from several threads at the
+  // same time.
+  using ClientNoisesCallback = std::function<void(size_t offset, const float *noises, size_t size)>;
+  // Read the noises of noises_size elements chunk by chunk without gathering them into one buffer.
+  CacheStatus GetClientNoises(uint64_t noises_size, const ClientNoisesCallback &callback);
 
   bool ResetOnNewIteration();
 
  private:
+  // The size of the published noises and the server which wrote them.
+  CacheStatus GetClientNoisesWriter(uint64_t *noises_size, std::string *writer);
   CacheStatus AddPbItem(const std::string &name, const std::string &fl_id, const google::protobuf::Message &value);
   template <class PbType, typename std::enable_if<std::is_base_of_v<google::protobuf::Message, PbType>, int>::type = 0>
   CacheStatus GetPbItem(const std::string &name, const std::string &fl_id, PbType *value) {
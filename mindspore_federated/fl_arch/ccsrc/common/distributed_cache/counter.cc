@@ -15,6 +15,9 @@
  */
 #include "distributed_cache/counter.h"
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "common/common.h"
 #include "distributed_cache/distributed_cache.h"
 #include "distributed_cache/redis_keys.h"
@@ -96,14 +99,7 @@ void Counter::ResetOnNewIteration() {
     MS_LOG_WARNING << "Get redis client failed";
     return;
   }
-  auto rel_time_in_seconds = Timer::release_expire_time_in_seconds();
-  (void)client->Expire(RedisKeys::GetInstance().CountHash(), rel_time_in_seconds);
-  for (auto &item : counter_map_) {
-    if (item.second.server_hash_) {
-      auto server_hash_key = RedisKeys::GetInstance().CountPerServerHash(item.first);
-      (void)client->Expire(server_hash_key, rel_time_in_seconds);
-    }
-  }
+  (void)client->Expire(GetCountKeys(), Timer::release_expire_time_in_seconds());
 }
 
 bool Counter::ReachThreshold(const std::string &name) {
@@ -149,29 +145,24 @@ bool Counter::Count(const std::string &name, bool *trigger_first, bool *trigger_
   uint64_t new_count = 0;
   if (info.server_hash_) {
     auto key = RedisKeys::GetInstance().CountPerServerHash(name);
-    uint64_t temp_value = 0;
-    auto ret = client->HIncr(key, Server::Instance().node_id(), &temp_value);
+    std::unordered_map<std::string, uint64_t> count_map;
+    auto ret = client->HIncrExpireGetAll(key, Server::Instance().node_id(), Timer::iteration_expire_time_in_seconds(),
+                                         &count_map);
     if (!ret.IsSuccess()) {
       MS_LOG_WARNING << "Get hash count " << name << " failed";
       return false;
     }
-    if (temp_value == 1) {
-      (void)client->Expire(key, Timer::iteration_expire_time_in_seconds());
-    }
-    if (!GetCountInner(client, name, &new_count)) {
+    if (!SumPerServerCount(count_map, &info, &new_count)) {
       MS_LOG_WARNING << "Get hash count " << name << " failed";
       return false;
     }
   } else {
     auto key = RedisKeys::GetInstance().CountHash();
-    auto ret = client->HIncr(key, name, &new_count);
+    auto ret = client->HIncrExpire(key, name, Timer::iteration_expire_time_in_seconds(), &new_count);
     if (!ret.IsSuccess()) {
       MS_LOG_WARNING << "Incr string count " << name << " failed";
       return false;
     }
-    if (new_count == 1) {
-      (void)client->Expire(key, Timer::iteration_expire_time_in_seconds());
-    }
   }
   *trigger_first = (new_count == 1);
   *trigger_last = (new_count == info.threshold);
@@ -285,11 +276,6 @@ bool Counter::GetCountInner(const std::shared_ptr<RedisClientBase> &client, cons
   auto &info = it->second;
   uint64_t cur_count = 0;
   if (info.server_hash_) {
-    auto server_map = cache::Server::Instance().GetAllServers();
-    if (server_map.empty()) {
-      MS_LOG_WARNING << "Get servers from cache failed";
-      return false;
-    }
     auto key = RedisKeys::GetInstance().CountPerServerHash(name);
     std::unordered_map<std::string, uint64_t> count_map;
     auto ret = client->HGetAll(key, &count_map);
@@ -297,14 +283,9 @@ bool Counter::GetCountInner(const std::shared_ptr<RedisClientBase> &client, cons
       MS_LOG_WARNING << "Get hash count " << name << " failed";
       return false;
     }
-    bool has_server_exit = false;
-    for (auto &count_item : count_map) {
-      if (!server_map.count(count_item.first)) {
-        has_server_exit = true;
-      }
-      cur_count += count_item.second;
+    if (!SumPerServerCount(count_map, &info, &cur_count)) {
+      return false;
     }
-    info.has_server_exit = has_server_exit;
   } else {
     auto key = RedisKeys::GetInstance().CountHash();
     auto ret = client->HGet(key, name, 0, &cur_count);
@@ -317,6 +298,36 @@ bool Counter::GetCountInner(const std::shared_ptr<RedisClientBase> &client, cons
   return true;
 }
 
+bool Counter::SumPerServerCount(const std::unordered_map<std::string, uint64_t> &count_map, CounterInfo *info,
+                                uint64_t *count) {
+  auto server_map = cache::Server::Instance().GetAllServers();
+  if (server_map.empty()) {
+    MS_LOG_WARNING << "Get servers from cache failed";
+    return false;
+  }
+  uint64_t cur_count = 0;
+  bool has_server_exit = false;
+  for (auto &count_item : count_map) {
+    if (!server_map.count(count_item.first)) {
+      has_server_exit = true;
+    }
+    cur_count += count_item.second;
+  }
+  info->has_server_exit = has_server_exit;
+  *count = cur_count;
+  return true;
+}
+
+std::vector<std::string> Counter::GetCountKeys() const {
+  std::vector<std::string> keys = {RedisKeys::GetInstance().CountHash()};
+  for (auto &item : counter_map_) {
+    if (item.second.server_hash_) {
+      keys.push_back(RedisKeys::GetInstance().CountPerServerHash(item.first));
+    }
+  }
+  return keys;
+}
+
 CacheStatus Counter::GetPerServerCountMap(const std::string &name,
                                           std::unordered_map<std::string, uint64_t> *count_map) {
   auto client = DistributedCacheLoader::Instance().GetOneClient();
@@ -367,14 +378,7 @@ void Counter::Sync() {
       HandleLastCountEvent(&info, cur_iteration_num);
     }
   }
-  auto expire_time_in_seconds = Timer::iteration_expire_time_in_seconds();
-  (void)client->Expire(RedisKeys::GetInstance().CountHash(), expire_time_in_seconds);
-  for (auto &item : counter_map_) {
-    if (item.second.server_hash_) {
-      auto server_hash_key = RedisKeys::GetInstance().CountPerServerHash(item.first);
-      (void)client->Expire(server_hash_key, expire_time_in_seconds);
-    }
-  }
+  (void)client->Expire(GetCountKeys(), Timer::iteration_expire_time_in_seconds());
 }
 }  // namespace cache
 }  // namespace fl
@@ -20,6 +20,7 @@
 #include <functional>
 #include <queue>
 #include <memory>
+#include <vector>
 #include "common/protos/comm.pb.h"
 #include "distributed_cache/distributed_cache.h"
 
@@ -68,6 +69,11 @@ class Counter {
   void HandleFirstCountEvent(CounterInfo *info, uint64_t event_iteration_num);
   void HandleLastCountEvent(CounterInfo *info, uint64_t event_iteration_num);
   bool GetCountInner(const std::shared_ptr<RedisClientBase> &client, const std::string &name, uint64_t *count);
+  // Total count of the servers, and whether some of the servers have exited.
+  bool SumPerServerCount(const std::unordered_map<std::string, uint64_t> &count_map, CounterInfo *info,
+                         uint64_t *count);
+  // Keys of the count hash and the per server count hashes.
+  std::vector<std::string> GetCountKeys() const;
   void SubmitEventHandle(const CounterCallback &task, uint64_t event_iteration_num);
 };
 }  // namespace cache
@@ -37,6 +37,15 @@ bool DistributedCacheLoader::InitCacheImpl(const DistributedCacheConfig &cache_c
   return true;
 }
 
+bool DistributedCacheLoader::InitCacheImpl(const std::shared_ptr<DistributedCacheBase> &cache_impl) {
+  if (cache_impl_ != nullptr) {
+    MS_LOG_ERROR << "InitCacheImpl should not be init twice";
+    return true;
+  }
+  cache_impl_ = cache_impl;
+  return cache_impl_ != nullptr;
+}
+
 std::shared_ptr<RedisClientBase> DistributedCacheLoader::GetOneClient() {
   if (cache_impl_ == nullptr) {
     MS_LOG_ERROR << "GetOneClient should called after InitCacheImpl";
@@ -74,15 +83,9 @@ CacheStatus RedisClientBase::HMSet(const std::string &key, const std::unordered_
   return HMSet(key, items_str);
 }
 
-CacheStatus RedisClientBase::HGetAll(const std::string &key, std::unordered_map<std::string, uint64_t> *items) {
-  if (items == nullptr) {
-    return kCacheInnerErr;
-  }
-  std::unordered_map<std::string, std::string> items_str;
-  auto status = HGetAll(key, &items_str);
-  if (!status.IsSuccess()) {
-    return status;
-  }
+namespace {
+CacheStatus ParseUint64Items(const std::string &key, const std::unordered_map<std::string, std::string> &items_str,
+                             std::unordered_map<std::string, uint64_t> *items) {
   std::unordered_map<std::string, uint64_t> items_ret;
   for (auto &item : items_str) {
     uint64_t item_value;
@@ -95,6 +98,32 @@ CacheStatus RedisClientBase::HGetAll(const std::string &key, std::unordered_map<
   *items = std::move(items_ret);
   return kCacheSuccess;
 }
+}  // namespace
+
+CacheStatus RedisClientBase::HGetAll(const std::string &key, std::unordered_map<std::string, uint64_t> *items) {
+  if (items == nullptr) {
+    return kCacheInnerErr;
+  }
+  std::unordered_map<std::string, std::string> items_str;
+  auto status = HGetAll(key, &items_str);
+  if (!status.IsSuccess()) {
+    return status;
+  }
+  return ParseUint64Items(key, items_str, items);
+}
+
+CacheStatus RedisClientBase::HIncrExpireGetAll(const std::string &key, const std::string &filed, uint64_t seconds,
+                                               std::unordered_map<std::string, uint64_t> *items) {
+  if (items == nullptr) {
+    return kCacheInnerErr;
+  }
+  std::unordered_map<std::string, std::string> items_str;
+  auto status = HIncrExpireGetAll(key, filed, seconds, &items_str);
+  if (!status.IsSuccess()) {
+    return status;
+  }
+  return ParseUint64Items(key, items_str, items);
+}
 
 // Get Hash filed and parse to int64
 CacheStatus RedisClientBase::HGet(const std::string &key, const std::string &filed, uint64_t default_val,
@@ -50,6 +50,7 @@ class RedisClientBase {
   CacheStatus Del(const std::string &key) { return Del(std::vector<std::string>({key})); }
   // expire
   virtual CacheStatus Expire(const std::string &key, uint64_t seconds) = 0;
+  virtual CacheStatus Expire(const std::vector<std::string> &keys, uint64_t seconds) = 0;
   // set operator
   virtual CacheStatus SAdd(const std::string &key, const std::string &member) = 0;
   virtual CacheStatus SIsMember(const std::string &key, const std::string &member, bool *value) = 0;
@@ -69,6 +70,15 @@ class RedisClientBase {
   virtual CacheStatus SetNx(const std::string &key, const std::string &value) = 0;
   virtual CacheStatus SetExNx(const std::string &key, const std::string &value, uint64_t seconds) = 0;
   virtual CacheStatus Incr(const std::string &key, uint64_t *new_value) = 0;
+  // compound operator in one round trip, the key expires in seconds if the filed or member is added by the operator
+  virtual CacheStatus HSetNxExpire(const std::string &key, const std::string &filed, const std::string &value,
+                                   uint64_t seconds) = 0;
+  virtual CacheStatus SAddExpire(const std::string &key, const std::string &member, uint64_t seconds) = 0;
+  virtual CacheStatus HIncrExpire(const std::string &key, const std::string &filed, uint64_t seconds,
+                                  uint64_t *new_value) = 0;
+  // HIncrExpire and then HGetAll
+  virtual CacheStatus HIncrExpireGetAll(const std::string &key, const std::string &filed, uint64_t seconds,
+                                        std::unordered_map<std::string, std::string> *items) = 0;
 
   // Set Hash filed and int64 value
   CacheStatus HMSet(const std::string &key, const std::unordered_map<std::string, uint64_t> &items);
@@ -78,6 +88,9 @@ class RedisClientBase {
   CacheStatus HGet(const std::string &key, const std::string &filed, uint64_t default_val, uint64_t *value);
   // Get String value and parse to int64
   CacheStatus Get(const std::string &key, uint64_t default_val, uint64_t *value);
+  // HIncrExpireGetAll and parse to int64
+  CacheStatus HIncrExpireGetAll(const std::string &key, const std::string &filed, uint64_t seconds,
+                                std::unordered_map<std::string, uint64_t> *items);
 };
 
 class DistributedCacheBase {
@@ -98,6 +111,8 @@ class DistributedCacheLoader {
     return instance;
   }
   bool InitCacheImpl(const DistributedCacheConfig &cache_config);
+  // Use a cache which is initialized already, such as an in-memory one of tests.
+  bool InitCacheImpl(const std::shared_ptr<DistributedCacheBase> &cache_impl);
   std::shared_ptr<RedisClientBase> GetOneClient();
   bool HasInvalid() const;
   CacheStatus RetryConnect();
@@ -470,10 +470,7 @@ void InstanceContext::ClearInstance() {
     RedisKeys::GetInstance().InstanceStatusHash(),
     RedisKeys::GetInstance().HyperParamsString(),
   };
-  auto instance_rel_time_in_seconds = Timer::release_expire_time_in_seconds();
-  for (auto &item : to_rel_keys) {
-    client->Expire(item, instance_rel_time_in_seconds);
-  }
+  (void)client->Expire(to_rel_keys, Timer::release_expire_time_in_seconds());
 }
 }  // namespace cache
 }  // namespace fl
@@ -21,6 +21,7 @@
 #include "common/core/comm_util.h"
 #include "common/common.h"
 #include "common/exit_handler.h"
+#include "distributed_cache/common.h"
 
 namespace mindspore {
 namespace fl {
@@ -325,22 +326,65 @@ RedisReply RedisClient::RunCommand(const std::vector<std::string> &args) {
   return RunCommand(static_cast<int>(argv.size()), argv.data(), argvlen.data());
 }
 
+std::vector<RedisReply> RedisClient::RunPipeline(const std::vector<std::vector<std::string>> &commands) {
+  std::unique_lock<std::mutex> lock(lock_);
+  if (!IsValid()) {
+    auto status = ReconnectInner();
+    if (!status.IsSuccess()) {
+      MS_LOG(ERROR) << "Init redis pipeline failed, failed to reconnect to redis server: " << status.GetDetail();
+      return std::vector<RedisReply>(commands.size());
+    }
+  }
+  auto replies = RunPipelineInner(commands);
+  if (!IsValid()) {
+    auto status = ReconnectInner();
+    if (!status.IsSuccess()) {
+      MS_LOG(ERROR) << "Init redis pipeline failed, failed to reconnect to redis server: " << status.GetDetail();
+      return std::vector<RedisReply>(commands.size());
+    }
+    replies = RunPipelineInner(commands);
+  }
+  return replies;
+}
+
+std::vector<RedisReply> RedisClient::RunPipelineInner(const std::vector<std::vector<std::string>> &commands) {
+  std::vector<RedisReply> replies(commands.size());
+  size_t append_num = 0;
+  for (auto &args : commands) {
+    std::vector<const char *> argv;
+    std::vector<size_t> argvlen;
+    for (auto &item : args) {
+      argv.push_back(item.c_str());
+      argvlen.push_back(item.size());
+    }
+    if (redisAppendCommandArgv(redis_context_, static_cast<int>(argv.size()), argv.data(), argvlen.data()) !=
+        REDIS_OK) {
+      break;
+    }
+    append_num++;
+  }
+  // The replies of the appended commands must be read even if some of the commands failed to be appended.
+  for (size_t i = 0; i < append_num; i++) {
+    void *reply = nullptr;
+    if (redisGetReply(redis_context_, &reply) != REDIS_OK) {
+      break;
+    }
+    replies[i] = RedisReply(reinterpret_cast<redisReply *>(reply));
+  }
+  return replies;
+}
+
+std::vector<std::string> RedisClient::EvalCommand(const std::string &script, const std::vector<std::string> &keys,
+                                                  const std::vector<std::string> &args) {
+  std::vector<std::string> command = {"EVAL", script, std::to_string(keys.size())};
+  std::copy(keys.begin(), keys.end(), std::back_inserter(command));
+  std::copy(args.begin(), args.end(), std::back_inserter(command));
+  return command;
+}
+
 RedisReply RedisClient::Eval(const std::string &script, const std::vector<std::string> &keys,
                              const std::vector<std::string> &args) {
-  std::vector<const char *> argv;
-  argv.push_back(script.c_str());
-  std::transform(keys.begin(), keys.end(), std::back_inserter(argv),
-                 [](const std::string &item) { return item.c_str(); });
-  std::transform(args.begin(), args.end(), std::back_inserter(argv),
-                 [](const std::string &item) { return item.c_str(); });
-
-  std::vector<size_t> argvlen;
-  argvlen.push_back(script.size());
-  std::transform(keys.begin(), keys.end(), std::back_inserter(argvlen),
-                 [](const std::string &item) { return item.size(); });
-  std::transform(args.begin(), args.end(), std::back_inserter(argvlen),
-                 [](const std::string &item) { return item.size(); });
-  return RunCommand(static_cast<int>(argv.size()), argv.data(), argvlen.data());
+  return RunCommand(EvalCommand(script, keys, args));
 }
 
 CacheStatus RedisClient::Del(const std::vector<std::string> &keys) {
@@ -364,6 +408,25 @@ CacheStatus RedisClient::Expire(const std::string &key, uint64_t seconds) {
   return kCacheSuccess;
 }
 
+CacheStatus RedisClient::Expire(const std::vector<std::string> &keys, uint64_t seconds) {
+  if (keys.empty()) {
+    return kCacheSuccess;
+  }
+  std::vector<std::vector<std::string>> commands;
+  auto seconds_str = std::to_string(seconds);
+  for (auto &key : keys) {
+    commands.push_back({"EXPIRE", key, seconds_str});
+  }
+  auto replies = RunPipeline(commands);
+  for (auto &reply : replies) {
+    if (!reply.IsValid()) {
+      MS_LOG(WARNING) << "Reply invalid: " << reply.GetError();
+      return kCacheNetErr;
+    }
+  }
+  return kCacheSuccess;
+}
+
 CacheStatus RedisClient::SAdd(const std::string &key, const std::string &member) {
   RedisReply reply = RunCommand({"SADD", key, member});
   if (!reply.IsValid()) {
@@ -579,6 +642,92 @@ CacheStatus RedisClient::Incr(const std::string &key, uint64_t *new_value) {
   return kCacheSuccess;
 }
 
+namespace {
+// Scripts of the compound operators, a script runs atomically on the redis server.
+const char kHSetNxExpireScript[] =
+  "local ret = redis.call('HSETNX', KEYS[1], ARGV[1], ARGV[2]) "
+  "if ret == 1 then redis.call('EXPIRE', KEYS[1], ARGV[3]) end "
+  "return ret";
+const char kSAddExpireScript[] =
+  "local ret = redis.call('SADD', KEYS[1], ARGV[1]) "
+  "if ret == 1 then redis.call('EXPIRE', KEYS[1], ARGV[2]) end "
+  "return ret";
+const char kHIncrExpireScript[] =
+  "local ret = redis.call('HINCRBY', KEYS[1], ARGV[1], 1) "
+  "if ret == 1 then redis.call('EXPIRE', KEYS[1], ARGV[2]) end "
+  "return ret";
+const char kHIncrExpireGetAllScript[] =
+  "if redis.call('HINCRBY', KEYS[1], ARGV[1], 1) == 1 then redis.call('EXPIRE', KEYS[1], ARGV[2]) end "
+  "return redis.call('HGETALL', KEYS[1])";
+
+// Replies of SADD and HSETNX: 1 if the member or filed is added, 0 if it exists.
+CacheStatus AddReplyToStatus(const RedisReply &reply, const std::string &command, const std::string &key,
+                             const std::string &item) {
+  if (!reply.IsValid()) {
+    MS_LOG(WARNING) << "Reply invalid: " << reply.GetError();
+    return kCacheNetErr;
+  }
+  uint64_t int_value = 0;
+  if (!reply.GetInteger(&int_value)) {
+    MS_LOG(WARNING) << "Failed to call " << command << " " << key << " " << item;
+    return kCacheInnerErr;
+  }
+  if (int_value == 0) {
+    return kCacheExist;
+  }
+  return kCacheSuccess;
+}
+
+CacheStatus IntegerReplyToStatus(const RedisReply &reply, const std::string &command, const std::string &key,
+                                 uint64_t *value) {
+  if (!reply.IsValid()) {
+    MS_LOG(WARNING) << "Reply invalid: " << reply.GetError();
+    return kCacheNetErr;
+  }
+  if (!reply.GetInteger(value)) {
+    MS_LOG(WARNING) << "Failed to call " << command << " " << key;
+    return kCacheInnerErr;
+  }
+  return kCacheSuccess;
+}
+
+CacheStatus MapReplyToStatus(const RedisReply &reply, const std::string &command, const std::string &key,
+                             std::unordered_map<std::string, std::string> *items) {
+  if (!reply.IsValid()) {
+    MS_LOG(WARNING) << "Reply invalid: " << reply.GetError();
+    return kCacheNetErr;
+  }
+  if (!reply.GetMap(items)) {
+    MS_LOG(WARNING) << "Failed to call " << command << " " << key;
+    return kCacheInnerErr;
+  }
+  return kCacheSuccess;
+}
+}  // namespace
+
+CacheStatus RedisClient::HSetNxExpire(const std::string &key, const std::string &filed, const std::string &value,
+                                      uint64_t seconds) {
+  RedisReply reply = Eval(kHSetNxExpireScript, {key}, {filed, value, std::to_string(seconds)});
+  return AddReplyToStatus(reply, "HSETNX and EXPIRE", key, filed);
+}
+
+CacheStatus RedisClient::SAddExpire(const std::string &key, const std::string &member, uint64_t seconds) {
+  RedisReply reply = Eval(kSAddExpireScript, {key}, {member, std::to_string(seconds)});
+  return AddReplyToStatus(reply, "SADD and EXPIRE", key, member);
+}
+
+CacheStatus RedisClient::HIncrExpire(const std::string &key, const std::string &filed, uint64_t seconds,
+                                     uint64_t *new_value) {
+  RedisReply reply = Eval(kHIncrExpireScript, {key}, {filed, std::to_string(seconds)});
+  return IntegerReplyToStatus(reply, "HINCRBY and EXPIRE", key, new_value);
+}
+
+CacheStatus RedisClient::HIncrExpireGetAll(const std::string &key, const std::string &filed, uint64_t seconds,
+                                           std::unordered_map<std::string, std::string> *items) {
+  RedisReply reply = Eval(kHIncrExpireGetAllScript, {key}, {filed, std::to_string(seconds)});
+  return MapReplyToStatus(reply, "HINCRBY, EXPIRE and HGETALL", key, items);
+}
+
 RedisDistributedCache::~RedisDistributedCache() {
   client_pool_.clear();
   if (ssl_context_ != nullptr) {
@@ -604,6 +753,21 @@ CacheStatus RedisDistributedCache::ParseSSLConfig(const std::unordered_map<std::
   return kCacheSuccess;
 }
 
+CacheStatus RedisDistributedCache::ParsePoolSize(const std::unordered_map<std::string, std::string> &configs,
+                                                 const std::string &name, uint64_t *pool_size) {
+  if (configs.find(name) == configs.end()) {
+    return kCacheSuccess;
+  }
+  uint64_t size = 0;
+  if (!GetUintValue(configs, name, &size) || size == 0 || size > kMaxClientPoolSize) {
+    auto reason = "The value of distributed_cache." + name + " should be an integer in [1, " +
+                  std::to_string(kMaxClientPoolSize) + "], but got " + configs.at(name);
+    return {kCacheParamFailed, reason};
+  }
+  *pool_size = size;
+  return kCacheSuccess;
+}
+
 bool RedisDistributedCache::Init(const DistributedCacheConfig &cache_config, int64_t timeout) {
   cache_config_ = cache_config;
   if (cache_config_.address.empty()) {
@@ -628,8 +792,14 @@ bool RedisDistributedCache::Init(const DistributedCacheConfig &cache_config, int
       return false;
     }
   }
-  MS_LOG_INFO << "Try connect to redis sever " << cache_config_.address << ", retry time in seconds " << timeout;
-  for (size_t i = 0; i < thread_pool_size_; i++) {
+  auto status = ParsePoolSize(cache_config_.configs, "client_pool_size", &client_pool_size_);
+  if (!status.IsSuccess()) {
+    MS_LOG_ERROR << status.GetDetail();
+    return false;
+  }
+  MS_LOG_INFO << "Try connect to redis sever " << cache_config_.address << ", retry time in seconds " << timeout
+              << ", client pool size " << client_pool_size_;
+  for (size_t i = 0; i < client_pool_size_; i++) {
     auto client = std::make_shared<RedisClient>(cache_config_.address, ssl_context_, timeout);
     if (client == nullptr) {
       MS_LOG_ERROR << "Failed to create RedisClient object";
@@ -89,6 +89,7 @@ class RedisClient : public RedisClientBase {
   CacheStatus Del(const std::vector<std::string> &keys) override;
   // expire
   CacheStatus Expire(const std::string &key, uint64_t seconds) override;
+  CacheStatus Expire(const std::vector<std::string> &keys, uint64_t seconds) override;
   // set operator
   CacheStatus SAdd(const std::string &key, const std::string &member) override;
   CacheStatus SIsMember(const std::string &key, const std::string &member, bool *value) override;
@@ -108,11 +109,26 @@ class RedisClient : public RedisClientBase {
   CacheStatus SetNx(const std::string &key, const std::string &value) override;
   CacheStatus SetExNx(const std::string &key, const std::string &value, uint64_t seconds) override;
   CacheStatus Incr(const std::string &key, uint64_t *new_value) override;
+  // compound operator
+  CacheStatus HSetNxExpire(const std::string &key, const std::string &filed, const std::string &value,
+                           uint64_t seconds) override;
+  CacheStatus SAddExpire(const std::string &key, const std::string &member, uint64_t seconds) override;
+  CacheStatus HIncrExpire(const std::string &key, const std::string &filed, uint64_t seconds,
+                          uint64_t *new_value) override;
+  CacheStatus HIncrExpireGetAll(const std::string &key, const std::string &filed, uint64_t seconds,
+                                std::unordered_map<std::string, std::string> *items) override;
+
+  // Arguments of the EVAL command which runs the script with the keys and args.
+  static std::vector<std::string> EvalCommand(const std::string &script, const std::vector<std::string> &keys,
+                                              const std::vector<std::string> &args);
 
  protected:
   CacheStatus ReconnectInner();
   RedisReply RunCommand(int argc, const char **argv, const size_t *argvlen);
   RedisReply RunCommand(const std::vector<std::string> &args);
+  // Sends all the commands and then reads all the replies, so they cost one round trip. The commands are not atomic.
+  std::vector<RedisReply> RunPipeline(const std::vector<std::vector<std::string>> &commands);
+  std::vector<RedisReply> RunPipelineInner(const std::vector<std::vector<std::string>> &commands);
   RedisReply Eval(const std::string &script, const std::vector<std::string> &keys,
                   const std::vector<std::string> &args);
 
@@ -137,13 +153,18 @@ class RedisDistributedCache : public DistributedCacheBase {
 
  private:
   DistributedCacheConfig cache_config_;
-  static constexpr uint32_t thread_pool_size_ = 4;
+  // Number of clients, configured by client_pool_size of distributed_cache.
+  static constexpr uint64_t kDefaultClientPoolSize = 4;
+  static constexpr uint64_t kMaxClientPoolSize = 256;
+  uint64_t client_pool_size_ = kDefaultClientPoolSize;
   std::atomic_uint64_t cur_client_ret_index_ = 0;
 
   redisSSLContext *ssl_context_ = nullptr;
   std::vector<std::shared_ptr<RedisClient>> client_pool_;
 
   CacheStatus ParseSSLConfig(const std::unordered_map<std::string, std::string> &configs, RedisSSLConfig *ssl_config_p);
+  CacheStatus ParsePoolSize(const std::unordered_map<std::string, std::string> &configs, const std::string &name,
+                            uint64_t *pool_size);
 };
 }  // namespace cache
 }  // namespace fl
@@ -100,7 +100,8 @@ class RedisKeys {
   std::string ClientSignaturesHash() const { return PrefixIteration() + "client:Signatures:Hash"; }
   std::string ClientKeysHash() const { return PrefixIteration() + "client:Keys:Hash"; }
 
-  std::string ClientNoisesString() const { return PrefixIteration() + "client:Noises:String"; }
+  // the noises are split into chunks, see ClientInfos::SetClientNoises
+  std::string ClientNoisesHash() const { return PrefixIteration() + "client:Noises:Hash"; }
   std::string ClientPrimeString() const { return PrefixIteration() + "client:Prime:String"; }
 
   std::string InstanceStatusHash() const {
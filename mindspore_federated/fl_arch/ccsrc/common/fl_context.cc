@@ -230,6 +230,10 @@ void FLContext::set_compression_config(const CompressionConfig &config) { compre
 
 const CompressionConfig &FLContext::compression_config() const { return compression_config_; }
 
+void FLContext::set_aggregation_config(const AggregationConfig &config) { aggregation_config_ = config; }
+
+const AggregationConfig &FLContext::aggregation_config() const { return aggregation_config_; }
+
 void FLContext::set_client_epoch_num(uint64_t client_epoch_num) { client_epoch_num_ = client_epoch_num; }
 
 uint64_t FLContext::client_epoch_num() const { return client_epoch_num_; }
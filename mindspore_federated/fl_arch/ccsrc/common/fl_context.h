@@ -62,6 +62,13 @@ struct CompressionConfig {
   std::string download_compress_type = kNoCompressType;
 };
 
+struct AggregationConfig {
+  // Number of partial FedAvg accumulators updateModel requests are spread over, 1 means a single locked sum.
+  uint64_t shard_num = 1;
+  // AllReduce algorithm used between servers, AUTO picks one from the message size and the server number.
+  std::string allreduce_algorithm = kAllReduceAuto;
+};
+
 struct SslConfig {
   // for tcp server
   std::string server_cert_path;
@@ -169,6 +176,9 @@ class MS_EXPORT FLContext {
   void set_compression_config(const CompressionConfig &config);
   const CompressionConfig &compression_config() const;
 
+  void set_aggregation_config(const AggregationConfig &config);
+  const AggregationConfig &aggregation_config() const;
+
   // Set the data batch size of the client.
   void set_client_batch_size(uint64_t client_batch_size);
   uint64_t client_batch_size() const;
@@ -337,6 +347,7 @@ class MS_EXPORT FLContext {
   // server config
   EncryptConfig encrypt_config_;
   CompressionConfig compression_config_;
+  AggregationConfig aggregation_config_;
   ClientVerifyConfig client_verify_config_;
 
   std::string metrics_file_ = "metrics.json";
@@ -0,0 +1,523 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/utils/simd_kernels.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FL_SIMD_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FL_SIMD_NEON
+#endif
+
+namespace mindspore {
+namespace fl {
+namespace simd {
+namespace {
+void AddScalar(float *dst, const float *src, size_t elem_num) {
+  for (size_t i = 0; i < elem_num; i++) {
+    dst[i] += src[i];
+  }
+}
+
+void ScaleScalar(float *dst, float scale, size_t elem_num) {
+  for (size_t i = 0; i < elem_num; i++) {
+    dst[i] *= scale;
+  }
+}
+
+void AddScaledScalar(float *dst, const float *src, float weight, size_t elem_num) {
+  for (size_t i = 0; i < elem_num; i++) {
+    dst[i] += src[i] * weight;
+  }
+}
+
+void MinMaxScalar(const float *src, size_t elem_num, float *min_val, float *max_val) {
+  float min_value = src[0];
+  float max_value = src[0];
+  for (size_t i = 1; i < elem_num; i++) {
+    min_value = src[i] < min_value ? src[i] : min_value;
+    max_value = src[i] > max_value ? src[i] : max_value;
+  }
+  *min_val = min_value;
+  *max_val = max_value;
+}
+
+void QuantizeScalar(const float *src, size_t elem_num, float min_val, float inv_scale, uint8_t max_code,
+                    uint8_t code_offset, uint8_t *codes) {
+  auto max_code_value = static_cast<float>(max_code);
+  for (size_t i = 0; i < elem_num; i++) {
+    float code = (src[i] - min_val) * inv_scale;
+    // Written so that NaN becomes 0 like the SIMD max instruction.
+    code = code > 0.0f ? code : 0.0f;
+    code = code < max_code_value ? code : max_code_value;
+    codes[i] = static_cast<uint8_t>(static_cast<int>(std::nearbyint(code)) - code_offset);
+  }
+}
+
+void DequantizeScalar(const uint8_t *codes, size_t elem_num, float min_val, float scale, uint8_t code_offset,
+                      float *dst) {
+  for (size_t i = 0; i < elem_num; i++) {
+    dst[i] = static_cast<float>(static_cast<uint8_t>(codes[i] + code_offset)) * scale + min_val;
+  }
+}
+
+#ifdef FL_SIMD_X86
+constexpr size_t kAvx2FloatNum = 8;
+constexpr size_t kAvx512FloatNum = 16;
+
+__attribute__((target("avx2"))) void AddAvx2(float *dst, const float *src, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    __m256 sum = _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i));
+    _mm256_storeu_ps(dst + i, sum);
+  }
+  AddScalar(dst + i, src + i, elem_num - i);
+}
+
+__attribute__((target("avx2"))) void ScaleAvx2(float *dst, float scale, size_t elem_num) {
+  size_t i = 0;
+  __m256 scale_vec = _mm256_set1_ps(scale);
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), scale_vec));
+  }
+  ScaleScalar(dst + i, scale, elem_num - i);
+}
+
+__attribute__((target("avx2,fma"))) void AddScaledAvx2(float *dst, const float *src, float weight, size_t elem_num) {
+  size_t i = 0;
+  __m256 weight_vec = _mm256_set1_ps(weight);
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    __m256 sum = _mm256_fmadd_ps(_mm256_loadu_ps(src + i), weight_vec, _mm256_loadu_ps(dst + i));
+    _mm256_storeu_ps(dst + i, sum);
+  }
+  AddScaledScalar(dst + i, src + i, weight, elem_num - i);
+}
+
+__attribute__((target("avx2"))) void MinMaxAvx2(const float *src, size_t elem_num, float *min_val, float *max_val) {
+  if (elem_num < kAvx2FloatNum) {
+    return MinMaxScalar(src, elem_num, min_val, max_val);
+  }
+  __m256 min_vec = _mm256_loadu_ps(src);
+  __m256 max_vec = min_vec;
+  size_t i = kAvx2FloatNum;
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    __m256 data = _mm256_loadu_ps(src + i);
+    min_vec = _mm256_min_ps(min_vec, data);
+    max_vec = _mm256_max_ps(max_vec, data);
+  }
+  float min_lanes[kAvx2FloatNum];
+  float max_lanes[kAvx2FloatNum];
+  _mm256_storeu_ps(min_lanes, min_vec);
+  _mm256_storeu_ps(max_lanes, max_vec);
+  float min_value = min_lanes[0];
+  float max_value = max_lanes[0];
+  for (size_t j = 1; j < kAvx2FloatNum; j++) {
+    min_value = min_lanes[j] < min_value ? min_lanes[j] : min_value;
+    max_value = max_lanes[j] > max_value ? max_lanes[j] : max_value;
+  }
+  for (; i < elem_num; i++) {
+    min_value = src[i] < min_value ? src[i] : min_value;
+    max_value = src[i] > max_value ? src[i] : max_value;
+  }
+  *min_val = min_value;
+  *max_val = max_value;
+}
+
+__attribute__((target("avx2"))) void QuantizeAvx2(const float *src, size_t elem_num, float min_val, float inv_scale,
+                                                  uint8_t max_code, uint8_t code_offset, uint8_t *codes) {
+  size_t i = 0;
+  __m256 min_vec = _mm256_set1_ps(min_val);
+  __m256 inv_scale_vec = _mm256_set1_ps(inv_scale);
+  __m256 zero_vec = _mm256_setzero_ps();
+  __m256 max_code_vec = _mm256_set1_ps(static_cast<float>(max_code));
+  __m128i offset_vec = _mm_set1_epi8(static_cast<char>(code_offset));
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    __m256 code = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(src + i), min_vec), inv_scale_vec);
+    code = _mm256_min_ps(_mm256_max_ps(code, zero_vec), max_code_vec);
+    __m256i code32 = _mm256_cvtps_epi32(code);
+    __m128i code16 = _mm_packus_epi32(_mm256_castsi256_si128(code32), _mm256_extracti128_si256(code32, 1));
+    __m128i code8 = _mm_sub_epi8(_mm_packus_epi16(code16, code16), offset_vec);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(codes + i), code8);
+  }
+  QuantizeScalar(src + i, elem_num - i, min_val, inv_scale, max_code, code_offset, codes + i);
+}
+
+__attribute__((target("avx2"))) void DequantizeAvx2(const uint8_t *codes, size_t elem_num, float min_val, float scale,
+                                                    uint8_t code_offset, float *dst) {
+  size_t i = 0;
+  __m256 min_vec = _mm256_set1_ps(min_val);
+  __m256 scale_vec = _mm256_set1_ps(scale);
+  __m128i offset_vec = _mm_set1_epi8(static_cast<char>(code_offset));
+  for (; i + kAvx2FloatNum <= elem_num; i += kAvx2FloatNum) {
+    __m128i code8 = _mm_add_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(codes + i)), offset_vec);
+    __m256 code = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(code8));
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(code, scale_vec), min_vec));
+  }
+  DequantizeScalar(codes + i, elem_num - i, min_val, scale, code_offset, dst + i);
+}
+
+__attribute__((target("avx512f"))) void AddAvx512(float *dst, const float *src, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    __m512 sum = _mm512_add_ps(_mm512_loadu_ps(dst + i), _mm512_loadu_ps(src + i));
+    _mm512_storeu_ps(dst + i, sum);
+  }
+  AddScalar(dst + i, src + i, elem_num - i);
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(float *dst, float scale, size_t elem_num) {
+  size_t i = 0;
+  __m512 scale_vec = _mm512_set1_ps(scale);
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_loadu_ps(dst + i), scale_vec));
+  }
+  ScaleScalar(dst + i, scale, elem_num - i);
+}
+
+__attribute__((target("avx512f"))) void AddScaledAvx512(float *dst, const float *src, float weight,
+                                                        size_t elem_num) {
+  size_t i = 0;
+  __m512 weight_vec = _mm512_set1_ps(weight);
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    __m512 sum = _mm512_fmadd_ps(_mm512_loadu_ps(src + i), weight_vec, _mm512_loadu_ps(dst + i));
+    _mm512_storeu_ps(dst + i, sum);
+  }
+  AddScaledScalar(dst + i, src + i, weight, elem_num - i);
+}
+
+// GCC reports the _mm512_undefined_* placeholders inside these intrinsics as maybe uninitialized.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f"))) void MinMaxAvx512(const float *src, size_t elem_num, float *min_val,
+                                                     float *max_val) {
+  if (elem_num < kAvx512FloatNum) {
+    return MinMaxScalar(src, elem_num, min_val, max_val);
+  }
+  __m512 min_vec = _mm512_loadu_ps(src);
+  __m512 max_vec = min_vec;
+  size_t i = kAvx512FloatNum;
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    __m512 data = _mm512_loadu_ps(src + i);
+    min_vec = _mm512_min_ps(min_vec, data);
+    max_vec = _mm512_max_ps(max_vec, data);
+  }
+  float min_value = _mm512_reduce_min_ps(min_vec);
+  float max_value = _mm512_reduce_max_ps(max_vec);
+  for (; i < elem_num; i++) {
+    min_value = src[i] < min_value ? src[i] : min_value;
+    max_value = src[i] > max_value ? src[i] : max_value;
+  }
+  *min_val = min_value;
+  *max_val = max_value;
+}
+
+__attribute__((target("avx512f"))) void QuantizeAvx512(const float *src, size_t elem_num, float min_val,
+                                                       float inv_scale, uint8_t max_code, uint8_t code_offset,
+                                                       uint8_t *codes) {
+  size_t i = 0;
+  __m512 min_vec = _mm512_set1_ps(min_val);
+  __m512 inv_scale_vec = _mm512_set1_ps(inv_scale);
+  __m512 zero_vec = _mm512_setzero_ps();
+  __m512 max_code_vec = _mm512_set1_ps(static_cast<float>(max_code));
+  __m128i offset_vec = _mm_set1_epi8(static_cast<char>(code_offset));
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    __m512 code = _mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(src + i), min_vec), inv_scale_vec);
+    code = _mm512_min_ps(_mm512_max_ps(code, zero_vec), max_code_vec);
+    __m128i code8 = _mm_sub_epi8(_mm512_cvtepi32_epi8(_mm512_cvtps_epi32(code)), offset_vec);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(codes + i), code8);
+  }
+  QuantizeScalar(src + i, elem_num - i, min_val, inv_scale, max_code, code_offset, codes + i);
+}
+
+__attribute__((target("avx512f"))) void DequantizeAvx512(const uint8_t *codes, size_t elem_num, float min_val,
+                                                         float scale, uint8_t code_offset, float *dst) {
+  size_t i = 0;
+  __m512 min_vec = _mm512_set1_ps(min_val);
+  __m512 scale_vec = _mm512_set1_ps(scale);
+  __m128i offset_vec = _mm_set1_epi8(static_cast<char>(code_offset));
+  for (; i + kAvx512FloatNum <= elem_num; i += kAvx512FloatNum) {
+    __m128i code8 = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(codes + i)), offset_vec);
+    __m512 code = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(code8));
+    _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_mul_ps(code, scale_vec), min_vec));
+  }
+  DequantizeScalar(codes + i, elem_num - i, min_val, scale, code_offset, dst + i);
+}
+#pragma GCC diagnostic pop
+#endif
+
+#ifdef FL_SIMD_NEON
+constexpr size_t kNeonFloatNum = 4;
+
+void AddNeon(float *dst, const float *src, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kNeonFloatNum <= elem_num; i += kNeonFloatNum) {
+    vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+  }
+  AddScalar(dst + i, src + i, elem_num - i);
+}
+
+void ScaleNeon(float *dst, float scale, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kNeonFloatNum <= elem_num; i += kNeonFloatNum) {
+    vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(dst + i), scale));
+  }
+  ScaleScalar(dst + i, scale, elem_num - i);
+}
+
+void AddScaledNeon(float *dst, const float *src, float weight, size_t elem_num) {
+  size_t i = 0;
+  for (; i + kNeonFloatNum <= elem_num; i += kNeonFloatNum) {
+    vst1q_f32(dst + i, vfmaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), weight));
+  }
+  AddScaledScalar(dst + i, src + i, weight, elem_num - i);
+}
+
+void MinMaxNeon(const float *src, size_t elem_num, float *min_val, float *max_val) {
+  if (elem_num < kNeonFloatNum) {
+    return MinMaxScalar(src, elem_num, min_val, max_val);
+  }
+  float32x4_t min_vec = vld1q_f32(src);
+  float32x4_t max_vec = min_vec;
+  size_t i = kNeonFloatNum;
+  for (; i + kNeonFloatNum <= elem_num; i += kNeonFloatNum) {
+    float32x4_t data = vld1q_f32(src + i);
+    min_vec = vminq_f32(min_vec, data);
+    max_vec = vmaxq_f32(max_vec, data);
+  }
+  float min_value = vminvq_f32(min_vec);
+  float max_value = vmaxvq_f32(max_vec);
+  for (; i < elem_num; i++) {
+    min_value = src[i] < min_value ? src[i] : min_value;
+    max_value = src[i] > max_value ? src[i] : max_value;
+  }
+  *min_val = min_value;
+  *max_val = max_value;
+}
+
+void QuantizeNeon(const float *src, size_t elem_num, float min_val, float inv_scale, uint8_t max_code,
+                  uint8_t code_offset, uint8_t *codes) {
+  constexpr size_t kNeonByteNum = 8;
+  size_t i = 0;
+  float32x4_t min_vec = vdupq_n_f32(min_val);
+  float32x4_t zero_vec = vdupq_n_f32(0.0f);
+  float32x4_t max_code_vec = vdupq_n_f32(static_cast<float>(max_code));
+  uint8x8_t offset_vec = vdup_n_u8(code_offset);
+  for (; i + kNeonByteNum <= elem_num; i += kNeonByteNum) {
+    float32x4_t code_low = vmulq_n_f32(vsubq_f32(vld1q_f32(src + i), min_vec), inv_scale);
+    float32x4_t code_high = vmulq_n_f32(vsubq_f32(vld1q_f32(src + i + kNeonFloatNum), min_vec), inv_scale);
+    code_low = vminq_f32(vmaxq_f32(code_low, zero_vec), max_code_vec);
+    code_high = vminq_f32(vmaxq_f32(code_high, zero_vec), max_code_vec);
+    uint16x8_t code16 = vcombine_u16(vqmovun_s32(vcvtnq_s32_f32(code_low)), vqmovun_s32(vcvtnq_s32_f32(code_high)));
+    vst1_u8(codes + i, vsub_u8(vqmovn_u16(code16), offset_vec));
+  }
+  QuantizeScalar(src + i, elem_num - i, min_val, inv_scale, max_code, code_offset, codes + i);
+}
+
+void DequantizeNeon(const uint8_t *codes, size_t elem_num, float min_val, float scale, uint8_t code_offset,
+                    float *dst) {
+  constexpr size_t kNeonByteNum = 8;
+  size_t i = 0;
+  float32x4_t min_vec = vdupq_n_f32(min_val);
+  uint8x8_t offset_vec = vdup_n_u8(code_offset);
+  for (; i + kNeonByteNum <= elem_num; i += kNeonByteNum) {
+    uint16x8_t code16 = vmovl_u8(vadd_u8(vld1_u8(codes + i), offset_vec));
+    float32x4_t code_low = vcvtq_f32_u32(vmovl_u16(vget_low_u16(code16)));
+    float32x4_t code_high = vcvtq_f32_u32(vmovl_u16(vget_high_u16(code16)));
+    vst1q_f32(dst + i, vaddq_f32(vmulq_n_f32(code_low, scale), min_vec));
+    vst1q_f32(dst + i + kNeonFloatNum, vaddq_f32(vmulq_n_f32(code_high, scale), min_vec));
+  }
+  DequantizeScalar(codes + i, elem_num - i, min_val, scale, code_offset, dst + i);
+}
+#endif
+
+SimdLevel DetectSimdLevel() {
+#if defined(FL_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::kAvx2;
+  }
+  return SimdLevel::kScalar;
+#elif defined(FL_SIMD_NEON)
+  return SimdLevel::kNeon;
+#else
+  return SimdLevel::kScalar;
+#endif
+}
+
+// Returns level if the running cpu supports it, otherwise kScalar.
+SimdLevel SupportedLevel(SimdLevel level) {
+  auto best_level = GetSimdLevel();
+  if (level == best_level) {
+    return level;
+  }
+  if (level == SimdLevel::kAvx2 && best_level == SimdLevel::kAvx512) {
+    return level;
+  }
+  return SimdLevel::kScalar;
+}
+}  // namespace
+
+SimdLevel GetSimdLevel() {
+  static const SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
+const char *SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kNeon:
+      return "NEON";
+    case SimdLevel::kAvx2:
+      return "AVX2";
+    case SimdLevel::kAvx512:
+      return "AVX512";
+    default:
+      return "SCALAR";
+  }
+}
+
+void Add(float *dst, const float *src, size_t elem_num) { Add(dst, src, elem_num, GetSimdLevel()); }
+
+void Scale(float *dst, float scale, size_t elem_num) { Scale(dst, scale, elem_num, GetSimdLevel()); }
+
+void AddScaled(float *dst, const float *src, float weight, size_t elem_num) {
+  AddScaled(dst, src, weight, elem_num, GetSimdLevel());
+}
+
+void MinMax(const float *src, size_t elem_num, float *min_val, float *max_val) {
+  MinMax(src, elem_num, min_val, max_val, GetSimdLevel());
+}
+
+void Quantize(const float *src, size_t elem_num, float min_val, float inv_scale, uint8_t max_code,
+              uint8_t code_offset, uint8_t *codes) {
+  Quantize(src, elem_num, min_val, inv_scale, max_code, code_offset, codes, GetSimdLevel());
+}
+
+void Dequantize(const uint8_t *codes, size_t elem_num, float min_val, float scale, uint8_t code_offset, float *dst) {
+  Dequantize(codes, elem_num, min_val, scale, code_offset, dst, GetSimdLevel());
+}
+
+void Add(float *dst, const float *src, size_t elem_num, SimdLevel level) {
+  switch (SupportedLevel(level)) {
+#ifdef FL_SIMD_X86
+    case SimdLevel::kAvx512:
+      return AddAvx512(dst, src, elem_num);
+    case SimdLevel::kAvx2:
+      return AddAvx2(dst, src, elem_num);
+#endif
+#ifdef FL_SIMD_NEON
+    case SimdLevel::kNeon:
+      return AddNeon(dst, src, elem_num);
+#endif
+    default:
+      return AddScalar(dst, src, elem_num);
+  }
+}
+
+void Scale(float *dst, float scale, size_t elem_num, SimdLevel level) {
+  switch (SupportedLevel(level)) {
+#ifdef FL_SIMD_X86
+    case SimdLevel::kAvx512:
+      return ScaleAvx512(dst, scale, elem_num);
+    case SimdLevel::kAvx2:
+      return ScaleAvx2(dst, scale, elem_num);
+#endif
+#ifdef FL_SIMD_NEON
+    case SimdLevel::kNeon:
+      return ScaleNeon(dst, scale, elem_num);
+#endif
+    default:
+      return ScaleScalar(dst, scale, elem_num);
+  }
+}
+
+void AddScaled(float *dst, const float *src, float weight, size_t elem_num, SimdLevel level) {
+  switch (SupportedLevel(level)) {
+#ifdef FL_SIMD_X86
+    case SimdLevel::kAvx512:
+      return AddScaledAvx512(dst, src, weight, elem_num);
+    case SimdLevel::kAvx2:
+      return AddScaledAvx2(dst, src, weight, elem_num);
+#endif
+#ifdef FL_SIMD_NEON
+    case SimdLevel::kNeon:
+      return AddScaledNeon(dst, src, weight, elem_num);
+#endif
+    default:
+      return AddScaledScalar(dst, src, weight, elem_num);
+  }
+}
+
+void MinMax(const float *src, size_t elem_num, float *min_val, float *max_val, SimdLevel level) {
+  switch (SupportedLevel(level)) {
+#ifdef FL_SIMD_X86
+    case SimdLevel::kAvx512:
+      return MinMaxAvx512(src, elem_num, min_val, max_val);
+    case SimdLevel::kAvx2:
+      return MinMaxAvx2(src, elem_num, min_val, max_val);
+#endif
+#ifdef FL_SIMD_NEON
+    case SimdLevel::kNeon:
+      return MinMaxNeon(src, elem_num, min_val, max_val);
+#endif
+    default:
+      return MinMaxScalar(src, elem_num, min_val, max_val);
+  }
+}
+
+void Quantize(const float *src, size_t elem_num, float min_val, float inv_scale, uint8_t max_code,
+              uint8_t code_offset, uint8_t *codes, SimdLevel level) {
+  switch (SupportedLevel(level)) {
+#ifdef FL_SIMD_X86
+    case SimdLevel::kAvx512:
+      return QuantizeAvx512(src, elem_num, min_val, inv_scale, max_code, code_offset, codes);
+    case SimdLevel::kAvx2:
+      return QuantizeAvx2(src, elem_num, min_val, inv_scale, max_code, code_offset, codes);
+#endif
+#ifdef FL_SIMD_NEON
+    case SimdLevel::kNeon:
+      return QuantizeNeon(src, elem_num, min_val, inv_scale, max_code, code_offset, codes);
+#endif
+    default:
+      return QuantizeScalar(src, elem_num, min_val, inv_scale, max_code, code_offset, codes);
+  }
+}
+
+void Dequantize(const uint8_t *codes, size_t elem_num, float min_val, float scale, uint8_t code_offset, float *dst,
+                SimdLevel level) {
+  switch (SupportedLevel(level)) {
+#ifdef FL_SIMD_X86
+    case SimdLevel::kAvx512:
+      return DequantizeAvx512(codes, elem_num, min_val, scale, code_offset, dst);
+    case SimdLevel::kAvx2:
+      return DequantizeAvx2(codes, elem_num, min_val, scale, code_offset, dst);
+#endif
+#ifdef FL_SIMD_NEON
+    case SimdLevel::kNeon:
+      return DequantizeNeon(codes, elem_num, min_val, scale, code_offset, dst);
+#endif
+    default:
+      return DequantizeScalar(codes, elem_num, min_val, scale, code_offset, dst);
+  }
+}
+}  // namespace simd
+}  // namespace fl
+}  // namespace mindspore
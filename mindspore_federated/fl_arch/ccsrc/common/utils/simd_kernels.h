@@ -0,0 +1,65 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_FEDERATED_COMMON_UTILS_SIMD_KERNELS_H_
+#define MINDSPORE_FEDERATED_COMMON_UTILS_SIMD_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include "common/utils/visible.h"
+
+namespace mindspore {
+namespace fl {
+namespace simd {
+// Instruction sets the float kernels below can run on. The best level supported by the running cpu is picked once at
+// runtime, so the library is still built for the baseline architecture.
+enum class SimdLevel { kScalar = 0, kNeon, kAvx2, kAvx512 };
+
+// Returns the best instruction set supported by the running cpu.
+MS_EXPORT SimdLevel GetSimdLevel();
+
+MS_EXPORT const char *SimdLevelName(SimdLevel level);
+
+// dst[i] += src[i]
+MS_EXPORT void Add(float *dst, const float *src, size_t elem_num);
+// dst[i] *= scale
+MS_EXPORT void Scale(float *dst, float scale, size_t elem_num);
+// dst[i] += src[i] * weight
+MS_EXPORT void AddScaled(float *dst, const float *src, float weight, size_t elem_num);
+
+// Minimum and maximum of src, elem_num must be positive.
+MS_EXPORT void MinMax(const float *src, size_t elem_num, float *min_val, float *max_val);
+// codes[i] = uint8_t(clamp(round((src[i] - min_val) * inv_scale), 0, max_code) - code_offset), rounding half to even.
+MS_EXPORT void Quantize(const float *src, size_t elem_num, float min_val, float inv_scale, uint8_t max_code,
+                        uint8_t code_offset, uint8_t *codes);
+// dst[i] = uint8_t(codes[i] + code_offset) * scale + min_val
+MS_EXPORT void Dequantize(const uint8_t *codes, size_t elem_num, float min_val, float scale, uint8_t code_offset,
+                          float *dst);
+
+// Same as above but run on the given instruction set, which falls back to the scalar one if the cpu can't run
+// it. Used by tests to compare every implementation against the scalar one.
+MS_EXPORT void Add(float *dst, const float *src, size_t elem_num, SimdLevel level);
+MS_EXPORT void Scale(float *dst, float scale, size_t elem_num, SimdLevel level);
+MS_EXPORT void AddScaled(float *dst, const float *src, float weight, size_t elem_num, SimdLevel level);
+MS_EXPORT void MinMax(const float *src, size_t elem_num, float *min_val, float *max_val, SimdLevel level);
+MS_EXPORT void Quantize(const float *src, size_t elem_num, float min_val, float inv_scale, uint8_t max_code,
+                        uint8_t code_offset, uint8_t *codes, SimdLevel level);
+MS_EXPORT void Dequantize(const uint8_t *codes, size_t elem_num, float min_val, float scale, uint8_t code_offset,
+                          float *dst, SimdLevel level);
+}  // namespace simd
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_FEDERATED_COMMON_UTILS_SIMD_KERNELS_H_
@@ -15,53 +15,74 @@
  */
 
 #include "compression/decode_executor.h"
+#include "common/utils/simd_kernels.h"
 
 namespace mindspore {
 namespace fl {
 namespace compression {
-std::vector<int> DecodeExecutor::ConstructMaskArray(int seed, float upload_sparse_rate, size_t param_num) {
-  static int multiplier = 2147483647;
-  static double increment = 4294967294.0;
-  static int modulo = 48271;
-  static double carry = 0.5;
-  size_t retain_num = size_t(static_cast<float>(param_num) * upload_sparse_rate);
-  if (retain_num == 0) {
-    MS_LOG(WARNING) << "The retain_num is 0, and upload_sparse_rate is too small.";
+namespace {
+constexpr size_t kMaxSparseMaskCacheNum = 4;
+}  // namespace
+
+SparseMaskPtr DecodeExecutor::ConstructMaskArray(int version, int seed, float upload_sparse_rate, size_t param_num) {
+  if (version != kSparseMaskLehmer && version != kSparseMaskCounter) {
+    MS_LOG(WARNING) << "The sparse mask version " << version << " is not supported.";
+    return nullptr;
+  }
+  SparseMaskKey key{version, seed, upload_sparse_rate, param_num};
+  std::promise<SparseMaskPtr> promise;
+  {
+    std::unique_lock<std::mutex> lock(mask_mutex_);
+    for (auto it = mask_cache_.begin(); it != mask_cache_.end(); ++it) {
+      if (it->first == key) {
+        auto mask = it->second;
+        (void)mask_cache_.erase(it);
+        (void)mask_cache_.emplace(mask_cache_.begin(), key, mask);
+        lock.unlock();
+        return mask.get();
+      }
+    }
+    if (mask_cache_.size() >= kMaxSparseMaskCacheNum) {
+      mask_cache_.pop_back();
+    }
+    (void)mask_cache_.emplace(mask_cache_.begin(), key, promise.get_future().share());
   }
-  std::vector<int> mask_array(param_num, 0);
-  for (size_t i = 0; i < retain_num; ++i) {
-    mask_array[i] = 1;
+  // Construct without the lock, so uploads of other masks are not blocked by it.
+  SparseMaskPtr mask = nullptr;
+  try {
+    mask = ConstructSparseMask(version, seed, upload_sparse_rate, param_num);
+  } catch (const std::exception &e) {
+    MS_LOG(WARNING) << "Failed to construct the sparse mask: " << e.what();
   }
-
-  seed = ((seed + multiplier) * modulo) % multiplier;
-  for (size_t i = 0; i < param_num; ++i) {
-    // generate random number in (0, 1)
-    double rand = static_cast<double>(seed) / increment + carry;
-    // update seed
-    seed = (seed * modulo) % multiplier;
-    size_t j = size_t(rand * static_cast<double>(param_num - i)) + i;
-    int temp = mask_array[i];
-    mask_array[i] = mask_array[j];
-    mask_array[j] = temp;
+  if (mask == nullptr) {
+    std::unique_lock<std::mutex> lock(mask_mutex_);
+    (void)mask_cache_.erase(std::remove_if(mask_cache_.begin(), mask_cache_.end(),
+                                           [&key](const auto &item) { return item.first == key; }),
+                            mask_cache_.end());
   }
-  return mask_array;
+  promise.set_value(mask);
+  return mask;
+}
+
+bool DecodeExecutor::DeQuantMinMax(const CompressFeatureMap &compress_feature_map, size_t num_bits,
+                                   std::vector<float> *output) {
+  return DequantizeMinMax(compress_feature_map, num_bits, output);
 }
 
 bool DecodeExecutor::DeQuantSparseDiff(std::map<std::string, std::vector<float>> *weight_map,
                                        const std::vector<CompressFeatureMap> &compress_feature_maps, size_t num_bits,
-                                       float upload_sparse_rate, int seed, const std::vector<std::string> &name_vec,
-                                       size_t data_size) {
+                                       float upload_sparse_rate, int seed, int mask_version,
+                                       const std::vector<std::string> &name_vec, size_t data_size) {
   std::vector<std::vector<float>> decompress_feature_maps;
 
   // origin parameters
   std::vector<size_t> shape_vec;
   size_t param_num = 0;
   auto model = mindspore::fl::server::ModelStore::GetInstance().GetLatestModel().second;
-  if (model == nullptr || model->weight_data.empty()) {
+  if (model == nullptr || model->empty()) {
     MS_LOG_WARNING << "Failed to get latest model";
     return false;
   }
-  auto weight_data_base = model->weight_data.data();
   // get shape vector and number of upload parameters
   for (const auto &name : name_vec) {
     auto it = model->weight_items.find(name);
@@ -76,33 +97,36 @@ bool DecodeExecutor::DeQuantSparseDiff(std::map<std::string, std::vector<float>>
   MS_LOG(DEBUG) << "Compression get last weights success!";
 
   // quant decode
-  auto temp1 = static_cast<float>(1 << num_bits) - 1.0f;
-  auto temp2 = static_cast<float>(1 << (num_bits - 1));
   std::vector<float> de_min_max_feature_map;
-  for (auto compress_feature_map : compress_feature_maps) {
-    float min_val = compress_feature_map.min_val;
-    float max_val = compress_feature_map.max_val;
-    float scale_val = static_cast<float>(max_val - min_val) / temp1 + 1e-10f;
-    size_t size = compress_feature_map.compress_data.size();
-    for (size_t i = 0; i < size; ++i) {
-      de_min_max_feature_map.emplace_back(
-        (static_cast<float>(compress_feature_map.compress_data[i]) + temp2) * scale_val + min_val);
+  size_t compress_data_size = 0;
+  for (const auto &compress_feature_map : compress_feature_maps) {
+    compress_data_size += compress_feature_map.compress_data.size();
+  }
+  if (num_bits != 0) {
+    de_min_max_feature_map.reserve(compress_data_size * (kQuantBitsPerByte / num_bits));
+  }
+  for (const auto &compress_feature_map : compress_feature_maps) {
+    if (!DeQuantMinMax(compress_feature_map, num_bits, &de_min_max_feature_map)) {
+      return false;
     }
   }
   MS_LOG(DEBUG) << "Compression quant decode success!";
 
   // sparse decode
-  std::vector<int> mask_array = ConstructMaskArray(seed, upload_sparse_rate, param_num);
+  auto mask_array = ConstructMaskArray(mask_version, seed, upload_sparse_rate, param_num);
+  if (mask_array == nullptr) {
+    return false;
+  }
   size_t index = 0;
   size_t de_min_max_feature_map_index = 0;
   for (const auto &shape : shape_vec) {
     std::vector<float> feature_map(shape);
     for (size_t i = 0; i < shape; ++i) {
-      if (index >= mask_array.size()) {
+      if (index >= mask_array->param_num()) {
         MS_LOG(WARNING) << "The mask_array and parameter shape is not matched.";
         return false;
       }
-      if (mask_array[index] == 1) {
+      if (mask_array->Get(index)) {
         if (de_min_max_feature_map_index >= de_min_max_feature_map.size()) {
           MS_LOG(WARNING) << "The number of upload parameters is too small.";
           return false;
@@ -114,7 +138,7 @@ bool DecodeExecutor::DeQuantSparseDiff(std::map<std::string, std::vector<float>>
       }
       index += 1;
     }
-    decompress_feature_maps.emplace_back(feature_map);
+    decompress_feature_maps.emplace_back(std::move(feature_map));
   }
   MS_LOG(DEBUG) << "Compression sparse decode success!";
 
@@ -122,12 +146,14 @@ bool DecodeExecutor::DeQuantSparseDiff(std::map<std::string, std::vector<float>>
   for (size_t i = 0; i < decompress_feature_maps.size(); ++i) {
     size_t feature_size = decompress_feature_maps[i].size();
     std::string name = name_vec[i];
-    float *weight_data = reinterpret_cast<float *>(weight_data_base + model->weight_items[name].offset);
-    auto &weight_item = (*weight_map)[name];
-    weight_item.resize(feature_size);
-    for (size_t j = 0; j < feature_size; ++j) {
-      weight_item[j] = decompress_feature_maps[i][j] + data_size * weight_data[j];
+    auto weight_data = reinterpret_cast<const float *>(model->weight_addr(model->weight_items[name]));
+    if (weight_data == nullptr) {
+      MS_LOG_WARNING << "Failed to find data of parameter " << name;
+      return false;
     }
+    auto &weight_item = (*weight_map)[name];
+    weight_item = std::move(decompress_feature_maps[i]);
+    simd::AddScaled(weight_item.data(), weight_data, static_cast<float>(data_size), feature_size);
   }
   MS_LOG(DEBUG) << "Compression difference decode success!";
 
@@ -137,9 +163,10 @@ bool DecodeExecutor::DeQuantSparseDiff(std::map<std::string, std::vector<float>>
 bool DecodeExecutor::Decode(std::map<std::string, std::vector<float>> *weight_map,
                             const std::vector<CompressFeatureMap> &compress_feature_maps,
                             schema::CompressType upload_compress_type, float upload_sparse_rate, int seed,
-                            const std::vector<std::string> &name_vec, size_t data_size) {
+                            int mask_version, const std::vector<std::string> &name_vec, size_t data_size) {
   if (upload_compress_type == schema::CompressType_DIFF_SPARSE_QUANT) {
-    return DeQuantSparseDiff(weight_map, compress_feature_maps, 8, upload_sparse_rate, seed, name_vec, data_size);
+    return DeQuantSparseDiff(weight_map, compress_feature_maps, 8, upload_sparse_rate, seed, mask_version, name_vec,
+                             data_size);
   }
   return false;
 }
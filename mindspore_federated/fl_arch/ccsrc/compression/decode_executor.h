@@ -24,26 +24,23 @@
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <future>
 #include <algorithm>
 #include <regex>
 #include <map>
+#include <mutex>
 #include <utility>
 #include "schema/fl_job_generated.h"
 #include "schema/cipher_generated.h"
 #include "server/model_store.h"
 #include "common/common.h"
 #include "common/fl_context.h"
+#include "compression/quantization.h"
+#include "compression/sparse_mask.h"
 
 namespace mindspore {
 namespace fl {
 namespace compression {
-struct CompressFeatureMap {
-  std::string weight_fullname;
-  std::vector<int8_t> compress_data;
-  float min_val;
-  float max_val;
-};
-
 class DecodeExecutor {
  public:
   static DecodeExecutor &GetInstance() {
@@ -51,21 +48,42 @@ class DecodeExecutor {
     return instance;
   }
 
-  // construct mask array for random sparse
-  std::vector<int> ConstructMaskArray(int seed, float upload_sparse_rate, size_t param_num);
+  // construct mask array for random sparse, the mask of the same parameters is shared by all clients of an
+  // iteration, so the recently used masks are cached
+  SparseMaskPtr ConstructMaskArray(int version, int seed, float upload_sparse_rate, size_t param_num);
+
+  // decode min_max quantization of num_bits by DequantizeMinMax, the decoded values are appended to output
+  bool DeQuantMinMax(const CompressFeatureMap &compress_feature_map, size_t num_bits, std::vector<float> *output);
 
   // decode min_max quantization and random sparse and parameter difference
   bool DeQuantSparseDiff(std::map<std::string, std::vector<float>> *weight_map,
                          const std::vector<CompressFeatureMap> &compress_feature_maps, size_t num_bits,
-                         float upload_sparse_rate, int seed, const std::vector<std::string> &name_vec,
-                         size_t data_size);
+                         float upload_sparse_rate, int seed, int mask_version,
+                         const std::vector<std::string> &name_vec, size_t data_size);
 
   // decode
   bool Decode(std::map<std::string, std::vector<float>> *weight_map,
               const std::vector<CompressFeatureMap> &compress_feature_maps, schema::CompressType upload_compress_type,
-              float upload_sparse_rate, int seed, const std::vector<std::string> &name_vec, size_t data_size);
+              float upload_sparse_rate, int seed, int mask_version, const std::vector<std::string> &name_vec,
+              size_t data_size);
 
   schema::CompressType GetCompressType(schema::CompressType upload_compress_type);
+
+ private:
+  struct SparseMaskKey {
+    int version;
+    int seed;
+    float upload_sparse_rate;
+    size_t param_num;
+    bool operator==(const SparseMaskKey &other) const {
+      return version == other.version && seed == other.seed && upload_sparse_rate == other.upload_sparse_rate &&
+             param_num == other.param_num;
+    }
+  };
+  std::mutex mask_mutex_;
+  // Most recently used first. A mask being constructed is in the cache too, so the other uploads of the iteration
+  // wait for it instead of constructing it again.
+  std::vector<std::pair<SparseMaskKey, std::shared_future<SparseMaskPtr>>> mask_cache_;
 };
 }  // namespace compression
 }  // namespace fl
@@ -36,60 +36,36 @@ bool CompressExecutor::EnableCompressWeight(const schema::CompressType compressT
 }
 
 bool CompressExecutor::construct_compress_weight(std::map<std::string, CompressWeight> *compressWeights,
-                                                 std::map<std::string, std::vector<float>> feature_maps,
+                                                 const std::map<std::string, Address> &feature_maps,
                                                  const schema::CompressType compressType) {
-  if (compressType == schema::CompressType_QUANT) {
-    return quant_min_max(compressWeights, feature_maps, kCompressTypeMap.at(compressType));
+  auto it = kCompressTypeMap.find(compressType);
+  if (it == kCompressTypeMap.end()) {
+    return false;
   }
-  return false;
+  // QUANT keeps one min/max pair per weight so that the existing clients can decode it.
+  size_t block_size = compressType == schema::CompressType_QUANT ? 0 : kQuantBlockSize;
+  return quant_min_max(compressWeights, feature_maps, it->second, block_size);
 }
 
 bool CompressExecutor::quant_min_max(std::map<std::string, CompressWeight> *compressWeights,
-                                     std::map<std::string, std::vector<float>> feature_maps, size_t num_bits) {
-  auto temp1 = static_cast<float>(1 << num_bits) - 1.0f;
-  auto temp2 = static_cast<float>(1 << (num_bits - 1));
+                                     const std::map<std::string, Address> &feature_maps, size_t num_bits,
+                                     size_t block_size) {
+  MS_ERROR_IF_NULL_W_RET_VAL(compressWeights, false);
   for (const auto &feature_map : feature_maps) {
-    std::string weight_name = feature_map.first;
-    float min_value = 1e10f;
-    float max_value = -min_value;
-    for (const auto &feature : feature_map.second) {
-      if (feature > max_value) {
-        max_value = feature;
-      }
-      if (feature < min_value) {
-        min_value = feature;
-      }
-    }
-    float scale_value = (max_value - min_value) / temp1 + 1e-10f;
-    size_t size = feature_map.second.size();
-    if (size == 0) {
-      MS_LOG(WARNING) << "The size of parameters is zero.";
-      return false;
-    }
+    auto weight = reinterpret_cast<const float *>(feature_map.second.addr);
+    size_t size = feature_map.second.size / sizeof(float);
     CompressWeight compressWeight;
-    for (size_t i = 0; i < size; ++i) {
-      auto round_data = round((feature_map.second[i] - min_value) / scale_value - temp2);
-      // bit pack can be implemented here in the future
-      auto int8_data = int8_t(round_data);
-      compressWeight.compress_data.emplace_back(int8_data);
+    if (!QuantizeMinMax(weight, size, num_bits, block_size, &compressWeight)) {
+      return false;
     }
-    compressWeight.min_val = min_value;
-    compressWeight.max_val = max_value;
-    compressWeight.compress_data_len = size;
-
-    (*compressWeights)[weight_name] = compressWeight;
+    (*compressWeights)[feature_map.first] = std::move(compressWeight);
   }
   return true;
 }
 
 schema::CompressType CompressExecutor::GetCompressType(const flatbuffers::Vector<int8_t> *download_compress_types) {
   schema::CompressType compressType = schema::CompressType_NO_COMPRESS;
-  schema::CompressType context_compress_type;
-  if (FLContext::instance()->compression_config().download_compress_type == kQuant) {
-    context_compress_type = schema::CompressType_QUANT;
-  } else {
-    context_compress_type = schema::CompressType_NO_COMPRESS;
-  }
+  schema::CompressType context_compress_type = GetContextCompressType();
   if (download_compress_types == nullptr) {
     MS_LOG(DEBUG) << "The client does not support current download compress type.";
   } else {
@@ -103,6 +79,58 @@ schema::CompressType CompressExecutor::GetCompressType(const flatbuffers::Vector
   }
   return compressType;
 }
+
+schema::CompressType CompressExecutor::GetContextCompressType() {
+  const auto &download_compress_type = FLContext::instance()->compression_config().download_compress_type;
+  if (download_compress_type == kQuant) {
+    return schema::CompressType_QUANT;
+  } else if (download_compress_type == kQuant4Bit) {
+    return schema::CompressType_QUANT_4BIT;
+  } else if (download_compress_type == kQuant2Bit) {
+    return schema::CompressType_QUANT_2BIT;
+  }
+  return schema::CompressType_NO_COMPRESS;
+}
+
+std::vector<flatbuffers::Offset<schema::CompressFeatureMap>> CompressExecutor::CreateCompressFeatureMaps(
+  flatbuffers::FlatBufferBuilder *fbb, const std::map<std::string, AddressPtr> &compress_feature_maps,
+  schema::CompressType compressType) {
+  std::vector<flatbuffers::Offset<schema::CompressFeatureMap>> fbs_compress_feature_maps;
+  for (const auto &compress_feature_map : compress_feature_maps) {
+    const std::string &weight_name = compress_feature_map.first;
+    auto min_val_it = compress_feature_maps.find(weight_name + "." + kMinVal);
+    auto max_val_it = compress_feature_maps.find(weight_name + "." + kMaxVal);
+    auto data_size_it = compress_feature_maps.find(weight_name + "." + kDataSize);
+    // Only the compressed data of a weight has the min, max and data size entries.
+    if (min_val_it == compress_feature_maps.end() || max_val_it == compress_feature_maps.end() ||
+        data_size_it == compress_feature_maps.end()) {
+      continue;
+    }
+    const AddressPtr &compress_data_ptr = compress_feature_map.second;
+    auto fbs_compress_weight_fullname = fbb->CreateString(weight_name);
+    auto fbs_compress_weight_data =
+      fbb->CreateVector(reinterpret_cast<const int8_t *>(compress_data_ptr->addr), compress_data_ptr->size);
+    auto min_vals = reinterpret_cast<const float *>(min_val_it->second->addr);
+    auto max_vals = reinterpret_cast<const float *>(max_val_it->second->addr);
+    auto data_size = static_cast<int>(*reinterpret_cast<const size_t *>(data_size_it->second->addr));
+    size_t block_num = min_val_it->second->size / sizeof(float);
+    if (block_num == 0) {
+      continue;
+    }
+    if (compressType == schema::CompressType_QUANT) {
+      fbs_compress_feature_maps.push_back(schema::CreateCompressFeatureMap(
+        *fbb, fbs_compress_weight_fullname, fbs_compress_weight_data, *min_vals, *max_vals, data_size, data_size));
+      continue;
+    }
+    auto fbs_block_min_val = fbb->CreateVector(min_vals, block_num);
+    auto fbs_block_max_val = fbb->CreateVector(max_vals, block_num);
+    fbs_compress_feature_maps.push_back(schema::CreateCompressFeatureMap(
+      *fbb, fbs_compress_weight_fullname, fbs_compress_weight_data, *std::min_element(min_vals, min_vals + block_num),
+      *std::max_element(max_vals, max_vals + block_num), data_size, static_cast<int>(kQuantBlockSize),
+      fbs_block_min_val, fbs_block_max_val));
+  }
+  return fbs_compress_feature_maps;
+}
 }  // namespace compression
 }  // namespace fl
 }  // namespace mindspore
@@ -28,20 +28,14 @@
 #include "worker/worker_node.h"
 #include "communicator/tcp_communicator.h"
 #include "common/common.h"
+#include "compression/quantization.h"
 
 namespace mindspore {
 namespace fl {
 namespace compression {
 // compress type map: schema::CompressType -> num bits
-const std::map<schema::CompressType, size_t> kCompressTypeMap = {{schema::CompressType_QUANT, 8}};
-
-struct CompressWeight {
-  std::vector<int8_t> compress_data;
-  size_t compress_data_len;
-  float min_val;
-  float max_val;
-};
-
+const std::map<schema::CompressType, size_t> kCompressTypeMap = {
+  {schema::CompressType_QUANT, 8}, {schema::CompressType_QUANT_4BIT, 4}, {schema::CompressType_QUANT_2BIT, 2}};
 class CompressExecutor {
  public:
   static CompressExecutor &GetInstance() {
@@ -52,13 +46,22 @@ class CompressExecutor {
   bool EnableCompressWeight(const schema::CompressType compressType);
 
   bool construct_compress_weight(std::map<std::string, CompressWeight> *compressWeights,
-                                 std::map<std::string, std::vector<float>> feature_maps,
+                                 const std::map<std::string, Address> &feature_maps,
                                  const schema::CompressType compressType);
 
+  // Quantize each weight by QuantizeMinMax. The weights are float data referred by the addresses.
   bool quant_min_max(std::map<std::string, CompressWeight> *compressWeights,
-                     std::map<std::string, std::vector<float>> feature_maps, size_t num_bits);
+                     const std::map<std::string, Address> &feature_maps, size_t num_bits, size_t block_size);
 
   schema::CompressType GetCompressType(const flatbuffers::Vector<int8_t> *download_compress_types);
+
+  // The download compress type in the config.
+  schema::CompressType GetContextCompressType();
+
+  // Build the fbs feature maps from the compress model got by ModelStore::GetCompressModelByIterNum.
+  std::vector<flatbuffers::Offset<schema::CompressFeatureMap>> CreateCompressFeatureMaps(
+    flatbuffers::FlatBufferBuilder *fbb, const std::map<std::string, AddressPtr> &compress_feature_maps,
+    schema::CompressType compressType);
 };
 }  // namespace compression
 }  // namespace fl
@@ -0,0 +1,147 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compression/quantization.h"
+#include <algorithm>
+#include <utility>
+#include "common/utils/log_adapter.h"
+#include "common/utils/simd_kernels.h"
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+namespace {
+void PackCodes(const uint8_t *codes, size_t code_num, size_t num_bits, uint8_t *packed_data) {
+  size_t codes_per_byte = kQuantBitsPerByte / num_bits;
+  for (size_t i = 0; i < code_num; ++i) {
+    packed_data[i / codes_per_byte] |= static_cast<uint8_t>(codes[i] << ((i % codes_per_byte) * num_bits));
+  }
+}
+}  // namespace
+
+bool QuantizeMinMax(const float *weight, size_t size, size_t num_bits, size_t block_size,
+                    CompressWeight *compress_weight) {
+  MS_ERROR_IF_NULL_W_RET_VAL(compress_weight, false);
+  if (num_bits == 0 || kQuantBitsPerByte % num_bits != 0) {
+    MS_LOG(WARNING) << "The quant num bits " << num_bits << " is not supported.";
+    return false;
+  }
+  size_t codes_per_byte = kQuantBitsPerByte / num_bits;
+  if (block_size % codes_per_byte != 0) {
+    MS_LOG(WARNING) << "The quant block size " << block_size << " should be a multiple of " << codes_per_byte;
+    return false;
+  }
+  if (weight == nullptr || size == 0) {
+    MS_LOG(WARNING) << "The size of parameters is zero.";
+    return false;
+  }
+  auto max_code = static_cast<uint8_t>((1u << num_bits) - 1);
+  uint8_t code_offset = num_bits == kQuantBitsPerByte ? kQuant8BitCodeOffset : 0;
+  auto temp1 = static_cast<float>(max_code);
+  // Codes of sub byte quantization are packed from this buffer, so the whole weight is never expanded.
+  uint8_t codes[kQuantCodeChunkSize];
+  size_t real_block_size = block_size == 0 ? size : block_size;
+  size_t block_num = (size + real_block_size - 1) / real_block_size;
+  CompressWeight compressWeight;
+  compressWeight.compress_data.resize((size + codes_per_byte - 1) / codes_per_byte, 0);
+  compressWeight.block_size = real_block_size;
+  compressWeight.block_min_vals.resize(block_num);
+  compressWeight.block_max_vals.resize(block_num);
+  auto packed_data = reinterpret_cast<uint8_t *>(compressWeight.compress_data.data());
+  for (size_t block = 0; block < block_num; ++block) {
+    size_t begin = block * real_block_size;
+    size_t end = std::min(begin + real_block_size, size);
+    float min_value = 0.0f;
+    float max_value = 0.0f;
+    simd::MinMax(weight + begin, end - begin, &min_value, &max_value);
+    float scale_value = (max_value - min_value) / temp1 + 1e-10f;
+    float inv_scale_value = 1.0f / scale_value;
+    if (codes_per_byte == 1) {
+      simd::Quantize(weight + begin, end - begin, min_value, inv_scale_value, max_code, code_offset,
+                     packed_data + begin);
+    } else {
+      for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += kQuantCodeChunkSize) {
+        size_t chunk_size = std::min(kQuantCodeChunkSize, end - chunk_begin);
+        simd::Quantize(weight + chunk_begin, chunk_size, min_value, inv_scale_value, max_code, code_offset, codes);
+        PackCodes(codes, chunk_size, num_bits, packed_data + chunk_begin / codes_per_byte);
+      }
+    }
+    compressWeight.block_min_vals[block] = min_value;
+    compressWeight.block_max_vals[block] = max_value;
+  }
+  compressWeight.min_val =
+    *std::min_element(compressWeight.block_min_vals.begin(), compressWeight.block_min_vals.end());
+  compressWeight.max_val =
+    *std::max_element(compressWeight.block_max_vals.begin(), compressWeight.block_max_vals.end());
+  compressWeight.compress_data_len = size;
+  *compress_weight = std::move(compressWeight);
+  return true;
+}
+
+bool DequantizeMinMax(const CompressFeatureMap &compress_feature_map, size_t num_bits, std::vector<float> *output) {
+  MS_ERROR_IF_NULL_W_RET_VAL(output, false);
+  if (num_bits == 0 || kQuantBitsPerByte % num_bits != 0) {
+    MS_LOG(WARNING) << "The quant num bits " << num_bits << " is not supported.";
+    return false;
+  }
+  size_t codes_per_byte = kQuantBitsPerByte / num_bits;
+  auto code_mask = static_cast<uint8_t>((1u << num_bits) - 1);
+  uint8_t code_offset = num_bits == kQuantBitsPerByte ? kQuant8BitCodeOffset : 0;
+  auto temp1 = static_cast<float>(code_mask);
+  const auto &compress_data = compress_feature_map.compress_data;
+  size_t size = compress_feature_map.data_size == 0 ? compress_data.size() * codes_per_byte
+                                                     : compress_feature_map.data_size;
+  if (size > compress_data.size() * codes_per_byte) {
+    MS_LOG(WARNING) << "The compress data of " << compress_feature_map.weight_fullname << " is too short.";
+    return false;
+  }
+  bool has_block = compress_feature_map.block_size != 0 && !compress_feature_map.block_min_vals.empty();
+  size_t block_size = has_block ? compress_feature_map.block_size : size;
+  size_t block_num = block_size == 0 ? 0 : (size + block_size - 1) / block_size;
+  if (has_block && (block_size % codes_per_byte != 0 || compress_feature_map.block_min_vals.size() < block_num ||
+                    compress_feature_map.block_max_vals.size() < block_num)) {
+    MS_LOG(WARNING) << "The quant blocks of " << compress_feature_map.weight_fullname << " are invalid.";
+    return false;
+  }
+  auto packed_data = reinterpret_cast<const uint8_t *>(compress_data.data());
+  size_t output_offset = output->size();
+  output->resize(output_offset + size);
+  auto output_data = output->data() + output_offset;
+  uint8_t codes[kQuantCodeChunkSize];
+  for (size_t block = 0; block < block_num; ++block) {
+    float min_val = has_block ? compress_feature_map.block_min_vals[block] : compress_feature_map.min_val;
+    float max_val = has_block ? compress_feature_map.block_max_vals[block] : compress_feature_map.max_val;
+    float scale_val = static_cast<float>(max_val - min_val) / temp1 + 1e-10f;
+    size_t begin = block * block_size;
+    size_t end = std::min(begin + block_size, size);
+    if (codes_per_byte == 1) {
+      simd::Dequantize(packed_data + begin, end - begin, min_val, scale_val, code_offset, output_data + begin);
+      continue;
+    }
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += kQuantCodeChunkSize) {
+      size_t chunk_size = std::min(kQuantCodeChunkSize, end - chunk_begin);
+      auto chunk_data = packed_data + chunk_begin / codes_per_byte;
+      for (size_t i = 0; i < chunk_size; ++i) {
+        codes[i] = (chunk_data[i / codes_per_byte] >> ((i % codes_per_byte) * num_bits)) & code_mask;
+      }
+      simd::Dequantize(codes, chunk_size, min_val, scale_val, code_offset, output_data + chunk_begin);
+    }
+  }
+  return true;
+}
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
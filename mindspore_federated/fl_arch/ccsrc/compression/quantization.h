@@ -0,0 +1,71 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_COMPRESSION_QUANTIZATION_H_
+#define MINDSPORE_CCSRC_FL_COMPRESSION_QUANTIZATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+// Number of elements sharing one min/max pair in the bit packed quantization. QUANT uses one pair per weight.
+constexpr size_t kQuantBlockSize = 256;
+constexpr size_t kQuantBitsPerByte = 8;
+// 8 bits codes are stored minus this offset as int8.
+constexpr uint8_t kQuant8BitCodeOffset = 128;
+// Number of codes quantized or dequantized at a time before they are packed or after they are unpacked.
+constexpr size_t kQuantCodeChunkSize = 1024;
+
+struct CompressWeight {
+  std::vector<int8_t> compress_data;
+  // number of elements of the weight
+  size_t compress_data_len;
+  float min_val;
+  float max_val;
+  size_t block_size = 0;
+  std::vector<float> block_min_vals;
+  std::vector<float> block_max_vals;
+};
+
+struct CompressFeatureMap {
+  std::string weight_fullname;
+  std::vector<int8_t> compress_data;
+  float min_val;
+  float max_val;
+  // Set by the block quantization, see schema::CompressFeatureMap. Without blocks, every element of compress_data
+  // is one int8 code quantized with min_val and max_val.
+  size_t data_size = 0;
+  size_t block_size = 0;
+  std::vector<float> block_min_vals;
+  std::vector<float> block_max_vals;
+};
+
+// Quantize every block_size elements, or the whole weight if block_size is 0, with their own min and max, and pack
+// the num_bits codes into bytes. For 8 bits the code is stored minus 128 as int8 which is what the QUANT clients
+// expect.
+bool QuantizeMinMax(const float *weight, size_t size, size_t num_bits, size_t block_size,
+                    CompressWeight *compress_weight);
+
+// Decode min_max quantization of num_bits, the decoded values are appended to output.
+bool DequantizeMinMax(const CompressFeatureMap &compress_feature_map, size_t num_bits, std::vector<float> *output);
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_COMPRESSION_QUANTIZATION_H_
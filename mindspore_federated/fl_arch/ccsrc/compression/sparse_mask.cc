@@ -0,0 +1,124 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compression/sparse_mask.h"
+#include <algorithm>
+#include "common/parallel_for.h"
+#include "common/utils/log_adapter.h"
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+namespace {
+constexpr size_t kSparseMaskThreadNum = 8;
+// Words of the bitset generated by one task.
+constexpr size_t kSparseMaskGrainWords = 4096;
+constexpr uint64_t kSplitMixGamma = 0x9E3779B97F4A7C15ULL;
+
+uint64_t SplitMix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// The client computes with Java int, so products wrap around in 32 bits.
+int32_t WrapMul(int32_t a, int32_t b) {
+  return static_cast<int32_t>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b));
+}
+
+int32_t WrapAdd(int32_t a, int32_t b) {
+  return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+}  // namespace
+
+SparseMaskPtr ConstructSparseMask(int version, int seed, float upload_sparse_rate, size_t param_num) {
+  if (version == kSparseMaskLehmer) {
+    return ConstructLehmerMask(seed, upload_sparse_rate, param_num);
+  }
+  if (version == kSparseMaskCounter) {
+    return ConstructCounterMask(seed, upload_sparse_rate, param_num);
+  }
+  MS_LOG(WARNING) << "The sparse mask version " << version << " is not supported.";
+  return nullptr;
+}
+
+size_t SparseMask::Count() const {
+  size_t count = 0;
+  for (auto word : bits_) {
+    count += static_cast<size_t>(__builtin_popcountll(word));
+  }
+  return count;
+}
+
+SparseMaskPtr ConstructLehmerMask(int seed, float upload_sparse_rate, size_t param_num) {
+  static const int32_t multiplier = 2147483647;
+  static const double increment = 4294967294.0;
+  static const int32_t modulo = 48271;
+  static const double carry = 0.5;
+  size_t retain_num = size_t(static_cast<float>(param_num) * upload_sparse_rate);
+  if (retain_num == 0) {
+    MS_LOG(WARNING) << "The retain_num is 0, and upload_sparse_rate is too small.";
+  }
+  auto mask = std::make_shared<SparseMask>(param_num);
+  for (size_t i = 0; i < std::min(retain_num, param_num); ++i) {
+    mask->Set(i, true);
+  }
+
+  int32_t state = WrapMul(WrapAdd(seed, multiplier), modulo) % multiplier;
+  for (size_t i = 0; i < param_num; ++i) {
+    // generate random number in (0, 1)
+    double rand = static_cast<double>(state) / increment + carry;
+    // update seed
+    state = WrapMul(state, modulo) % multiplier;
+    size_t j = size_t(rand * static_cast<double>(param_num - i)) + i;
+    bool temp = mask->Get(i);
+    mask->Set(i, mask->Get(j));
+    mask->Set(j, temp);
+  }
+  return mask;
+}
+
+SparseMaskPtr ConstructCounterMask(int seed, float upload_sparse_rate, size_t param_num) {
+  auto mask = std::make_shared<SparseMask>(param_num);
+  uint64_t key = SplitMix64(static_cast<uint64_t>(static_cast<uint32_t>(seed)));
+  auto threshold = static_cast<uint64_t>(static_cast<double>(upload_sparse_rate) * 4294967296.0);
+  auto words = mask->words();
+  auto generate = [&](size_t begin, size_t end) {
+    for (size_t w = begin; w < end; ++w) {
+      size_t base = w * SparseMask::kBitsPerWord;
+      size_t bit_num = std::min(SparseMask::kBitsPerWord, param_num - base);
+      uint64_t word = 0;
+      for (size_t b = 0; b < bit_num; ++b) {
+        uint64_t rand = SplitMix64(key + (base + b + 1) * kSplitMixGamma);
+        word |= static_cast<uint64_t>((rand >> 32) < threshold) << b;
+      }
+      words[w] = word;
+    }
+  };
+  if (mask->word_num() <= kSparseMaskGrainWords) {
+    generate(0, mask->word_num());
+  } else {
+    ParallelSync parallel(kSparseMaskThreadNum);
+    parallel.parallel_for(0, mask->word_num(), kSparseMaskGrainWords, generate);
+  }
+  if (mask->Count() == 0) {
+    MS_LOG(WARNING) << "The retain_num is 0, and upload_sparse_rate is too small.";
+  }
+  return mask;
+}
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
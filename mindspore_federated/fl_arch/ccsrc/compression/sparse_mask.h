@@ -0,0 +1,75 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_COMPRESSION_SPARSE_MASK_H_
+#define MINDSPORE_CCSRC_FL_COMPRESSION_SPARSE_MASK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+// Versions of the algorithm generating the random sparse mask. The server advertises the newest version it supports
+// by ResponseFLJob.sparse_mask_version, and the client sends the version it used by
+// RequestUpdateModel.sparse_mask_version.
+// kSparseMaskLehmer: the first upload_sparse_rate * param_num elements are retained and shuffled by Fisher-Yates with
+// a Lehmer generator. It is sequential and kept for clients which don't send the version.
+// kSparseMaskCounter: element i is retained if the high 32 bits of SplitMix64(key + (i + 1) * kSplitMixGamma) are
+// less than upload_sparse_rate * 2^32, where key = SplitMix64(uint32(seed)). Every element is independent, so the
+// mask is computed in parallel, and the number of retained elements is binomial instead of exact.
+constexpr int kSparseMaskLehmer = 0;
+constexpr int kSparseMaskCounter = 1;
+
+// Random sparse mask of param_num elements stored as a bitset.
+class SparseMask {
+ public:
+  static constexpr size_t kBitsPerWord = 64;
+
+  explicit SparseMask(size_t param_num) : param_num_(param_num), bits_((param_num + kBitsPerWord - 1) / kBitsPerWord) {}
+
+  bool Get(size_t index) const { return (bits_[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1u; }
+  void Set(size_t index, bool value) {
+    uint64_t bit = uint64_t(1) << (index % kBitsPerWord);
+    if (value) {
+      bits_[index / kBitsPerWord] |= bit;
+    } else {
+      bits_[index / kBitsPerWord] &= ~bit;
+    }
+  }
+  size_t param_num() const { return param_num_; }
+  // Number of retained elements.
+  size_t Count() const;
+
+  uint64_t *words() { return bits_.data(); }
+  size_t word_num() const { return bits_.size(); }
+
+ private:
+  size_t param_num_;
+  std::vector<uint64_t> bits_;
+};
+using SparseMaskPtr = std::shared_ptr<const SparseMask>;
+
+// Constructs the mask of the version, the same as the client does. Returns nullptr if the version is not supported.
+SparseMaskPtr ConstructSparseMask(int version, int seed, float upload_sparse_rate, size_t param_num);
+SparseMaskPtr ConstructLehmerMask(int seed, float upload_sparse_rate, size_t param_num);
+SparseMaskPtr ConstructCounterMask(int seed, float upload_sparse_rate, size_t param_num);
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_COMPRESSION_SPARSE_MASK_H_
@@ -49,21 +49,20 @@ std::shared_ptr<FeatureItemPy> FeatureItemPy::CreateFeatureFromModel(const Model
   if (model == nullptr) {
     MS_LOG_EXCEPTION << "Model cannot be nullptr";
   }
-  if (model->weight_data.empty()) {
+  if (model->empty()) {
     MS_LOG_EXCEPTION << "Model weight data cannot be empty";
   }
   if (weight_item.type != "fp32") {
     MS_LOG_EXCEPTION << "Data type of model weight can be only be fp32";
   }
-  if (weight_item.offset < 0 || weight_item.size <= 0 ||
-      weight_item.offset + weight_item.size > model->weight_data.size()) {
+  auto data = model->weight_addr(weight_item);
+  if (weight_item.size <= 0 || data == nullptr) {
     MS_LOG_EXCEPTION << "Weight data offset or size is invalid, offset: " << weight_item.offset
                      << ", size: " << weight_item.size << ", model data size: " << model->weight_data.size();
   }
   const auto &tensor_shape = weight_item.shape;
   std::vector<ssize_t> shape(tensor_shape.begin(), tensor_shape.end());
   auto item_size = sizeof(float);
-  auto data = model->weight_data.data() + weight_item.offset;
   auto format = py::format_descriptor<float>::format();
 
   std::vector<ssize_t> strides = GetStrides(shape, static_cast<ssize_t>(item_size));
@@ -58,6 +58,34 @@ void InitVFLContext(const py::module &m) {
     .def("load_yaml_config", &VFLContext::LoadYamlConfig, "Load yaml config");
 }
 
+void SetTensorItemData(TensorItemPy *tensor, const py::array &data) {
+  auto array = py::array::ensure(data, py::array::c_style);
+  if (!array) {
+    MS_LOG_EXCEPTION << "The data of tensor " << tensor->ref_key() << " can't be converted to a contiguous array";
+  }
+  auto bytes = reinterpret_cast<const uint8_t *>(array.data());
+  tensor->set_raw_data(std::vector<uint8_t>(bytes, bytes + array.nbytes()));
+}
+
+py::array GetTensorItemData(const TensorItemPy &tensor) {
+  py::dtype dtype(tensor.dtype());
+  auto data = tensor.shared_raw_data();
+  auto item_size = static_cast<size_t>(dtype.itemsize());
+  if (item_size == 0 || data->size() % item_size != 0) {
+    MS_LOG_EXCEPTION << "The data size " << data->size() << " of tensor " << tensor.ref_key()
+                     << " is not a multiple of " << tensor.dtype() << " size";
+  }
+  // The array holds a reference of the data, so it stays valid after the item is destroyed. The data is shared by all
+  // copies of the item, so the array is read only.
+  using DataHolder = std::shared_ptr<const std::vector<uint8_t>>;
+  py::capsule base(new DataHolder(data), [](void *ptr) { delete static_cast<DataHolder *>(ptr); });
+  std::vector<ssize_t> shape = {static_cast<ssize_t>(data->size() / item_size)};
+  std::vector<ssize_t> strides = {static_cast<ssize_t>(item_size)};
+  py::array array(dtype, shape, strides, data->data(), base);
+  py::detail::array_proxy(array.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+  return array;
+}
+
 void InitTensorItemPy(const py::module &m) {
   (void)py::class_<TensorItemPy, std::shared_ptr<TensorItemPy>>(m, "TensorItem_")
     .def(py::init<>())
@@ -65,12 +93,12 @@ void InitTensorItemPy(const py::module &m) {
     .def("set_ref_key", &TensorItemPy::set_ref_key, "Get tensors.")
     .def("set_shape", &TensorItemPy::set_shape, "Set shape.")
     .def("set_dtype", &TensorItemPy::set_dtype, "Set dtype.")
-    .def("set_data", &TensorItemPy::set_data, "Set data.")
+    .def("set_data", &SetTensorItemData, "Set data by copying a numpy array.")
     .def("name", &TensorItemPy::name, "Get name.")
     .def("ref_key", &TensorItemPy::ref_key, "Get ref_key.")
     .def("shape", &TensorItemPy::shape, "Get shape.")
     .def("dtype", &TensorItemPy::dtype, "Get dtype.")
-    .def("data", &TensorItemPy::data, "Get data.");
+    .def("data", &GetTensorItemData, "Get data as a 1-D read only numpy array sharing memory with the item.");
 }
 
 void InitTensorListItemPy(const py::module &m) {
@@ -78,8 +106,11 @@ void InitTensorListItemPy(const py::module &m) {
     .def(py::init<>())
     .def(py::init<const std::string &, const std::vector<TensorItemPy> &, const std::vector<TensorListItemPy> &>())
     .def("name", &TensorListItemPy::name, "Get tensor list name.")
-    .def("tensors", &TensorListItemPy::tensors, "Get tensors.")
-    .def("tensorListItems", &TensorListItemPy::tensorListItems, "Get tensorListItems.")
+    // Copies of the items share the tensor data, while references to the elements of the vectors dangle once the
+    // vectors grow.
+    .def("tensors", &TensorListItemPy::tensors, py::return_value_policy::copy, "Get copies of tensors.")
+    .def("tensorListItems", &TensorListItemPy::tensorListItems, py::return_value_policy::copy,
+         "Get copies of tensorListItems.")
     .def("set_name", &TensorListItemPy::set_name, "Set name.")
     .def("add_tensor", &TensorListItemPy::add_tensor, "Add tensor.")
     .def("add_tensor_list_item", &TensorListItemPy::add_tensor_list_item, "Add tensor list item.");
@@ -88,7 +119,13 @@ void InitTensorListItemPy(const py::module &m) {
 // cppcheck-suppress syntaxError
 PYBIND11_MODULE(_mindspore_federated, m) {
   m.def("RunPSIDemo", &mindspore::fl::psi::RunPSIDemo, "run psi demo", py::arg("alice_list"), py::arg("bob_list"));
-  m.def("RunPSI", &mindspore::fl::psi::RunPSI, "run psi with communicate");
+  m.def("RunPSI", &mindspore::fl::psi::RunPSI, "run psi with communicate", py::arg("input_vct"), py::arg("com_role"),
+        py::arg("http_server_address"), py::arg("remote_server_address"), py::arg("thread_num"), py::arg("bin_id"),
+        py::arg("psi_type") = "filter_ecdh");
+  m.def("RunStreamingPSI", &mindspore::fl::psi::RunStreamingPSI, "run psi bin by bin over the ids in a file",
+        py::arg("input_path"), py::arg("output_path"), py::arg("com_role"), py::arg("http_server_address"),
+        py::arg("remote_server_address"), py::arg("thread_num"), py::arg("bin_num"),
+        py::arg("psi_type") = "filter_ecdh");
 
   (void)py::class_<FederatedJob, std::shared_ptr<FederatedJob>>(m, "Federated_")
     .def_static("start_federated_server", &FederatedJob::StartFederatedServer)
@@ -182,8 +219,10 @@ PYBIND11_MODULE(_mindspore_federated, m) {
 
   (void)py::class_<VerticalFederatedJob, std::shared_ptr<VerticalFederatedJob>>(m, "VerticalFederated_")
     .def_static("start_vertical_communicator", &VerticalFederatedJob::StartVerticalCommunicator)
-    .def_static("send", &VerticalFederatedJob::Send)
-    .def_static("receive", &VerticalFederatedJob::Receive);
+    .def_static("send", &VerticalFederatedJob::Send, py::call_guard<py::gil_scoped_release>())
+    .def_static("send_async", &VerticalFederatedJob::SendAsync, py::call_guard<py::gil_scoped_release>())
+    .def_static("flush", &VerticalFederatedJob::Flush, py::call_guard<py::gil_scoped_release>())
+    .def_static("receive", &VerticalFederatedJob::Receive, py::call_guard<py::gil_scoped_release>());
 
   InitVFLContext(m);
   InitTensorItemPy(m);
@@ -16,7 +16,9 @@
 
 #include "server/collective_ops_impl.h"
 #include <algorithm>
+#include <type_traits>
 #include <utility>
+#include "common/utils/simd_kernels.h"
 #include "server/local_meta_store.h"
 #include "distributed_cache/server.h"
 #include "distributed_cache/instance_context.h"
@@ -29,12 +31,111 @@ const char kCollectivePhaseRing[] = "ring";
 const char kCollectivePhaseGather[] = "gather";
 const char kCollectivePhaseReduce[] = "reduce";
 const char kCollectivePhaseBroadcast[] = "broadcast";
+const char kCollectivePhaseHalving[] = "halving";
+const char kCollectivePhaseDoubling[] = "doubling";
+// Ring chunks are pipelined in segments of about this many bytes.
+constexpr size_t kRingSegmentSize = 1 << 20;
+
+template <typename T>
+void ReduceSum(T *dst, const T *src, size_t count) {
+  if constexpr (std::is_same<T, float>::value) {
+    simd::Add(dst, src, count);
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      dst[i] += src[i];
+    }
+  }
+}
+
+class ServerNodeCommunicator : public CollectiveCommunicator {
+ public:
+  explicit ServerNodeCommunicator(const std::shared_ptr<ServerNode> &server_node) : server_node_(server_node) {}
+  ~ServerNodeCommunicator() override = default;
+
+  std::string node_id() const override { return server_node_->node_id(); }
+  std::shared_ptr<ResponseTrack> CollectiveSendAsync(const std::string &recv_address,
+                                                     const CollectiveMessageMeta &collective_meta, const void *data,
+                                                     size_t size) override {
+    return server_node_->CollectiveSendAsync(recv_address, collective_meta, data, size);
+  }
+  bool CollectiveRecvWait(const CollectiveMessageMeta &expect_meta, size_t expect_size, VectorPtr *output,
+                          const uint32_t &timeout) override {
+    return server_node_->CollectiveRecvWait(expect_meta, expect_size, output, timeout);
+  }
+  bool Wait(const std::shared_ptr<ResponseTrack> &request_track, const uint32_t &timeout) override {
+    return server_node_->Wait(request_track, timeout);
+  }
+
+ private:
+  std::shared_ptr<ServerNode> server_node_;
+};
 }  // namespace
 
 void CollectiveOpsImpl::Initialize(const std::shared_ptr<ServerNode> &server_node) {
   MS_EXCEPTION_IF_NULL(server_node);
-  server_node_ = server_node;
-  node_id_ = server_node_->node_id();
+  Initialize(std::make_shared<ServerNodeCommunicator>(server_node));
+}
+
+void CollectiveOpsImpl::Initialize(const std::shared_ptr<CollectiveCommunicator> &communicator) {
+  MS_EXCEPTION_IF_NULL(communicator);
+  communicator_ = communicator;
+  node_id_ = communicator_->node_id();
+}
+
+CollectiveMessageMeta CollectiveOpsImpl::CreateMessageMeta(const std::string &data_name, const std::string &phase,
+                                                           uint32_t for_index, size_t send_rank,
+                                                           size_t recv_rank) const {
+  CollectiveMessageMeta meta;
+  meta.set_enable_flag(true);
+  meta.set_send_node(server_nodes_[send_rank].first);
+  meta.set_recv_node(server_nodes_[recv_rank].first);
+  meta.set_iteration(cache::InstanceContext::Instance().iteration_num());
+  meta.set_weight_name(data_name);
+  meta.set_phase(phase);
+  meta.set_chunk_index(0);
+  meta.set_for_index(for_index);
+  return meta;
+}
+
+std::shared_ptr<ResponseTrack> CollectiveOpsImpl::SendAsync(const std::string &data_name, const std::string &phase,
+                                                            uint32_t for_index, size_t peer_rank, const void *data,
+                                                            size_t size) {
+  auto send_meta = CreateMessageMeta(data_name, phase, for_index, rank_id_, peer_rank);
+  return communicator_->CollectiveSendAsync(server_nodes_[peer_rank].second, send_meta, data, size);
+}
+
+bool CollectiveOpsImpl::Send(const std::string &data_name, const std::string &phase, uint32_t for_index,
+                             size_t peer_rank, const void *data, size_t size) {
+  auto send_req_id = SendAsync(data_name, phase, for_index, peer_rank, data, size);
+  if (!communicator_->Wait(send_req_id, kCollectiveCommTimeout)) {
+    MS_LOG(ERROR) << "Wait response of rank " << peer_rank << " failed, phase: " << phase;
+    return false;
+  }
+  return true;
+}
+
+bool CollectiveOpsImpl::Recv(const std::string &data_name, const std::string &phase, uint32_t for_index,
+                             size_t peer_rank, size_t expect_size, VectorPtr *output) {
+  auto recv_meta = CreateMessageMeta(data_name, phase, for_index, peer_rank, rank_id_);
+  if (!communicator_->CollectiveRecvWait(recv_meta, expect_size, output, kCollectiveCommTimeout)) {
+    MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
+    return false;
+  }
+  return true;
+}
+
+bool CollectiveOpsImpl::SendRecv(const std::string &data_name, const std::string &phase, uint32_t for_index,
+                                 size_t peer_rank, const void *send_data, size_t send_size, size_t expect_size,
+                                 VectorPtr *output) {
+  auto send_req_id = SendAsync(data_name, phase, for_index, peer_rank, send_data, send_size);
+  if (!Recv(data_name, phase, for_index, peer_rank, expect_size, output)) {
+    return false;
+  }
+  if (!communicator_->Wait(send_req_id, kCollectiveCommTimeout)) {
+    MS_LOG(ERROR) << "Wait response of rank " << peer_rank << " failed, phase: " << phase;
+    return false;
+  }
+  return true;
 }
 
 template <typename T>
@@ -83,7 +184,7 @@ template <typename T>
 bool CollectiveOpsImpl::RunRingAllReduce(const std::string &data_name, uint32_t send_to_rank, uint32_t recv_from_rank,
                                          const std::vector<size_t> &chunk_sizes,
                                          const std::vector<size_t> &chunk_offset, T *output_buff) {
-  MS_ERROR_IF_NULL_W_RET_VAL(server_node_, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(communicator_, false);
   MS_ERROR_IF_NULL_W_RET_VAL(output_buff, false);
   auto curr_iteration_num = cache::InstanceContext::Instance().iteration_num();
 
@@ -104,100 +205,87 @@ bool CollectiveOpsImpl::RunRingAllReduce(const std::string &data_name, uint32_t
   recv_meta.set_iteration(curr_iteration_num);
   recv_meta.set_weight_name(data_name);
 
-  // Ring ReduceScatter.
-  MS_LOG(DEBUG) << "Start Ring ReduceScatter.";
-  send_meta.set_phase(kCollectivePhaseRing);
-  recv_meta.set_phase(kCollectivePhaseRing);
-
+  // Every chunk is split into the same number of segments. A segment is forwarded to the next rank as soon as it's
+  // reduced, so the transfer of one segment overlaps with the receiving and reducing of the others.
+  size_t max_chunk_size = *std::max_element(chunk_sizes.begin(), chunk_sizes.end());
+  size_t segment_num = std::max<size_t>((max_chunk_size * sizeof(T) + kRingSegmentSize - 1) / kRingSegmentSize, 1);
+  auto get_segment = [&chunk_sizes, &chunk_offset, segment_num, output_buff](size_t chunk_index, size_t segment_index) {
+    size_t chunk_count = chunk_sizes[chunk_index];
+    size_t begin = chunk_count * segment_index / segment_num;
+    size_t end = chunk_count * (segment_index + 1) / segment_num;
+    return std::make_pair(output_buff + chunk_offset[chunk_index] + begin, end - begin);
+  };
+  // ReduceScatter takes the first rank_size_ - 1 steps and AllGather takes the rest. In both phases step i sends chunk
+  // (rank_id_ - i) and receives chunk (rank_id_ - i - 1), which is the chunk to send in step i + 1.
+  size_t reduce_scatter_step_num = rank_size_ - 1;
+  size_t step_num = 2 * reduce_scatter_step_num;
+  auto set_step = [reduce_scatter_step_num, segment_num](CollectiveMessageMeta *meta, size_t step,
+                                                          size_t chunk_index, size_t segment_index) {
+    bool is_reduce_scatter = step < reduce_scatter_step_num;
+    size_t for_index = is_reduce_scatter ? step : step - reduce_scatter_step_num;
+    meta->set_phase(is_reduce_scatter ? kCollectivePhaseRing : kCollectivePhaseGather);
+    meta->set_chunk_index(static_cast<uint32_t>(chunk_index));
+    meta->set_for_index(static_cast<uint32_t>(for_index * segment_num + segment_index));
+  };
   const auto &send_address = send_to_node.second;
-  for (size_t i = 0; i < rank_size_ - 1; i++) {
-    // Step 1: Async send data to next rank.
-    size_t send_chunk_index = (rank_id_ - i + rank_size_) % rank_size_;
-    T *send_chunk = output_buff + chunk_offset[send_chunk_index];
-    send_meta.set_chunk_index(send_chunk_index);
-    send_meta.set_for_index(i);
-    auto send_chunk_count = chunk_sizes[send_chunk_index];
-    auto send_req_id =
-      server_node_->CollectiveSendAsync(send_address, send_meta, send_chunk, send_chunk_count * sizeof(T));
-
-    // Step 2: Async receive data to next rank and wait until it's done.
-    size_t recv_chunk_index = (rank_id_ - i - 1 + rank_size_) % rank_size_;
-    recv_meta.set_chunk_index(recv_chunk_index);
-    recv_meta.set_for_index(i);
-    T *recv_chunk = output_buff + chunk_offset[recv_chunk_index];
-    auto recv_chunk_count = chunk_sizes[recv_chunk_index];
-    MS_LOG(DEBUG) << "Ring ReduceScatter send_to_rank:" << send_to_node.first
-                  << ", recv_from_rank:" << recv_from_node.first << ", send chunk index:" << send_chunk_index
-                  << ", send count:" << send_chunk_count << ", recv chunk index:" << recv_chunk_index
-                  << ", recv count:" << recv_chunk_count << ", for index:" << i;
+  auto send_segment = [&, this](size_t step, size_t segment_index) {
+    size_t send_chunk_index = (rank_id_ + step_num - step) % rank_size_;
+    auto segment = get_segment(send_chunk_index, segment_index);
+    set_step(&send_meta, step, send_chunk_index, segment_index);
+    return communicator_->CollectiveSendAsync(send_address, send_meta, segment.first, segment.second * sizeof(T));
+  };
 
-    VectorPtr recv_str;
-    auto expect_size = recv_chunk_count * sizeof(T);
-    if (!server_node_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
-      MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
-      return false;
-    }
-    auto tmp_recv_chunk = reinterpret_cast<T *>(recv_str->data());
-    // Step 3: Reduce the data so we can overlap the time cost of send.
-    for (size_t j = 0; j < recv_chunk_count; j++) {
-      recv_chunk[j] += tmp_recv_chunk[j];
-    }
-    // Step 4: Wait until send is done.
-    if (!server_node_->Wait(send_req_id, kCollectiveCommTimeout)) {
-      MS_LOG(ERROR) << "Wait response of rank " << send_req_id << " failed.";
-      return false;
-    }
+  MS_LOG(DEBUG) << "Start Ring AllReduce, send_to_rank:" << send_to_node.first
+                << ", recv_from_rank:" << recv_from_node.first << ", segment num:" << segment_num;
+  std::vector<std::shared_ptr<ResponseTrack>> pending_sends;
+  for (size_t j = 0; j < segment_num; j++) {
+    pending_sends.push_back(send_segment(0, j));
   }
-  MS_LOG(DEBUG) << "End Ring ReduceScatter.";
-
-  // Ring AllGather.
-  MS_LOG(DEBUG) << "Start Ring AllGather.";
-  send_meta.set_phase(kCollectivePhaseGather);
-  recv_meta.set_phase(kCollectivePhaseGather);
-  for (size_t i = 0; i < rank_size_ - 1; i++) {
-    size_t send_chunk_index = (rank_id_ - i + 1 + rank_size_) % rank_size_;
-    T *send_chunk = output_buff + chunk_offset[send_chunk_index];
-    send_meta.set_chunk_index(send_chunk_index);
-    send_meta.set_for_index(i);
-    auto send_chunk_count = chunk_sizes[send_chunk_index];
-    auto send_req_id =
-      server_node_->CollectiveSendAsync(send_address, send_meta, send_chunk, send_chunk_count * sizeof(T));
-
-    size_t recv_chunk_index = (rank_id_ - i + rank_size_) % rank_size_;
-    T *recv_chunk = output_buff + chunk_offset[recv_chunk_index];
-    recv_meta.set_chunk_index(recv_chunk_index);
-    recv_meta.set_for_index(i);
-    auto recv_chunk_count = chunk_sizes[recv_chunk_index];
-    MS_LOG(DEBUG) << "Ring AllGather send_to_rank:" << send_to_node.first << ", recv_from_rank:" << recv_from_node.first
-                  << ", send chunk index:" << send_chunk_index << ", send count:" << send_chunk_count
-                  << ", recv chunk index:" << recv_chunk_index << ", recv count:" << recv_chunk_count
-                  << ", for index:" << i;
-
-    VectorPtr recv_str;
-    auto expect_size = recv_chunk_count * sizeof(T);
-    if (!server_node_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
-      MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
-      return false;
-    }
-    auto ret = memcpy_s(recv_chunk, expect_size, recv_str->data(), recv_str->size());
-    if (ret != 0) {
-      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")"
-                    << ", dest size is " << recv_chunk_count * sizeof(T) << ", src size is " << recv_str->size();
-      return false;
+  for (size_t i = 0; i < step_num; i++) {
+    size_t recv_chunk_index = (rank_id_ + step_num - i - 1) % rank_size_;
+    std::vector<std::shared_ptr<ResponseTrack>> next_sends;
+    for (size_t j = 0; j < segment_num; j++) {
+      auto segment = get_segment(recv_chunk_index, j);
+      T *recv_segment = segment.first;
+      auto recv_count = segment.second;
+      set_step(&recv_meta, i, recv_chunk_index, j);
+      VectorPtr recv_str;
+      auto expect_size = recv_count * sizeof(T);
+      if (!communicator_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
+        MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
+        return false;
+      }
+      if (i < reduce_scatter_step_num) {
+        ReduceSum(recv_segment, reinterpret_cast<const T *>(recv_str->data()), recv_count);
+      } else if (expect_size != 0) {
+        auto ret = memcpy_s(recv_segment, expect_size, recv_str->data(), recv_str->size());
+        if (ret != 0) {
+          MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")"
+                        << ", dest size is " << expect_size << ", src size is " << recv_str->size();
+          return false;
+        }
+      }
+      if (i + 1 < step_num) {
+        next_sends.push_back(send_segment(i + 1, j));
+      }
     }
-    if (!server_node_->Wait(send_req_id, kCollectiveCommTimeout)) {
-      MS_LOG(ERROR) << "Wait response of rank " << send_req_id << " failed.";
-      return false;
+    // Keep at most two steps of sends in flight.
+    for (auto &send_req_id : pending_sends) {
+      if (!communicator_->Wait(send_req_id, kCollectiveCommTimeout)) {
+        MS_LOG(ERROR) << "Wait response of send to rank " << send_to_node.first << " failed.";
+        return false;
+      }
     }
+    pending_sends = std::move(next_sends);
   }
-  MS_LOG(DEBUG) << "End Ring AllGather.";
+  MS_LOG(DEBUG) << "End Ring AllReduce.";
   return true;
 }
 
 template <typename T>
 bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff,
                                                  size_t count) {
-  MS_ERROR_IF_NULL_W_RET_VAL(server_node_, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(communicator_, false);
   MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
   MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
   MS_LOG(DEBUG) << "Reduce Broadcast AllReduce rank_size:" << rank_size_ << ", rank_id:" << rank_id_
@@ -239,14 +327,12 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const std::string &data_name, c
       auto &send_node = server_nodes_[i];
       recv_meta.set_send_node(send_node.first);
       auto expect_size = count * sizeof(T);
-      if (!server_node_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
+      if (!communicator_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
         MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
         return false;
       }
       auto tmp_recv_chunk = reinterpret_cast<T *>(recv_str->data());  // recv_str size has checked in CollectiveWait
-      for (size_t j = 0; j < count; j++) {
-        output_buff[j] += tmp_recv_chunk[j];
-      }
+      ReduceSum(output_buff, tmp_recv_chunk, count);
     }
     MS_LOG(DEBUG) << "End Reduce.";
     MS_LOG(DEBUG) << "Start broadcast from rank 0 to other processes.";
@@ -256,8 +342,8 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const std::string &data_name, c
       auto &recv_node = server_nodes_[i];
       send_meta.set_recv_node(recv_node.first);
       auto send_req_id2 =
-        server_node_->CollectiveSendAsync(recv_node.second, send_meta, output_buff, count * sizeof(T));
-      if (!server_node_->Wait(send_req_id2, kCollectiveCommTimeout)) {
+        communicator_->CollectiveSendAsync(recv_node.second, send_meta, output_buff, count * sizeof(T));
+      if (!communicator_->Wait(send_req_id2, kCollectiveCommTimeout)) {
         MS_LOG(ERROR) << "Wait response of rank " << send_req_id2 << " failed.";
         return false;
       }
@@ -268,8 +354,8 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const std::string &data_name, c
     send_meta.set_phase(kCollectivePhaseReduce);
     auto &rank0_node = server_nodes_[0];
     send_meta.set_recv_node(rank0_node.first);
-    auto send_req_id1 = server_node_->CollectiveSendAsync(rank0_node.second, send_meta, sendbuff, count * sizeof(T));
-    if (!server_node_->Wait(send_req_id1, kCollectiveCommTimeout)) {
+    auto send_req_id1 = communicator_->CollectiveSendAsync(rank0_node.second, send_meta, sendbuff, count * sizeof(T));
+    if (!communicator_->Wait(send_req_id1, kCollectiveCommTimeout)) {
       MS_LOG(ERROR) << "Wait response of rank " << send_req_id1 << " failed.";
       return false;
     }
@@ -279,7 +365,7 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const std::string &data_name, c
     recv_meta.set_send_node(rank0_node.first);
     VectorPtr recv_str;
     auto expect_size = count * sizeof(T);
-    if (!server_node_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
+    if (!communicator_->CollectiveRecvWait(recv_meta, expect_size, &recv_str, kCollectiveCommTimeout)) {
       MS_LOG(ERROR) << "CollectiveRecvWait failed, send rank id: " << recv_meta.send_node();
       return false;
     }
@@ -294,6 +380,186 @@ bool CollectiveOpsImpl::ReduceBroadcastAllReduce(const std::string &data_name, c
   return true;
 }
 
+template <typename T>
+bool CollectiveOpsImpl::HalvingDoublingAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff,
+                                                 size_t count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(communicator_, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
+  size_t data_size = count * sizeof(T);
+  if (recvbuff != sendbuff) {
+    auto ret = memcpy_s(recvbuff, data_size, sendbuff, data_size);
+    if (ret != 0) {
+      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      return false;
+    }
+  }
+  T *output_buff = reinterpret_cast<T *>(recvbuff);
+  size_t pof2 = 1;
+  while (pof2 * 2 <= rank_size_) {
+    pof2 *= 2;
+  }
+  // When the rank size is not a power of two, each even rank of the first 2 * rem ranks hands its data to the next
+  // odd rank, and gets the result back after the other pof2 ranks finish the allreduce.
+  size_t rem = rank_size_ - pof2;
+  size_t new_rank = rank_id_ - rem;
+  if (rank_id_ < 2 * rem) {
+    VectorPtr recv_str;
+    if (rank_id_ % 2 == 0) {
+      if (!Send(data_name, kCollectivePhaseReduce, 0, rank_id_ + 1, output_buff, data_size) ||
+          !Recv(data_name, kCollectivePhaseBroadcast, 0, rank_id_ + 1, data_size, &recv_str)) {
+        return false;
+      }
+      auto ret = memcpy_s(output_buff, data_size, recv_str->data(), recv_str->size());
+      if (ret != 0) {
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        return false;
+      }
+      return true;
+    }
+    if (!Recv(data_name, kCollectivePhaseReduce, 0, rank_id_ - 1, data_size, &recv_str)) {
+      return false;
+    }
+    ReduceSum(output_buff, reinterpret_cast<const T *>(recv_str->data()), count);
+    new_rank = rank_id_ / 2;
+  }
+  auto to_rank = [rem](size_t rank) { return rank < rem ? rank * 2 + 1 : rank + rem; };
+  MS_LOG(DEBUG) << "Halving doubling AllReduce rank_size:" << rank_size_ << ", rank_id:" << rank_id_
+                << ", new rank:" << new_rank << ", count:" << count;
+
+  // Recursive halving ReduceScatter: exchange half of the current range with the peer and keep reducing the other
+  // half, until each rank owns count / pof2 reduced elements.
+  size_t begin = 0;
+  size_t end = count;
+  std::vector<std::pair<size_t, size_t>> ranges;
+  uint32_t for_index = 0;
+  for (size_t mask = pof2 / 2; mask > 0; mask /= 2, for_index++) {
+    size_t mid = begin + (end - begin) / 2;
+    bool keep_upper = (new_rank & mask) != 0;
+    size_t send_begin = keep_upper ? begin : mid;
+    size_t send_end = keep_upper ? mid : end;
+    ranges.emplace_back(begin, end);
+    begin = keep_upper ? mid : begin;
+    end = keep_upper ? end : mid;
+    VectorPtr recv_str;
+    if (!SendRecv(data_name, kCollectivePhaseHalving, for_index, to_rank(new_rank ^ mask), output_buff + send_begin,
+                  (send_end - send_begin) * sizeof(T), (end - begin) * sizeof(T), &recv_str)) {
+      return false;
+    }
+    ReduceSum(output_buff + begin, reinterpret_cast<const T *>(recv_str->data()), end - begin);
+  }
+  // Recursive doubling AllGather: walk the ranges back and exchange the reduced part with the same peers.
+  for_index = 0;
+  for (size_t mask = 1; mask < pof2; mask *= 2, for_index++) {
+    auto outer_range = ranges.back();
+    ranges.pop_back();
+    bool is_upper = (new_rank & mask) != 0;
+    size_t recv_begin = is_upper ? outer_range.first : end;
+    size_t recv_end = is_upper ? begin : outer_range.second;
+    size_t expect_size = (recv_end - recv_begin) * sizeof(T);
+    VectorPtr recv_str;
+    if (!SendRecv(data_name, kCollectivePhaseDoubling, for_index, to_rank(new_rank ^ mask), output_buff + begin,
+                  (end - begin) * sizeof(T), expect_size, &recv_str)) {
+      return false;
+    }
+    if (expect_size != 0) {
+      auto ret = memcpy_s(output_buff + recv_begin, expect_size, recv_str->data(), recv_str->size());
+      if (ret != 0) {
+        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+        return false;
+      }
+    }
+    begin = outer_range.first;
+    end = outer_range.second;
+  }
+  if (rank_id_ < 2 * rem) {
+    return Send(data_name, kCollectivePhaseBroadcast, 0, rank_id_ - 1, output_buff, data_size);
+  }
+  return true;
+}
+
+template <typename T>
+bool CollectiveOpsImpl::TreeAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff,
+                                      size_t count) {
+  MS_ERROR_IF_NULL_W_RET_VAL(communicator_, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
+  size_t data_size = count * sizeof(T);
+  if (recvbuff != sendbuff) {
+    auto ret = memcpy_s(recvbuff, data_size, sendbuff, data_size);
+    if (ret != 0) {
+      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      return false;
+    }
+  }
+  T *output_buff = reinterpret_cast<T *>(recvbuff);
+  MS_LOG(DEBUG) << "Tree AllReduce rank_size:" << rank_size_ << ", rank_id:" << rank_id_ << ", count:" << count;
+  // The children of rank i are rank 2i+1 and 2i+2.
+  std::vector<size_t> children;
+  for (size_t child = 2 * rank_id_ + 1; child <= 2 * rank_id_ + 2 && child < rank_size_; child++) {
+    children.push_back(child);
+  }
+  for (auto child : children) {
+    VectorPtr recv_str;
+    if (!Recv(data_name, kCollectivePhaseReduce, 0, child, data_size, &recv_str)) {
+      return false;
+    }
+    ReduceSum(output_buff, reinterpret_cast<const T *>(recv_str->data()), count);
+  }
+  if (rank_id_ != 0) {
+    size_t parent = (rank_id_ - 1) / 2;
+    VectorPtr recv_str;
+    if (!Send(data_name, kCollectivePhaseReduce, 0, parent, output_buff, data_size) ||
+        !Recv(data_name, kCollectivePhaseBroadcast, 0, parent, data_size, &recv_str)) {
+      return false;
+    }
+    auto ret = memcpy_s(output_buff, data_size, recv_str->data(), recv_str->size());
+    if (ret != 0) {
+      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      return false;
+    }
+  }
+  std::vector<std::shared_ptr<ResponseTrack>> send_req_ids;
+  for (auto child : children) {
+    send_req_ids.push_back(SendAsync(data_name, kCollectivePhaseBroadcast, 0, child, output_buff, data_size));
+  }
+  for (auto &send_req_id : send_req_ids) {
+    if (!communicator_->Wait(send_req_id, kCollectiveCommTimeout)) {
+      MS_LOG(ERROR) << "Wait response of tree broadcast failed.";
+      return false;
+    }
+  }
+  return true;
+}
+
+AllReduceAlgorithm CollectiveOpsImpl::SelectAllReduceAlgorithm(const std::string &algorithm, size_t rank_size,
+                                                                size_t count, size_t data_size) {
+  // RingAllReduce needs at least one element per rank, fall back to the tree otherwise.
+  if (algorithm == kAllReduceRing) {
+    return count >= rank_size ? AllReduceAlgorithm::kRing : AllReduceAlgorithm::kTree;
+  }
+  if (algorithm == kAllReduceReduceBroadcast) {
+    return AllReduceAlgorithm::kReduceBroadcast;
+  }
+  if (algorithm == kAllReduceHalvingDoubling) {
+    return AllReduceAlgorithm::kHalvingDoubling;
+  }
+  if (algorithm == kAllReduceTree) {
+    return AllReduceAlgorithm::kTree;
+  }
+  // Small messages are latency bound, the tree takes 2*log(n) steps of sending the whole message. Large messages are
+  // bandwidth bound, both ring and halving doubling send 2*(n-1)/n of the message, but halving doubling takes
+  // 2*log(n) steps instead of 2*(n-1) and needs 2 more steps when n is not a power of two.
+  if (data_size <= kTreeAllReduceMaxSize || count < rank_size) {
+    return AllReduceAlgorithm::kTree;
+  }
+  bool is_power_of_two = (rank_size & (rank_size - 1)) == 0;
+  if (!is_power_of_two && rank_size <= kRingAllReduceMaxRankSize) {
+    return AllReduceAlgorithm::kRing;
+  }
+  return AllReduceAlgorithm::kHalvingDoubling;
+}
+
 template <typename T>
 bool CollectiveOpsImpl::AllReduce(const std::string &data_name, void *sendbuff, void *recvbuff, size_t count,
                                   const std::map<std::string, std::string> &server_map) {
@@ -301,7 +567,7 @@ bool CollectiveOpsImpl::AllReduce(const std::string &data_name, void *sendbuff,
   std::unique_lock<std::mutex> lock(mtx_);
   MS_ERROR_IF_NULL_W_RET_VAL(recvbuff, false);
   MS_ERROR_IF_NULL_W_RET_VAL(sendbuff, false);
-  MS_ERROR_IF_NULL_W_RET_VAL(server_node_, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(communicator_, false);
 
   rank_size_ = server_map.size();
   rank_id_ = 0;
@@ -331,10 +597,16 @@ bool CollectiveOpsImpl::AllReduce(const std::string &data_name, void *sendbuff,
     MS_LOG(WARNING) << "Detect iteration " << iteration_num << " has failed";
     return false;
   }
-  if (count >= rank_size_) {
-    return RingAllReduce<T>(data_name, sendbuff, recvbuff, count);
-  } else {
-    return ReduceBroadcastAllReduce<T>(data_name, sendbuff, recvbuff, count);
+  const auto &algorithm = FLContext::instance()->aggregation_config().allreduce_algorithm;
+  switch (SelectAllReduceAlgorithm(algorithm, rank_size_, count, count * sizeof(T))) {
+    case AllReduceAlgorithm::kRing:
+      return RingAllReduce<T>(data_name, sendbuff, recvbuff, count);
+    case AllReduceAlgorithm::kHalvingDoubling:
+      return HalvingDoublingAllReduce<T>(data_name, sendbuff, recvbuff, count);
+    case AllReduceAlgorithm::kTree:
+      return TreeAllReduce<T>(data_name, sendbuff, recvbuff, count);
+    default:
+      return ReduceBroadcastAllReduce<T>(data_name, sendbuff, recvbuff, count);
   }
 }
 
@@ -35,9 +35,32 @@ constexpr uint32_t kCollectiveCommTimeout = 30;
 // The max timeout for server collective communication, used in disaster recovery to prevent networking flapping.
 constexpr uint32_t kCollectiveCommMaxTimeout = 300;
 
+// Messages not larger than this are allreduced along a binary tree when the algorithm is picked automatically.
+constexpr size_t kTreeAllReduceMaxSize = 64 * 1024;
+// Up to this many servers, RingAllReduce is preferred to HalvingDoublingAllReduce for large messages when the server
+// number is not a power of two.
+constexpr size_t kRingAllReduceMaxRankSize = 8;
+
+enum class AllReduceAlgorithm { kRing, kReduceBroadcast, kHalvingDoubling, kTree };
+
+// The point to point communication which the AllReduce algorithms run on. It's the server node in the cluster.
+class CollectiveCommunicator {
+ public:
+  virtual ~CollectiveCommunicator() = default;
+
+  virtual std::string node_id() const = 0;
+  virtual std::shared_ptr<ResponseTrack> CollectiveSendAsync(const std::string &recv_address,
+                                                             const CollectiveMessageMeta &collective_meta,
+                                                             const void *data, size_t size) = 0;
+  virtual bool CollectiveRecvWait(const CollectiveMessageMeta &expect_meta, size_t expect_size, VectorPtr *output,
+                                  const uint32_t &timeout) = 0;
+  virtual bool Wait(const std::shared_ptr<ResponseTrack> &request_track, const uint32_t &timeout) = 0;
+};
+
 // CollectiveOpsImpl is the collective communication API of the server.
-// For now, it implements two AllReduce algorithms: RingAllReduce and BroadcastAllReduce. Elastic AllReduce is also
-// supported for the elastic scaling feature of the server.
+// It implements four AllReduce algorithms: RingAllReduce, BroadcastAllReduce, HalvingDoublingAllReduce and
+// TreeAllReduce. The algorithm is picked from the message size and the server number unless it's set in the
+// aggregation config. Elastic AllReduce is also supported for the elastic scaling feature of the server.
 class CollectiveOpsImpl {
  public:
   static CollectiveOpsImpl &GetInstance() {
@@ -46,17 +69,23 @@ class CollectiveOpsImpl {
   }
 
   void Initialize(const std::shared_ptr<ServerNode> &server_node);
+  void Initialize(const std::shared_ptr<CollectiveCommunicator> &communicator);
 
   template <typename T>
   bool AllReduce(const std::string &data_name, void *sendbuff, void *recvbuff, size_t count,
                  const std::map<std::string, std::string> &server_map);
 
- private:
-  CollectiveOpsImpl() : server_node_(nullptr), node_(nullptr), node_role_(NodeRole::WORKER), rank_size_(0) {}
+  // Picks the algorithm configured by allreduce_algorithm, or by the message size and the server number if it's AUTO.
+  static AllReduceAlgorithm SelectAllReduceAlgorithm(const std::string &algorithm, size_t rank_size, size_t count,
+                                                     size_t data_size);
+
+  // Besides the instance of the server, tests create one instance per rank to run the algorithms in one process.
+  CollectiveOpsImpl() : communicator_(nullptr), node_(nullptr), node_role_(NodeRole::WORKER), rank_size_(0) {}
   ~CollectiveOpsImpl() = default;
   CollectiveOpsImpl(const CollectiveOpsImpl &) = delete;
   CollectiveOpsImpl &operator=(const CollectiveOpsImpl &) = delete;
 
+ private:
   // Implementation of RingAllReduce.
   template <typename T>
   bool RunRingAllReduce(const std::string &data_name, uint32_t send_to_rank, uint32_t recv_from_rank,
@@ -71,7 +100,27 @@ class CollectiveOpsImpl {
   template <typename T>
   bool ReduceBroadcastAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff, size_t count);
 
-  std::shared_ptr<ServerNode> server_node_;
+  // Implementation of AllReduce with recursive halving reduce-scatter and recursive doubling allgather.
+  template <typename T>
+  bool HalvingDoublingAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff, size_t count);
+
+  // Implementation of AllReduce which reduces to rank 0 and broadcasts back along a binary tree.
+  template <typename T>
+  bool TreeAllReduce(const std::string &data_name, const void *sendbuff, void *recvbuff, size_t count);
+
+  // Point to point helpers for the algorithms above, the peer is identified by its rank.
+  CollectiveMessageMeta CreateMessageMeta(const std::string &data_name, const std::string &phase, uint32_t for_index,
+                                          size_t send_rank, size_t recv_rank) const;
+  std::shared_ptr<ResponseTrack> SendAsync(const std::string &data_name, const std::string &phase, uint32_t for_index,
+                                           size_t peer_rank, const void *data, size_t size);
+  bool Send(const std::string &data_name, const std::string &phase, uint32_t for_index, size_t peer_rank,
+            const void *data, size_t size);
+  bool Recv(const std::string &data_name, const std::string &phase, uint32_t for_index, size_t peer_rank,
+            size_t expect_size, VectorPtr *output);
+  bool SendRecv(const std::string &data_name, const std::string &phase, uint32_t for_index, size_t peer_rank,
+                const void *send_data, size_t send_size, size_t expect_size, VectorPtr *output);
+
+  std::shared_ptr<CollectiveCommunicator> communicator_;
   std::string node_id_;
 
   // The mutex to ensure that collective communication is threadsafe.
@@ -57,6 +57,15 @@ bool DistributedCountService::Count(const std::string &name) {
 bool DistributedCountService::CountReachThreshold(const std::string &name) {
   return cache::Counter::Instance().ReachThreshold(name);
 }
+
+void DistributedCountService::BroadcastClientNoisesReady() {
+  if (server_node_ == nullptr) {
+    return;
+  }
+  ServerBroadcastMessage msg;
+  msg.set_type(ServerBroadcastMessage_BroadcastEventType_CLIENT_NOISES_READY_EVENT);
+  server_node_->BroadcastEvent(msg);
+}
 }  // namespace server
 }  // namespace fl
 }  // namespace mindspore
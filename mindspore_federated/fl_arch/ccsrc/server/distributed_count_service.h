@@ -63,6 +63,10 @@ class DistributedCountService {
   // this method returns true.
   bool CountReachThreshold(const std::string &name);
 
+  // Notify other servers that the client noises have been updated to the distributed cache, so that they start
+  // unmasking without polling.
+  void BroadcastClientNoisesReady();
+
  private:
   std::shared_ptr<ServerNode> server_node_;
 };
@@ -21,6 +21,8 @@
 #include <vector>
 #include <unordered_map>
 #include <utility>
+#include <string_view>
+#include <cmath>
 #include "distributed_cache/instance_context.h"
 #include "distributed_cache/server.h"
 #include "distributed_cache/counter.h"
@@ -71,9 +73,78 @@ FlStatus Executor::CheckUpdatedModel(const std::map<std::string, Address> &featu
   return kFlSuccess;
 }
 
-void Executor::HandleModelUpdate(const std::map<std::string, Address> &feature_map, size_t data_size) {
+FlStatus Executor::CheckUpdatedModel(const FbsFeatureMap *fbs_feature_map, const std::string &update_model_fl_id) {
+  if (fbs_feature_map == nullptr) {
+    auto reason = "Feature map is empty for fl id " + update_model_fl_id;
+    return {kFlFailed, reason};
+  }
+  // Scan the uploaded buffer before taking the lock, so that concurrent updates only serialize on the lookups.
+  for (uint32_t i = 0; i < fbs_feature_map->size(); i++) {
+    auto feature = fbs_feature_map->Get(i);
+    if (feature == nullptr || feature->weight_fullname() == nullptr || feature->data() == nullptr) {
+      auto reason = "Feature parsed from flatbuffer is invalid, fl id: " + update_model_fl_id;
+      MS_LOG_WARNING << reason;
+      return {kFlFailed, reason};
+    }
+    auto upload_data = feature->data();
+    auto weight_data = upload_data->data();
+    for (uint32_t j = 0; j < upload_data->size(); j++) {
+      if (!std::isfinite(weight_data[j])) {
+        auto reason =
+          "The updated weight " + feature->weight_fullname()->str() + " is nan or inf, fl id: " + update_model_fl_id;
+        MS_LOG_WARNING << reason;
+        return {kFlFailed, reason};
+      }
+    }
+  }
   std::unique_lock<std::mutex> lock(parameter_mutex_);
+  size_t require_aggr_count = 0;
   for (auto &param_item : param_aggregation_info_) {
+    if (param_item.second.require_aggr) {
+      require_aggr_count++;
+    }
+  }
+  std::set<const ParamAggregationInfo *> uploaded_params;
+  for (uint32_t i = 0; i < fbs_feature_map->size(); i++) {
+    auto feature = fbs_feature_map->Get(i);
+    auto fbs_name = feature->weight_fullname();
+    auto it = param_aggregation_info_.find(std::string_view(fbs_name->c_str(), fbs_name->size()));
+    if (it == param_aggregation_info_.end()) {
+      auto reason = "The updated weight " + fbs_name->str() + " is not registered in server, fl id: " +
+                    update_model_fl_id;
+      MS_LOG_WARNING << reason;
+      return {kFlFailed, reason};
+    }
+    auto &param_aggr = it->second;
+    auto upload_data = feature->data();
+    if (param_aggr.weight_size != upload_data->size() * sizeof(float)) {
+      MS_LOG_WARNING << "The weight bytes size " << upload_data->size() * sizeof(float) << " uploaded of parameter "
+                     << param_aggr.name << " != expected size " << param_aggr.weight_size
+                     << ", fl id: " << update_model_fl_id;
+      auto reason = "Updating weight " + param_aggr.name + " failed, fl id: " + update_model_fl_id;
+      return {kFlFailed, reason};
+    }
+    if (!uploaded_params.insert(&param_aggr).second) {
+      auto reason = "The weight " + param_aggr.name + " is uploaded repeatedly, fl id: " + update_model_fl_id;
+      MS_LOG_WARNING << reason;
+      return {kFlFailed, reason};
+    }
+    if (param_aggr.require_aggr) {
+      require_aggr_count--;
+    }
+  }
+  if (require_aggr_count != 0 && FLContext::instance()->server_mode() != kServerModeHybrid) {
+    auto reason = "The updated weights of " + std::to_string(require_aggr_count) +
+                  " parameters are missing, fl id: " + update_model_fl_id;
+    MS_LOG_WARNING << reason;
+    return {kFlFailed, reason};
+  }
+  return kFlSuccess;
+}
+
+void Executor::AccumulateModelUpdate(const std::map<std::string, Address> &feature_map, size_t data_size,
+                                     ParamAggregationInfoMap *param_aggregation_info) {
+  for (auto &param_item : *param_aggregation_info) {
     auto &param_name = param_item.first;
     auto &param_aggr = param_item.second;
     if (!param_aggr.require_aggr) {
@@ -90,6 +161,72 @@ void Executor::HandleModelUpdate(const std::map<std::string, Address> &feature_m
   }
 }
 
+void Executor::AccumulateModelUpdate(const FbsFeatureMap *fbs_feature_map, size_t data_size,
+                                     ParamAggregationInfoMap *param_aggregation_info) {
+  for (uint32_t i = 0; i < fbs_feature_map->size(); i++) {
+    auto feature = fbs_feature_map->Get(i);
+    auto fbs_name = feature->weight_fullname();
+    auto it = param_aggregation_info->find(std::string_view(fbs_name->c_str(), fbs_name->size()));
+    if (it == param_aggregation_info->end() || !it->second.require_aggr) {
+      continue;
+    }
+    Address upload_data(feature->data()->data(), feature->data()->size() * sizeof(float));
+    kernel::FedAvgKernel<float, size_t>::Launch(upload_data, data_size, &it->second);
+  }
+}
+
+void Executor::HandleModelUpdate(const std::map<std::string, Address> &feature_map, size_t data_size) {
+  AccumulateToFreeShard([&feature_map, data_size](ParamAggregationInfoMap *param_aggregation_info) {
+    AccumulateModelUpdate(feature_map, data_size, param_aggregation_info);
+  });
+}
+
+void Executor::HandleModelUpdate(const FbsFeatureMap *fbs_feature_map, size_t data_size) {
+  MS_ERROR_IF_NULL_WO_RET_VAL(fbs_feature_map);
+  AccumulateToFreeShard([fbs_feature_map, data_size](ParamAggregationInfoMap *param_aggregation_info) {
+    AccumulateModelUpdate(fbs_feature_map, data_size, param_aggregation_info);
+  });
+}
+
+void Executor::AccumulateToFreeShard(const std::function<void(ParamAggregationInfoMap *)> &accumulate_func) {
+  if (aggregation_shards_.empty()) {
+    std::unique_lock<std::mutex> lock(parameter_mutex_);
+    accumulate_func(&param_aggregation_info_);
+    return;
+  }
+  // Slot 0 is param_aggregation_info_ and slot i is aggregation_shards_[i - 1]. Take the first free slot from a
+  // round-robin start, and only block on the start slot when all of them are busy.
+  auto try_accumulate = [this, &accumulate_func](size_t slot, bool block) {
+    auto mtx = &parameter_mutex_;
+    auto param_aggregation_info = &param_aggregation_info_;
+    AggregationShard *shard = nullptr;
+    if (slot > 0) {
+      shard = aggregation_shards_[slot - 1].get();
+      mtx = &shard->mtx;
+      param_aggregation_info = &shard->param_aggregation_info;
+    }
+    std::unique_lock<std::mutex> lock(*mtx, std::defer_lock);
+    if (block) {
+      lock.lock();
+    } else if (!lock.try_lock()) {
+      return false;
+    }
+    accumulate_func(param_aggregation_info);
+    if (shard != nullptr) {
+      shard->updated = true;
+    }
+    return true;
+  };
+  auto slot_num = aggregation_shards_.size() + 1;
+  auto start = next_shard_index_.fetch_add(1) % slot_num;
+  for (size_t i = 0; i < slot_num; i++) {
+    if (try_accumulate((start + i) % slot_num, false)) {
+      return;
+    }
+  }
+  (void)try_accumulate(start, true);
+}
+
 bool Executor::OnReceiveModelWeight(const uint8_t *proto_model_data, size_t len) {
   ProtoModel proto_model;
   if (!proto_model.ParseFromArray(proto_model_data, static_cast<int>(len))) {
@@ -110,6 +247,9 @@ bool Executor::OnReceiveModelWeight(const uint8_t *proto_model_data, size_t len)
       continue;
     }
     auto &param_aggr = param_aggregation_info_[param_name];
+    if (!PrepareWeightForWrite(&param_aggr)) {
+      return false;
+    }
     int ret = memcpy_s(param_aggr.weight_data, param_aggr.weight_size, param.data().data(), param.data().size());
     if (ret != 0) {
       MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << "), src size: " << param.data().size()
@@ -160,7 +300,9 @@ bool Executor::HandlePushWeight(const std::map<std::string, Address> &feature_ma
     }
     auto &param_aggr = param_aggregation_info_[param_name];
     const Address &new_weight = trainable_param.second;
-    MS_ERROR_IF_NULL_W_RET_VAL(param_aggr.weight_data, false);
+    if (!PrepareWeightForWrite(&param_aggr)) {
+      return false;
+    }
     MS_ERROR_IF_NULL_W_RET_VAL(new_weight.addr, false);
     int ret = memcpy_s(param_aggr.weight_data, param_aggr.weight_size, new_weight.addr, new_weight.size);
     if (ret != 0) {
@@ -394,12 +536,20 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
     MS_LOG_INFO << "Servers count for RunWeightAggregation is 1";
   }
   std::unique_lock<std::mutex> lock(parameter_mutex_);
+  MergeAggregationShards();
+  std::vector<ParamAggregationInfo *> aggr_infos;
   for (auto &item : param_aggregation_info_) {
-    auto &param_aggr = item.second;
-    if (!param_aggr.require_aggr) {
-      continue;
+    if (item.second.require_aggr) {
+      aggr_infos.push_back(&item.second);
     }
-    if (!kernel::FedAvgKernel<float, size_t>::AllReduce(server_map, &param_aggr)) {
+  }
+  if (!kernel::FedAvgKernel<float, size_t>::FusedAllReduce(server_map, aggr_infos)) {
+    MS_LOG(WARNING) << "Failed to run allreduce for " << aggr_infos.size() << " parameters";
+    return false;
+  }
+  for (auto param_info : aggr_infos) {
+    auto &param_aggr = *param_info;
+    if (!kernel::FedAvgKernel<float, size_t>::Average(&param_aggr)) {
       if (FLContext::instance()->server_mode() == kServerModeHybrid) {
         continue;
       }
@@ -411,6 +561,28 @@ bool Executor::RunWeightAggregationInner(const std::map<std::string, std::string
   return true;
 }
 
+void Executor::MergeAggregationShards() {
+  for (auto &shard : aggregation_shards_) {
+    std::unique_lock<std::mutex> lock(shard->mtx);
+    if (!shard->updated) {
+      continue;
+    }
+    for (auto &item : param_aggregation_info_) {
+      auto &param_aggr = item.second;
+      if (!param_aggr.require_aggr) {
+        continue;
+      }
+      auto it = shard->param_aggregation_info.find(item.first);
+      if (it == shard->param_aggregation_info.end()) {
+        continue;
+      }
+      auto &shard_aggr = it->second;
+      Address partial_sum(shard_aggr.weight_data, shard_aggr.weight_size);
+      kernel::FedAvgKernel<float, size_t>::Launch(partial_sum, shard_aggr.data_size, &param_aggr);
+    }
+  }
+}
+
 void Executor::FinishIteration(bool is_last_iter_valid, const std::string &in_reason) {
   cache::InstanceContext::Instance().NotifyNext(is_last_iter_valid, in_reason);
 }
@@ -429,17 +601,65 @@ bool Executor::ResetAggregationStatus() {
     return false;
   }
   param_aggregation_info_.clear();
-  auto weight_data = model_aggregation_->weight_data.data();
   for (auto &item : model_aggregation_->weight_items) {
     auto &weight_item = item.second;
     ParamAggregationInfo info;
     info.name = weight_item.name;
-    info.weight_data = weight_data + weight_item.offset;
+    info.weight_data = model_aggregation_->weight_addr(weight_item);
     info.weight_size = weight_item.size;
     info.data_size = 0;
     info.require_aggr = weight_item.require_aggr;
     param_aggregation_info_[info.name] = info;
   }
+  return ResetAggregationShards();
+}
+
+bool Executor::ResetAggregationShards() {
+  auto shard_num = FLContext::instance()->aggregation_config().shard_num;
+  if (shard_num <= 1) {
+    return true;
+  }
+  if (aggregation_shards_.empty()) {
+    for (size_t i = 1; i < shard_num; i++) {
+      aggregation_shards_.push_back(std::make_unique<AggregationShard>());
+    }
+    MS_LOG_INFO << "FedAvg aggregation is sharded into " << shard_num << " partial sums";
+  }
+  auto model_size = model_aggregation_->weight_data.size();
+  for (auto &shard : aggregation_shards_) {
+    std::unique_lock<std::mutex> shard_lock(shard->mtx);
+    auto &weight_data = shard->weight_data;
+    if (weight_data.size() != model_size) {
+      weight_data.resize(model_size);
+      shard->updated = true;
+    }
+    if (shard->updated) {
+      auto ret = memset_s(weight_data.data(), weight_data.size(), 0, weight_data.size());
+      if (ret != EOK) {
+        MS_LOG_ERROR << "Failed to reset aggregation shard, memset_s return " << ret;
+        return false;
+      }
+      shard->updated = false;
+    }
+    shard->param_aggregation_info = param_aggregation_info_;
+    for (auto &item : shard->param_aggregation_info) {
+      auto &info = item.second;
+      if (info.require_aggr) {
+        info.weight_data = weight_data.data() + model_aggregation_->weight_items[item.first].offset;
+      }
+    }
+  }
+  return true;
+}
+
+bool Executor::PrepareWeightForWrite(ParamAggregationInfo *param_aggr) {
+  MS_ERROR_IF_NULL_W_RET_VAL(param_aggr, false);
+  MS_ERROR_IF_NULL_W_RET_VAL(model_aggregation_, false);
+  // Weights which don't require aggregation may be shared with the models of previous iterations.
+  if (!param_aggr->require_aggr) {
+    param_aggr->weight_data = model_aggregation_->mutable_weight_addr(param_aggr->name);
+  }
+  MS_ERROR_IF_NULL_W_RET_VAL(param_aggr->weight_data, false);
   return true;
 }
 
@@ -483,7 +703,6 @@ bool Executor::TransModel2ProtoModel(uint64_t iteration_num, const ModelItemPtr
   }
   proto_model->set_instance_state(proto_state);
   proto_model->set_iteration_num(iteration_num);
-  auto weight_base = model->weight_data.data();
   for (auto &weight_item : model->weight_items) {
     auto &weight = weight_item.second;
     auto proto_weight = proto_model->add_weights();
@@ -493,7 +712,12 @@ bool Executor::TransModel2ProtoModel(uint64_t iteration_num, const ModelItemPtr
     for (auto &dim : weight.shape) {
       proto_weight->add_shape(static_cast<int64_t>(dim));
     }
-    proto_weight->set_data(weight_base + weight.offset, weight.size);
+    auto weight_data = model->weight_addr(weight);
+    if (weight_data == nullptr) {
+      MS_LOG_WARNING << "Data of weight " << weight.name << " is missing";
+      return false;
+    }
+    proto_weight->set_data(weight_data, weight.size);
   }
   return true;
 }
@@ -548,7 +772,16 @@ void Executor::Unmask() {
     return;
   }
   MS_LOG(INFO) << "start unmask";
-  auto ret = cipher_unmask_.UnMask(model);
+  // Waiting for the client noises may take minutes, so do it before blocking the weight accesses.
+  bool ret = cipher_unmask_.WaitClientNoises();
+  if (ret) {
+    std::unique_lock<std::mutex> lock(parameter_mutex_);
+    ret = cipher_unmask_.UnMask(model);
+    // UnMask copies the shared weights before writing them, so refresh the addresses of the weights.
+    for (auto &item : param_aggregation_info_) {
+      item.second.weight_data = model->weight_addr(model->weight_items[item.first]);
+    }
+  }
   MS_LOG(INFO) << "end unmask";
   if (!ret) {
     std::string reason = "Failed to unmask, current iteration: " + std::to_string(curr_iter_num);
@@ -24,6 +24,8 @@
 #include <vector>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <functional>
 #include "armour/cipher/cipher_unmask.h"
 #include "common/common.h"
 #include "server/model_store.h"
@@ -40,6 +42,9 @@ struct ParamAggregationInfo {
   size_t data_size = 0;    // batch size
   bool require_aggr = false;
 };
+// Transparent comparator so that weights can be looked up by the names in flatbuffers without building std::string.
+using ParamAggregationInfoMap = std::map<std::string, ParamAggregationInfo, std::less<>>;
+using FbsFeatureMap = flatbuffers::Vector<flatbuffers::Offset<schema::FeatureMap>>;
 // Executor is the entrance for server to handle aggregation, optimizing, model querying, etc. It handles
 // logics relevant to kernel launching.
 class Executor {
@@ -57,8 +62,12 @@ class Executor {
   FlStatus SyncLatestModelFromOtherServers();
 
   FlStatus CheckUpdatedModel(const std::map<std::string, Address> &feature_map, const std::string &update_model_fl_id);
+  // Check names, sizes and values of the weights uploaded without compression in place in the flatbuffer.
+  FlStatus CheckUpdatedModel(const FbsFeatureMap *fbs_feature_map, const std::string &update_model_fl_id);
   // Called in federated learning training mode. Update value for parameters.
   void HandleModelUpdate(const std::map<std::string, Address> &feature_map, size_t data_size);
+  // Accumulate the weights straight from the flatbuffer, which should have passed CheckUpdatedModel.
+  void HandleModelUpdate(const FbsFeatureMap *fbs_feature_map, size_t data_size);
 
   std::map<std::string, Address> ParseFeatureMap(const schema::RequestPushWeight *push_weight_req);
   FlStatus HandlePullWeightRequest(const uint8_t *req_data, size_t len, FBBuilder *fbb);
@@ -107,12 +116,35 @@ class Executor {
 
   void SetSkipAggregation();
   bool RunWeightAggregationInner(const std::map<std::string, std::string> &server_map);
+  // Merge the partial sums of all aggregation shards into param_aggregation_info_.
+  void MergeAggregationShards();
+  // Make the weight writable by copying it if it's shared with other models, called with parameter_mutex_ held.
+  bool PrepareWeightForWrite(ParamAggregationInfo *param_aggr);
+  bool ResetAggregationShards();
+  // Run accumulate_func on param_aggregation_info_ or on a free aggregation shard.
+  void AccumulateToFreeShard(const std::function<void(ParamAggregationInfoMap *)> &accumulate_func);
+  static void AccumulateModelUpdate(const std::map<std::string, Address> &feature_map, size_t data_size,
+                                    ParamAggregationInfoMap *param_aggregation_info);
+  static void AccumulateModelUpdate(const FbsFeatureMap *fbs_feature_map, size_t data_size,
+                                    ParamAggregationInfoMap *param_aggregation_info);
   // The unmasking method for pairwise encrypt algorithm.
   void Unmask();
 
   std::mutex parameter_mutex_;
   ModelItemPtr model_aggregation_ = nullptr;
-  std::map<std::string, ParamAggregationInfo> param_aggregation_info_;
+  ParamAggregationInfoMap param_aggregation_info_;
+
+  // Partial FedAvg sum with the same layout as model_aggregation_. When aggregation.shard_num > 1, concurrent
+  // updateModel requests accumulate into param_aggregation_info_ or into one of these shards, whichever is free, so
+  // they don't all queue on parameter_mutex_. The shards are merged once before the allreduce.
+  struct AggregationShard {
+    std::mutex mtx;
+    std::vector<uint8_t> weight_data;
+    ParamAggregationInfoMap param_aggregation_info;
+    bool updated = false;
+  };
+  std::vector<std::unique_ptr<AggregationShard>> aggregation_shards_;
+  std::atomic<size_t> next_shard_index_ = 0;
   // whether model in model_aggregation_ has finished
   bool model_finished_ = false;
 
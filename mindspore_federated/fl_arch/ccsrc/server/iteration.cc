@@ -334,7 +334,7 @@ void Iteration::SaveModel() {
     } else {
       // Store the model which is successfully aggregated for this iteration.
       const auto &model = Executor::GetInstance().GetModel();
-      if (model == nullptr || model->weight_data.empty() || model->weight_items.empty() ||
+      if (model == nullptr || model->empty() ||
           !LocalMetaStore::GetInstance().verifyAggregationFeatureMap(model)) {
         MS_LOG(WARNING) << "Verify feature maps failed, iteration " << store_iteration_num
                         << " will not be stored. Use the previous iteration model instead";
@@ -23,7 +23,9 @@
 #include <vector>
 #include <functional>
 #include <map>
+#include <type_traits>
 #include "common/common.h"
+#include "common/utils/simd_kernels.h"
 #include "server/collective_ops_impl.h"
 #include "server/local_meta_store.h"
 #include "server/executor.h"
@@ -55,15 +57,92 @@ class FedAvgKernel {
       MS_LOG(ERROR) << "Federated average allreduce failed.";
       return false;
     }
+    return Average(info);
+  }
+
+  // Sum the weights and data sizes of all the given parameters across servers. The weights are fused into one buffer so
+  // that only two allreduce operations are run no matter how many parameters the model has. Every server must pass the
+  // parameters in the same order. Call Average for each parameter afterwards.
+  static bool FusedAllReduce(const std::map<std::string, std::string> &server_map,
+                             const std::vector<ParamAggregationInfo *> &infos) {
+    // Nothing to exchange with a single server, skip packing the weights.
+    if (infos.empty() || server_map.size() == 1) {
+      return true;
+    }
+    // Parameters which are laid out back to back are reduced in place, otherwise they are packed into a new buffer.
+    bool is_contiguous = true;
+    size_t total_size = 0;
+    std::vector<S> data_sizes;
+    for (size_t i = 0; i < infos.size(); i++) {
+      MS_ERROR_IF_NULL_W_RET_VAL(infos[i], false);
+      if (i > 0 && infos[i]->weight_data != infos[i - 1]->weight_data + infos[i - 1]->weight_size) {
+        is_contiguous = false;
+      }
+      total_size += infos[i]->weight_size;
+      data_sizes.push_back(infos[i]->data_size);
+    }
+    std::vector<T> fused_weight;
+    T *weight_addr = reinterpret_cast<T *>(infos[0]->weight_data);
+    if (!is_contiguous) {
+      fused_weight.resize(total_size / sizeof(T));
+      auto fused_data = reinterpret_cast<uint8_t *>(fused_weight.data());
+      size_t offset = 0;
+      for (auto info : infos) {
+        auto ret = memcpy_s(fused_data + offset, total_size - offset, info->weight_data, info->weight_size);
+        if (ret != EOK) {
+          MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+          return false;
+        }
+        offset += info->weight_size;
+      }
+      weight_addr = fused_weight.data();
+    }
+    if (!CollectiveOpsImpl::GetInstance().AllReduce<T>("fused_weight", weight_addr, weight_addr,
+                                                       total_size / sizeof(T), server_map)) {
+      MS_LOG(ERROR) << "Federated average fused allreduce failed.";
+      return false;
+    }
+    if (!CollectiveOpsImpl::GetInstance().AllReduce<S>("fused_data_size", data_sizes.data(), data_sizes.data(),
+                                                       data_sizes.size(), server_map)) {
+      MS_LOG(ERROR) << "Federated average fused allreduce failed.";
+      return false;
+    }
+    auto fused_data = reinterpret_cast<const uint8_t *>(fused_weight.data());
+    size_t offset = 0;
+    for (size_t i = 0; i < infos.size(); i++) {
+      auto info = infos[i];
+      info->data_size = data_sizes[i];
+      if (!is_contiguous) {
+        auto ret = memcpy_s(info->weight_data, info->weight_size, fused_data + offset, info->weight_size);
+        if (ret != EOK) {
+          MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+          return false;
+        }
+        offset += info->weight_size;
+      }
+    }
+    return true;
+  }
+
+  // Divide the summed weight by the summed data size.
+  static bool Average(ParamAggregationInfo *info) {
+    if (info == nullptr) {
+      return false;
+    }
     auto data_size = info->data_size;
     if (data_size == 0) {
       MS_LOG(INFO) << "Parameter:" << info->name << " data size is 0, do not need to run fed avg.";
       return false;
     }
     LocalMetaStore::GetInstance().put_value(kCtxFedAvgTotalDataSize, data_size);
+    T *weight_addr = reinterpret_cast<T *>(info->weight_data);
     auto elem_num = info->weight_size / sizeof(T);
-    for (size_t i = 0; i < elem_num; i++) {
-      weight_addr[i] /= data_size;
+    if constexpr (std::is_same<T, float>::value) {
+      simd::Scale(weight_addr, 1.0f / static_cast<float>(data_size), elem_num);
+    } else {
+      for (size_t i = 0; i < elem_num; i++) {
+        weight_addr[i] /= data_size;
+      }
     }
     return true;
   }
@@ -78,8 +157,12 @@ class FedAvgKernel {
     auto new_weight_addr = reinterpret_cast<const T *>(update_weight.addr);
 
     auto elem_num = info->weight_size / sizeof(T);
-    for (size_t i = 0; i < elem_num; i++) {
-      weight_addr[i] += new_weight_addr[i];
+    if constexpr (std::is_same<T, float>::value) {
+      simd::Add(weight_addr, new_weight_addr, elem_num);
+    } else {
+      for (size_t i = 0; i < elem_num; i++) {
+        weight_addr[i] += new_weight_addr[i];
+      }
     }
     info->data_size += update_data_size;
   }
@@ -108,12 +108,8 @@ void GetModelKernel::GetModel(const schema::RequestGetModel *get_model_req,
   auto download_compress_types = get_model_req->download_compress_types();
   schema::CompressType compressType =
     mindspore::fl::compression::CompressExecutor::GetInstance().GetCompressType(download_compress_types);
-  std::string compress_type;
-  if (compressType == schema::CompressType_QUANT) {
-    compress_type = kQuant;
-  } else {
-    compress_type = kNoCompressType;
-  }
+  // The response cache is kept for each compress type.
+  std::string compress_type = schema::EnumNameCompressType(compressType);
   auto cache = ModelStore::GetInstance().GetModelResponseCache(name_, current_iter, real_get_model_iter, compress_type);
   if (cache == nullptr) {
     // Only download compress weights if client support.
@@ -157,10 +153,9 @@ void GetModelKernel::BuildGetModelRsp(const std::shared_ptr<FBBuilder> &fbb, con
   auto fbs_timestamp = fbb->CreateString(timestamp);
   std::vector<flatbuffers::Offset<schema::FeatureMap>> fbs_feature_maps;
   if (model) {
-    auto weight_data = model->weight_data.data();
     for (const auto &feature : model->weight_items) {
       auto fbs_weight_fullname = fbb->CreateString(feature.first);
-      auto fbs_weight_data = fbb->CreateVector(reinterpret_cast<float *>(weight_data + feature.second.offset),
+      auto fbs_weight_data = fbb->CreateVector(reinterpret_cast<const float *>(model->weight_addr(feature.second)),
                                                feature.second.size / sizeof(float));
       auto fbs_feature_map = schema::CreateFeatureMap(*(fbb.get()), fbs_weight_fullname, fbs_weight_data);
       fbs_feature_maps.push_back(fbs_feature_map);
@@ -169,30 +164,9 @@ void GetModelKernel::BuildGetModelRsp(const std::shared_ptr<FBBuilder> &fbb, con
   auto fbs_feature_maps_vector = fbb->CreateVector(fbs_feature_maps);
 
   // construct compress feature maps with fbs
-  std::vector<flatbuffers::Offset<schema::CompressFeatureMap>> fbs_compress_feature_maps;
-  for (const auto &compress_feature_map : compress_feature_maps) {
-    if (compress_feature_map.first.find(kMinVal) != std::string::npos ||
-        compress_feature_map.first.find(kMaxVal) != std::string::npos) {
-      continue;
-    }
-    auto fbs_compress_weight_fullname = fbb->CreateString(compress_feature_map.first);
-    auto fbs_compress_weight_data =
-      fbb->CreateVector(reinterpret_cast<const int8_t *>(compress_feature_map.second->addr),
-                        compress_feature_map.second->size / sizeof(int8_t));
-
-    const std::string min_val_name = compress_feature_map.first + "." + kMinVal;
-    const std::string max_val_name = compress_feature_map.first + "." + kMaxVal;
-
-    const AddressPtr min_val_ptr = compress_feature_maps.at(min_val_name);
-    const AddressPtr max_val_ptr = compress_feature_maps.at(max_val_name);
-
-    auto fbs_min_val_ptr = reinterpret_cast<const float *>(min_val_ptr->addr);
-    auto fbs_max_val_ptr = reinterpret_cast<const float *>(max_val_ptr->addr);
-    auto fbs_compress_feature_map = schema::CreateCompressFeatureMap(
-      *(fbb.get()), fbs_compress_weight_fullname, fbs_compress_weight_data, *fbs_min_val_ptr, *fbs_max_val_ptr);
-
-    fbs_compress_feature_maps.push_back(fbs_compress_feature_map);
-  }
+  auto fbs_compress_feature_maps =
+    mindspore::fl::compression::CompressExecutor::GetInstance().CreateCompressFeatureMaps(
+      fbb.get(), compress_feature_maps, compressType);
   auto fbs_compress_feature_maps_vector = fbb->CreateVector(fbs_compress_feature_maps);
 
   schema::ResponseGetModelBuilder rsp_get_model_builder(*(fbb.get()));
@@ -147,11 +147,12 @@ bool ReconstructSecretsKernel::checkReachThreshold(const std::vector<std::string
   if (DistributedCountService::GetInstance().CountReachThreshold(name_)) {
     MS_LOG(INFO) << "Current amount for ReconstructSecretsKernel is enough.";
     clock_t start_time = clock();
-    fl::ClientNoises clients_noises_pb;
-    auto ret = fl::cache::ClientInfos::GetInstance().GetClientNoises(&clients_noises_pb);
+    uint64_t noises_size = 0;
+    auto ret = fl::cache::ClientInfos::GetInstance().GetClientNoisesSize(&noises_size);
     if (ret == fl::cache::kCacheNil) {
       MS_LOG(INFO) << "Success, the secret will be reconstructed.";
       if (cipher_reconstruct_.ReconstructSecretsGenNoise(update_model_clients)) {
+        DistributedCountService::GetInstance().BroadcastClientNoisesReady();
         cipher_reconstruct_.BuildReconstructSecretsRsp(
           fbb, schema::ResponseCode_SUCCEED, "Success,the secret is reconstructing.", cur_iterator, next_req_time);
         MS_LOG(INFO) << "CipherReconStruct::ReconstructSecrets" << fl_id << " Success, reconstruct ok.";
@@ -23,6 +23,7 @@
 #include "server/model_store.h"
 #include "server/iteration.h"
 #include "distributed_cache/timer.h"
+#include "compression/sparse_mask.h"
 
 namespace mindspore {
 namespace fl {
@@ -129,12 +130,8 @@ bool StartFLJobKernel::Launch(const uint8_t *req_data, size_t len, const std::sh
   auto download_compress_types = start_fl_job_req->download_compress_types();
   schema::CompressType compressType =
     mindspore::fl::compression::CompressExecutor::GetInstance().GetCompressType(download_compress_types);
-  std::string compress_type;
-  if (compressType == schema::CompressType_QUANT) {
-    compress_type = kQuant;
-  } else {
-    compress_type = kNoCompressType;
-  }
+  // The response cache is kept for each compress type.
+  std::string compress_type = schema::EnumNameCompressType(compressType);
   auto cache = ModelStore::GetInstance().GetModelResponseCache(name_, curr_iter_num, last_iteration, compress_type);
   if (cache == nullptr) {
     StartFLJob(fbb, device_meta, start_fl_job_req);
@@ -369,10 +366,9 @@ void StartFLJobKernel::BuildStartFLJobRsp(const std::shared_ptr<FBBuilder> &fbb,
 
   std::vector<flatbuffers::Offset<schema::FeatureMap>> fbs_feature_maps;
   if (model_item) {
-    auto weight_data_base = model_item->weight_data.data();
     for (auto &feature : model_item->weight_items) {
       auto fbs_weight_fullname = fbb->CreateString(feature.first);
-      auto fbs_weight_data = fbb->CreateVector(reinterpret_cast<float *>(weight_data_base + feature.second.offset),
+      auto fbs_weight_data = fbb->CreateVector(reinterpret_cast<const float *>(model_item->weight_addr(feature.second)),
                                                feature.second.size / sizeof(float));
       auto fbs_feature_map = schema::CreateFeatureMap(*(fbb.get()), fbs_weight_fullname, fbs_weight_data);
       fbs_feature_maps.push_back(fbs_feature_map);
@@ -381,31 +377,9 @@ void StartFLJobKernel::BuildStartFLJobRsp(const std::shared_ptr<FBBuilder> &fbb,
   auto fbs_feature_maps_vector = fbb->CreateVector(fbs_feature_maps);
 
   // construct compress feature maps with fbs
-  std::vector<flatbuffers::Offset<schema::CompressFeatureMap>> fbs_compress_feature_maps;
-  for (const auto &compress_feature_map : compress_feature_maps) {
-    if (compressType == schema::CompressType_QUANT) {
-      if (compress_feature_map.first.find(kMinVal) != std::string::npos ||
-          compress_feature_map.first.find(kMaxVal) != std::string::npos) {
-        continue;
-      }
-      auto fbs_compress_weight_fullname = fbb->CreateString(compress_feature_map.first);
-      auto fbs_compress_weight_data =
-        fbb->CreateVector(reinterpret_cast<const int8_t *>(compress_feature_map.second->addr),
-                          compress_feature_map.second->size / sizeof(int8_t));
-
-      const std::string min_val_name = compress_feature_map.first + "." + kMinVal;
-      const std::string max_val_name = compress_feature_map.first + "." + kMaxVal;
-
-      const AddressPtr min_val_ptr = compress_feature_maps.at(min_val_name);
-      const AddressPtr max_val_ptr = compress_feature_maps.at(max_val_name);
-
-      auto fbs_min_val_ptr = reinterpret_cast<const float *>(min_val_ptr->addr);
-      auto fbs_max_val_ptr = reinterpret_cast<const float *>(max_val_ptr->addr);
-      auto fbs_compress_feature_map = schema::CreateCompressFeatureMap(
-        *(fbb.get()), fbs_compress_weight_fullname, fbs_compress_weight_data, *fbs_min_val_ptr, *fbs_max_val_ptr);
-      fbs_compress_feature_maps.push_back(fbs_compress_feature_map);
-    }
-  }
+  auto fbs_compress_feature_maps =
+    mindspore::fl::compression::CompressExecutor::GetInstance().CreateCompressFeatureMaps(
+      fbb.get(), compress_feature_maps, compressType);
   auto fbs_compress_feature_maps_vector = fbb->CreateVector(fbs_compress_feature_maps);
 
   schema::ResponseFLJobBuilder rsp_fl_job_builder(*(fbb.get()));
@@ -420,6 +394,7 @@ void StartFLJobKernel::BuildStartFLJobRsp(const std::shared_ptr<FBBuilder> &fbb,
   rsp_fl_job_builder.add_compress_feature_map(fbs_compress_feature_maps_vector);
   rsp_fl_job_builder.add_upload_compress_type(upload_compress_type);
   rsp_fl_job_builder.add_upload_sparse_rate(FLContext::instance()->compression_config().upload_sparse_rate);
+  rsp_fl_job_builder.add_sparse_mask_version(mindspore::fl::compression::kSparseMaskCounter);
   auto rsp_fl_job = rsp_fl_job_builder.Finish();
   fbb->Finish(rsp_fl_job);
   return;
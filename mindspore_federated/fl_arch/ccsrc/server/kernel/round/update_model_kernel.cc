@@ -258,10 +258,6 @@ ResultCode UpdateModelKernel::VerifyUpdateModel(const schema::RequestUpdateModel
     }
   } else if (IsCompress(update_model_req)) {
     verifyFeatureMapIsSuccess = VerifyUploadCompressFeatureMap(update_model_req, device_meta);
-  } else {
-    ModelItemPtr modelItemPtr = ParseModelItemPtr(update_model_req);
-    MS_ERROR_IF_NULL_W_RET_VAL(modelItemPtr, ResultCode::kFail);
-    verifyFeatureMapIsSuccess = LocalMetaStore::GetInstance().verifyAggregationFeatureMap(modelItemPtr);
   }
   if (!verifyFeatureMapIsSuccess) {
     auto next_req_time = LocalMetaStore::GetInstance().value<uint64_t>(kCtxIterationNextRequestTimestamp);
@@ -301,10 +297,19 @@ bool UpdateModelKernel::VerifySignDSFeatureMap(const schema::RequestUpdateModel
   if (index_array_size == 0 || index_array_size > array_size_upper) {
     return false;
   }
-  std::map<std::string, std::vector<float>> weight_map;
-  std::map<std::string, Address> feature_map =
-    ParseSignDSFeatureMap(update_model_req, device_meta->data_size(), &weight_map);
-  return LocalMetaStore::GetInstance().verifyAggregationFeatureMap(feature_map);
+  // The weights are reconstructed from the latest model only once in ParseAndVerifyFeatureMap, here only check that
+  // they are all registered.
+  auto &aggregation_feature_map = LocalMetaStore::GetInstance().aggregation_feature_map();
+  MS_ERROR_IF_NULL_W_RET_VAL(aggregation_feature_map, false);
+  auto fbs_feature_map = update_model_req->feature_map();
+  for (uint32_t i = 0; i < fbs_feature_map->size(); i++) {
+    auto weight_full_name = fbs_feature_map->Get(i)->weight_fullname()->str();
+    if (aggregation_feature_map->weight_items.count(weight_full_name) == 0) {
+      MS_LOG(WARNING) << "The weight " << weight_full_name << " is not registered in server.";
+      return false;
+    }
+  }
+  return true;
 }
 
 bool UpdateModelKernel::VerifyUploadCompressFeatureMap(const schema::RequestUpdateModel *update_model_req,
@@ -359,11 +364,13 @@ bool UpdateModelKernel::VerifyUploadCompressFeatureMap(const schema::RequestUpda
       return false;
     }
   }
+  // The decoded weights are verified in ParseAndVerifyFeatureMap so that they are only decoded once.
+  return true;
+}
 
-  std::map<std::string, std::vector<float>> weight_map;
-  std::map<std::string, Address> feature_map =
-    ParseUploadCompressFeatureMap(update_model_req, device_meta->data_size(), &weight_map);
-  return LocalMetaStore::GetInstance().verifyAggregationFeatureMap(feature_map);
+bool UpdateModelKernel::IsFbsFeatureMapUpdate() const {
+  return FLContext::instance()->encrypt_type() != kDSEncryptType &&
+         FLContext::instance()->compression_config().upload_compress_type != kDiffSparseQuant;
 }
 
 ResultCode UpdateModelKernel::ParseAndVerifyFeatureMap(const schema::RequestUpdateModel *update_model_req,
@@ -376,20 +383,31 @@ ResultCode UpdateModelKernel::ParseAndVerifyFeatureMap(const schema::RequestUpda
 
   std::map<std::string, std::vector<float>> &weight_map = *weight_map_ptr;
   std::map<std::string, Address> &feature_map = *feature_map_ptr;
-  if (FLContext::instance()->encrypt_type() == kDSEncryptType) {
-    feature_map = ParseSignDSFeatureMap(update_model_req, data_size, &weight_map);
-  } else if (FLContext::instance()->compression_config().upload_compress_type == kDiffSparseQuant) {
-    feature_map = ParseUploadCompressFeatureMap(update_model_req, data_size, &weight_map);
+  FlStatus status;
+  if (IsFbsFeatureMapUpdate()) {
+    // The weights are verified and later accumulated in place in the received flatbuffer.
+    status = Executor::GetInstance().CheckUpdatedModel(update_model_req->feature_map(), update_model_fl_id);
   } else {
-    feature_map = ParseFeatureMap(update_model_req);
-  }
-  if (feature_map.empty()) {
-    std::string reason = "Feature map is empty for fl id " + update_model_fl_id;
-    BuildUpdateModelRsp(fbb, schema::ResponseCode_RequestError, reason, "");
-    MS_LOG(WARNING) << reason;
-    return ResultCode::kFail;
+    if (FLContext::instance()->encrypt_type() == kDSEncryptType) {
+      feature_map = ParseSignDSFeatureMap(update_model_req, data_size, &weight_map);
+    } else {
+      feature_map = ParseUploadCompressFeatureMap(update_model_req, data_size, &weight_map);
+    }
+    if (feature_map.empty()) {
+      std::string reason = "Feature map is empty for fl id " + update_model_fl_id;
+      BuildUpdateModelRsp(fbb, schema::ResponseCode_RequestError, reason, "");
+      MS_LOG(WARNING) << reason;
+      return ResultCode::kFail;
+    }
+    if (!LocalMetaStore::GetInstance().verifyAggregationFeatureMap(feature_map)) {
+      auto next_req_time = LocalMetaStore::GetInstance().value<uint64_t>(kCtxIterationNextRequestTimestamp);
+      std::string reason = "Verify model feature map failed, retry later at time: " + std::to_string(next_req_time);
+      BuildUpdateModelRsp(fbb, schema::ResponseCode_RequestError, reason, std::to_string(next_req_time));
+      MS_LOG(WARNING) << reason;
+      return ResultCode::kFail;
+    }
+    status = Executor::GetInstance().CheckUpdatedModel(feature_map, update_model_fl_id);
   }
-  auto status = Executor::GetInstance().CheckUpdatedModel(feature_map, update_model_fl_id);
   if (!status.IsSuccess()) {
     std::string reason = status.StatusMessage();
     BuildUpdateModelRsp(
@@ -426,7 +444,11 @@ ResultCode UpdateModelKernel::UpdateModel(const schema::RequestUpdateModel *upda
     MS_LOG(WARNING) << reason;
     return ResultCode::kFail;
   }
-  executor_->HandleModelUpdate(feature_map, data_size);
+  if (IsFbsFeatureMapUpdate()) {
+    executor_->HandleModelUpdate(update_model_req->feature_map(), data_size);
+  } else {
+    executor_->HandleModelUpdate(feature_map, data_size);
+  }
   UpdateClientUploadLoss(update_model_req->upload_loss(), data_size);
   UpdateClientUploadAccuracy(update_model_req->upload_accuracy(), eval_data_size);
   BuildUpdateModelRsp(fbb, schema::ResponseCode_SUCCEED, "success not ready",
@@ -442,33 +464,6 @@ ResultCode UpdateModelKernel::CountForAggregation() {
   return ResultCode::kSuccess;
 }
 
-ModelItemPtr UpdateModelKernel::ParseModelItemPtr(const schema::RequestUpdateModel *update_model_req) {
-  ModelItemPtr modelItemPtr = std::make_shared<ModelItem>();
-  auto upload_feature_map = update_model_req->feature_map();
-  for (uint32_t i = 0; i < upload_feature_map->size(); i++) {
-    const auto &item = upload_feature_map->Get(i);
-
-    if (item == nullptr || item->weight_fullname() == nullptr || item->data() == nullptr) {
-      MS_LOG(WARNING) << "Verify upload feature map failed";
-      return nullptr;
-    }
-    WeightItem weight;
-    std::string weight_full_name = item->weight_fullname()->str();
-    const auto &data = item->data();
-    size_t weight_size = data->size() * sizeof(float);
-
-    weight.name = weight_full_name;
-    weight.size = weight_size;
-    uint8_t *upload_weight_data_arr = reinterpret_cast<uint8_t *>(const_cast<float *>(data->data()));
-    std::vector<uint8_t> upload_weight_data(upload_weight_data_arr,
-                                            upload_weight_data_arr + weight_size / sizeof(uint8_t));
-    modelItemPtr->weight_items[weight_full_name] = weight;
-    modelItemPtr->weight_data.insert(modelItemPtr->weight_data.end(), upload_weight_data.begin(),
-                                     upload_weight_data.end());
-  }
-  return modelItemPtr;
-}
-
 std::map<std::string, Address> UpdateModelKernel::ParseFeatureMap(const schema::RequestUpdateModel *update_model_req) {
   std::map<std::string, Address> feature_map;
   auto fbs_feature_map = update_model_req->feature_map();
@@ -501,11 +496,10 @@ std::map<std::string, Address> UpdateModelKernel::ParseSignDSFeatureMap(
   }
 
   auto latest_model = ModelStore::GetInstance().GetLatestModel().second;
-  if (latest_model == nullptr || latest_model->weight_data.empty()) {
+  if (latest_model == nullptr || latest_model->empty()) {
     MS_LOG_ERROR << "Failed to get latest model";
     return {};
   }
-  auto weight_data = latest_model->weight_data.data();
   auto index_array = update_model_req->index_array();
   size_t index_store = 0;
   size_t index_array_j = 0;
@@ -513,7 +507,8 @@ std::map<std::string, Address> UpdateModelKernel::ParseSignDSFeatureMap(
   for (size_t i = 0; i < fbs_feature_map->size(); i++) {
     std::string weight_full_name = fbs_feature_map->Get(i)->weight_fullname()->str();
     auto weight_info = latest_model->weight_items[weight_full_name];
-    auto feature_data = weight_data + weight_info.offset;
+    auto feature_data = latest_model->weight_addr(weight_info);
+    MS_ERROR_IF_NULL_W_RET_VAL(feature_data, {});
     size_t iter_feature_num = weight_info.size / sizeof(float);
     auto &weight_item = (*weight_map)[weight_full_name];
     weight_item.resize(iter_feature_num);
@@ -575,6 +570,8 @@ std::map<std::string, Address> UpdateModelKernel::DecodeFeatureMap(
   MS_LOG(DEBUG) << "The seed for compression is: " << seed;
   auto upload_sparse_rate = update_model_req->upload_sparse_rate();
   MS_LOG(DEBUG) << "The upload_sparse_rate for compression is: " << upload_sparse_rate;
+  auto mask_version = update_model_req->sparse_mask_version();
+  MS_LOG(DEBUG) << "The sparse_mask_version for compression is: " << mask_version;
   // Get name vector.
   auto fbs_name_vec = update_model_req->name_vec();
   std::vector<std::string> name_vec;
@@ -595,6 +592,13 @@ std::map<std::string, Address> UpdateModelKernel::DecodeFeatureMap(
     }
     compress_feature_map.min_val = feature->min_val();
     compress_feature_map.max_val = feature->max_val();
+    if (feature->block_min_val() != nullptr && feature->block_max_val() != nullptr && feature->block_size() > 0 &&
+        feature->data_size() > 0) {
+      compress_feature_map.data_size = IntToSize(feature->data_size());
+      compress_feature_map.block_size = IntToSize(feature->block_size());
+      compress_feature_map.block_min_vals.assign(feature->block_min_val()->begin(), feature->block_min_val()->end());
+      compress_feature_map.block_max_vals.assign(feature->block_max_val()->begin(), feature->block_max_val()->end());
+    }
     MS_LOG(DEBUG) << "Min value: " << compress_feature_map.min_val;
     MS_LOG(DEBUG) << "Max value: " << compress_feature_map.max_val;
     compress_feature_maps.emplace_back(compress_feature_map);
@@ -602,7 +606,8 @@ std::map<std::string, Address> UpdateModelKernel::DecodeFeatureMap(
 
   // Decode.
   bool status = mindspore::fl::compression::DecodeExecutor::GetInstance().Decode(
-    weight_map, compress_feature_maps, upload_compress_type, upload_sparse_rate, seed, name_vec, data_size);
+    weight_map, compress_feature_maps, upload_compress_type, upload_sparse_rate, seed, mask_version, name_vec,
+    data_size);
   if (status) {
     for (size_t i = 0; i < name_vec.size(); ++i) {
       std::string weight_full_name = name_vec[i];
@@ -76,7 +76,6 @@ class UpdateModelKernel : public RoundKernel {
                                                                std::map<std::string, std::vector<float>> *weight_map);
   bool VerifySignDSFeatureMap(const schema::RequestUpdateModel *update_model_req, DeviceMeta *device_meta);
   bool VerifyUploadCompressFeatureMap(const schema::RequestUpdateModel *update_model_req, DeviceMeta *device_meta);
-  ModelItemPtr ParseModelItemPtr(const schema::RequestUpdateModel *update_model_req);
   sigVerifyResult VerifySignature(const schema::RequestUpdateModel *update_model_req);
   void BuildUpdateModelRsp(const std::shared_ptr<FBBuilder> &fbb, const schema::ResponseCode retcode,
                            const std::string &reason, const std::string &next_req_time);
@@ -98,6 +97,10 @@ class UpdateModelKernel : public RoundKernel {
   // Check upload mode
   bool IsCompress(const schema::RequestUpdateModel *update_model_req);
 
+  // Whether the uploaded weights are verified and accumulated in place in the flatbuffer, which is true unless they
+  // have to be decoded or reconstructed first.
+  bool IsFbsFeatureMapUpdate() const;
+
   // From StartFlJob to UpdateModel complete time and number
   std::vector<std::pair<uint64_t, uint32_t>> participation_time_and_num_{};
 
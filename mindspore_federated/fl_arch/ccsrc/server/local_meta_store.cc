@@ -68,36 +68,45 @@ bool LocalMetaStore::verifyAggregationFeatureMap(const ModelItemPtr &modelItemPt
       return false;
     }
   }
-  float *data_arr = reinterpret_cast<float *>(modelItemPtr->weight_data.data());
-  std::vector<float> weight_data(data_arr, data_arr + modelItemPtr->weight_data.size() / sizeof(float));
-
-  for (const auto &data : weight_data) {
-    if (std::isnan(data) || std::isinf(data)) {
-      MS_LOG(WARNING) << "The aggregation weight is nan or inf.";
+  for (const auto &weight : modelItemPtr->weight_items) {
+    auto weight_data = reinterpret_cast<const float *>(modelItemPtr->weight_addr(weight.second));
+    if (weight_data == nullptr) {
       return false;
     }
+    size_t elem_num = weight.second.size / sizeof(float);
+    for (size_t i = 0; i < elem_num; i++) {
+      if (std::isnan(weight_data[i]) || std::isinf(weight_data[i])) {
+        MS_LOG(WARNING) << "The aggregation weight is nan or inf.";
+        return false;
+      }
+    }
   }
   return true;
 }
 
 bool LocalMetaStore::verifyAggregationFeatureMap(const std::map<std::string, Address> &model) {
-  ModelItemPtr modelItemPtr = std::make_shared<ModelItem>();
+  // Verify the uploaded weights in place rather than copying them into a ModelItem.
+  if (model.size() > aggregation_feature_map_->weight_items.size()) {
+    return false;
+  }
   for (const auto &item : model) {
-    WeightItem weight;
-    std::string weight_full_name = item.first;
-    size_t weight_size = item.second.size;
-
-    weight.name = weight_full_name;
-    weight.size = weight_size;
-
-    uint8_t *upload_weight_data_arr = reinterpret_cast<uint8_t *>(const_cast<void *>(item.second.addr));
-    std::vector<uint8_t> upload_weight_data(upload_weight_data_arr,
-                                            upload_weight_data_arr + weight_size / sizeof(uint8_t));
-    modelItemPtr->weight_items[weight_full_name] = weight;
-    modelItemPtr->weight_data.insert(modelItemPtr->weight_data.end(), upload_weight_data.begin(),
-                                     upload_weight_data.end());
+    auto it = aggregation_feature_map_->weight_items.find(item.first);
+    if (it == aggregation_feature_map_->weight_items.end() || item.second.size != it->second.size) {
+      return false;
+    }
+    auto weight_data = reinterpret_cast<const float *>(item.second.addr);
+    size_t elem_num = item.second.size / sizeof(float);
+    if (weight_data == nullptr && elem_num > 0) {
+      return false;
+    }
+    for (size_t i = 0; i < elem_num; i++) {
+      if (std::isnan(weight_data[i]) || std::isinf(weight_data[i])) {
+        MS_LOG(WARNING) << "The aggregation weight is nan or inf.";
+        return false;
+      }
+    }
   }
-  return verifyAggregationFeatureMap(modelItemPtr);
+  return true;
 }
 }  // namespace server
 }  // namespace fl
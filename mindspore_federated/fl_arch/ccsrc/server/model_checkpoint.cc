@@ -0,0 +1,368 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "server/model_checkpoint.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <utility>
+#include "common/fl_context.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+namespace {
+constexpr char kCheckpointMagic[] = "MSFLCKPT";
+constexpr size_t kCheckpointMagicLen = 8;
+constexpr uint32_t kCheckpointVersion = 2;
+constexpr size_t kCheckpointAlignment = 64;
+constexpr char kCheckpointFileSuffix[] = "_server_model.flckpt";
+
+struct CheckpointHeader {
+  char magic[kCheckpointMagicLen];
+  uint32_t version;
+  uint32_t weight_num;
+  uint64_t iteration;
+  uint64_t payload_offset;
+  uint64_t file_size;
+};
+
+// Followed by name_len bytes of name, type_len bytes of type and dim_num uint64_t dims.
+struct CheckpointWeightEntry {
+  uint64_t offset;
+  uint64_t size;
+  uint32_t require_aggr;
+  uint32_t name_len;
+  uint32_t type_len;
+  uint32_t dim_num;
+};
+
+size_t AlignUp(size_t value) {
+  return (value + kCheckpointAlignment - 1) / kCheckpointAlignment * kCheckpointAlignment;
+}
+
+template <typename T>
+void AppendPod(std::string *buffer, const T &value) {
+  buffer->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+bool WriteAll(int fd, const void *data, size_t size) {
+  auto ptr = reinterpret_cast<const char *>(data);
+  while (size > 0) {
+    auto ret = write(fd, ptr, size);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    ptr += ret;
+    size -= static_cast<size_t>(ret);
+  }
+  return true;
+}
+
+bool WritePadding(int fd, size_t cur_offset, size_t target_offset) {
+  static const char zeros[kCheckpointAlignment] = {0};
+  return cur_offset == target_offset || WriteAll(fd, zeros, target_offset - cur_offset);
+}
+
+// Sync the directory of the file, so that a rename in it survives a crash.
+bool SyncParentDir(const std::string &file_path) {
+  auto dir_pos = file_path.find_last_of('/');
+  std::string dir = ".";
+  if (dir_pos == 0) {
+    dir = "/";
+  } else if (dir_pos != std::string::npos) {
+    dir = file_path.substr(0, dir_pos);
+  }
+  int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    return false;
+  }
+  bool success = fsync(fd) == 0;
+  (void)close(fd);
+  return success;
+}
+}  // namespace
+
+void ModelCheckpoint::Start() {
+  if (!is_stopped_) {
+    return;
+  }
+  is_stopped_ = false;
+  writer_thread_ = std::thread([this]() { WriterThreadHandle(); });
+}
+
+void ModelCheckpoint::Stop() {
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+    is_stopped_ = true;
+  }
+  cond_var_.notify_all();
+  if (writer_thread_.joinable()) {
+    writer_thread_.join();
+  }
+}
+
+void ModelCheckpoint::SaveAsync(size_t iteration, const ModelItemPtr &model) {
+  if (model == nullptr || CheckpointPath().empty()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(lock_);
+  pending_iteration_ = iteration;
+  pending_model_ = model;
+  cond_var_.notify_all();
+}
+
+void ModelCheckpoint::WriterThreadHandle() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(lock_);
+    cond_var_.wait(lock, [this]() { return is_stopped_ || pending_model_ != nullptr; });
+    if (pending_model_ == nullptr) {
+      return;
+    }
+    auto iteration = pending_iteration_;
+    auto model = std::move(pending_model_);
+    pending_model_ = nullptr;
+    lock.unlock();
+    auto file_path = CheckpointPath();
+    if (!Save(file_path, iteration, *model)) {
+      MS_LOG_WARNING << "Failed to save model checkpoint of iteration " << iteration << " to " << file_path;
+    }
+  }
+}
+
+std::string ModelCheckpoint::CheckpointPath() {
+  auto checkpoint_dir = FLContext::instance()->checkpoint_dir();
+  struct stat dir_stat {};
+  if (checkpoint_dir.empty() || stat(checkpoint_dir.c_str(), &dir_stat) != 0 || !S_ISDIR(dir_stat.st_mode)) {
+    return "";
+  }
+  if (checkpoint_dir.back() != '/') {
+    checkpoint_dir += "/";
+  }
+  return checkpoint_dir + FLContext::instance()->fl_name() + kCheckpointFileSuffix;
+}
+
+bool ModelCheckpoint::Save(const std::string &file_path, size_t iteration, const ModelItem &model) {
+  if (file_path.empty() || model.empty()) {
+    return false;
+  }
+  // Build the header and weight table first to know where the payload begins.
+  std::vector<CheckpointWeightEntry> entries;
+  for (auto &item : model.weight_items) {
+    auto &weight = item.second;
+    CheckpointWeightEntry entry{};
+    entry.size = weight.size;
+    entry.require_aggr = weight.require_aggr ? 1 : 0;
+    entry.name_len = static_cast<uint32_t>(weight.name.size());
+    entry.type_len = static_cast<uint32_t>(weight.type.size());
+    entry.dim_num = static_cast<uint32_t>(weight.shape.size());
+    entries.push_back(entry);
+  }
+  size_t table_size = sizeof(CheckpointHeader);
+  size_t index = 0;
+  for (auto &item : model.weight_items) {
+    table_size += sizeof(CheckpointWeightEntry) + item.second.name.size() + item.second.type.size() +
+                  item.second.shape.size() * sizeof(uint64_t);
+  }
+  size_t payload_offset = AlignUp(table_size);
+  std::vector<const uint8_t *> weight_addrs;
+  for (auto &item : model.weight_items) {
+    auto weight_addr = model.weight_addr(item.second);
+    if (weight_addr == nullptr) {
+      MS_LOG_WARNING << "Data of weight " << item.first << " is missing";
+      return false;
+    }
+    weight_addrs.push_back(weight_addr);
+  }
+  // The weights which require aggregation are written back to back, so that ModelStore uses them in place as one
+  // buffer on loading.
+  std::vector<size_t> write_order;
+  size_t cur_offset = payload_offset;
+  for (index = 0; index < entries.size(); index++) {
+    if (entries[index].require_aggr != 0) {
+      entries[index].offset = cur_offset;
+      cur_offset += entries[index].size;
+      write_order.push_back(index);
+    }
+  }
+  cur_offset = AlignUp(cur_offset);
+  for (index = 0; index < entries.size(); index++) {
+    if (entries[index].require_aggr == 0) {
+      entries[index].offset = cur_offset;
+      cur_offset = AlignUp(cur_offset + entries[index].size);
+      write_order.push_back(index);
+    }
+  }
+  size_t file_size = cur_offset;
+
+  CheckpointHeader header{};
+  (void)memcpy(header.magic, kCheckpointMagic, kCheckpointMagicLen);
+  header.version = kCheckpointVersion;
+  header.weight_num = static_cast<uint32_t>(entries.size());
+  header.iteration = iteration;
+  header.payload_offset = payload_offset;
+  header.file_size = file_size;
+  std::string table;
+  table.reserve(table_size);
+  AppendPod(&table, header);
+  index = 0;
+  for (auto &item : model.weight_items) {
+    auto &weight = item.second;
+    AppendPod(&table, entries[index++]);
+    table.append(weight.name);
+    table.append(weight.type);
+    for (auto dim : weight.shape) {
+      AppendPod(&table, static_cast<uint64_t>(dim));
+    }
+  }
+
+  auto tmp_path = file_path + ".tmp." + std::to_string(getpid());
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    MS_LOG_WARNING << "Failed to open " << tmp_path << ", errno: " << errno;
+    return false;
+  }
+  bool success = WriteAll(fd, table.data(), table.size());
+  cur_offset = table.size();
+  for (auto i : write_order) {
+    success = success && WritePadding(fd, cur_offset, entries[i].offset) &&
+              WriteAll(fd, weight_addrs[i], entries[i].size);
+    cur_offset = entries[i].offset + entries[i].size;
+  }
+  success = success && WritePadding(fd, cur_offset, file_size) && fsync(fd) == 0;
+  (void)close(fd);
+  if (!success || rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+    MS_LOG_WARNING << "Failed to write checkpoint " << file_path << ", errno: " << errno;
+    (void)unlink(tmp_path.c_str());
+    return false;
+  }
+  if (!SyncParentDir(file_path)) {
+    MS_LOG_WARNING << "Failed to sync the directory of checkpoint " << file_path << ", errno: " << errno;
+    return false;
+  }
+  MS_LOG_INFO << "Save model checkpoint of iteration " << iteration << " to " << file_path << ", size " << file_size;
+  return true;
+}
+
+MappedCheckpoint::~MappedCheckpoint() { Close(); }
+
+void MappedCheckpoint::Close() {
+  mapping_ = nullptr;
+  size_ = 0;
+  weights_.clear();
+}
+
+bool MappedCheckpoint::Open(const std::string &file_path) {
+  Close();
+  if (file_path.empty()) {
+    return false;
+  }
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(CheckpointHeader)) {
+    (void)close(fd);
+    return false;
+  }
+  auto size = static_cast<size_t>(file_stat.st_size);
+  // Writable but private, ModelStore updates the weights in place without touching the file.
+  auto addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  (void)close(fd);
+  if (addr == MAP_FAILED) {
+    MS_LOG_WARNING << "Failed to map checkpoint " << file_path << ", errno: " << errno;
+    return false;
+  }
+  mapping_ = std::shared_ptr<void>(addr, [size](void *ptr) { (void)munmap(ptr, size); });
+  size_ = size;
+  if (!Parse()) {
+    MS_LOG_WARNING << "Checkpoint " << file_path << " is invalid";
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool MappedCheckpoint::Parse() {
+  auto base = reinterpret_cast<const uint8_t *>(mapping_.get());
+  CheckpointHeader header{};
+  (void)memcpy(&header, base, sizeof(header));
+  if (memcmp(header.magic, kCheckpointMagic, kCheckpointMagicLen) != 0 || header.version != kCheckpointVersion ||
+      header.file_size != size_ || header.payload_offset > size_) {
+    return false;
+  }
+  iteration_ = header.iteration;
+  size_t pos = sizeof(CheckpointHeader);
+  for (uint32_t i = 0; i < header.weight_num; i++) {
+    CheckpointWeightEntry entry{};
+    if (pos + sizeof(entry) > header.payload_offset) {
+      return false;
+    }
+    (void)memcpy(&entry, base + pos, sizeof(entry));
+    pos += sizeof(entry);
+    size_t shape_len = static_cast<size_t>(entry.dim_num) * sizeof(uint64_t);
+    if (pos + entry.name_len + entry.type_len + shape_len > header.payload_offset ||
+        entry.offset < header.payload_offset || entry.offset > size_ || entry.size > size_ - entry.offset) {
+      return false;
+    }
+    InputWeight weight;
+    weight.name.assign(reinterpret_cast<const char *>(base + pos), entry.name_len);
+    pos += entry.name_len;
+    weight.type.assign(reinterpret_cast<const char *>(base + pos), entry.type_len);
+    pos += entry.type_len;
+    for (uint32_t j = 0; j < entry.dim_num; j++) {
+      uint64_t dim = 0;
+      (void)memcpy(&dim, base + pos, sizeof(dim));
+      weight.shape.push_back(static_cast<size_t>(dim));
+      pos += sizeof(dim);
+    }
+    weight.data = base + entry.offset;
+    weight.size = entry.size;
+    weight.require_aggr = entry.require_aggr != 0;
+    weight.data_owner = mapping_;
+    weights_.push_back(std::move(weight));
+  }
+  return true;
+}
+
+bool MappedCheckpoint::Match(const std::vector<InputWeight> &expect_weights) const {
+  if (expect_weights.size() != weights_.size()) {
+    return false;
+  }
+  std::map<std::string, const InputWeight *> weight_map;
+  for (auto &weight : weights_) {
+    weight_map[weight.name] = &weight;
+  }
+  for (auto &expect : expect_weights) {
+    auto it = weight_map.find(expect.name);
+    if (it == weight_map.end() || it->second->size != expect.size ||
+        it->second->require_aggr != expect.require_aggr) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MINDSPORE_CCSRC_FL_SERVER_MODEL_CHECKPOINT_H_
+#define MINDSPORE_CCSRC_FL_SERVER_MODEL_CHECKPOINT_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+// ModelCheckpoint writes the latest model of ModelStore to {checkpoint_dir}/{fl_name}_server_model.flckpt after each
+// iteration if checkpoint_dir exists, so that a restarted server maps the file instead of pulling the model from other
+// servers.
+//
+// File layout, integers are in host byte order:
+//   header: magic, version, weight number, iteration, payload offset and file size.
+//   weight table: for each weight, its payload offset, size, require_aggr, name, type and shape.
+//   payload: the weights which require aggregation back to back in name order, as ModelStore lays them out, then each
+//   of the other weights, all aligned to kCheckpointAlignment bytes.
+// The file is written to a temporary file which is synced and renamed, then the directory is synced, so a crash leaves
+// either the previous or the new checkpoint.
+class ModelCheckpoint {
+ public:
+  static ModelCheckpoint &GetInstance() {
+    static ModelCheckpoint instance;
+    return instance;
+  }
+
+  // Start and stop the thread which writes checkpoints. Stop writes the pending checkpoint before returning.
+  void Start();
+  void Stop();
+
+  // Queue the model to be written. If the writer is busy, only the latest queued model is written.
+  void SaveAsync(size_t iteration, const ModelItemPtr &model);
+
+  // Returns the checkpoint path of the current job, or an empty string if the checkpoint dir is not set or does not
+  // exist.
+  static std::string CheckpointPath();
+
+  static bool Save(const std::string &file_path, size_t iteration, const ModelItem &model);
+
+ private:
+  ModelCheckpoint() = default;
+  ~ModelCheckpoint() = default;
+  ModelCheckpoint(const ModelCheckpoint &) = delete;
+  ModelCheckpoint &operator=(const ModelCheckpoint &) = delete;
+
+  void WriterThreadHandle();
+
+  std::thread writer_thread_;
+  std::mutex lock_;
+  std::condition_variable cond_var_;
+  std::atomic_bool is_stopped_ = true;
+  size_t pending_iteration_ = 0;
+  ModelItemPtr pending_model_ = nullptr;
+};
+
+// A checkpoint file mapped copy on write. The data of the weights points into the mapping, and their data_owner keeps
+// the mapping alive after the object is closed or destroyed, so ModelStore uses the weights in place.
+class MappedCheckpoint {
+ public:
+  MappedCheckpoint() = default;
+  ~MappedCheckpoint();
+  MappedCheckpoint(const MappedCheckpoint &) = delete;
+  MappedCheckpoint &operator=(const MappedCheckpoint &) = delete;
+
+  bool Open(const std::string &file_path);
+  // Whether the weights have the same names, sizes and require_aggr as the expected ones.
+  bool Match(const std::vector<InputWeight> &expect_weights) const;
+
+  size_t iteration() const { return iteration_; }
+  const std::vector<InputWeight> &weights() const { return weights_; }
+
+ private:
+  bool Parse();
+  void Close();
+
+  std::shared_ptr<void> mapping_ = nullptr;
+  size_t size_ = 0;
+  size_t iteration_ = 0;
+  std::vector<InputWeight> weights_;
+};
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
+#endif  // MINDSPORE_CCSRC_FL_SERVER_MODEL_CHECKPOINT_H_
@@ -15,11 +15,13 @@
  */
 
 #include "server/model_store.h"
+#include <algorithm>
 #include <map>
 #include <string>
 #include <memory>
 #include <utility>
 #include "common/utils/python_adapter.h"
+#include "server/model_checkpoint.h"
 #include "distributed_cache/instance_context.h"
 
 namespace mindspore {
@@ -32,9 +34,12 @@ void ModelStore::Initialize(const std::vector<InputWeight> &feature_map, uint32_
   InitModel(feature_map);
   MS_EXCEPTION_IF_NULL(initial_model_);
   iteration_to_model_[latest_iteration_num] = initial_model_;
-  for (const auto &item : mindspore::fl::compression::kCompressTypeMap) {
-    iteration_to_compress_model_[latest_iteration_num][item.first] =
-      AssignNewCompressModelMemory(item.first, initial_model_);
+  // Other compress types are encoded when they are first requested.
+  auto &compress_executor = mindspore::fl::compression::CompressExecutor::GetInstance();
+  auto compress_type = compress_executor.GetContextCompressType();
+  if (compress_executor.EnableCompressWeight(compress_type)) {
+    iteration_to_compress_model_[latest_iteration_num][compress_type] =
+      AssignNewCompressModelMemory(compress_type, initial_model_);
   }
   model_size_ = initial_model_->model_size;
   MS_LOG(INFO) << "Model store checkpoint dir is: " << FLContext::instance()->checkpoint_dir();
@@ -57,29 +62,77 @@ void ModelStore::InitModel(const std::vector<InputWeight> &feature_map) {
   if (model_size == 0 || model_size >= INT32_MAX) {
     MS_LOG(EXCEPTION) << "Model size " << model_size << " cannot <=0 or >=UINT32_MAX";
   }
-  // Assign new memory for the model.
-  initial_model_ = AllocNewModelItem(model_size);
-  initial_model_->model_size = model_size;
-  initial_model_->weight_data.resize(model_size);
-  auto model_data = initial_model_->weight_data.data();
-  size_t cur_offset = 0;
+  std::map<std::string, WeightItem> weight_items;
+  std::map<std::string, const InputWeight *> weight_inputs;
   for (auto &feature : feature_map) {
-    auto ret = memcpy_s(model_data + cur_offset, feature.size, feature.data, feature.size);
-    if (ret != EOK) {
-      MS_LOG(EXCEPTION) << "memcpy_s failed, ret " << ret << ", feature size: " << feature.size
-                        << ", cur offset: " << cur_offset;
-    }
-    auto &weight_item = initial_model_->weight_items[feature.name];
+    auto &weight_item = weight_items[feature.name];
     weight_item.name = feature.name;
-    weight_item.offset = cur_offset;
     weight_item.size = feature.size;
     weight_item.shape = feature.shape;
     weight_item.type = feature.type;
     weight_item.require_aggr = feature.require_aggr;
-    cur_offset += feature.size;
-
+    weight_inputs[feature.name] = &feature;
+  }
+  // Weights which require aggregation are laid out back to back in name order, which is the order the executor
+  // allreduces them in, the others get their own buffers which are shared by the models of all iterations.
+  size_t aggr_size = 0;
+  for (auto &item : weight_items) {
+    if (item.second.require_aggr) {
+      item.second.offset = aggr_size;
+      aggr_size += item.second.size;
+    }
+  }
+  // The weights with a data owner, e.g. the ones mapped from the checkpoint, are used in place. The weights which
+  // require aggregation are used in place only if they are already laid out back to back in name order.
+  const InputWeight *first_aggr_feature = nullptr;
+  const uint8_t *next_aggr_data = nullptr;
+  bool borrow_aggr = true;
+  for (auto &item : weight_items) {
+    auto feature = weight_inputs[item.first];
+    if (!item.second.require_aggr) {
+      continue;
+    }
+    if (feature->data_owner == nullptr || (next_aggr_data != nullptr && feature->data != next_aggr_data)) {
+      borrow_aggr = false;
+      break;
+    }
+    if (first_aggr_feature == nullptr) {
+      first_aggr_feature = feature;
+    }
+    next_aggr_data = reinterpret_cast<const uint8_t *>(feature->data) + feature->size;
+  }
+  borrow_aggr = borrow_aggr && first_aggr_feature != nullptr;
+  if (borrow_aggr) {
+    initial_model_ = std::make_shared<ModelItem>();
+    auto aggr_data = reinterpret_cast<uint8_t *>(const_cast<void *>(first_aggr_feature->data));
+    initial_model_->weight_data = WeightBuffer(aggr_data, aggr_size, first_aggr_feature->data_owner);
+  } else {
+    // Assign new memory for the model.
+    initial_model_ = AllocNewModelItem(aggr_size);
+  }
+  MS_EXCEPTION_IF_NULL(initial_model_);
+  initial_model_->model_size = model_size;
+  initial_model_->weight_items = weight_items;
+  initial_model_->shared_weights.clear();
+  for (auto &item : weight_items) {
+    auto &weight_item = item.second;
+    auto feature = weight_inputs[item.first];
+    bool borrowed = weight_item.require_aggr ? borrow_aggr : feature->data_owner != nullptr;
+    if (!weight_item.require_aggr) {
+      auto data = reinterpret_cast<uint8_t *>(const_cast<void *>(feature->data));
+      initial_model_->shared_weights[item.first] =
+        borrowed ? std::make_shared<WeightBuffer>(data, weight_item.size, feature->data_owner)
+                 : std::make_shared<WeightBuffer>(weight_item.size);
+    }
+    if (!borrowed) {
+      auto ret = memcpy_s(initial_model_->weight_addr(weight_item), weight_item.size, feature->data, feature->size);
+      if (ret != EOK) {
+        MS_LOG(EXCEPTION) << "memcpy_s failed, ret " << ret << ", feature size: " << feature->size
+                          << ", offset: " << weight_item.offset;
+      }
+    }
     MS_LOG(INFO) << "Aggregate Weight full name is " << weight_item.name << ", weight byte size is "
-                 << weight_item.size;
+                 << weight_item.size << ", require aggregation: " << weight_item.require_aggr;
   }
   LocalMetaStore::GetInstance().put_aggregation_feature_map(initial_model_);
 }
@@ -163,11 +216,12 @@ bool ModelStore::StoreModelByIterNum(size_t iteration, const std::map<std::strin
   }
   iteration_to_model_[iteration] = stored_model;
   OnIterationUpdate();
+  ModelCheckpoint::GetInstance().SaveAsync(iteration, stored_model);
   return true;
 }
 
 bool ModelStore::StoreModelByIterNum(size_t iteration, const ModelItemPtr &new_model_ptr) {
-  if (new_model_ptr == nullptr || new_model_ptr->weight_data.empty() || new_model_ptr->weight_items.empty()) {
+  if (new_model_ptr == nullptr || new_model_ptr->empty()) {
     MS_LOG(WARNING) << "Model cannot be empty.";
     return false;
   }
@@ -186,6 +240,7 @@ bool ModelStore::StoreModelByIterNum(size_t iteration, const ModelItemPtr &new_m
   }
   iteration_to_model_[iteration] = new_model_ptr;
   OnIterationUpdate();
+  ModelCheckpoint::GetInstance().SaveAsync(iteration, new_model_ptr);
   return true;
 }
 
@@ -221,13 +276,22 @@ std::map<std::string, AddressPtr> ModelStore::GetCompressModelByIterNum(size_t i
     StoreCompressModelByIterNum(iteration, no_compress_model);
     lock.lock();
   }
-  std::map<schema::CompressType, std::shared_ptr<MemoryRegister>> compress_model_map =
-    iteration_to_compress_model_[iteration];
+  auto &compress_model_map = iteration_to_compress_model_[iteration];
   if (compress_model_map.count(compressType) == 0) {
-    MS_LOG(ERROR) << "Compress Model for compress type " << compressType << " is not stored.";
-    return compressModel;
+    // The compress type is not the configured one, encode it for this request and later ones.
+    auto model_it = iteration_to_model_.find(iteration);
+    if (model_it == iteration_to_model_.end()) {
+      MS_LOG(ERROR) << "Compress Model for compress type " << compressType << " is not stored.";
+      return compressModel;
+    }
+    auto memory_register = AssignNewCompressModelMemory(compressType, model_it->second);
+    if (memory_register == nullptr) {
+      MS_LOG(ERROR) << "Failed to encode model for compress type " << compressType;
+      return compressModel;
+    }
+    compress_model_map[compressType] = memory_register;
   }
-  compressModel = iteration_to_compress_model_[iteration][compressType]->addresses();
+  compressModel = compress_model_map[compressType]->addresses();
   return compressModel;
 }
 
@@ -251,9 +315,9 @@ const std::map<size_t, CompressTypeMap> &ModelStore::iteration_to_compress_model
 
 size_t ModelStore::model_size() const { return model_size_; }
 
-ModelItemPtr ModelStore::AllocNewModelItem(size_t model_size) {
+ModelItemPtr ModelStore::AllocNewModelItem(size_t weight_data_size) {
   std::unique_lock<std::mutex> lock(model_cache_mtx_);
-  auto &cache_list = empty_model_cache_[model_size];
+  auto &cache_list = empty_model_cache_[weight_data_size];
   for (auto &item : cache_list) {
     if (item.use_count() == 1) {
       return item;
@@ -263,8 +327,7 @@ ModelItemPtr ModelStore::AllocNewModelItem(size_t model_size) {
   if (model == nullptr) {
     return nullptr;
   }
-  model->weight_data.resize(model_size);
-  model->model_size = model_size;
+  model->weight_data.resize(weight_data_size);
   constexpr size_t max_cache_size = 6;
   if (cache_list.size() < max_cache_size) {
     cache_list.push_back(model);
@@ -273,7 +336,7 @@ ModelItemPtr ModelStore::AllocNewModelItem(size_t model_size) {
 }
 
 ModelItemPtr ModelStore::AssignNewModelMemory() {
-  if (initial_model_ == nullptr || initial_model_->weight_data.empty() || initial_model_->weight_items.empty()) {
+  if (initial_model_ == nullptr || initial_model_->empty()) {
     MS_LOG(WARNING) << "Load model is invalid.";
     return nullptr;
   }
@@ -284,42 +347,35 @@ ModelItemPtr ModelStore::AssignNewModelMemory() {
   if (weight_data.size() != initial_model_->weight_data.size()) {
     return nullptr;
   }
-  auto ret = memset_s(weight_data.data(), weight_data.size(), 0, weight_data.size());
-  if (ret != EOK) {
-    MS_LOG_WARNING << "Failed to init weight data, memset_s return " << ret;
-    return nullptr;
-  }
-  new_model->weight_items = initial_model_->weight_items;
-  auto new_weight_base = weight_data.data();
-  auto src_weight_base = initial_model_->weight_data.data();
-  for (auto &weight : initial_model_->weight_items) {
-    auto &weight_info = weight.second;
-    if (!weight_info.require_aggr) {
-      auto dst_size = weight_data.size() - weight_info.offset;
-      ret = memcpy_s(new_weight_base + weight_info.offset, dst_size, src_weight_base + weight_info.offset,
-                     weight_info.size);
-      if (ret != EOK) {
-        MS_LOG_WARNING << "Failed to init weight data, memcpy_s return " << ret << ", offset: " << weight_info.offset
-                       << ", weight size: " << weight_info.size << ", model size: " << weight_data.size();
-        return nullptr;
-      }
+  if (!weight_data.empty()) {
+    auto ret = memset_s(weight_data.data(), weight_data.size(), 0, weight_data.size());
+    if (ret != EOK) {
+      MS_LOG_WARNING << "Failed to init weight data, memset_s return " << ret;
+      return nullptr;
     }
   }
+  new_model->model_size = initial_model_->model_size;
+  new_model->weight_items = initial_model_->weight_items;
+  // Weights which don't require aggregation are shared with the initial model rather than copied.
+  new_model->shared_weights = initial_model_->shared_weights;
   return new_model;
 }
 
 std::shared_ptr<MemoryRegister> ModelStore::AssignNewCompressModelMemory(schema::CompressType compressType,
                                                                          const ModelItemPtr &model) {
-  if (model == nullptr || model->weight_items.empty() || model->weight_data.empty()) {
+  if (model == nullptr || model->empty()) {
     MS_LOG(EXCEPTION) << "Model feature map is empty.";
     return nullptr;
   }
-  std::map<std::string, std::vector<float>> feature_maps;
+  // The weights are quantized in place, the model is not copied.
+  std::map<std::string, Address> feature_maps;
   for (auto &feature : model->weight_items) {
     auto weight_fullname = feature.first;
-    auto weight_data = reinterpret_cast<float *>(model->weight_data.data() + feature.second.offset);
-    std::vector<float> weight_data_vector{weight_data, weight_data + feature.second.size / sizeof(float)};
-    feature_maps[weight_fullname] = weight_data_vector;
+    auto weight_data = model->weight_addr(feature.second);
+    if (weight_data == nullptr) {
+      MS_LOG(EXCEPTION) << "Data of weight " << weight_fullname << " is missing.";
+    }
+    feature_maps[weight_fullname] = Address(weight_data, feature.second.size);
   }
 
   std::map<std::string, mindspore::fl::compression::CompressWeight> compressWeights;
@@ -336,28 +392,34 @@ std::shared_ptr<MemoryRegister> ModelStore::AssignNewCompressModelMemory(schema:
   MS_LOG(INFO) << "Register compressWeight for compressType: " << schema::EnumNameCompressType(compressType);
 
   for (const auto &compressWeight : compressWeights) {
-    if (compressType == schema::CompressType_QUANT) {
-      std::string compress_weight_name = compressWeight.first;
-      std::string min_val_name = compress_weight_name + "." + kMinVal;
-      std::string max_val_name = compress_weight_name + "." + kMaxVal;
-      size_t compress_weight_size = compressWeight.second.compress_data_len * sizeof(int8_t);
-      auto compress_weight_data = std::make_unique<char[]>(compress_weight_size);
-      auto src_data_size = compress_weight_size;
-      auto dst_data_size = compress_weight_size;
-      int ret =
-        memcpy_s(compress_weight_data.get(), dst_data_size, compressWeight.second.compress_data.data(), src_data_size);
-      if (ret != 0) {
-        MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
-        return nullptr;
-      }
-      memory_register->RegisterArray(compress_weight_name, &compress_weight_data, compress_weight_size);
-      size_t float_size = 1;
-      auto min_val_ptr = std::make_unique<float>(compressWeight.second.min_val);
-      auto max_val_ptr = std::make_unique<float>(compressWeight.second.max_val);
-
-      memory_register->RegisterParameter(min_val_name, &min_val_ptr, float_size);
-      memory_register->RegisterParameter(max_val_name, &max_val_ptr, float_size);
+    std::string compress_weight_name = compressWeight.first;
+    std::string min_val_name = compress_weight_name + "." + kMinVal;
+    std::string max_val_name = compress_weight_name + "." + kMaxVal;
+    size_t compress_weight_size = compressWeight.second.compress_data.size() * sizeof(int8_t);
+    auto compress_weight_data = std::make_unique<char[]>(compress_weight_size);
+    auto src_data_size = compress_weight_size;
+    auto dst_data_size = compress_weight_size;
+    int ret =
+      memcpy_s(compress_weight_data.get(), dst_data_size, compressWeight.second.compress_data.data(), src_data_size);
+    if (ret != 0) {
+      MS_LOG(ERROR) << "memcpy_s error, errorno(" << ret << ")";
+      return nullptr;
     }
+    memory_register->RegisterArray(compress_weight_name, &compress_weight_data, compress_weight_size);
+    // One min and max for each quant block.
+    const auto &block_min_vals = compressWeight.second.block_min_vals;
+    const auto &block_max_vals = compressWeight.second.block_max_vals;
+    size_t block_vals_size = block_min_vals.size() * sizeof(float);
+    auto min_vals = std::make_unique<float[]>(block_min_vals.size());
+    auto max_vals = std::make_unique<float[]>(block_max_vals.size());
+    std::copy(block_min_vals.begin(), block_min_vals.end(), min_vals.get());
+    std::copy(block_max_vals.begin(), block_max_vals.end(), max_vals.get());
+    memory_register->RegisterArray(min_val_name, &min_vals, block_vals_size);
+    memory_register->RegisterArray(max_val_name, &max_vals, block_vals_size);
+    // The packed data may have padding bits, so the number of elements is stored as well.
+    auto data_size = std::make_unique<size_t[]>(1);
+    data_size[0] = compressWeight.second.compress_data_len;
+    memory_register->RegisterArray(compress_weight_name + "." + kDataSize, &data_size, sizeof(size_t));
   }
   return memory_register;
 }
@@ -368,7 +430,7 @@ void ModelStore::StoreCompressModelByIterNum(size_t iteration, const ModelItemPt
     MS_LOG(WARNING) << "Compress Model for iteration " << iteration << " is already stored";
     return;
   }
-  if (new_model == nullptr || new_model->weight_items.empty() || new_model->weight_data.empty()) {
+  if (new_model == nullptr || new_model->empty()) {
     MS_LOG(ERROR) << "Compress Model feature map is empty.";
     return;
   }
@@ -380,10 +442,12 @@ void ModelStore::StoreCompressModelByIterNum(size_t iteration, const ModelItemPt
     (void)iteration_to_compress_model_.erase(iteration_to_compress_model_.begin());
   }
 
-  for (const auto &item : mindspore::fl::compression::kCompressTypeMap) {
-    auto memory_register = AssignNewCompressModelMemory(item.first, new_model);
+  auto &compress_executor = mindspore::fl::compression::CompressExecutor::GetInstance();
+  auto compress_type = compress_executor.GetContextCompressType();
+  if (compress_executor.EnableCompressWeight(compress_type)) {
+    auto memory_register = AssignNewCompressModelMemory(compress_type, new_model);
     MS_ERROR_IF_NULL_WO_RET_VAL(memory_register);
-    iteration_to_compress_model_[iteration][item.first] = memory_register;
+    iteration_to_compress_model_[iteration][compress_type] = memory_register;
   }
 }
 
@@ -87,7 +87,7 @@ class MS_EXPORT ModelStore {
                                     const std::string &compress_type, const void *data, size_t datalen);
 
   ModelItemPtr AssignNewModelMemory();
-  ModelItemPtr AllocNewModelItem(size_t model_size);
+  ModelItemPtr AllocNewModelItem(size_t weight_data_size);
 
  private:
   ModelStore() : max_model_count_(0), model_size_(0), iteration_to_model_({}), iteration_to_compress_model_({}) {}
@@ -24,6 +24,7 @@
 #include "armour/cipher/cipher_init.h"
 #include "server/round.h"
 #include "server/model_store.h"
+#include "server/model_checkpoint.h"
 #include "server/iteration.h"
 #include "server/collective_ops_impl.h"
 #include "server/cert_verify.h"
@@ -176,12 +177,14 @@ void Server::RunMainProcess() {
               << ", instance state: " << cache::GetInstanceStateStr(state);
   Iteration::GetInstance().StartThreadToRecordDataRate();
   cache::IterationTaskThread::Instance().Start();
+  ModelCheckpoint::GetInstance().Start();
   while (!ExitHandler::Instance().HasStopped()) {
     RunMainProcessInner();
     constexpr int default_sync_duration_ms = 1000;  // 1000ms
     std::this_thread::sleep_for(std::chrono::milliseconds(default_sync_duration_ms));
   }
   cache::IterationTaskThread::Instance().Stop();
+  ModelCheckpoint::GetInstance().Stop();
   Iteration::GetInstance().Stop();
   MS_LOG_INFO << "End run main process";
 }
@@ -581,6 +584,17 @@ FlStatus Server::SyncAndInitModel(const std::vector<InputWeight> &init_feature_m
     return {kFlFailed, reason};
   }
   auto model_latest_iteration = updated_iteration - 1;
+  // The local checkpoint of the latest iteration saves pulling the model from other servers. Its weights are used in
+  // place by ModelStore and keep the mapping alive after the checkpoint object is destroyed.
+  MappedCheckpoint checkpoint;
+  bool checkpoint_valid =
+    checkpoint.Open(ModelCheckpoint::CheckpointPath()) && checkpoint.Match(init_feature_map);
+  if (checkpoint_valid && checkpoint.iteration() == model_latest_iteration) {
+    Executor::GetInstance().Initialize(checkpoint.weights(), server_node_);
+    MS_LOG_INFO << "Load model success: The local checkpoint is used as the model of iteration "
+                << model_latest_iteration;
+    return kFlSuccess;
+  }
   VectorPtr output = nullptr;
   if (server_node_->GetModelWeight(model_latest_iteration, &output)) {
     ProtoModel proto_model;
@@ -603,6 +617,10 @@ FlStatus Server::SyncAndInitModel(const std::vector<InputWeight> &init_feature_m
     Executor::GetInstance().Initialize(feature_map, server_node_);
     MS_LOG_INFO << "Load model success: The model synced from other servers is used as the model of iteration "
                 << model_latest_iteration;
+  } else if (checkpoint_valid) {
+    Executor::GetInstance().Initialize(checkpoint.weights(), server_node_);
+    MS_LOG_INFO << "Load model success: The local checkpoint of iteration " << checkpoint.iteration()
+                << " is used as the model of iteration " << model_latest_iteration;
   } else {
     Executor::GetInstance().Initialize(init_feature_map, server_node_);
     MS_LOG_INFO << "Load model success: The initial local model is used as the model of iteration "
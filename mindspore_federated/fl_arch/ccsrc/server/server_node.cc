@@ -21,6 +21,7 @@
 #include "distributed_cache/iteration_task_thread.h"
 #include "common/common.h"
 #include "server/iteration.h"
+#include "armour/cipher/cipher_init.h"
 
 namespace mindspore {
 namespace fl {
@@ -140,6 +141,10 @@ void ServerNode::HandleBroadcastEvent(const std::shared_ptr<TcpConnection> &conn
       MS_LOG_INFO << "Receive count event from " << meta.send_node();
       cache::Counter::Instance().OnNotifyCountEvent(broadcast_msg);
       break;
+    case ServerBroadcastMessage_BroadcastEventType_CLIENT_NOISES_READY_EVENT:
+      MS_LOG_INFO << "Receive client noises ready event from " << meta.send_node();
+      armour::CipherInit::GetInstance().cipher_meta_storage_.OnClientNoisesReady();
+      break;
     default:
       MS_LOG_WARNING << "Unexpected broadcast message " << static_cast<int>(broadcast_msg.type());
   }
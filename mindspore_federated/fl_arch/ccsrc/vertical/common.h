@@ -51,6 +51,15 @@ constexpr auto KServerPSIInitMsgType = "/serverPsiInit";
 constexpr auto KAlicePbaAndBFMsgType = "/alicePbaAndBF";
 constexpr auto KBobAlignResultMsgType = "/bobAlignResult";
 constexpr auto KAliceCheckMsgType = "/aliceCheck";
+
+// Received messages waiting for the consumer. The message handler blocks when the queue is full, so the peer is
+// slowed down instead of the memory growing.
+constexpr size_t KMessageQueueCapacity = 16;
+// How long the message handler waits for room in the queue before it responds with an error. It is shorter than the
+// request timeout of the peer, so the peer gets the error instead of timing out.
+constexpr uint32_t KMessageQueuePushTimeoutInMs = 5000;
+// Tensor lists queued by TrainerCommunicator::SendAsync, including the one being sent.
+constexpr size_t KTrainerMaxInFlightMessages = 4;
 }  // namespace fl
 }  // namespace mindspore
 #endif  // MINDSPORE_FL_ARCH_CCSRC_VERTICAL_COMMON_H_
@@ -21,6 +21,9 @@
 
 namespace mindspore {
 namespace fl {
+static_assert(KMessageQueuePushTimeoutInMs < static_cast<uint32_t>(kCommTimeoutInSeconds) * 1000,
+              "The peer should get the response of a full message queue before its request times out");
+
 std::shared_ptr<HttpCommunicator> AbstractCommunicator::CreateHttpCommunicator() {
   auto http_server_address = VFLContext::instance()->http_server_address();
   std::string server_ip;
@@ -20,25 +20,40 @@
 #include <utility>
 #include <string>
 
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <queue>
 #include <deque>
+#include "vertical/common.h"
 
 namespace mindspore {
 namespace fl {
+// A bounded queue of received messages. Messages are moved in and out, and push blocks while the queue is full.
 template <typename T>
 class MessageQueue {
  private:
   std::deque<T> queue_;
+  size_t capacity_;
   std::mutex msg_mutex_;
   std::condition_variable message_received_cond_;
+  std::condition_variable message_popped_cond_;
 
  public:
-  void push(T data) {
+  explicit MessageQueue(size_t capacity = KMessageQueueCapacity) : capacity_(capacity) {}
+  MessageQueue(const MessageQueue &) = delete;
+  MessageQueue &operator=(const MessageQueue &) = delete;
+
+  // Returns false if the queue is still full after timeout_in_ms milliseconds.
+  bool push(T &&data, uint32_t timeout_in_ms = KMessageQueuePushTimeoutInMs) {
     std::unique_lock<std::mutex> lock(msg_mutex_);
-    queue_.push_back(data);
+    if (!message_popped_cond_.wait_for(lock, std::chrono::milliseconds(timeout_in_ms),
+                                       [this] { return queue_.size() < capacity_; })) {
+      return false;
+    }
+    queue_.push_back(std::move(data));
     message_received_cond_.notify_all();
+    return true;
   }
 
   T pop(const uint32_t &timeout = 100000) {
@@ -47,6 +62,7 @@ class MessageQueue {
     if (queue_.size() > 0) {
       ret = std::move(queue_.front());
       queue_.pop_front();
+      message_popped_cond_.notify_all();
       return ret;
     }
     for (uint32_t i = 0; i < timeout; i++) {
@@ -54,6 +70,7 @@ class MessageQueue {
       if (res) {
         ret = std::move(queue_.front());
         queue_.pop_front();
+        message_popped_cond_.notify_all();
         return ret;
       }
     }
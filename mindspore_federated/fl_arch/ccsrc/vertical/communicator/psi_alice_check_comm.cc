@@ -45,14 +45,19 @@ bool AliceCheckCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandl
     datajoin::AliceCheckProto AliceCheckProto;
     AliceCheckProto.ParseFromArray(message->data(), static_cast<int>(message->len()));
 
-    psi::AliceCheck AliceCheck = ParseAliceCheckProto(AliceCheckProto);
+    psi::AliceCheck AliceCheck = ParseAliceCheckProto(std::move(AliceCheckProto));
     if (!VerifyProtoMessage(AliceCheck)) {
       std::string reason = "Verify AliceCheck data failed for vertical psi.";
       MS_LOG(WARNING) << reason;
       SendResponseMsg(message, reason.c_str(), reason.size());
       return false;
     }
-    message_queue_->push(AliceCheck);
+    if (!message_queue_->push(std::move(AliceCheck))) {
+      std::string reason = "Push message to the queue timeout.";
+      MS_LOG(WARNING) << reason;
+      SendResponseMsg(message, reason.c_str(), reason.size());
+      return false;
+    }
     std::string res = std::to_string(ResponseElem::SUCCESS);
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching psi AliceCheck message handler successful.";
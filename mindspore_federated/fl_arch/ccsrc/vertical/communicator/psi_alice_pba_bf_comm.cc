@@ -45,14 +45,19 @@ bool AlicePbaAndBFCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHa
     datajoin::AlicePbaAndBFProto alicePbaAndBFProto;
     alicePbaAndBFProto.ParseFromArray(message->data(), static_cast<int>(message->len()));
 
-    psi::AlicePbaAndBF alicePbaAndBF = ParseAlicePbaAndBFProto(alicePbaAndBFProto);
+    psi::AlicePbaAndBF alicePbaAndBF = ParseAlicePbaAndBFProto(std::move(alicePbaAndBFProto));
     if (!VerifyProtoMessage(alicePbaAndBF)) {
       std::string reason = "Verify bob data failed for vertical psi.";
       MS_LOG(WARNING) << reason;
       SendResponseMsg(message, reason.c_str(), reason.size());
       return false;
     }
-    message_queue_->push(alicePbaAndBF);
+    if (!message_queue_->push(std::move(alicePbaAndBF))) {
+      std::string reason = "Push message to the queue timeout.";
+      MS_LOG(WARNING) << reason;
+      SendResponseMsg(message, reason.c_str(), reason.size());
+      return false;
+    }
     std::string res = std::to_string(ResponseElem::SUCCESS);
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching psi BobAlignResult message handler successful.";
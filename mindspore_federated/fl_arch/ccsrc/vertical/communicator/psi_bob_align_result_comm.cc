@@ -45,14 +45,19 @@ bool BobAlignResultCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageH
     datajoin::BobAlignResultProto BobAlignResultProto;
     BobAlignResultProto.ParseFromArray(message->data(), static_cast<int>(message->len()));
 
-    psi::BobAlignResult BobAlignResult = ParseBobAlignResultProto(BobAlignResultProto);
+    psi::BobAlignResult BobAlignResult = ParseBobAlignResultProto(std::move(BobAlignResultProto));
     if (!VerifyProtoMessage(BobAlignResult)) {
       std::string reason = "Verify BobAlignResult data failed for vertical psi.";
       MS_LOG(WARNING) << reason;
       SendResponseMsg(message, reason.c_str(), reason.size());
       return false;
     }
-    message_queue_->push(BobAlignResult);
+    if (!message_queue_->push(std::move(BobAlignResult))) {
+      std::string reason = "Push message to the queue timeout.";
+      MS_LOG(WARNING) << reason;
+      SendResponseMsg(message, reason.c_str(), reason.size());
+      return false;
+    }
     std::string res = std::to_string(ResponseElem::SUCCESS);
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching psi BobAlignResult message handler successful.";
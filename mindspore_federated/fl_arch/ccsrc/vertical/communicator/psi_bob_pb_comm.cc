@@ -45,14 +45,19 @@ bool BobPbCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler> &
     datajoin::BobPbProto bobPbProto;
     bobPbProto.ParseFromArray(message->data(), static_cast<int>(message->len()));
 
-    psi::BobPb bobPb = ParseBobPbProto(bobPbProto);
+    psi::BobPb bobPb = ParseBobPbProto(std::move(bobPbProto));
     if (!VerifyProtoMessage(bobPb)) {
       std::string reason = "Verify bob data failed for vertical psi.";
       MS_LOG(WARNING) << reason;
       SendResponseMsg(message, reason.c_str(), reason.size());
       return false;
     }
-    message_queue_->push(bobPb);
+    if (!message_queue_->push(std::move(bobPb))) {
+      std::string reason = "Push message to the queue timeout.";
+      MS_LOG(WARNING) << reason;
+      SendResponseMsg(message, reason.c_str(), reason.size());
+      return false;
+    }
     std::string res = std::to_string(ResponseElem::SUCCESS);
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching psi BobPb message handler successful.";
@@ -52,7 +52,12 @@ bool ServerPSIInitCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHa
       SendResponseMsg(message, reason.c_str(), reason.size());
       return false;
     }
-    message_queue_->push(serverPSIInit);
+    if (!message_queue_->push(std::move(serverPSIInit))) {
+      std::string reason = "Push message to the queue timeout.";
+      MS_LOG(WARNING) << reason;
+      SendResponseMsg(message, reason.c_str(), reason.size());
+      return false;
+    }
     std::string res = std::to_string(ResponseElem::SUCCESS);
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching psi ServerPSIInit message handler successful.";
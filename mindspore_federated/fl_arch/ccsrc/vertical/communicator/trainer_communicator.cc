@@ -32,6 +32,21 @@ void TrainerCommunicator::InitCommunicator(const std::shared_ptr<HttpCommunicato
   RegisterMsgCallBack(http_communicator, KTrainer);
   InitHttpClient();
   message_queue_ = std::make_shared<MessageQueue<TensorListItemPy>>();
+  if (!send_thread_.joinable()) {
+    send_thread_ = std::thread([this]() { SendThreadHandle(); });
+  }
+}
+
+bool TrainerCommunicator::Stop() {
+  {
+    std::unique_lock<std::mutex> lock(send_mutex_);
+    send_stopped_ = true;
+  }
+  send_cond_.notify_all();
+  if (send_thread_.joinable()) {
+    send_thread_.join();
+  }
+  return true;
 }
 
 bool TrainerCommunicator::VerifyTensorListItem(const TensorListItemPy &tensorListItemPy) {
@@ -65,7 +80,12 @@ bool TrainerCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler>
       return false;
     }
 
-    TensorMsgReceiveHandler(tensorListItemPy);
+    if (!TensorMsgReceiveHandler(std::move(tensorListItemPy))) {
+      std::string reason = "Push message to the queue timeout.";
+      SendResponseMsg(message, reason.c_str(), reason.size());
+      MS_LOG(WARNING) << reason;
+      return false;
+    }
     std::string res = std::to_string(ResponseElem::SUCCESS);
     SendResponseMsg(message, res.c_str(), res.size());
     MS_LOG(INFO) << "Launching vertical trainer message handler successful.";
@@ -77,15 +97,66 @@ bool TrainerCommunicator::LaunchMsgHandler(const std::shared_ptr<MessageHandler>
 }
 
 bool TrainerCommunicator::Send(const TensorListItemPy &tensorListItemPy) {
-  std::shared_ptr<TensorListProto> tensor_list_proto_ptr = std::make_shared<TensorListProto>();
-  CreateTensorListProto(tensor_list_proto_ptr.get(), tensorListItemPy);
-  std::string data = tensor_list_proto_ptr->SerializeAsString();
-  size_t data_size = data.size();
-  return SendMessage(data.c_str(), data_size, KTrainerMsgType);
+  return SendAsync(tensorListItemPy) && Flush();
+}
+
+bool TrainerCommunicator::SendAsync(TensorListItemPy tensorListItemPy) {
+  std::unique_lock<std::mutex> lock(send_mutex_);
+  send_cond_.wait(lock, [this]() { return send_stopped_ || send_queue_.size() < KTrainerMaxInFlightMessages; });
+  if (send_stopped_) {
+    MS_LOG(WARNING) << "The trainer communicator is stopped.";
+    return false;
+  }
+  send_queue_.push_back(std::move(tensorListItemPy));
+  send_cond_.notify_all();
+  return true;
+}
+
+bool TrainerCommunicator::Flush() {
+  std::unique_lock<std::mutex> lock(send_mutex_);
+  send_cond_.wait(lock, [this]() { return send_stopped_ || send_queue_.empty(); });
+  bool success = !send_failed_ && send_queue_.empty();
+  send_failed_ = false;
+  return success;
+}
+
+void TrainerCommunicator::SendThreadHandle() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(send_mutex_);
+    send_cond_.wait(lock, [this]() { return send_stopped_ || !send_queue_.empty(); });
+    if (send_stopped_) {
+      // Sending each of them may take up to the request timeout, so the tensor lists not sent yet are dropped and
+      // Flush fails.
+      if (!send_queue_.empty()) {
+        MS_LOG(WARNING) << "The trainer communicator is stopped, " << send_queue_.size()
+                        << " queued tensor lists are not sent.";
+        send_queue_.clear();
+        send_failed_ = true;
+        send_cond_.notify_all();
+      }
+      return;
+    }
+    // Keep the tensor list in the queue while sending, so that it counts as in flight.
+    const auto &tensorListItemPy = send_queue_.front();
+    lock.unlock();
+    TensorListProto tensor_list_proto;
+    CreateTensorListProto(&tensor_list_proto, tensorListItemPy);
+    std::string data = tensor_list_proto.SerializeAsString();
+    bool success = SendMessage(data.c_str(), data.size(), KTrainerMsgType);
+    if (!success) {
+      MS_LOG(WARNING) << "Send tensor list " << tensorListItemPy.name() << " failed.";
+    }
+    lock.lock();
+    send_failed_ = send_failed_ || !success;
+    send_queue_.pop_front();
+    send_cond_.notify_all();
+  }
 }
 
-bool TrainerCommunicator::TensorMsgReceiveHandler(const TensorListItemPy &tensorListItemPy) {
-  message_queue_->push(tensorListItemPy);
+bool TrainerCommunicator::TensorMsgReceiveHandler(TensorListItemPy &&tensorListItemPy) {
+  if (!message_queue_->push(std::move(tensorListItemPy))) {
+    return false;
+  }
   MS_LOG(INFO) << "Trainer push tensorListItemPy message success.";
   return true;
 }
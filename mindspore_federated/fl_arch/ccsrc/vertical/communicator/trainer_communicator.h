@@ -21,6 +21,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <deque>
+#include <thread>
+#include <condition_variable>
 
 #include "vertical/communicator/abstract_communicator.h"
 #include "vertical/common.h"
@@ -35,18 +38,32 @@ namespace fl {
 class TrainerCommunicator : public AbstractCommunicator {
  public:
   TrainerCommunicator() = default;
-  ~TrainerCommunicator() = default;
+  ~TrainerCommunicator() override { Stop(); }
 
   bool LaunchMsgHandler(const std::shared_ptr<MessageHandler> &message) override;
 
   void InitCommunicator(const std::shared_ptr<HttpCommunicator> &http_communicator) override;
 
+  // Stop the sender thread after the tensor list being sent. The queued tensor lists are dropped and Flush fails.
+  bool Stop() override;
+
+  // Send the tensor list after the ones queued by SendAsync, and wait until all of them are sent.
   bool Send(const TensorListItemPy &tensorListItemPy);
 
+  // Queue the tensor list to be sent in order by the sender thread and return without waiting for the peer, so the
+  // next step is computed while this one is on the network. Blocks while KTrainerMaxInFlightMessages tensor lists
+  // are in flight.
+  bool SendAsync(TensorListItemPy tensorListItemPy);
+
+  // Wait until all queued tensor lists are sent. Returns false if any of them failed since the last call.
+  bool Flush();
+
   TensorListItemPy Receive(const uint32_t &timeout = 100000);
 
  private:
-  bool TensorMsgReceiveHandler(const TensorListItemPy &tensorListItemPy);
+  bool TensorMsgReceiveHandler(TensorListItemPy &&tensorListItemPy);
+
+  void SendThreadHandle();
 
   bool VerifyTensorListItem(const TensorListItemPy &tensorListItemPy);
 
@@ -55,6 +72,14 @@ class TrainerCommunicator : public AbstractCommunicator {
   std::mutex message_received_mutex_;
 
   std::shared_ptr<MessageQueue<TensorListItemPy>> message_queue_ = nullptr;
+
+  std::thread send_thread_;
+  std::mutex send_mutex_;
+  std::condition_variable send_cond_;
+  // Tensor lists to be sent, the front one is being sent by the sender thread.
+  std::deque<TensorListItemPy> send_queue_;
+  bool send_failed_ = false;
+  bool send_stopped_ = false;
 };
 }  // namespace fl
 }  // namespace mindspore
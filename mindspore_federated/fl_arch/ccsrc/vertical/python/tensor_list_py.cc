@@ -15,6 +15,7 @@
  */
 #include "vertical/python/tensor_list_py.h"
 #include <functional>
+#include <utility>
 #include <vector>
 
 namespace mindspore {
@@ -28,16 +29,16 @@ TensorListItemPy::TensorListItemPy(const std::string &name, const std::vector<Te
 
 std::string TensorListItemPy::name() const { return name_; }
 
-std::vector<TensorItemPy> TensorListItemPy::tensors() const { return tensors_; }
+const std::vector<TensorItemPy> &TensorListItemPy::tensors() const { return tensors_; }
 
-std::vector<TensorListItemPy> TensorListItemPy::tensorListItems() const { return tensorListItems_; }
+const std::vector<TensorListItemPy> &TensorListItemPy::tensorListItems() const { return tensorListItems_; }
 
 void TensorListItemPy::set_name(const std::string &name) { name_ = name; }
 
-void TensorListItemPy::set_tensors(const std::vector<TensorItemPy> &tensors) { tensors_ = tensors; }
+void TensorListItemPy::set_tensors(std::vector<TensorItemPy> tensors) { tensors_ = std::move(tensors); }
 
-void TensorListItemPy::set_tensor_list_items(const std::vector<TensorListItemPy> &tensorListItems) {
-  tensorListItems_ = tensorListItems;
+void TensorListItemPy::set_tensor_list_items(std::vector<TensorListItemPy> tensorListItems) {
+  tensorListItems_ = std::move(tensorListItems);
 }
 
 void TensorListItemPy::add_tensor(const TensorItemPy &tensor) { tensors_.push_back(tensor); }
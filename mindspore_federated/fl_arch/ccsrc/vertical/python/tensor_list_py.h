@@ -38,11 +38,11 @@ class MS_EXPORT TensorListItemPy {
   void set_name(const std::string &name);
   std::string name() const;
 
-  void set_tensors(const std::vector<TensorItemPy> &tensors);
-  std::vector<TensorItemPy> tensors() const;
+  void set_tensors(std::vector<TensorItemPy> tensors);
+  const std::vector<TensorItemPy> &tensors() const;
 
-  void set_tensor_list_items(const std::vector<TensorListItemPy> &tensorListItems);
-  std::vector<TensorListItemPy> tensorListItems() const;
+  void set_tensor_list_items(std::vector<TensorListItemPy> tensorListItems);
+  const std::vector<TensorListItemPy> &tensorListItems() const;
 
   void add_tensor(const TensorItemPy &tensor);
   void add_tensor_list_item(const TensorListItemPy &tensorListItem);
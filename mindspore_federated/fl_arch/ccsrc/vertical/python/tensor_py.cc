@@ -15,6 +15,7 @@
  */
 #include "vertical/python/tensor_py.h"
 #include <functional>
+#include <utility>
 #include <vector>
 
 namespace mindspore {
@@ -31,7 +32,10 @@ std::vector<size_t> TensorItemPy::shape() const { return shape_; }
 void TensorItemPy::set_dtype(const std::string &dtype) { dtype_ = dtype; }
 std::string TensorItemPy::dtype() const { return dtype_; }
 
-void TensorItemPy::set_data(const std::vector<float> &data) { data_ = data; }
-std::vector<float> TensorItemPy::data() const { return data_; }
+void TensorItemPy::set_raw_data(std::vector<uint8_t> data) {
+  data_ = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+}
+const std::vector<uint8_t> &TensorItemPy::raw_data() const { return *data_; }
+std::shared_ptr<const std::vector<uint8_t>> TensorItemPy::shared_raw_data() const { return data_; }
 }  // namespace fl
 }  // namespace mindspore
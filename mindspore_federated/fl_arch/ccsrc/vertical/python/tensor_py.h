@@ -41,18 +41,22 @@ class MS_EXPORT TensorItemPy {
   void set_shape(const std::vector<size_t> &shape);
   std::vector<size_t> shape() const;
 
+  // Name of the element type in numpy, such as float32, float16 and int8.
   void set_dtype(const std::string &dtype);
   std::string dtype() const;
 
-  void set_data(const std::vector<float> &data);
-  std::vector<float> data() const;
+  // Data in host byte order. It is replaced as a whole by set_raw_data and shared by copies of the item and by the
+  // numpy views returned to python, which stay valid after the item is destroyed.
+  void set_raw_data(std::vector<uint8_t> data);
+  const std::vector<uint8_t> &raw_data() const;
+  std::shared_ptr<const std::vector<uint8_t>> shared_raw_data() const;
 
  private:
   std::string name_;
   std::string ref_key_;
   std::vector<size_t> shape_;
   std::string dtype_;
-  std::vector<float> data_;
+  std::shared_ptr<const std::vector<uint8_t>> data_ = std::make_shared<const std::vector<uint8_t>>();
 };
 }  // namespace fl
 }  // namespace mindspore
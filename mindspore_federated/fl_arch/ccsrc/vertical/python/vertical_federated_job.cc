@@ -29,6 +29,12 @@ void VerticalFederatedJob::Send(const TensorListItemPy &tensorListItemPy) {
   VerticalServer::GetInstance().Send(tensorListItemPy);
 }
 
+bool VerticalFederatedJob::SendAsync(const TensorListItemPy &tensorListItemPy) {
+  return VerticalServer::GetInstance().SendAsync(tensorListItemPy);
+}
+
+bool VerticalFederatedJob::Flush() { return VerticalServer::GetInstance().Flush(); }
+
 TensorListItemPy VerticalFederatedJob::Receive() {
   TensorListItemPy tensorListItemPy;
   VerticalServer::GetInstance().Receive(&tensorListItemPy);
@@ -27,6 +27,8 @@ class MS_EXPORT VerticalFederatedJob {
   ~VerticalFederatedJob() = default;
   static void StartVerticalCommunicator();
   static void Send(const TensorListItemPy &tensorListItemPy);
+  static bool SendAsync(const TensorListItemPy &tensorListItemPy);
+  static bool Flush();
   static TensorListItemPy Receive();
 };
 }  // namespace fl
@@ -17,6 +17,7 @@
 #include "vertical/utils/psi_utils.h"
 #include <vector>
 #include <string>
+#include <utility>
 
 namespace mindspore {
 namespace fl {
@@ -24,7 +25,8 @@ void CreateAliceCheckProto(datajoin::AliceCheckProto *alice_check_proto, const p
   alice_check_proto->set_bin_id(alice_check.bin_id());
   alice_check_proto->set_wrong_num(alice_check.wrong_num());
 
-  auto wrong_id = alice_check.wrong_id();
+  const auto &wrong_id = alice_check.wrong_id();
+  alice_check_proto->mutable_wrong_id()->Reserve(static_cast<int>(wrong_id.size()));
   for (const auto &item : wrong_id) {
     alice_check_proto->add_wrong_id(item);
   }
@@ -45,7 +47,8 @@ void CreateServerPSIInitProto(datajoin::ServerPSIInitProto *server_init_proto, c
 void CreateBobPbProto(datajoin::BobPbProto *bob_p_b_proto, const psi::BobPb &bob_p_b) {
   bob_p_b_proto->set_bin_id(bob_p_b.bin_id());
 
-  auto p_b_vct = bob_p_b.p_b_vct();
+  const auto &p_b_vct = bob_p_b.p_b_vct();
+  bob_p_b_proto->mutable_p_b_vct()->Reserve(static_cast<int>(p_b_vct.size()));
   for (const auto &item : p_b_vct) {
     bob_p_b_proto->add_p_b_vct(item);
   }
@@ -55,7 +58,8 @@ void CreateAlicePbaAndBFProto(datajoin::AlicePbaAndBFProto *alice_pba_bf_proto,
                               const psi::AlicePbaAndBF &alice_pba_bf) {
   alice_pba_bf_proto->set_bin_id(alice_pba_bf.bin_id());
 
-  auto p_b_a_vct = alice_pba_bf.p_b_a_vct();
+  const auto &p_b_a_vct = alice_pba_bf.p_b_a_vct();
+  alice_pba_bf_proto->mutable_p_b_a_vct()->Reserve(static_cast<int>(p_b_a_vct.size()));
   for (const auto &item : p_b_a_vct) {
     alice_pba_bf_proto->add_p_b_a_vct(item);
   }
@@ -67,7 +71,8 @@ void CreateBobAlignResultProto(datajoin::BobAlignResultProto *bob_alice_result_p
                                const psi::BobAlignResult &bob_align_result) {
   bob_alice_result_proto->set_bin_id(bob_align_result.bin_id());
 
-  auto align_result = bob_align_result.align_result();
+  const auto &align_result = bob_align_result.align_result();
+  bob_alice_result_proto->mutable_align_result()->Reserve(static_cast<int>(align_result.size()));
   for (const auto &item : align_result) {
     bob_alice_result_proto->add_align_result(item);
   }
@@ -77,11 +82,11 @@ psi::BobPb ParseBobPbProto(datajoin::BobPbProto bobPbProto) {
   psi::BobPb bobPb;
   bobPb.set_bin_id(bobPbProto.bin_id());
   std::vector<std::string> p_b_vct;
-  int p_b_vct_size = bobPbProto.p_b_vct_size();
-  for (int i = 0; i < p_b_vct_size; i++) {
-    p_b_vct.push_back(bobPbProto.p_b_vct(i));
+  p_b_vct.reserve(bobPbProto.p_b_vct_size());
+  for (auto &item : *bobPbProto.mutable_p_b_vct()) {
+    p_b_vct.push_back(std::move(item));
   }
-  bobPb.set_p_b_vct(p_b_vct);
+  bobPb.set_p_b_vct(std::move(p_b_vct));
   MS_LOG(INFO) << "bob_p_b, bin_id is " << bobPb.bin_id();
   MS_LOG(INFO) << "bob_p_b size is " << bobPb.p_b_vct().size();
   return bobPb;
@@ -112,12 +117,12 @@ psi::AlicePbaAndBF ParseAlicePbaAndBFProto(datajoin::AlicePbaAndBFProto alicePba
   psi::AlicePbaAndBF alicePbaAndBF;
   alicePbaAndBF.set_bin_id(alicePbaAndBFProto.bin_id());
   std::vector<std::string> p_b_vct;
-  int p_b_a_vct_size = alicePbaAndBFProto.p_b_a_vct_size();
-  for (int i = 0; i < p_b_a_vct_size; i++) {
-    p_b_vct.push_back(alicePbaAndBFProto.p_b_a_vct(i));
+  p_b_vct.reserve(alicePbaAndBFProto.p_b_a_vct_size());
+  for (auto &item : *alicePbaAndBFProto.mutable_p_b_a_vct()) {
+    p_b_vct.push_back(std::move(item));
   }
-  alicePbaAndBF.set_p_b_a_vct(p_b_vct);
-  alicePbaAndBF.set_bf_alice(alicePbaAndBFProto.bf_alice());
+  alicePbaAndBF.set_p_b_a_vct(std::move(p_b_vct));
+  alicePbaAndBF.set_bf_alice(std::move(*alicePbaAndBFProto.mutable_bf_alice()));
   MS_LOG(INFO) << "alice_pba_bf, bin_id is " << alicePbaAndBF.bin_id();
   MS_LOG(INFO) << "alice_p_b_a size is " << alicePbaAndBF.p_b_a_vct().size();
   MS_LOG(INFO) << "bf_alice size is " << alicePbaAndBF.bf_alice().size();
@@ -128,11 +133,11 @@ psi::BobAlignResult ParseBobAlignResultProto(datajoin::BobAlignResultProto bobAl
   psi::BobAlignResult bobAlignResult;
   bobAlignResult.set_bin_id(bobAlignResultProto.bin_id());
   std::vector<std::string> align_result;
-  int align_result_size = bobAlignResultProto.align_result_size();
-  for (int i = 0; i < align_result_size; i++) {
-    align_result.push_back(bobAlignResultProto.align_result(i));
+  align_result.reserve(bobAlignResultProto.align_result_size());
+  for (auto &item : *bobAlignResultProto.mutable_align_result()) {
+    align_result.push_back(std::move(item));
   }
-  bobAlignResult.set_align_resul(align_result);
+  bobAlignResult.set_align_resul(std::move(align_result));
   MS_LOG(INFO) << "bob_align_result, bin_id is " << bobAlignResult.bin_id();
   MS_LOG(INFO) << "bob_align_result size is " << bobAlignResult.align_result().size();
   return bobAlignResult;
@@ -143,11 +148,11 @@ psi::AliceCheck ParseAliceCheckProto(datajoin::AliceCheckProto aliceCheckProto)
   aliceCheck.set_bin_id(aliceCheckProto.bin_id());
   aliceCheck.set_wrong_num(aliceCheckProto.wrong_num());
   std::vector<std::string> wrong_id_vct;
-  int wrong_id_size = aliceCheckProto.wrong_id_size();
-  for (int i = 0; i < wrong_id_size; i++) {
-    wrong_id_vct.push_back(aliceCheckProto.wrong_id(i));
+  wrong_id_vct.reserve(aliceCheckProto.wrong_id_size());
+  for (auto &item : *aliceCheckProto.mutable_wrong_id()) {
+    wrong_id_vct.push_back(std::move(item));
   }
-  aliceCheck.set_wrong_id(wrong_id_vct);
+  aliceCheck.set_wrong_id(std::move(wrong_id_vct));
   MS_LOG(INFO) << "alice_check, bin_id is " << aliceCheck.bin_id();
   MS_LOG(INFO) << "alice_check, wrong_id size is " << aliceCheck.wrong_id().size();
   return aliceCheck;
@@ -17,43 +17,104 @@
 #include "vertical/utils/tensor_utils.h"
 #include <vector>
 #include <string>
+#include <utility>
 
 namespace mindspore {
 namespace fl {
+namespace {
+struct DtypeInfo {
+  const char *dtype;
+  DataType data_type;
+  size_t size;
+};
+
+// Element types of TensorItemPy, named as numpy. The first entry of a data type is used when parsing.
+const DtypeInfo kDtypeInfos[] = {
+  {"float32", DataType::FLOAT, 4},
+  {"float", DataType::FLOAT, 4},
+  {"float16", DataType::FLOAT16, 2},
+  {"float64", DataType::FLOAT64, 8},
+  {"float64", DataType::DOUBLE, 8},
+  {"int8", DataType::INT8, 1},
+  {"uint8", DataType::UINT8, 1},
+  {"int16", DataType::INT16, 2},
+  {"uint16", DataType::UINT16, 2},
+  {"int32", DataType::INT32, 4},
+  {"uint32", DataType::UINT32, 4},
+  {"int64", DataType::INT64, 8},
+  {"uint64", DataType::UINT64, 8},
+  {"bool", DataType::BOOL, 1},
+};
+
+const DtypeInfo *FindDtypeInfo(const std::string &dtype) {
+  for (const auto &info : kDtypeInfos) {
+    if (dtype == info.dtype) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+const DtypeInfo *FindDtypeInfo(DataType data_type) {
+  // Tensors sent without data type carry floats.
+  if (data_type == DataType::UNDEFINED) {
+    data_type = DataType::FLOAT;
+  }
+  for (const auto &info : kDtypeInfos) {
+    if (data_type == info.data_type) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
 TensorListItemPy ParseTensorListProto(const TensorListProto &tensorListProto) {
   TensorListItemPy tensorListItemPy;
   std::string name = tensorListProto.name();
   tensorListItemPy.set_name(name);
-  auto tensors_proto = tensorListProto.tensors();
-  std::vector<TensorItemPy> tensors;
-  for (const auto &item : tensors_proto) {
-    TensorItemPy tensor;
+  const auto &tensors_proto = tensorListProto.tensors();
+  std::vector<TensorItemPy> tensors(tensors_proto.size());
+  for (int index = 0; index < tensors_proto.size(); index++) {
+    const auto &item = tensors_proto.Get(index);
+    auto &tensor = tensors[index];
     tensor.set_name(item.name());
     tensor.set_ref_key(item.ref_key());
-    tensor.set_dtype("float");
+    auto dtype_info = FindDtypeInfo(item.data_type());
+    if (dtype_info == nullptr) {
+      MS_LOG_EXCEPTION << "ParseTensorListProto: unsupported data type " << item.data_type() << " of tensor "
+                       << item.ref_key();
+    }
+    tensor.set_dtype(dtype_info->dtype);
 
-    int float_data_size = item.float_data_size();
-    std::vector<float> data;
-    for (int i = 0; i < float_data_size; i++) {
-      data.push_back(item.float_data(i));
+    const auto &raw_data = item.raw_data();
+    if (!raw_data.empty()) {
+      if (raw_data.size() % dtype_info->size != 0) {
+        MS_LOG_EXCEPTION << "ParseTensorListProto: the raw data size " << raw_data.size() << " of tensor "
+                         << item.ref_key() << " is not a multiple of " << dtype_info->dtype << " size";
+      }
+      tensor.set_raw_data(std::vector<uint8_t>(raw_data.begin(), raw_data.end()));
+    } else if (item.float_data_size() > 0 && dtype_info->data_type == DataType::FLOAT) {
+      // Sent by a peer which doesn't fill raw_data.
+      auto float_data = item.float_data().data();
+      auto bytes = reinterpret_cast<const uint8_t *>(float_data);
+      tensor.set_raw_data(std::vector<uint8_t>(bytes, bytes + item.float_data_size() * sizeof(float)));
     }
-    tensor.set_data(data);
     std::vector<size_t> shape;
     int dims_size = item.dims_size();
     for (int i = 0; i < dims_size; i++) {
       shape.push_back(item.dims(i));
     }
     tensor.set_shape(shape);
-    tensors.push_back(tensor);
   }
-  tensorListItemPy.set_tensors(tensors);
+  tensorListItemPy.set_tensors(std::move(tensors));
 
   int tensor_list_size = tensorListProto.tensor_list_size();
   std::vector<TensorListItemPy> tensorListItems;
   for (int i = 0; i < tensor_list_size; i++) {
     tensorListItems.push_back(ParseTensorListProto(tensorListProto.tensor_list(i)));
   }
-  tensorListItemPy.set_tensor_list_items(tensorListItems);
+  tensorListItemPy.set_tensor_list_items(std::move(tensorListItems));
   return tensorListItemPy;
 }
 
@@ -61,26 +122,30 @@ void CreateTensorProto(TensorProto *tensor_proto, const TensorItemPy &tensor, st
   if (!ref_key.empty()) {
     tensor_proto->set_ref_key(ref_key);
   }
-  std::string data_type = tensor.dtype();
-  if (data_type.empty()) {
-    MS_LOG_EXCEPTION << "CreateTensorProto: input a Tensor with unsupported value type";
+  auto dtype_info = FindDtypeInfo(tensor.dtype());
+  if (dtype_info == nullptr) {
+    MS_LOG_EXCEPTION << "CreateTensorProto: input a Tensor with unsupported value type " << tensor.dtype();
   }
-  tensor_proto->set_data_type(DataType::FLOAT);
+  tensor_proto->set_data_type(dtype_info->data_type);
 
   for (size_t dim : tensor.shape()) {
     tensor_proto->add_dims(dim);
   }
 
-  for (float ts_data : tensor.data()) {
-    tensor_proto->add_float_data(ts_data);
+  // The data is copied at once in host byte order instead of one by one into float_data.
+  const auto &data = tensor.raw_data();
+  if (data.size() % dtype_info->size != 0) {
+    MS_LOG_EXCEPTION << "CreateTensorProto: the data size " << data.size() << " is not a multiple of "
+                     << dtype_info->dtype << " size";
   }
+  tensor_proto->set_raw_data(data.data(), data.size());
 }
 
 void CreateTensorListProto(TensorListProto *tensor_list_proto, const TensorListItemPy &tensorListItemPy) {
   tensor_list_proto->set_name(tensorListItemPy.name());
 
-  auto tensors = tensorListItemPy.tensors();
-  auto tensorListItems = tensorListItemPy.tensorListItems();
+  const auto &tensors = tensorListItemPy.tensors();
+  const auto &tensorListItems = tensorListItemPy.tensorListItems();
 
   for (const auto &tensor : tensors) {
     TensorProto *tensor_proto = tensor_list_proto->add_tensors();
@@ -90,6 +90,18 @@ void VerticalServer::Send(const TensorListItemPy &tensorListItemPy) {
   communicator_ptr->Send(tensorListItemPy);
 }
 
+bool VerticalServer::SendAsync(const TensorListItemPy &tensorListItemPy) {
+  auto communicator_ptr = reinterpret_cast<TrainerCommunicator *>(communicators_[KTrainer].get());
+  MS_EXCEPTION_IF_NULL(communicator_ptr);
+  return communicator_ptr->SendAsync(tensorListItemPy);
+}
+
+bool VerticalServer::Flush() {
+  auto communicator_ptr = reinterpret_cast<TrainerCommunicator *>(communicators_[KTrainer].get());
+  MS_EXCEPTION_IF_NULL(communicator_ptr);
+  return communicator_ptr->Flush();
+}
+
 void VerticalServer::Send(const psi::BobPb &bobPb) {
   auto communicator_ptr = reinterpret_cast<BobPbCommunicator *>(communicators_[KBobPb].get());
   MS_EXCEPTION_IF_NULL(communicator_ptr);
@@ -53,6 +53,10 @@ class VerticalServer {
 
   void Send(const TensorListItemPy &tensorListItemPy);
 
+  bool SendAsync(const TensorListItemPy &tensorListItemPy);
+
+  bool Flush();
+
   void Send(const psi::BobPb &bobPb);
 
   void Send(const psi::ClientPSIInit &clientPSIInit);
@@ -218,16 +218,12 @@ class UpdateModelKernelMod : public AbstractKernel {
         MS_LOG(EXCEPTION) << "Get secret seed failed!";
       }
 
-      // generate pairwise encryption noise
-      std::vector<float> noise_i;
-      if (armour::Masking::GetMasking(&noise_i, noise_len, (const uint8_t *)secret1, SECRET_MAX_LEN,
-                                      encrypt_pw_iv.data(), encrypt_pw_iv.size()) < 0) {
+      // generate pairwise encryption noise and add it to the total noise
+      float noise_sign = (fl_id_ < remote_fl_id) ? -1.0f : 1.0f;
+      if (armour::Masking::AccumulateMasking(total_noise.data(), 0, noise_len, noise_sign, (const uint8_t *)secret1,
+                                             SECRET_MAX_LEN, encrypt_pw_iv.data(), encrypt_pw_iv.size()) < 0) {
         MS_LOG(EXCEPTION) << "Get masking noise failed.";
       }
-      int noise_sign = (fl_id_ < remote_fl_id) ? -1 : 1;
-      for (size_t k = 0; k < noise_len; k++) {
-        total_noise[k] += noise_sign * noise_i[k];
-      }
       MS_LOG(INFO) << "Generate noise between fl_id: " << fl_id_ << " and fl_id: " << remote_fl_id << " finished.";
     }
     return total_noise;
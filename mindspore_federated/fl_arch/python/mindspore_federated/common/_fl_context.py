@@ -50,7 +50,7 @@ _check_positive_float_keys = ["update_model_ratio", "client_learning_rate"]
 
 _check_string_keys = {
     "upload_compress_type": ["NO_COMPRESS", "DIFF_SPARSE_QUANT"],
-    "download_compress_type": ["NO_COMPRESS", "QUANT"],
+    "download_compress_type": ["NO_COMPRESS", "QUANT", "QUANT_4BIT", "QUANT_2BIT"],
 }
 
 
@@ -14,13 +14,15 @@
 # ============================================================================
 """Essential tools to modeling the split-learning process."""
 
-import logging
 from typing import OrderedDict
 
-from mindspore import dtype as mstype
-from mindspore import ops, Tensor
+from mindspore import Tensor
 from mindspore_federated._mindspore_federated import TensorListItem_, TensorItem_
 
+# numpy names of the data types which can be exchanged, see vertical/utils/tensor_utils.cc.
+_SUPPORTED_DTYPES = ('float32', 'float16', 'float64', 'int8', 'uint8', 'int16', 'uint16', 'int32', 'uint32', 'int64',
+                     'uint64', 'bool')
+
 
 def tensor_to_tensor_pybind_obj(ts: Tensor, ref_key: str = None):
     """
@@ -34,12 +36,12 @@ def tensor_to_tensor_pybind_obj(ts: Tensor, ref_key: str = None):
     tensor = TensorItem_()
     if ref_key:
         tensor.set_ref_key(ref_key)
-    data_type = "float32"
-    if data_type is None:
+    ts_values = ts.asnumpy()
+    data_type = ts_values.dtype.name
+    if data_type not in _SUPPORTED_DTYPES:
         raise TypeError('tensor_to_tensor_pybind_obj: input a Tensor with unsupported value type ', ts.dtype)
     tensor.set_dtype(data_type)
     tensor.set_shape(ts.shape)
-    ts_values = ts.reshape(ts.size,).asnumpy()
     tensor.set_data(ts_values)
     return tensor
 
@@ -73,14 +75,10 @@ def tensor_pybind_obj_to_tensor(tensor_item: TensorItem_):
         tensor_item (class): the pybind object of the Tensor.
     """
     ref_key = tensor_item.ref_key()
-    ts_type = mstype.float32
-    if ts_type is None:
-        logging.warning('tensor_pybind_obj_to_tensor: not specify data_type in TensorProto, using float32 by default')
-        ts_type = mstype.float32
-    values = tensor_item.data()
-    ts = Tensor(list(values), dtype=ts_type)
-
-    ts = ops.reshape(ts, tuple(tensor_item.shape()))
+    # The numpy array is read only and shares memory with the received data, and so does the tensor, which is never
+    # updated in place.
+    values = tensor_item.data().reshape(tuple(tensor_item.shape()))
+    ts = Tensor.from_numpy(values)
     return ref_key, ts
 
 
@@ -41,5 +41,18 @@ class VFLTrainer:
     def send(self, tensor_list_item: TensorListItem_):
         return VerticalFederated_.send(tensor_list_item)
 
+    def send_async(self, tensor_list_item: TensorListItem_):
+        """
+        Queue the tensor list and return before the peer receives it, so that the next step can be computed while
+        this one is sent. Blocks while too many tensor lists are in flight. Tensor lists are sent in order.
+        """
+        return VerticalFederated_.send_async(tensor_list_item)
+
+    def flush(self):
+        """
+        Wait until all tensor lists queued by send_async are sent. Returns False if any of them failed.
+        """
+        return VerticalFederated_.flush()
+
     def receive(self):
         return VerticalFederated_.receive()
@@ -0,0 +1,240 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "distributed_cache/client_infos.h"
+#include "distributed_cache/redis_keys.h"
+#include "distributed_cache/server.h"
+
+namespace mindspore {
+namespace fl {
+namespace cache {
+// In-memory hashes of one redis server, the other operators are not used by ClientInfos and fail.
+class FakeRedisClient : public RedisClientBase {
+ public:
+  bool IsValid() override { return true; }
+  void Disconnect() override {}
+  CacheStatus Connect(bool) override { return kCacheSuccess; }
+  CacheStatus Reconnect() override { return kCacheSuccess; }
+  using RedisClientBase::Del;
+  CacheStatus Del(const std::vector<std::string> &keys) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    for (auto &key : keys) {
+      (void)hashes_.erase(key);
+    }
+    return kCacheSuccess;
+  }
+  CacheStatus Expire(const std::string &, uint64_t) override { return kCacheSuccess; }
+  CacheStatus Expire(const std::vector<std::string> &, uint64_t) override { return kCacheSuccess; }
+  CacheStatus SAdd(const std::string &, const std::string &) override { return kCacheInnerErr; }
+  CacheStatus SIsMember(const std::string &, const std::string &, bool *) override { return kCacheInnerErr; }
+  CacheStatus SMembers(const std::string &, std::vector<std::string> *) override { return kCacheInnerErr; }
+  CacheStatus HExists(const std::string &key, const std::string &filed, bool *value) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    *value = hashes_[key].count(filed) > 0;
+    return kCacheSuccess;
+  }
+  CacheStatus HSet(const std::string &key, const std::string &filed, const std::string &value) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    hashes_[key][filed] = value;
+    return kCacheSuccess;
+  }
+  CacheStatus HSetNx(const std::string &key, const std::string &filed, const std::string &value) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    return hashes_[key].emplace(filed, value).second ? kCacheSuccess : kCacheExist;
+  }
+  CacheStatus HMSet(const std::string &, const std::unordered_map<std::string, std::string> &) override {
+    return kCacheInnerErr;
+  }
+  CacheStatus HGet(const std::string &key, const std::string &filed, std::string *value) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto &hash = hashes_[key];
+    auto it = hash.find(filed);
+    if (it == hash.end()) {
+      return kCacheNil;
+    }
+    *value = it->second;
+    return kCacheSuccess;
+  }
+  CacheStatus HGetAll(const std::string &key, std::unordered_map<std::string, std::string> *items) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto &hash = hashes_[key];
+    *items = {hash.begin(), hash.end()};
+    return kCacheSuccess;
+  }
+  CacheStatus HIncr(const std::string &, const std::string &, uint64_t *) override { return kCacheInnerErr; }
+  CacheStatus HDel(const std::string &key, const std::string &filed) override {
+    std::lock_guard<std::mutex> lock(lock_);
+    (void)hashes_[key].erase(filed);
+    return kCacheSuccess;
+  }
+  CacheStatus Get(const std::string &, std::string *) override { return kCacheInnerErr; }
+  CacheStatus SetEx(const std::string &, const std::string &, uint64_t) override { return kCacheInnerErr; }
+  CacheStatus SetNx(const std::string &, const std::string &) override { return kCacheInnerErr; }
+  CacheStatus SetExNx(const std::string &, const std::string &, uint64_t) override { return kCacheInnerErr; }
+  CacheStatus Incr(const std::string &, uint64_t *) override { return kCacheInnerErr; }
+  CacheStatus HSetNxExpire(const std::string &key, const std::string &filed, const std::string &value,
+                           uint64_t) override {
+    return HSetNx(key, filed, value);
+  }
+  CacheStatus SAddExpire(const std::string &, const std::string &, uint64_t) override { return kCacheInnerErr; }
+  CacheStatus HIncrExpire(const std::string &, const std::string &, uint64_t, uint64_t *) override {
+    return kCacheInnerErr;
+  }
+  CacheStatus HIncrExpireGetAll(const std::string &, const std::string &, uint64_t,
+                                std::unordered_map<std::string, std::string> *) override {
+    return kCacheInnerErr;
+  }
+
+  std::map<std::string, std::string> hash(const std::string &key) {
+    std::lock_guard<std::mutex> lock(lock_);
+    return hashes_[key];
+  }
+
+ private:
+  std::mutex lock_;
+  std::map<std::string, std::map<std::string, std::string>> hashes_;
+};
+
+class FakeDistributedCache : public DistributedCacheBase {
+ public:
+  explicit FakeDistributedCache(const std::shared_ptr<FakeRedisClient> &client) : client_(client) {}
+  bool Init(const DistributedCacheConfig &, int64_t) override { return true; }
+  std::shared_ptr<RedisClientBase> GetOneClient() override { return client_; }
+  bool HasInvalid() const override { return false; }
+  CacheStatus RetryConnect() override { return kCacheSuccess; }
+  void Clear() override {}
+
+ private:
+  std::shared_ptr<FakeRedisClient> client_;
+};
+
+class TestClientInfos : public testing::Test {
+ public:
+  void SetUp() override {
+    client_ = std::make_shared<FakeRedisClient>();
+    ASSERT_TRUE(DistributedCacheLoader::Instance().InitCacheImpl(std::make_shared<FakeDistributedCache>(client_)));
+  }
+
+  void TearDown() override {
+    DistributedCacheLoader::Instance().Clear();
+    Server::Instance().Init("", "");
+  }
+
+  static std::vector<float> CreateNoises(size_t size, float base) {
+    std::vector<float> noises(size);
+    for (size_t i = 0; i < size; i++) {
+      noises[i] = base + static_cast<float>(i % 1000);
+    }
+    return noises;
+  }
+
+  // Sets the noises by the server node_id.
+  static CacheStatus SetClientNoises(const std::string &node_id, const std::vector<float> &noises) {
+    Server::Instance().Init(node_id, "127.0.0.1:6666");
+    return ClientInfos::GetInstance().SetClientNoises(noises);
+  }
+
+  // Reads the noises chunk by chunk, and checks that the chunks cover the noises once in chunks of
+  // kClientNoisesChunkSize elements but the last one.
+  static CacheStatus GetClientNoises(uint64_t noises_size, std::vector<float> *noises) {
+    std::mutex lock;
+    std::map<size_t, size_t> chunks;
+    std::vector<float> result(noises_size);
+    auto ret = ClientInfos::GetInstance().GetClientNoises(
+      noises_size, [&lock, &chunks, &result](size_t offset, const float *chunk_noises, size_t size) {
+        std::lock_guard<std::mutex> guard(lock);
+        chunks[offset] = size;
+        if (offset + size <= result.size()) {
+          std::copy(chunk_noises, chunk_noises + size, result.begin() + offset);
+        }
+      });
+    if (!ret.IsSuccess()) {
+      return ret;
+    }
+    size_t chunk_size = ClientInfos::kClientNoisesChunkSize;
+    size_t expect_offset = 0;
+    for (auto &chunk : chunks) {
+      EXPECT_EQ(chunk.first, expect_offset);
+      EXPECT_EQ(chunk.second, std::min<size_t>(chunk_size, noises_size - expect_offset));
+      expect_offset += chunk.second;
+    }
+    EXPECT_EQ(chunks.size(), (noises_size + chunk_size - 1) / chunk_size);
+    EXPECT_EQ(expect_offset, noises_size);
+    *noises = std::move(result);
+    return kCacheSuccess;
+  }
+
+  std::shared_ptr<FakeRedisClient> client_;
+};
+
+/// Feature: Client noises of secure aggregation stored in chunks in the distributed cache.
+/// Description: Set and get noises of 1 element, one element less and more than a chunk, a chunk, and two chunks and
+/// a partial one.
+/// Expectation: The chunks are read at their offsets with their sizes, and the noises read are the ones set.
+TEST_F(TestClientInfos, ClientNoisesChunks) {
+  const size_t chunk_size = ClientInfos::kClientNoisesChunkSize;
+  for (size_t size : {static_cast<size_t>(1), chunk_size - 1, chunk_size, chunk_size + 1, 2 * chunk_size + 3}) {
+    (void)client_->Del(RedisKeys::GetInstance().ClientNoisesHash());
+    uint64_t noises_size = 0;
+    EXPECT_EQ(ClientInfos::GetInstance().GetClientNoisesSize(&noises_size), kCacheNil);
+    auto noises = CreateNoises(size, 0.5f);
+    ASSERT_EQ(SetClientNoises("server_0", noises), kCacheSuccess);
+    ASSERT_EQ(ClientInfos::GetInstance().GetClientNoisesSize(&noises_size), kCacheSuccess);
+    EXPECT_EQ(noises_size, size);
+    std::vector<float> result;
+    ASSERT_EQ(GetClientNoises(noises_size, &result), kCacheSuccess) << "size " << size;
+    EXPECT_EQ(result, noises) << "size " << size;
+    // The size of the noises read must be the one set.
+    EXPECT_NE(ClientInfos::GetInstance().GetClientNoises(size + 1, [](size_t, const float *, size_t) {}),
+              kCacheSuccess);
+  }
+}
+
+/// Feature: Client noises of secure aggregation stored in chunks in the distributed cache.
+/// Description: A server stops after writing a part of its chunks, then two other servers set different noises one
+/// after another.
+/// Expectation: The noises of the first server which finishes are read, and the chunks of the later one are deleted.
+TEST_F(TestClientInfos, ClientNoisesWriters) {
+  const size_t size = ClientInfos::kClientNoisesChunkSize + 5;
+  auto key = RedisKeys::GetInstance().ClientNoisesHash();
+  ASSERT_EQ(client_->HSet(key, "server_0:0", "stopped halfway"), kCacheSuccess);
+  auto noises_1 = CreateNoises(size, 1.0f);
+  auto noises_2 = CreateNoises(size, 2.0f);
+  ASSERT_EQ(SetClientNoises("server_1", noises_1), kCacheSuccess);
+  ASSERT_EQ(SetClientNoises("server_2", noises_2), kCacheSuccess);
+  // Setting the noises again by the server which published them changes nothing.
+  ASSERT_EQ(SetClientNoises("server_1", noises_2), kCacheSuccess);
+  std::vector<float> result;
+  ASSERT_EQ(GetClientNoises(size, &result), kCacheSuccess);
+  EXPECT_EQ(result, noises_1);
+  std::vector<std::string> fields;
+  for (auto &item : client_->hash(key)) {
+    fields.push_back(item.first);
+  }
+  EXPECT_EQ(fields, (std::vector<std::string>{"server_0:0", "server_1:0", "server_1:1", "size"}));
+}
+}  // namespace cache
+}  // namespace fl
+}  // namespace mindspore
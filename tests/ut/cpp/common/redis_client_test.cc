@@ -0,0 +1,213 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "gtest/gtest.h"
+#include "distributed_cache/redis/redis.h"
+
+namespace mindspore {
+namespace fl {
+namespace cache {
+// These tests need a redis server, whose address is set by the environment variable MS_TEST_REDIS_ADDRESS and is
+// 127.0.0.1:6379 by default. They are skipped if the server cannot be connected.
+class TestRedisClient : public testing::Test {
+ public:
+  class Client : public RedisClient {
+   public:
+    using RedisClient::RedisClient;
+    using RedisClient::RunCommand;
+  };
+
+  void SetUp() override {
+    auto address_env = std::getenv("MS_TEST_REDIS_ADDRESS");
+    std::string address = address_env == nullptr ? "127.0.0.1:6379" : address_env;
+    client_ = std::make_shared<Client>(address, nullptr, 1);
+    if (!client_->Connect(false).IsSuccess()) {
+      client_ = nullptr;
+      GTEST_SKIP() << "Cannot connect to redis server " << address;
+    }
+    (void)client_->Del(keys_);
+  }
+
+  void TearDown() override {
+    if (client_ != nullptr) {
+      (void)client_->Del(keys_);
+    }
+  }
+
+  uint64_t Ttl(const std::string &key) {
+    uint64_t ttl = 0;
+    (void)client_->RunCommand({"TTL", key}).GetInteger(&ttl);
+    return ttl;
+  }
+
+  template <class F>
+  static double CostPerCall(size_t call_num, const F &f) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < call_num; i++) {
+      f(i);
+    }
+    auto cost = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return cost / call_num;
+  }
+
+  std::shared_ptr<Client> client_;
+  const std::vector<std::string> keys_ = {"ut_redis_hash", "ut_redis_set", "ut_redis_count", "ut_redis_server_count"};
+};
+
+/// Feature: Compound redis operators in one round trip for client infos and counters.
+/// Description: Add fields and members, and count twice in a hash and a per server hash.
+/// Expectation: The results are the same as the separate commands, and the expire time is set when the key is created.
+TEST_F(TestRedisClient, CompoundOperators) {
+  const uint64_t seconds = 100;
+  EXPECT_EQ(client_->HSetNxExpire("ut_redis_hash", "fl_1", "value_1", seconds), kCacheSuccess);
+  EXPECT_EQ(client_->HSetNxExpire("ut_redis_hash", "fl_1", "value_2", seconds), kCacheExist);
+  std::string value;
+  EXPECT_EQ(client_->HGet("ut_redis_hash", "fl_1", &value), kCacheSuccess);
+  EXPECT_EQ(value, "value_1");
+  EXPECT_GT(Ttl("ut_redis_hash"), 0);
+  EXPECT_LE(Ttl("ut_redis_hash"), seconds);
+
+  EXPECT_EQ(client_->SAddExpire("ut_redis_set", "fl_1", seconds), kCacheSuccess);
+  EXPECT_EQ(client_->SAddExpire("ut_redis_set", "fl_1", seconds), kCacheExist);
+  EXPECT_GT(Ttl("ut_redis_set"), 0);
+
+  uint64_t count = 0;
+  EXPECT_EQ(client_->HIncrExpire("ut_redis_count", "count", seconds, &count), kCacheSuccess);
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(client_->HIncrExpire("ut_redis_count", "count", seconds, &count), kCacheSuccess);
+  EXPECT_EQ(count, 2);
+  EXPECT_GT(Ttl("ut_redis_count"), 0);
+
+  std::shared_ptr<RedisClientBase> base_client = client_;
+  std::unordered_map<std::string, uint64_t> count_map;
+  EXPECT_EQ(base_client->HIncrExpireGetAll("ut_redis_server_count", "server_1", seconds, &count_map), kCacheSuccess);
+  EXPECT_EQ(base_client->HIncrExpireGetAll("ut_redis_server_count", "server_2", seconds, &count_map), kCacheSuccess);
+  EXPECT_EQ(base_client->HIncrExpireGetAll("ut_redis_server_count", "server_1", seconds, &count_map), kCacheSuccess);
+  EXPECT_EQ(count_map, (std::unordered_map<std::string, uint64_t>{{"server_1", 2}, {"server_2", 1}}));
+  EXPECT_GT(Ttl("ut_redis_server_count"), 0);
+
+  const uint64_t new_seconds = 10;
+  EXPECT_EQ(client_->Expire(keys_, new_seconds), kCacheSuccess);
+  for (auto &key : keys_) {
+    EXPECT_LE(Ttl(key), new_seconds) << key;
+  }
+}
+
+/// Feature: Compound redis operators in one round trip for client infos and counters.
+/// Description: Add client infos and count by the separate commands and by the compound operators 10K times.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: The time cost per call of each is printed.
+TEST_F(TestRedisClient, DISABLED_Benchmark) {
+  const size_t call_num = 10000;
+  const uint64_t seconds = 100;
+  auto separate_add = CostPerCall(call_num, [this](size_t i) {
+    if (client_->HSetNx("ut_redis_hash", std::to_string(i), "value").IsSuccess()) {
+      (void)client_->Expire("ut_redis_hash", seconds);
+    }
+  });
+  (void)client_->Del(keys_);
+  auto compound_add = CostPerCall(call_num, [this](size_t i) {
+    (void)client_->HSetNxExpire("ut_redis_hash", std::to_string(i), "value", seconds);
+  });
+  std::cout << "add client info, HSETNX and EXPIRE: " << separate_add << " us, compound: " << compound_add << " us"
+            << std::endl;
+
+  auto separate_count = CostPerCall(call_num, [this](size_t) {
+    uint64_t new_count = 0;
+    (void)client_->HIncr("ut_redis_server_count", "server_1", &new_count);
+    if (new_count == 1) {
+      (void)client_->Expire("ut_redis_server_count", seconds);
+    }
+    std::unordered_map<std::string, std::string> count_map;
+    (void)client_->HGetAll("ut_redis_server_count", &count_map);
+  });
+  (void)client_->Del(keys_);
+  auto compound_count = CostPerCall(call_num, [this](size_t) {
+    std::unordered_map<std::string, std::string> count_map;
+    (void)client_->HIncrExpireGetAll("ut_redis_server_count", "server_1", seconds, &count_map);
+  });
+  std::cout << "per server count, HINCRBY, EXPIRE and HGETALL: " << separate_count << " us, compound: "
+            << compound_count << " us" << std::endl;
+
+  auto separate_expire = CostPerCall(call_num / keys_.size(), [this](size_t) {
+    for (auto &key : keys_) {
+      (void)client_->Expire(key, seconds);
+    }
+  });
+  auto pipeline_expire =
+    CostPerCall(call_num / keys_.size(), [this](size_t) { (void)client_->Expire(keys_, seconds); });
+  std::cout << "expire " << keys_.size() << " keys, one by one: " << separate_expire
+            << " us, pipeline: " << pipeline_expire << " us" << std::endl;
+}
+
+// Commands and replies of the compound operators, which need no redis server.
+class TestRedisCommand : public testing::Test {
+ public:
+  // Parse a reply in the redis protocol as it is read from the server.
+  static RedisReply ParseReply(const std::string &data) {
+    auto reader = redisReaderCreate();
+    void *reply = nullptr;
+    if (redisReaderFeed(reader, data.data(), data.size()) != REDIS_OK ||
+        redisReaderGetReply(reader, &reply) != REDIS_OK) {
+      reply = nullptr;
+    }
+    redisReaderFree(reader);
+    return RedisReply(reinterpret_cast<redisReply *>(reply));
+  }
+};
+
+/// Feature: Compound redis operators in one round trip for client infos and counters.
+/// Description: Build the EVAL command of a script with one key and two args, and with no key.
+/// Expectation: The arguments are EVAL, the script, the key number, the keys and the args in order.
+TEST_F(TestRedisCommand, EvalCommand) {
+  const std::string script = "return redis.call('HINCRBY', KEYS[1], ARGV[1], 1)";
+  EXPECT_EQ(RedisClient::EvalCommand(script, {"ut_key"}, {"field", "100"}),
+            (std::vector<std::string>{"EVAL", script, "1", "ut_key", "field", "100"}));
+  EXPECT_EQ(RedisClient::EvalCommand("return 1", {}, {"1"}), (std::vector<std::string>{"EVAL", "return 1", "0", "1"}));
+}
+
+/// Feature: Compound redis operators in one round trip for client infos and counters.
+/// Description: Read the integer reply of HIncrExpire, the array reply of HIncrExpireGetAll and an error reply of a
+/// script.
+/// Expectation: The integer and map are read, an odd array is not a map, and the error reply is invalid.
+TEST_F(TestRedisCommand, ScriptReplies) {
+  uint64_t value = 0;
+  auto integer_reply = ParseReply(":3\r\n");
+  EXPECT_TRUE(integer_reply.IsValid());
+  EXPECT_TRUE(integer_reply.GetInteger(&value));
+  EXPECT_EQ(value, 3);
+
+  std::unordered_map<std::string, std::string> items;
+  auto map_reply = ParseReply("*4\r\n$8\r\nserver_1\r\n$1\r\n2\r\n$8\r\nserver_2\r\n$1\r\n1\r\n");
+  EXPECT_TRUE(map_reply.GetMap(&items));
+  EXPECT_EQ(items, (std::unordered_map<std::string, std::string>{{"server_1", "2"}, {"server_2", "1"}}));
+  EXPECT_FALSE(ParseReply("*1\r\n$8\r\nserver_1\r\n").GetMap(&items));
+
+  auto error_reply = ParseReply("-ERR Error running script\r\n");
+  EXPECT_FALSE(error_reply.IsValid());
+  EXPECT_EQ(error_reply.GetError(), "ERR Error running script");
+  EXPECT_FALSE(error_reply.GetInteger(&value));
+}
+}  // namespace cache
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,202 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "common/utils/simd_kernels.h"
+
+namespace mindspore {
+namespace fl {
+namespace simd {
+class TestSimdKernels : public testing::Test {
+ public:
+  static std::vector<float> RandomVector(size_t elem_num, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::vector<float> ret(elem_num);
+    for (auto &item : ret) {
+      item = dist(gen);
+    }
+    return ret;
+  }
+
+  static void ExpectNear(const std::vector<float> &expect, const std::vector<float> &actual) {
+    ASSERT_EQ(expect.size(), actual.size());
+    for (size_t i = 0; i < expect.size(); i++) {
+      ASSERT_NEAR(expect[i], actual[i], 1e-4f * (1.0f + std::fabs(expect[i]))) << "index " << i;
+    }
+  }
+
+  const std::vector<SimdLevel> levels_ = {SimdLevel::kScalar, SimdLevel::kNeon, SimdLevel::kAvx2, SimdLevel::kAvx512};
+  // Include sizes that are not a multiple of any vector width to cover the scalar tail.
+  const std::vector<size_t> sizes_ = {0, 1, 7, 15, 17, 33, 1000, 4099};
+};
+
+/// Feature: SIMD float kernels for FedAvg.
+/// Description: Run add, scale and fused add with weight on every instruction set.
+/// Expectation: All results are the same as the scalar implementation.
+TEST_F(TestSimdKernels, AllLevelsMatchScalar) {
+  for (auto elem_num : sizes_) {
+    auto src = RandomVector(elem_num, 1);
+    auto dst = RandomVector(elem_num, 2);
+    auto expect_add = dst;
+    auto expect_scale = dst;
+    auto expect_add_scaled = dst;
+    Add(expect_add.data(), src.data(), elem_num, SimdLevel::kScalar);
+    Scale(expect_scale.data(), 0.125f, elem_num, SimdLevel::kScalar);
+    AddScaled(expect_add_scaled.data(), src.data(), 3.5f, elem_num, SimdLevel::kScalar);
+    for (auto level : levels_) {
+      auto actual = dst;
+      Add(actual.data(), src.data(), elem_num, level);
+      ExpectNear(expect_add, actual);
+      actual = dst;
+      Scale(actual.data(), 0.125f, elem_num, level);
+      ExpectNear(expect_scale, actual);
+      actual = dst;
+      AddScaled(actual.data(), src.data(), 3.5f, elem_num, level);
+      ExpectNear(expect_add_scaled, actual);
+    }
+  }
+}
+
+/// Feature: SIMD min max quantization kernels for model compression.
+/// Description: Run min max, quantize and dequantize of 8, 4 and 2 bits on every instruction set.
+/// Expectation: All results are the same as the scalar implementation.
+TEST_F(TestSimdKernels, QuantLevelsMatchScalar) {
+  const std::vector<std::pair<uint8_t, uint8_t>> code_params = {{255, 128}, {15, 0}, {3, 0}};
+  for (auto elem_num : sizes_) {
+    if (elem_num == 0) {
+      continue;
+    }
+    auto src = RandomVector(elem_num, 5);
+    float expect_min = 0;
+    float expect_max = 0;
+    MinMax(src.data(), elem_num, &expect_min, &expect_max, SimdLevel::kScalar);
+    EXPECT_EQ(expect_min, *std::min_element(src.begin(), src.end()));
+    EXPECT_EQ(expect_max, *std::max_element(src.begin(), src.end()));
+    for (auto &code_param : code_params) {
+      float scale = (expect_max - expect_min) / code_param.first + 1e-10f;
+      std::vector<uint8_t> expect_codes(elem_num);
+      std::vector<float> expect_values(elem_num);
+      Quantize(src.data(), elem_num, expect_min, 1.0f / scale, code_param.first, code_param.second,
+               expect_codes.data(), SimdLevel::kScalar);
+      Dequantize(expect_codes.data(), elem_num, expect_min, scale, code_param.second, expect_values.data(),
+                 SimdLevel::kScalar);
+      for (size_t i = 0; i < elem_num; i++) {
+        ASSERT_NEAR(src[i], expect_values[i], scale / 2 + 1e-4f) << "index " << i;
+      }
+      for (auto level : levels_) {
+        float min_val = 0;
+        float max_val = 0;
+        MinMax(src.data(), elem_num, &min_val, &max_val, level);
+        EXPECT_EQ(expect_min, min_val);
+        EXPECT_EQ(expect_max, max_val);
+        std::vector<uint8_t> codes(elem_num);
+        std::vector<float> values(elem_num);
+        Quantize(src.data(), elem_num, expect_min, 1.0f / scale, code_param.first, code_param.second, codes.data(),
+                 level);
+        EXPECT_EQ(expect_codes, codes) << SimdLevelName(level);
+        Dequantize(expect_codes.data(), elem_num, expect_min, scale, code_param.second, values.data(), level);
+        ExpectNear(expect_values, values);
+      }
+    }
+  }
+}
+
+/// Feature: SIMD float kernels for FedAvg.
+/// Description: Measure single core throughput of the accumulate and scale kernels for realistic parameter sizes.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: Every instruction set produces a positive throughput, which is printed as bytes per second.
+TEST_F(TestSimdKernels, DISABLED_Benchmark) {
+  const std::vector<size_t> bench_sizes = {1 << 16, 1 << 20, 1 << 24};  // 256KB, 4MB, 64MB
+  const size_t min_bytes = 1 << 28;
+  for (auto elem_num : bench_sizes) {
+    auto src = RandomVector(elem_num, 3);
+    auto dst = RandomVector(elem_num, 4);
+    size_t repeat = std::max<size_t>(min_bytes / (elem_num * sizeof(float)), 1);
+    for (auto level : levels_) {
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeat; i++) {
+        Add(dst.data(), src.data(), elem_num, level);
+      }
+      auto add_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeat; i++) {
+        Scale(dst.data(), 1.0f, elem_num, level);
+      }
+      auto scale_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      // Add reads dst and src and writes dst, scale reads and writes dst.
+      double add_bytes = 3.0 * elem_num * sizeof(float) * repeat;
+      double scale_bytes = 2.0 * elem_num * sizeof(float) * repeat;
+      std::cout << "[" << SimdLevelName(level) << "] elements: " << elem_num
+                << ", add: " << add_bytes / add_cost / (1 << 30) << " GB/s"
+                << ", scale: " << scale_bytes / scale_cost / (1 << 30) << " GB/s" << std::endl;
+      EXPECT_GT(add_cost, 0);
+      EXPECT_GT(scale_cost, 0);
+    }
+  }
+}
+
+/// Feature: SIMD min max quantization kernels for model compression.
+/// Description: Measure single core throughput of min max, 8 bits quantize and dequantize for 1M to 100M elements.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: Every instruction set produces a positive throughput, which is printed as float elements per second.
+TEST_F(TestSimdKernels, DISABLED_QuantBenchmark) {
+  const std::vector<size_t> bench_sizes = {1000000, 10000000, 100000000};
+  const size_t min_elems = 1 << 28;
+  for (auto elem_num : bench_sizes) {
+    auto src = RandomVector(elem_num, 6);
+    std::vector<uint8_t> codes(elem_num);
+    size_t repeat = std::max<size_t>(min_elems / elem_num, 1);
+    for (auto level : levels_) {
+      float min_val = 0;
+      float max_val = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeat; i++) {
+        MinMax(src.data(), elem_num, &min_val, &max_val, level);
+      }
+      auto min_max_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      float scale = (max_val - min_val) / 255 + 1e-10f;
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeat; i++) {
+        Quantize(src.data(), elem_num, min_val, 1.0f / scale, 255, 128, codes.data(), level);
+      }
+      auto quant_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      // Dequantize back to src, the values stay within the same range.
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeat; i++) {
+        Dequantize(codes.data(), elem_num, min_val, scale, 128, src.data(), level);
+      }
+      auto dequant_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      double elems = static_cast<double>(elem_num) * repeat / 1e9;
+      std::cout << "[" << SimdLevelName(level) << "] elements: " << elem_num << ", min max: " << elems / min_max_cost
+                << " G/s, quantize: " << elems / quant_cost << " G/s, dequantize: " << elems / dequant_cost << " G/s"
+                << std::endl;
+      EXPECT_GT(min_max_cost, 0);
+      EXPECT_GT(quant_cost, 0);
+      EXPECT_GT(dequant_cost, 0);
+    }
+  }
+}
+}  // namespace simd
+}  // namespace fl
+}  // namespace mindspore
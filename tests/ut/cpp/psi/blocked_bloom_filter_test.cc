@@ -0,0 +1,119 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/base_crypto/bloom_filter.h"
+#include "armour/base_crypto/blocked_bloom_filter.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+class TestBlockedBloomFilter : public testing::Test {
+ public:
+  static constexpr size_t kThreadNum = 4;
+
+  // Random compare strings of 32 bytes, like the x coordinates of p1^a.
+  static std::vector<std::string> RandomStrings(size_t num, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<std::string> ret(num, std::string(32, '\0'));
+    for (auto &item : ret) {
+      for (auto &c : item) {
+        c = static_cast<char>(gen());
+      }
+    }
+    return ret;
+  }
+
+  template <class Filter>
+  static size_t CountHits(const Filter &filter, const std::vector<std::string> &keys) {
+    size_t hits = 0;
+    for (auto &key : keys) {
+      hits += filter.LookUp(key) ? 1 : 0;
+    }
+    return hits;
+  }
+};
+
+/// Feature: Blocked bloom filter for filter ecdh PSI.
+/// Description: Build filters of 0 to 100K items, send them through GetData and Parse, and look up the items and
+/// other random items with a false positive rate of 2^-10.
+/// Expectation: All the items are found, and the false positive rate is close to the expected one.
+TEST_F(TestBlockedBloomFilter, LookUp) {
+  const std::vector<size_t> input_nums = {0, 1, 1000, 100000};
+  for (auto input_num : input_nums) {
+    auto input_vct = RandomStrings(input_num, input_num);
+    BlockedBloomFilter filter(input_vct, 10, kThreadNum);
+    BlockedBloomFilter filter_recv;
+    ASSERT_TRUE(filter_recv.Parse(filter.GetData()));
+    EXPECT_EQ(filter_recv.input_num_, input_num);
+    EXPECT_EQ(filter_recv.words_, filter.words_);
+    EXPECT_EQ(CountHits(filter_recv, input_vct), input_num);
+    auto other_vct = RandomStrings(100000, input_num + 1);
+    EXPECT_LE(CountHits(filter_recv, other_vct), 100000 * 2 / 1024);
+  }
+}
+
+/// Feature: Blocked bloom filter for filter ecdh PSI.
+/// Description: Parse data with a wrong magic, a wrong size and a wrong number of blocks per key.
+/// Expectation: Parse fails.
+TEST_F(TestBlockedBloomFilter, ParseInvalidData) {
+  auto data = BlockedBloomFilter(RandomStrings(100, 1), 40, kThreadNum).GetData();
+  BlockedBloomFilter filter;
+  EXPECT_FALSE(filter.Parse(""));
+  EXPECT_FALSE(filter.Parse(data.substr(0, data.size() - 1)));
+  auto wrong_magic = data;
+  wrong_magic[0] = 'X';
+  EXPECT_FALSE(filter.Parse(wrong_magic));
+  auto wrong_blocks_per_key = data;
+  wrong_blocks_per_key[BlockedBloomFilter::kMagicSize] = 0;
+  EXPECT_FALSE(filter.Parse(wrong_blocks_per_key));
+  EXPECT_TRUE(filter.Parse(data));
+}
+
+/// Feature: Blocked bloom filter for filter ecdh PSI.
+/// Description: Build and look up 1M items with a false positive rate of 2^-40 by the blocked and the byte per bit
+/// bloom filter.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: Both find all the items, the time cost and the size of each is printed.
+TEST_F(TestBlockedBloomFilter, DISABLED_Benchmark) {
+  const size_t input_num = 1000000;
+  auto input_vct = RandomStrings(input_num, 2);
+  auto start = std::chrono::steady_clock::now();
+  BloomFilter bloom_filter(input_vct, 40);
+  auto build_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(CountHits(bloom_filter, input_vct), input_num);
+  auto look_up_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "bloom filter, build: " << build_cost << " s, look up: " << look_up_cost
+            << " s, size: " << bloom_filter.bitArrayByteLen() << " bytes" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  BlockedBloomFilter blocked_filter(input_vct, 40, kThreadNum);
+  build_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(CountHits(blocked_filter, input_vct), input_num);
+  look_up_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "blocked bloom filter, build: " << build_cost << " s, look up: " << look_up_cost
+            << " s, size: " << blocked_filter.DataByteLen() << " bytes" << std::endl;
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,134 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/base_crypto/digest_hash_set.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+class TestDigestHashSet : public testing::Test {
+ public:
+  static constexpr size_t kThreadNum = 4;
+
+  // Random strings of the given length, the first intersect_num of bob are also in alice.
+  static void GenData(size_t alice_num, size_t bob_num, size_t intersect_num, size_t length,
+                      std::vector<std::string> *alice_vct, std::vector<std::string> *bob_vct) {
+    std::mt19937_64 gen(length + alice_num);
+    auto random_string = [&gen, length]() {
+      std::string ret(length, '\0');
+      for (auto &c : ret) {
+        c = static_cast<char>(gen());
+      }
+      return ret;
+    };
+    alice_vct->resize(alice_num);
+    bob_vct->resize(bob_num);
+    for (auto &item : *alice_vct) {
+      item = random_string();
+    }
+    for (size_t i = 0; i < bob_num; i++) {
+      (*bob_vct)[i] = i < intersect_num ? (*alice_vct)[i * (alice_num / intersect_num)] : random_string();
+    }
+    std::shuffle(bob_vct->begin(), bob_vct->end(), gen);
+  }
+
+  template <size_t kWidth>
+  static std::vector<unsigned char> HashSetLookUp(const std::vector<std::string> &alice_vct,
+                                                  const std::vector<std::string> &bob_vct) {
+    DigestHashSet<kWidth> alice_set(alice_vct, kThreadNum, 1);
+    std::vector<unsigned char> flags(bob_vct.size());
+    ParallelSync parallel_sync(kThreadNum);
+    parallel_sync.parallel_for(0, bob_vct.size(), 1, [&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; i++) {
+        flags[i] = alice_set.Contains(bob_vct[i]) ? 1 : 0;
+      }
+    });
+    return flags;
+  }
+
+  static std::vector<unsigned char> SortLookUp(std::vector<std::string> alice_vct,
+                                               const std::vector<std::string> &bob_vct) {
+    std::sort(alice_vct.begin(), alice_vct.end());
+    std::vector<unsigned char> flags(bob_vct.size());
+    ParallelSync parallel_sync(kThreadNum);
+    parallel_sync.parallel_for(0, bob_vct.size(), 1, [&](size_t beg, size_t end) {
+      for (size_t i = beg; i < end; i++) {
+        flags[i] = std::binary_search(alice_vct.begin(), alice_vct.end(), bob_vct[i]) ? 1 : 0;
+      }
+    });
+    return flags;
+  }
+};
+
+/// Feature: Hash set of fixed width digests for PSI align.
+/// Description: Look up random strings of 12, 16 and 32 bytes, duplicated keys and the all zero key.
+/// Expectation: The results are the same as sort and binary search.
+TEST_F(TestDigestHashSet, SameAsBinarySearch) {
+  const std::vector<size_t> alice_nums = {0, 1, 100, 200000};
+  for (auto alice_num : alice_nums) {
+    for (auto length : {12, 16, 32}) {
+      std::vector<std::string> alice_vct;
+      std::vector<std::string> bob_vct;
+      GenData(alice_num, 1000, std::min<size_t>(alice_num, 500), length, &alice_vct, &bob_vct);
+      auto expect = SortLookUp(alice_vct, bob_vct);
+      auto actual = length <= 16 ? HashSetLookUp<16>(alice_vct, bob_vct) : HashSetLookUp<32>(alice_vct, bob_vct);
+      EXPECT_EQ(expect, actual) << "alice num " << alice_num << ", length " << length;
+    }
+  }
+
+  std::vector<std::string> keys = {std::string(16, '\0'), "0123456789abcdef", "0123456789abcdef"};
+  DigestHashSet<16> digest_set(keys, kThreadNum, 1);
+  EXPECT_EQ(digest_set.size(), 2);
+  EXPECT_TRUE(digest_set.Contains(std::string(16, '\0')));
+  EXPECT_TRUE(digest_set.Contains("0123456789abcdef"));
+  EXPECT_FALSE(digest_set.Contains("0123456789abcdeg"));
+  DigestHashSet<16> empty_set({}, kThreadNum, 1);
+  EXPECT_EQ(empty_set.size(), 0);
+  EXPECT_FALSE(empty_set.Contains(std::string(16, '\0')));
+  EXPECT_FALSE(empty_set.Contains("0123456789abcdef"));
+}
+
+/// Feature: Hash set of fixed width digests for PSI align.
+/// Description: Align 1M and 10M compare strings of 32 bytes by the hash set and by sort and binary search.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: Both have the same results, the time cost of each is printed.
+TEST_F(TestDigestHashSet, DISABLED_Benchmark) {
+  const std::vector<size_t> bench_sizes = {1000000, 10000000};
+  for (auto item_num : bench_sizes) {
+    std::vector<std::string> alice_vct;
+    std::vector<std::string> bob_vct;
+    GenData(item_num, item_num, item_num / 2, 32, &alice_vct, &bob_vct);
+    auto start = std::chrono::steady_clock::now();
+    auto expect = SortLookUp(alice_vct, bob_vct);
+    auto sort_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    auto actual = HashSetLookUp<32>(alice_vct, bob_vct);
+    auto hash_set_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(expect, actual);
+    std::cout << "items: " << item_num << ", sort and binary search: " << sort_cost
+              << " s, hash set: " << hash_set_cost << " s" << std::endl;
+  }
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/base_crypto/ecc.h"
+#include "armour/base_crypto/hash.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+class TestECC : public testing::Test {
+ public:
+  static constexpr size_t kThreadNum = 4;
+
+  static std::vector<std::string> HashedInputs(size_t num) {
+    std::vector<std::string> ret(num);
+    for (size_t i = 0; i < num; i++) {
+      ret[i] = HashInput(std::to_string(i));
+    }
+    return ret;
+  }
+};
+
+/// Feature: ECDH operations of PSI.
+/// Description: Compute p^a^b by alice and bob in both orders, and remove b by bob's inverse key, with compress
+/// length 32 and 33 on every supported curve.
+/// Expectation: p^a^b is the same in both orders, and p^a^b^(b^-1) is the same as p^a.
+TEST_F(TestECC, Commutative) {
+  auto hash_inputs = HashedInputs(100);
+  for (auto curve_name : {"p256", "sm2", "brainpoolP256r1"}) {
+    for (auto compress_length : {LENGTH_32, LENGTH_33}) {
+      ECC alice(curve_name, kThreadNum, 1);
+      ECC bob(curve_name, kThreadNum, 1);
+      auto p_a_vct = alice.HashToCurveAndMul(hash_inputs, compress_length, compress_length);
+      auto p_b_vct = bob.HashToCurveAndMul(hash_inputs, compress_length, compress_length);
+      auto p_a_b_vct = bob.DcpsAndMul(p_a_vct, compress_length, compress_length);
+      auto p_b_a_vct = alice.DcpsAndMul(p_b_vct, compress_length, compress_length);
+      EXPECT_EQ(p_a_b_vct, p_b_a_vct) << curve_name << ", compress length " << compress_length;
+
+      auto p_a_compare_vct = alice.HashToCurveAndMul(hash_inputs, compress_length, LENGTH_12);
+      auto p_a_b_bI_vct = bob.DcpsAndInverseMul(p_a_b_vct, compress_length, LENGTH_12);
+      if (compress_length == LENGTH_32) {
+        EXPECT_EQ(p_a_b_bI_vct, p_a_compare_vct) << curve_name;
+      }
+      ASSERT_EQ(p_a_compare_vct.size(), hash_inputs.size());
+      EXPECT_EQ(p_a_compare_vct[0].size(), LENGTH_12);
+      EXPECT_NE(p_a_compare_vct[0], p_a_compare_vct[1]);
+    }
+  }
+}
+
+/// Feature: ECDH operations of PSI.
+/// Description: Measure the throughput of hash to curve and mul, decompress and mul, and decompress and inverse mul
+/// on 20K items with one thread.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: The throughput of each is printed as items per second.
+TEST_F(TestECC, DISABLED_Benchmark) {
+  const size_t item_num = 20000;
+  auto hash_inputs = HashedInputs(item_num);
+  ECC ecc("p256", 1, 1);
+  auto start = std::chrono::steady_clock::now();
+  auto p_vct = ecc.HashToCurveAndMul(hash_inputs, LENGTH_32, LENGTH_32);
+  auto hash_to_curve_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  auto p_k_vct = ecc.DcpsAndMul(p_vct, LENGTH_32, LENGTH_32);
+  auto mul_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  start = std::chrono::steady_clock::now();
+  auto p_k_kI_vct = ecc.DcpsAndInverseMul(p_k_vct, LENGTH_32, LENGTH_32);
+  auto inverse_mul_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(p_k_kI_vct, p_vct);
+  std::cout << "hash to curve and mul: " << item_num / hash_to_curve_cost
+            << " /s, decompress and mul: " << item_num / mul_cost
+            << " /s, decompress and inverse mul: " << item_num / inverse_mul_cost << " /s" << std::endl;
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <iostream>
 #include <memory>
 #include <random>
 #include "gtest/gtest.h"
@@ -107,6 +109,38 @@ TEST_F(TestFindDelWrong, PSI_FindDelWrong) {
   EXPECT_EQ(align_result, true_align_result);
 }
 
+/// Feature: Delete false positives in PSI align result.
+/// Description: Delete repeated wrong ids and an id that is not in the align result.
+/// Expectation: Each wrong id deletes its first occurrence and the order of the rest is kept.
+TEST_F(TestFindDelWrong, PSI_DelWrongRepeated) {
+  std::vector<std::string> align_results = {"a", "b", "c", "b", "d", "b", "e"};
+  DelWrong(&align_results, {"b", "e", "b", "x"});
+  std::vector<std::string> expect_results = {"a", "c", "d", "b"};
+  EXPECT_EQ(align_results, expect_results);
+  DelWrong(&align_results, {});
+  EXPECT_EQ(align_results, expect_results);
+}
+
+/// Feature: Find and delete false positives in PSI align result.
+/// Description: Find and delete 10K and 100K false positives in 1M align result.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: Get truly align result in Bob's side, the time cost of DelWrong is printed.
+TEST_F(TestFindDelWrong, DISABLED_PSI_FindDelWrongLarge) {
+  const std::vector<size_t> wrong_nums = {10000, 100000};
+  for (auto wrong_num : wrong_nums) {
+    size_t intersect_num = 1000000 - wrong_num;
+    GenData(intersect_num * 2, intersect_num, wrong_num);
+    FindWrong(psi_ctx_alice, align_result, &wrong_vct, &fix_vct);
+    ASSERT_EQ(wrong_vct, true_wrong_vct);
+    auto start = std::chrono::steady_clock::now();
+    DelWrong(&align_result, wrong_vct);
+    auto cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(align_result, true_align_result);
+    std::cout << "align result: " << intersect_num + wrong_num << ", wrong: " << wrong_num
+              << ", DelWrong time cost: " << cost << " s" << std::endl;
+  }
+}
+
 }  // namespace psi
 }  // namespace fl
 }  // namespace mindspore
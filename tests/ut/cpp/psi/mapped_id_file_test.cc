@@ -0,0 +1,95 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/util/io_util.h"
+
+namespace mindspore {
+namespace fl {
+namespace psi {
+class TestMappedIdFile : public testing::Test {
+ public:
+  static constexpr char kFilePath[] = "mapped_id_file_test.csv";
+
+  void TearDown() override { (void)std::remove(kFilePath); }
+
+  static void WriteRaw(const std::string &content) {
+    std::ofstream out_file(kFilePath, std::ios::binary);
+    out_file << content;
+  }
+};
+
+/// Feature: Read the ids of a bin from a memory mapped input file for streaming PSI.
+/// Description: Read every bin of a file of 10K ids opened with 1 and 7 bins.
+/// Expectation: Each id is in exactly one bin, the bin of each id is BinOf the id, and the ids of a bin keep the order
+/// of the file.
+TEST_F(TestMappedIdFile, ReadBin) {
+  std::vector<std::string> ids;
+  for (size_t i = 0; i < 10000; i++) {
+    ids.push_back("id_" + std::to_string(i * 7919));
+  }
+  WriteFile(kFilePath, ids);
+  MappedIdFile input_file;
+  ASSERT_TRUE(input_file.Open(kFilePath, 1));
+  EXPECT_EQ(input_file.ReadBin(0), ids);
+  const size_t bin_num = 7;
+  ASSERT_TRUE(input_file.Open(kFilePath, bin_num));
+  EXPECT_EQ(input_file.bin_num(), bin_num);
+  for (size_t bin_id = 0; bin_id < bin_num; bin_id++) {
+    std::vector<std::string> expect;
+    for (const auto &id : ids) {
+      if (MappedIdFile::BinOf(id.data(), id.size(), bin_num) == bin_id) {
+        expect.push_back(id);
+      }
+    }
+    EXPECT_FALSE(expect.empty());
+    EXPECT_EQ(input_file.ReadBin(bin_id), expect) << "bin " << bin_id;
+  }
+  EXPECT_TRUE(input_file.ReadBin(bin_num).empty());
+}
+
+/// Feature: Read the ids of a bin from a memory mapped input file for streaming PSI.
+/// Description: Read files with CRLF line breaks, blank lines, no last line break, an empty file, a missing file, and
+/// open a file with 0 bins.
+/// Expectation: '\r' is stripped and blank lines are skipped, the empty file has no ids, the missing file and 0 bins
+/// fail to open.
+TEST_F(TestMappedIdFile, Lines) {
+  MappedIdFile input_file;
+  WriteRaw("a\r\n\n\r\nb\nc");
+  ASSERT_TRUE(input_file.Open(kFilePath, 1));
+  EXPECT_EQ(input_file.ReadBin(0), std::vector<std::string>({"a", "b", "c"}));
+  WriteRaw("");
+  ASSERT_TRUE(input_file.Open(kFilePath, 1));
+  EXPECT_TRUE(input_file.ReadBin(0).empty());
+  EXPECT_FALSE(input_file.Open(kFilePath, 0));
+  EXPECT_FALSE(input_file.Open("mapped_id_file_test_missing.csv", 1));
+}
+
+/// Feature: Partition ids into bins for streaming PSI.
+/// Description: Compute the bin of known ids.
+/// Expectation: The bin is the 64 bits FNV-1a hash of the id modulo the bin num, the same on every host.
+TEST_F(TestMappedIdFile, BinOf) {
+  EXPECT_EQ(MappedIdFile::BinOf("", 0, 1000), 0xCBF29CE484222325ULL % 1000);
+  EXPECT_EQ(MappedIdFile::BinOf("a", 1, 1000), 0xAF63DC4C8601EC8CULL % 1000);
+  EXPECT_EQ(MappedIdFile::BinOf("a", 1, 1), 0);
+}
+}  // namespace psi
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,214 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/secure_protocol/encrypt.h"
+#include "armour/secure_protocol/masking.h"
+
+namespace mindspore {
+namespace fl {
+namespace armour {
+class TestMasking : public testing::Test {
+ public:
+  // More than two chunks of the key stream generated by one EVP call.
+  static constexpr size_t kNoiseLen = 10000;
+
+  // The mask computed as before it was generated in chunks: AESEncrypt of the zeros of the whole mask.
+  static std::vector<float> ExpectMasking(size_t noise_len, const std::vector<uint8_t> &secret,
+                                          const std::vector<uint8_t> &ivec) {
+    int size = static_cast<int>(noise_len * sizeof(int32_t));
+    std::vector<uint8_t> data(size, 0);
+    std::vector<uint8_t> encrypt_data(size, 0);
+    int encrypt_len = 0;
+    AESEncrypt encrypt(secret.data(), static_cast<int>(secret.size()), ivec.data(), AES_IV_SIZE, AES_CTR);
+    EXPECT_EQ(encrypt.EncryptData(data.data(), size, encrypt_data.data(), &encrypt_len), 0);
+    EXPECT_EQ(encrypt_len, size);
+    std::vector<float> noise;
+    for (size_t i = 0; i < noise_len; i++) {
+      auto value = *(reinterpret_cast<int32_t *>(encrypt_data.data()) + i);
+      noise.push_back(static_cast<float>(value) / INT32_MAX);
+    }
+    return noise;
+  }
+
+  static std::vector<uint8_t> RandomBytes(size_t size, std::mt19937 *gen) {
+    std::vector<uint8_t> bytes(size);
+    for (auto &byte : bytes) {
+      byte = static_cast<uint8_t>((*gen)());
+    }
+    return bytes;
+  }
+};
+
+/// Feature: Masks of secure aggregation generated chunk by chunk by AES-CTR.
+/// Description: Generate masks of 16 and 32 bytes keys by the vector overload of GetMasking, and at unaligned offsets
+/// by the pointer overload.
+/// Expectation: The masks are the same as the ones of AESEncrypt of the whole mask.
+TEST_F(TestMasking, GetMasking) {
+  std::mt19937 gen(1);
+  for (size_t key_len : {KEY_LENGTH_16, KEY_LENGTH_32}) {
+    auto secret = RandomBytes(key_len, &gen);
+    auto ivec = RandomBytes(AES_IV_SIZE, &gen);
+    auto expect = ExpectMasking(kNoiseLen, secret, ivec);
+
+    std::vector<float> noise;
+    ASSERT_EQ(Masking::GetMasking(&noise, kNoiseLen, secret.data(), key_len, ivec.data(), AES_IV_SIZE), 0);
+    EXPECT_EQ(noise, expect) << "key length " << key_len;
+
+    for (size_t offset : {1, 3, 5, 4095, 4097, 9999}) {
+      size_t len = std::min<size_t>(4099, kNoiseLen - offset);
+      std::vector<float> stripe(len);
+      ASSERT_EQ(Masking::GetMasking(stripe.data(), offset, len, secret.data(), key_len, ivec.data(), AES_IV_SIZE), 0);
+      EXPECT_EQ(stripe, std::vector<float>(expect.begin() + offset, expect.begin() + offset + len))
+        << "key length " << key_len << ", offset " << offset;
+    }
+  }
+}
+
+/// Feature: Masks of secure aggregation generated chunk by chunk by AES-CTR.
+/// Description: Generate a mask stripe by stripe, with stripes of unaligned sizes, by GetMasking and by
+/// AccumulateMasking.
+/// Expectation: The stripes make up the mask of AESEncrypt, and AccumulateMasking adds the scaled mask.
+TEST_F(TestMasking, Stripes) {
+  std::mt19937 gen(2);
+  auto secret = RandomBytes(KEY_LENGTH_32, &gen);
+  auto ivec = RandomBytes(AES_IV_SIZE, &gen);
+  auto expect = ExpectMasking(kNoiseLen, secret, ivec);
+  const float scale = -2.0f;
+  std::vector<float> noise(kNoiseLen);
+  std::vector<float> accumulated(kNoiseLen, 1.0f);
+  for (size_t offset = 0, stripe = 1; offset < kNoiseLen; offset += stripe, stripe = stripe * 3 + 1) {
+    stripe = std::min(stripe, kNoiseLen - offset);
+    ASSERT_EQ(Masking::GetMasking(noise.data() + offset, offset, stripe, secret.data(), KEY_LENGTH_32, ivec.data(),
+                                  AES_IV_SIZE),
+              0);
+    ASSERT_EQ(Masking::AccumulateMasking(accumulated.data() + offset, offset, stripe, scale, secret.data(),
+                                         KEY_LENGTH_32, ivec.data(), AES_IV_SIZE),
+              0);
+  }
+  EXPECT_EQ(noise, expect);
+  for (size_t i = 0; i < kNoiseLen; i++) {
+    EXPECT_FLOAT_EQ(accumulated[i], 1.0f + scale * expect[i]) << "index " << i;
+  }
+}
+
+/// Feature: Masks of secure aggregation generated chunk by chunk by AES-CTR.
+/// Description: Generate masks whose counter carries past the lower 64 bits and wraps around 128 bits, from offsets
+/// before and after the carry.
+/// Expectation: The masks are the same as the ones of AESEncrypt, which increments the 128 bits counter.
+TEST_F(TestMasking, CounterCarry) {
+  std::mt19937 gen(3);
+  auto secret = RandomBytes(KEY_LENGTH_16, &gen);
+  std::vector<uint8_t> carry_64(AES_IV_SIZE, 0xFF);
+  carry_64[0] = 0x12;
+  carry_64[7] = 0x34;
+  carry_64[15] = 0xF0;
+  std::vector<uint8_t> carry_128(AES_IV_SIZE, 0xFF);
+  carry_128[15] = 0xFE;
+  for (auto &ivec : {carry_64, carry_128}) {
+    auto expect = ExpectMasking(kNoiseLen, secret, ivec);
+    for (size_t offset : {0, 7, 63, 64, 65, 9000}) {
+      size_t len = kNoiseLen - offset;
+      std::vector<float> stripe(len);
+      ASSERT_EQ(Masking::GetMasking(stripe.data(), offset, len, secret.data(), KEY_LENGTH_16, ivec.data(),
+                                    AES_IV_SIZE),
+                0);
+      EXPECT_EQ(stripe, std::vector<float>(expect.begin() + offset, expect.end())) << "offset " << offset;
+    }
+  }
+}
+
+/// Feature: Sum of the masks of secure aggregation, generated stripe by stripe by several threads.
+/// Description: Sum the scaled masks of 16 and 32 bytes keys by 1 and 8 threads, with stripes which divide the noise,
+/// which don't, and which are longer than the noise, and with more threads than masks.
+/// Expectation: The sum is the same as the one of the whole masks added one after another.
+TEST_F(TestMasking, SumMaskings) {
+  std::mt19937 gen(4);
+  const size_t task_num = 5;
+  std::vector<Masking::MaskingTask> tasks(task_num);
+  std::vector<float> expect(kNoiseLen, 0.0f);
+  for (size_t i = 0; i < task_num; i++) {
+    tasks[i].secret = RandomBytes(i % 2 == 0 ? KEY_LENGTH_16 : KEY_LENGTH_32, &gen);
+    tasks[i].ivec = RandomBytes(AES_IV_SIZE, &gen);
+    tasks[i].scale = i % 3 == 0 ? -1.0f : 1.0f;
+    auto mask = ExpectMasking(kNoiseLen, tasks[i].secret, tasks[i].ivec);
+    for (size_t j = 0; j < kNoiseLen; j++) {
+      expect[j] += tasks[i].scale * mask[j];
+    }
+  }
+  auto get_task = [&tasks](size_t index, Masking::MaskingTask *task) {
+    *task = tasks[index];
+    return true;
+  };
+  for (size_t thread_num : {1, 8}) {
+    for (size_t stripe_size : {static_cast<size_t>(1000), static_cast<size_t>(4099), kNoiseLen, kNoiseLen + 1}) {
+      std::vector<float> sum(kNoiseLen, 0.0f);
+      ASSERT_EQ(Masking::SumMaskings(sum.data(), kNoiseLen, task_num, get_task, thread_num, stripe_size), 0);
+      for (size_t i = 0; i < kNoiseLen; i++) {
+        // The masks are added in another order, each of them is in [-1, 1].
+        ASSERT_NEAR(sum[i], expect[i], 1e-5f)
+          << "thread num " << thread_num << ", stripe size " << stripe_size << ", index " << i;
+      }
+    }
+  }
+  std::vector<float> sum(kNoiseLen, 0.0f);
+  ASSERT_EQ(Masking::SumMaskings(sum.data(), kNoiseLen, 0, get_task, 8, 1000), 0);
+  EXPECT_EQ(sum, std::vector<float>(kNoiseLen, 0.0f));
+}
+
+/// Feature: Sum of the masks of secure aggregation, generated stripe by stripe by several threads.
+/// Description: Sum masks with valid keys, with one of the keys invalid, when getting the tasks fails, with stripes of
+/// size 0 and with no sum.
+/// Expectation: SumMaskings succeeds with the valid keys and fails otherwise.
+TEST_F(TestMasking, SumMaskingsInvalidInput) {
+  std::vector<float> sum(kNoiseLen, 0.0f);
+  // The key of the task 3 is invalid.
+  auto get_task = [](size_t index, Masking::MaskingTask *task) {
+    task->secret.assign(index == 3 ? 24 : KEY_LENGTH_32, 1);
+    task->ivec.assign(AES_IV_SIZE, 2);
+    return true;
+  };
+  auto get_task_failed = [](size_t, Masking::MaskingTask *) { return false; };
+  EXPECT_EQ(Masking::SumMaskings(sum.data(), kNoiseLen, 3, get_task, 2, 1000), 0);
+  EXPECT_NE(Masking::SumMaskings(sum.data(), kNoiseLen, 4, get_task, 2, 1000), 0);
+  EXPECT_NE(Masking::SumMaskings(sum.data(), kNoiseLen, 3, get_task_failed, 2, 1000), 0);
+  EXPECT_NE(Masking::SumMaskings(sum.data(), kNoiseLen, 3, get_task, 2, 0), 0);
+  EXPECT_NE(Masking::SumMaskings(nullptr, kNoiseLen, 3, get_task, 2, 1000), 0);
+}
+
+/// Feature: Masks of secure aggregation generated chunk by chunk by AES-CTR.
+/// Description: Generate masks with a key of invalid length, a null key and an invalid ivec.
+/// Expectation: GetMasking and AccumulateMasking fail, and the vector overload keeps the noise unchanged.
+TEST_F(TestMasking, InvalidInput) {
+  std::vector<uint8_t> secret(KEY_LENGTH_32, 1);
+  std::vector<uint8_t> ivec(AES_IV_SIZE, 2);
+  std::vector<float> noise = {1.0f};
+  EXPECT_NE(Masking::GetMasking(&noise, 10, secret.data(), 24, ivec.data(), AES_IV_SIZE), 0);
+  EXPECT_NE(Masking::GetMasking(&noise, 10, nullptr, KEY_LENGTH_32, ivec.data(), AES_IV_SIZE), 0);
+  EXPECT_NE(Masking::GetMasking(&noise, 10, secret.data(), KEY_LENGTH_32, ivec.data(), 12), 0);
+  EXPECT_EQ(noise, std::vector<float>{1.0f});
+  EXPECT_NE(Masking::AccumulateMasking(noise.data(), 0, 1, 1.0f, secret.data(), KEY_LENGTH_32, nullptr, AES_IV_SIZE),
+            0);
+  EXPECT_EQ(noise, std::vector<float>{1.0f});
+}
+}  // namespace armour
+}  // namespace fl
+}  // namespace mindspore
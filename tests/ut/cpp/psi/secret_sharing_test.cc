@@ -0,0 +1,202 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/secure_protocol/secret_sharing.h"
+
+namespace mindspore {
+namespace fl {
+namespace armour {
+class TestSecretSharing : public testing::Test {
+ public:
+  static constexpr size_t kSecretLen = 32;
+
+  void SetUp() override {
+    prime_ = BN_new();
+    ASSERT_EQ(GetPrime(prime_), 0);
+    ctx_ = BN_CTX_new();
+  }
+
+  void TearDown() override {
+    BN_free(prime_);
+    BN_CTX_free(ctx_);
+  }
+
+  // Shares of a random secret at x = 1, ..., n by a random polynomial of degree k - 1.
+  std::vector<std::vector<uint8_t>> Split(size_t n, size_t k, std::mt19937_64 *gen, std::vector<uint8_t> *secret) {
+    std::vector<BIGNUM *> coefficients(k);
+    for (size_t i = 0; i < k; i++) {
+      std::vector<uint8_t> bytes(kSecretLen);
+      for (auto &byte : bytes) {
+        byte = static_cast<uint8_t>((*gen)());
+      }
+      bytes[0] |= 1;  // no leading zero, so the secret keeps its size through BN_bn2bin
+      coefficients[i] = BN_bin2bn(bytes.data(), bytes.size(), nullptr);
+      if (i == 0) {
+        *secret = bytes;
+      }
+    }
+    std::vector<std::vector<uint8_t>> shares(n);
+    BIGNUM *y = BN_new();
+    BIGNUM *x = BN_new();
+    for (size_t index = 1; index <= n; index++) {
+      // Horner's method
+      BN_zero(y);
+      (void)BN_set_word(x, index);
+      for (size_t i = k; i > 0; i--) {
+        (void)BN_mod_mul(y, y, x, prime_, ctx_);
+        (void)BN_mod_add(y, y, coefficients[i - 1], prime_, ctx_);
+      }
+      shares[index - 1].resize(BN_num_bytes(y));
+      (void)BN_bn2bin(y, shares[index - 1].data());
+    }
+    BN_free(x);
+    BN_free(y);
+    for (auto coefficient : coefficients) {
+      BN_free(coefficient);
+    }
+    return shares;
+  }
+
+  // The shares of each client, taken by the indices in random order.
+  std::vector<std::vector<ShareView>> ShareGroups(const std::vector<std::vector<std::vector<uint8_t>>> &shares_list,
+                                                  std::vector<unsigned int> indices, std::mt19937_64 *gen) {
+    std::vector<std::vector<ShareView>> share_groups;
+    for (auto &shares : shares_list) {
+      std::shuffle(indices.begin(), indices.end(), *gen);
+      std::vector<ShareView> group;
+      for (auto index : indices) {
+        group.push_back({index, shares[index - 1].data(), shares[index - 1].size()});
+      }
+      share_groups.push_back(group);
+    }
+    return share_groups;
+  }
+
+  BIGNUM *prime_ = nullptr;
+  BN_CTX *ctx_ = nullptr;
+};
+
+/// Feature: Batched Lagrange interpolation for secret reconstruction.
+/// Description: Reconstruct the secrets of 100 clients from 3 of 5 shares, with two index sets and shares in random
+/// order, by BatchCombine and by Combine.
+/// Expectation: Both return the original secrets.
+TEST_F(TestSecretSharing, BatchCombine) {
+  std::mt19937_64 gen(1);
+  const size_t n = 5;
+  const size_t k = 3;
+  std::vector<std::vector<uint8_t>> secrets(100);
+  std::vector<std::vector<std::vector<uint8_t>>> shares_list;
+  for (auto &secret : secrets) {
+    shares_list.push_back(Split(n, k, &gen, &secret));
+  }
+  SecretSharing secret_sharing(prime_);
+  for (auto &indices : std::vector<std::vector<unsigned int>>{{1, 2, 3, 4, 5}, {5, 2, 4}}) {
+    auto share_groups = ShareGroups(shares_list, indices, &gen);
+    std::vector<std::vector<uint8_t>> batch_secrets;
+    ASSERT_EQ(secret_sharing.BatchCombine(k, share_groups, &batch_secrets), 0);
+    EXPECT_EQ(batch_secrets, secrets);
+
+    auto &group = share_groups[0];
+    std::vector<Share> shares(k);
+    std::vector<Share *> share_ptrs;
+    for (size_t i = 0; i < k; i++) {
+      shares[i].index = group[i].index;
+      shares[i].len = group[i].len;
+      shares[i].data = static_cast<unsigned char *>(malloc(group[i].len));
+      std::copy(group[i].data, group[i].data + group[i].len, shares[i].data);
+      share_ptrs.push_back(&shares[i]);
+    }
+    std::vector<uint8_t> secret(kSecretLen + 1);
+    size_t length = 0;
+    ASSERT_EQ(secret_sharing.Combine(k, share_ptrs, secret.data(), &length), 0);
+    secret.resize(length);
+    EXPECT_EQ(secret, secrets[0]);
+  }
+}
+
+/// Feature: Batched Lagrange interpolation for secret reconstruction.
+/// Description: Reconstruct from too few shares, and from shares with a duplicate index.
+/// Expectation: BatchCombine fails.
+TEST_F(TestSecretSharing, BatchCombineInvalidShares) {
+  std::mt19937_64 gen(2);
+  std::vector<uint8_t> secret;
+  std::vector<std::vector<std::vector<uint8_t>>> shares_list = {Split(3, 2, &gen, &secret)};
+  SecretSharing secret_sharing(prime_);
+  std::vector<std::vector<uint8_t>> secrets;
+  EXPECT_NE(secret_sharing.BatchCombine(3, ShareGroups(shares_list, {1, 2}, &gen), &secrets), 0);
+  EXPECT_NE(secret_sharing.BatchCombine(2, ShareGroups(shares_list, {2, 2}, &gen), &secrets), 0);
+  EXPECT_EQ(secret_sharing.BatchCombine(2, ShareGroups(shares_list, {3, 1}, &gen), &secrets), 0);
+  EXPECT_EQ(secrets, std::vector<std::vector<uint8_t>>{secret});
+}
+
+/// Feature: Batched Lagrange interpolation for secret reconstruction.
+/// Description: Reconstruct the secrets of 1000 and 5000 clients from 20 of 30 shares by Combine one by one and by
+/// BatchCombine.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: The time cost of each is printed.
+TEST_F(TestSecretSharing, DISABLED_Benchmark) {
+  std::mt19937_64 gen(3);
+  const size_t n = 30;
+  const size_t k = 20;
+  std::vector<unsigned int> indices(k);
+  for (size_t i = 0; i < k; i++) {
+    indices[i] = static_cast<unsigned int>(i + 1);
+  }
+  for (size_t client_num : {1000, 5000}) {
+    std::vector<std::vector<uint8_t>> secrets(client_num);
+    std::vector<std::vector<std::vector<uint8_t>>> shares_list;
+    for (auto &secret : secrets) {
+      shares_list.push_back(Split(n, k, &gen, &secret));
+    }
+    auto share_groups = ShareGroups(shares_list, indices, &gen);
+    SecretSharing secret_sharing(prime_);
+
+    std::vector<Share> shares(k);
+    std::vector<Share *> share_ptrs;
+    for (auto &share : shares) {
+      share.data = static_cast<unsigned char *>(malloc(kSecretLen + 1));
+      share_ptrs.push_back(&share);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < client_num; i++) {
+      for (size_t j = 0; j < k; j++) {
+        shares[j].index = share_groups[i][j].index;
+        shares[j].len = share_groups[i][j].len;
+        std::copy(share_groups[i][j].data, share_groups[i][j].data + share_groups[i][j].len, shares[j].data);
+      }
+      uint8_t secret[kSecretLen + 1] = {0};
+      size_t length = 0;
+      ASSERT_EQ(secret_sharing.Combine(k, share_ptrs, secret, &length), 0);
+    }
+    auto combine_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    std::vector<std::vector<uint8_t>> batch_secrets;
+    ASSERT_EQ(secret_sharing.BatchCombine(k, share_groups, &batch_secrets), 0);
+    auto batch_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(batch_secrets, secrets);
+    std::cout << client_num << " clients, " << k << " of " << n << " shares, combine one by one: " << combine_cost
+              << " s, batch combine: " << batch_cost << " s" << std::endl;
+  }
+}
+}  // namespace armour
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "armour/cipher/unmask_segment.h"
+
+namespace mindspore {
+namespace fl {
+namespace armour {
+class TestUnmaskSegment : public testing::Test {
+ public:
+  static std::vector<std::vector<float>> CreateWeights(const std::vector<size_t> &sizes, std::mt19937 *gen) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<std::vector<float>> weights;
+    for (auto size : sizes) {
+      std::vector<float> weight(size);
+      for (auto &value : weight) {
+        value = dist(*gen);
+      }
+      weights.push_back(weight);
+    }
+    return weights;
+  }
+
+  // The unmask before the noises were read in chunks: every weight adds the noises at its offset divided by the data
+  // size, one element after another. The chunks multiply by the inverse of the data size, which rounds differently.
+  static void ExpectUnmask(const std::vector<float> &noise, size_t data_size,
+                           std::vector<std::vector<float>> *weights) {
+    size_t sum_size = 0;
+    for (auto &weight : *weights) {
+      for (size_t i = 0; i < weight.size(); ++i) {
+        weight[i] = weight[i] + noise[i + sum_size] / data_size;
+      }
+      sum_size += weight.size();
+    }
+  }
+};
+
+/// Feature: Unmask of the aggregated model of secure aggregation, chunk by chunk of the noises.
+/// Description: Add noises of 40 elements to weights of 40, 39 and 25 elements, which are smaller than the noises, in
+/// chunks of 1, 3, 7, 16, 40 and 64 elements in a random order, so chunk boundaries fall inside the weights and a
+/// chunk may be beyond all of them.
+/// Expectation: The weights are the ones of the scalar loop within rounding, and nothing is written beyond them.
+TEST_F(TestUnmaskSegment, AddNoisesToSegments) {
+  std::mt19937 gen(1);
+  const size_t noise_len = 40;
+  const size_t data_size = 7;
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> noise(noise_len);
+  for (auto &value : noise) {
+    value = dist(gen);
+  }
+  // Weights of 40, 39 and 25 elements in all, with an empty one.
+  for (auto &sizes : std::vector<std::vector<size_t>>{{5, 1, 0, 13, 8, 13}, {1, 7, 31}, {25}}) {
+    auto weights = CreateWeights(sizes, &gen);
+    auto expect = weights;
+    ExpectUnmask(noise, data_size, &expect);
+    for (size_t chunk_size : {1, 3, 7, 16, 40, 64}) {
+      auto unmasked = weights;
+      std::vector<UnmaskSegment> segments;
+      size_t sum_size = 0;
+      for (auto &weight : unmasked) {
+        segments.push_back({weight.data(), sum_size, weight.size()});
+        sum_size += weight.size();
+      }
+      std::vector<size_t> offsets;
+      for (size_t offset = 0; offset < noise_len; offset += chunk_size) {
+        offsets.push_back(offset);
+      }
+      std::shuffle(offsets.begin(), offsets.end(), gen);
+      for (auto offset : offsets) {
+        size_t size = std::min(chunk_size, noise_len - offset);
+        AddNoisesToSegments(segments, offset, noise.data() + offset, size, 1.0f / data_size);
+      }
+      for (size_t i = 0; i < unmasked.size(); i++) {
+        ASSERT_EQ(unmasked[i].size(), expect[i].size());
+        for (size_t j = 0; j < unmasked[i].size(); j++) {
+          EXPECT_NEAR(unmasked[i][j], expect[i][j], 1e-6f)
+            << "chunk size " << chunk_size << ", weight " << i << ", index " << j;
+        }
+      }
+    }
+  }
+}
+
+/// Feature: Unmask of the aggregated model of secure aggregation, chunk by chunk of the noises.
+/// Description: Add chunks of noises to a model without weights, and chunks beyond the model to a model.
+/// Expectation: Nothing is changed.
+TEST_F(TestUnmaskSegment, ChunkBeyondWeights) {
+  std::vector<float> noise(16, 1.0f);
+  AddNoisesToSegments({}, 0, noise.data(), noise.size(), 1.0f);
+  std::vector<float> weight(4, 0.5f);
+  std::vector<UnmaskSegment> segments = {{weight.data(), 0, weight.size()}};
+  AddNoisesToSegments(segments, 4, noise.data(), 12, 1.0f);
+  AddNoisesToSegments(segments, 10, noise.data(), 0, 1.0f);
+  EXPECT_EQ(weight, std::vector<float>(4, 0.5f));
+}
+}  // namespace armour
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,241 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "server/collective_ops_impl.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+// In-process network of the ranks. As AbstractNode, the messages from one node to another are received in the order
+// they are sent, and a received message whose meta is not the expected one fails the receiving.
+class FakeNetwork {
+ public:
+  void Send(const CollectiveMessageMeta &meta, const void *data, size_t size) {
+    auto bytes = reinterpret_cast<const uint8_t *>(data);
+    auto buffer = std::make_shared<std::vector<uint8_t>>(bytes, bytes + size);
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_[std::make_pair(meta.send_node(), meta.recv_node())].emplace_back(meta, buffer);
+    phases_.insert(meta.phase());
+    cond_.notify_all();
+  }
+
+  bool Recv(const CollectiveMessageMeta &expect_meta, size_t expect_size, VectorPtr *output, uint32_t timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto &queue = queues_[std::make_pair(expect_meta.send_node(), expect_meta.recv_node())];
+    if (!cond_.wait_for(lock, std::chrono::seconds(timeout), [&queue]() { return !queue.empty(); })) {
+      return false;
+    }
+    auto message = std::move(queue.front());
+    queue.pop_front();
+    auto &meta = message.first;
+    if (meta.iteration() != expect_meta.iteration() || meta.weight_name() != expect_meta.weight_name() ||
+        meta.phase() != expect_meta.phase() || meta.chunk_index() != expect_meta.chunk_index() ||
+        meta.for_index() != expect_meta.for_index()) {
+      return false;
+    }
+    *output = message.second;
+    return (*output)->size() == expect_size;
+  }
+
+  std::set<std::string> phases() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phases_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::map<std::pair<std::string, std::string>, std::deque<std::pair<CollectiveMessageMeta, VectorPtr>>> queues_;
+  std::set<std::string> phases_;
+};
+
+class FakeCommunicator : public CollectiveCommunicator {
+ public:
+  FakeCommunicator(const std::string &node_id, const std::shared_ptr<FakeNetwork> &network)
+      : node_id_(node_id), network_(network) {}
+  ~FakeCommunicator() override = default;
+
+  std::string node_id() const override { return node_id_; }
+  std::shared_ptr<ResponseTrack> CollectiveSendAsync(const std::string &, const CollectiveMessageMeta &collective_meta,
+                                                     const void *data, size_t size) override {
+    network_->Send(collective_meta, data, size);
+    return std::make_shared<ResponseTrack>(nullptr, ++request_id_, 1, nullptr);
+  }
+  bool CollectiveRecvWait(const CollectiveMessageMeta &expect_meta, size_t expect_size, VectorPtr *output,
+                          const uint32_t &timeout) override {
+    return network_->Recv(expect_meta, expect_size, output, timeout);
+  }
+  bool Wait(const std::shared_ptr<ResponseTrack> &request_track, const uint32_t &) override {
+    return request_track != nullptr;
+  }
+
+ private:
+  std::string node_id_;
+  std::shared_ptr<FakeNetwork> network_;
+  uint64_t request_id_ = 0;
+};
+
+class TestCollectiveOpsImpl : public testing::Test {
+ public:
+  void TearDown() override { SetAlgorithm(kAllReduceAuto); }
+
+  static void SetAlgorithm(const std::string &algorithm) {
+    auto config = FLContext::instance()->aggregation_config();
+    config.allreduce_algorithm = algorithm;
+    FLContext::instance()->set_aggregation_config(config);
+  }
+
+  // Allreduces the data of rank_size ranks on one thread per rank, and checks the result of every rank against the
+  // sum computed one element after another. The data are small integers, so the sum is exact in any order.
+  template <typename T>
+  static void CheckAllReduce(const std::string &algorithm, size_t rank_size, size_t count,
+                             std::set<std::string> *phases = nullptr) {
+    SetAlgorithm(algorithm);
+    auto network = std::make_shared<FakeNetwork>();
+    std::map<std::string, std::string> server_map;
+    for (size_t rank = 0; rank < rank_size; rank++) {
+      server_map["server_" + std::to_string(rank)] = "127.0.0.1:" + std::to_string(6000 + rank);
+    }
+    std::vector<std::vector<T>> inputs(rank_size, std::vector<T>(count));
+    std::vector<T> expect(count, 0);
+    for (size_t rank = 0; rank < rank_size; rank++) {
+      for (size_t i = 0; i < count; i++) {
+        inputs[rank][i] = static_cast<T>((rank * 7 + i) % 13);
+        expect[i] += inputs[rank][i];
+      }
+    }
+    std::vector<std::vector<T>> outputs(rank_size, std::vector<T>(count, 0));
+    std::vector<int> results(rank_size, 0);
+    std::vector<std::thread> threads;
+    for (size_t rank = 0; rank < rank_size; rank++) {
+      threads.emplace_back([&, rank]() {
+        CollectiveOpsImpl collective_ops;
+        collective_ops.Initialize(std::make_shared<FakeCommunicator>("server_" + std::to_string(rank), network));
+        // Odd ranks reduce in place.
+        void *recvbuff = rank % 2 == 0 ? static_cast<void *>(outputs[rank].data()) : inputs[rank].data();
+        results[rank] = collective_ops.AllReduce<T>("weight", inputs[rank].data(), recvbuff, count, server_map);
+        if (rank % 2 != 0) {
+          outputs[rank] = inputs[rank];
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (size_t rank = 0; rank < rank_size; rank++) {
+      std::string message = algorithm + ", rank size " + std::to_string(rank_size) + ", count " +
+                            std::to_string(count) + ", rank " + std::to_string(rank);
+      ASSERT_TRUE(results[rank]) << message;
+      EXPECT_EQ(outputs[rank], expect) << message;
+    }
+    if (phases != nullptr) {
+      *phases = network->phases();
+    }
+  }
+};
+
+/// Feature: AllReduce algorithms of the server collective communication.
+/// Description: Allreduce float data with each algorithm, for power of two and other rank sizes, and for counts which
+/// are smaller than the rank size or not divisible by it.
+/// Expectation: Every rank gets the sum of the data of all ranks.
+TEST_F(TestCollectiveOpsImpl, AllReduceAlgorithms) {
+  for (auto algorithm : {kAllReduceRing, kAllReduceReduceBroadcast, kAllReduceHalvingDoubling, kAllReduceTree}) {
+    for (size_t rank_size : {2, 3, 4, 5, 6, 7, 8}) {
+      for (size_t count : {1, 5, 13, 1001}) {
+        CheckAllReduce<float>(algorithm, rank_size, count);
+      }
+    }
+  }
+}
+
+/// Feature: AllReduce algorithms of the server collective communication.
+/// Description: Allreduce int and size_t data, whose sum is not vectorized, with each algorithm.
+/// Expectation: Every rank gets the sum of the data of all ranks.
+TEST_F(TestCollectiveOpsImpl, AllReduceIntegers) {
+  for (auto algorithm : {kAllReduceRing, kAllReduceReduceBroadcast, kAllReduceHalvingDoubling, kAllReduceTree}) {
+    CheckAllReduce<int>(algorithm, 5, 103);
+    CheckAllReduce<size_t>(algorithm, 6, 103);
+  }
+}
+
+/// Feature: Ring AllReduce, which pipelines the chunks in segments of 1MB.
+/// Description: Allreduce chunks of several segments with a count not divisible by the rank size, which makes the
+/// chunks and segments of different sizes.
+/// Expectation: Every rank gets the sum of the data of all ranks.
+TEST_F(TestCollectiveOpsImpl, RingAllReduceSegments) {
+  std::set<std::string> phases;
+  CheckAllReduce<float>(kAllReduceRing, 3, 3 * 700000 + 2, &phases);
+  EXPECT_EQ(phases, (std::set<std::string>{"ring", "gather"}));
+}
+
+/// Feature: Selection of the AllReduce algorithm.
+/// Description: Allreduce with the AUTO algorithm a small message, and large messages with 6 and 8 ranks.
+/// Expectation: The tree, the ring and halving doubling run respectively and every rank gets the sum.
+TEST_F(TestCollectiveOpsImpl, AllReduceAuto) {
+  std::set<std::string> phases;
+  CheckAllReduce<float>(kAllReduceAuto, 6, 100, &phases);
+  EXPECT_EQ(phases, (std::set<std::string>{"reduce", "broadcast"}));
+  size_t large_count = kTreeAllReduceMaxSize / sizeof(float) + 3;
+  CheckAllReduce<float>(kAllReduceAuto, 6, large_count, &phases);
+  EXPECT_EQ(phases, (std::set<std::string>{"ring", "gather"}));
+  CheckAllReduce<float>(kAllReduceAuto, 8, large_count, &phases);
+  EXPECT_EQ(phases, (std::set<std::string>{"halving", "doubling"}));
+}
+
+/// Feature: Selection of the AllReduce algorithm.
+/// Description: Select the algorithm for configured algorithms, and for AUTO with different message sizes, counts
+/// and rank sizes.
+/// Expectation: The configured algorithm is used unless the ring has less elements than ranks, AUTO picks the tree for
+/// small messages, the ring for up to 8 ranks which are not a power of two and halving doubling otherwise.
+TEST_F(TestCollectiveOpsImpl, SelectAllReduceAlgorithm) {
+  const size_t large_size = kTreeAllReduceMaxSize + sizeof(float);
+  const size_t large_count = large_size / sizeof(float);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceRing, 4, 4, 16), AllReduceAlgorithm::kRing);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceRing, 4, 3, 12), AllReduceAlgorithm::kTree);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceReduceBroadcast, 4, large_count, large_size),
+            AllReduceAlgorithm::kReduceBroadcast);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceHalvingDoubling, 3, 1, 4),
+            AllReduceAlgorithm::kHalvingDoubling);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceTree, 4, large_count, large_size),
+            AllReduceAlgorithm::kTree);
+
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceAuto, 6, kTreeAllReduceMaxSize / sizeof(float),
+                                                        kTreeAllReduceMaxSize),
+            AllReduceAlgorithm::kTree);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceAuto, 100, 20, large_size),
+            AllReduceAlgorithm::kTree);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceAuto, 6, large_count, large_size),
+            AllReduceAlgorithm::kRing);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceAuto, 8, large_count, large_size),
+            AllReduceAlgorithm::kHalvingDoubling);
+  EXPECT_EQ(CollectiveOpsImpl::SelectAllReduceAlgorithm(kAllReduceAuto, 12, large_count, large_size),
+            AllReduceAlgorithm::kHalvingDoubling);
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,187 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "server/model_checkpoint.h"
+
+namespace mindspore {
+namespace fl {
+namespace server {
+class TestModelCheckpoint : public testing::Test {
+ public:
+  static constexpr char kFilePath[] = "model_checkpoint_test.flckpt";
+
+  void TearDown() override { (void)std::remove(kFilePath); }
+
+  // Weights "a" and "c" require aggregation and are laid out back to back in weight_data, "b" does not.
+  static ModelItem CreateModel(std::vector<InputWeight> *weights) {
+    std::vector<std::pair<std::string, std::vector<size_t>>> shapes = {{"a", {2, 5}}, {"b", {3}}, {"c", {7}}};
+    ModelItem model;
+    for (auto &shape : shapes) {
+      auto &item = model.weight_items[shape.first];
+      item.name = shape.first;
+      item.shape = shape.second;
+      item.type = "fp32";
+      item.size = sizeof(float);
+      for (auto dim : shape.second) {
+        item.size *= dim;
+      }
+      item.require_aggr = shape.first != "b";
+      if (item.require_aggr) {
+        item.offset = model.weight_data.size();
+        model.weight_data.resize(item.offset + item.size);
+      } else {
+        model.shared_weights[item.name] = std::make_shared<WeightBuffer>(item.size);
+      }
+      model.model_size += item.size;
+      auto data = reinterpret_cast<float *>(model.weight_addr(item));
+      for (size_t i = 0; i < item.size / sizeof(float); i++) {
+        data[i] = static_cast<float>(i) + 0.5f * static_cast<float>(shape.first[0]);
+      }
+      InputWeight weight;
+      weight.name = item.name;
+      weight.shape = item.shape;
+      weight.type = item.type;
+      weight.size = item.size;
+      weight.require_aggr = item.require_aggr;
+      weights->push_back(weight);
+    }
+    // weight_data is complete, the addresses of its weights are valid from now on.
+    for (auto &weight : *weights) {
+      weight.data = model.weight_addr(model.weight_items[weight.name]);
+    }
+    return model;
+  }
+};
+
+/// Feature: Server model checkpoint, which is mapped and used in place on restarting.
+/// Description: Save a model of 3 weights, 2 of which require aggregation, then open the file.
+/// Expectation: The iteration, names, shapes, types and data are the same as saved, the weights which require
+/// aggregation are back to back in the mapping, and the mapping outlives the checkpoint object by data_owner.
+TEST_F(TestModelCheckpoint, SaveAndOpen) {
+  std::vector<InputWeight> expect_weights;
+  auto model = CreateModel(&expect_weights);
+  ASSERT_TRUE(ModelCheckpoint::Save(kFilePath, 12, model));
+
+  std::vector<InputWeight> weights;
+  {
+    MappedCheckpoint checkpoint;
+    ASSERT_TRUE(checkpoint.Open(kFilePath));
+    EXPECT_EQ(checkpoint.iteration(), 12);
+    EXPECT_TRUE(checkpoint.Match(expect_weights));
+    weights = checkpoint.weights();
+  }
+  ASSERT_EQ(weights.size(), expect_weights.size());
+  for (size_t i = 0; i < weights.size(); i++) {
+    auto &weight = weights[i];
+    auto &expect = expect_weights[i];
+    EXPECT_EQ(weight.name, expect.name);
+    EXPECT_EQ(weight.shape, expect.shape);
+    EXPECT_EQ(weight.type, expect.type);
+    EXPECT_EQ(weight.require_aggr, expect.require_aggr);
+    ASSERT_EQ(weight.size, expect.size);
+    EXPECT_NE(weight.data_owner, nullptr);
+    auto data = reinterpret_cast<const uint8_t *>(weight.data);
+    auto expect_data = reinterpret_cast<const uint8_t *>(expect.data);
+    EXPECT_EQ(std::vector<uint8_t>(data, data + weight.size),
+              std::vector<uint8_t>(expect_data, expect_data + expect.size));
+  }
+  EXPECT_EQ(reinterpret_cast<const uint8_t *>(weights[0].data) + weights[0].size, weights[2].data);
+}
+
+/// Feature: Server model checkpoint, which is mapped and used in place on restarting.
+/// Description: Match the checkpoint against weights with a different size, require_aggr or number.
+/// Expectation: Match fails.
+TEST_F(TestModelCheckpoint, Mismatch) {
+  std::vector<InputWeight> expect_weights;
+  auto model = CreateModel(&expect_weights);
+  ASSERT_TRUE(ModelCheckpoint::Save(kFilePath, 1, model));
+  MappedCheckpoint checkpoint;
+  ASSERT_TRUE(checkpoint.Open(kFilePath));
+
+  auto weights = expect_weights;
+  weights[1].size += sizeof(float);
+  EXPECT_FALSE(checkpoint.Match(weights));
+  weights = expect_weights;
+  weights[2].require_aggr = false;
+  EXPECT_FALSE(checkpoint.Match(weights));
+  weights = expect_weights;
+  weights.pop_back();
+  EXPECT_FALSE(checkpoint.Match(weights));
+}
+
+/// Feature: Server model checkpoint, which is mapped and used in place on restarting.
+/// Description: Open a missing file, a truncated checkpoint and a checkpoint with a corrupted magic.
+/// Expectation: Open fails.
+TEST_F(TestModelCheckpoint, InvalidFile) {
+  MappedCheckpoint checkpoint;
+  EXPECT_FALSE(checkpoint.Open(kFilePath));
+  EXPECT_FALSE(checkpoint.Open(""));
+
+  std::vector<InputWeight> expect_weights;
+  auto model = CreateModel(&expect_weights);
+  ASSERT_TRUE(ModelCheckpoint::Save(kFilePath, 1, model));
+  std::string content;
+  {
+    std::ifstream in_file(kFilePath, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(in_file), std::istreambuf_iterator<char>());
+  }
+  ASSERT_FALSE(content.empty());
+  {
+    std::ofstream out_file(kFilePath, std::ios::binary | std::ios::trunc);
+    out_file << content.substr(0, content.size() - 1);
+  }
+  EXPECT_FALSE(checkpoint.Open(kFilePath));
+  content[0] = 'X';
+  {
+    std::ofstream out_file(kFilePath, std::ios::binary | std::ios::trunc);
+    out_file << content;
+  }
+  EXPECT_FALSE(checkpoint.Open(kFilePath));
+  EXPECT_TRUE(checkpoint.weights().empty());
+}
+
+/// Feature: Weight buffer of the model, which borrows the weights mapped from the checkpoint.
+/// Description: Borrow bytes kept alive by an owner, then copy and resize the buffer.
+/// Expectation: The borrowed buffer uses the bytes in place and holds the owner, a copy and a resized buffer own their
+/// bytes.
+TEST_F(TestModelCheckpoint, WeightBuffer) {
+  auto owner = std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>{1, 2, 3, 4});
+  WeightBuffer buffer(owner->data(), owner->size(), owner);
+  EXPECT_EQ(buffer.data(), owner->data());
+  EXPECT_EQ(buffer.size(), 4);
+  EXPECT_EQ(owner.use_count(), 2);
+
+  WeightBuffer copy = buffer;
+  EXPECT_NE(copy.data(), owner->data());
+  EXPECT_EQ(std::vector<uint8_t>(copy.data(), copy.data() + copy.size()), *owner);
+
+  buffer.resize(6);
+  EXPECT_EQ(owner.use_count(), 1);
+  EXPECT_NE(buffer.data(), owner->data());
+  std::vector<uint8_t> expect = {1, 2, 3, 4, 0, 0};
+  EXPECT_EQ(std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size()), expect);
+}
+}  // namespace server
+}  // namespace fl
+}  // namespace mindspore
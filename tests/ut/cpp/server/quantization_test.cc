@@ -0,0 +1,140 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "compression/quantization.h"
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+class TestQuantization : public testing::Test {
+ public:
+  // Every block of kQuantBlockSize elements has its own range, the third block is constant.
+  static std::vector<float> CreateWeight(size_t size, std::mt19937 *gen) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> weight(size);
+    for (size_t i = 0; i < size; i++) {
+      size_t block = i / kQuantBlockSize;
+      weight[i] = block == 2 ? 0.25f : dist(*gen) * static_cast<float>(block + 1) + static_cast<float>(block);
+    }
+    return weight;
+  }
+
+  // The feature map which the client decodes from the compress weight.
+  static CompressFeatureMap ToFeatureMap(const CompressWeight &compress_weight, bool has_block) {
+    CompressFeatureMap feature_map;
+    feature_map.weight_fullname = "weight";
+    feature_map.compress_data = compress_weight.compress_data;
+    feature_map.min_val = compress_weight.min_val;
+    feature_map.max_val = compress_weight.max_val;
+    feature_map.data_size = compress_weight.compress_data_len;
+    if (has_block) {
+      feature_map.block_size = compress_weight.block_size;
+      feature_map.block_min_vals = compress_weight.block_min_vals;
+      feature_map.block_max_vals = compress_weight.block_max_vals;
+    }
+    return feature_map;
+  }
+};
+
+/// Feature: Min max quantization of the downloaded model, in blocks of 256 elements for 4 and 2 bits.
+/// Description: Quantize and dequantize weights of 8, 4 and 2 bits, with and without blocks, whose size is smaller
+/// than a block, a multiple of it, or ends with a partial block and a partial byte.
+/// Expectation: The error of each element is within (max - min) / (2^bits - 1) of its block.
+TEST_F(TestQuantization, RoundTrip) {
+  std::mt19937 gen(1);
+  for (size_t num_bits : {8, 4, 2}) {
+    for (size_t block_size : {static_cast<size_t>(0), kQuantBlockSize}) {
+      for (size_t size : {1, 3, 255, 256, 257, 1000, 2051}) {
+        auto weight = CreateWeight(size, &gen);
+        CompressWeight compress_weight;
+        ASSERT_TRUE(QuantizeMinMax(weight.data(), size, num_bits, block_size, &compress_weight));
+        size_t codes_per_byte = kQuantBitsPerByte / num_bits;
+        EXPECT_EQ(compress_weight.compress_data.size(), (size + codes_per_byte - 1) / codes_per_byte);
+        EXPECT_EQ(compress_weight.compress_data_len, size);
+        size_t real_block_size = block_size == 0 ? size : block_size;
+        size_t block_num = (size + real_block_size - 1) / real_block_size;
+        ASSERT_EQ(compress_weight.block_min_vals.size(), block_num);
+        ASSERT_EQ(compress_weight.block_max_vals.size(), block_num);
+
+        std::vector<float> output = {-7.0f};
+        ASSERT_TRUE(DequantizeMinMax(ToFeatureMap(compress_weight, block_size != 0), num_bits, &output));
+        ASSERT_EQ(output.size(), size + 1);
+        EXPECT_EQ(output[0], -7.0f);
+        float max_code = static_cast<float>((1u << num_bits) - 1);
+        for (size_t i = 0; i < size; i++) {
+          size_t block = i / real_block_size;
+          float min_val = compress_weight.block_min_vals[block];
+          float max_val = compress_weight.block_max_vals[block];
+          ASSERT_LE(min_val, weight[i]);
+          ASSERT_GE(max_val, weight[i]);
+          float bound = (max_val - min_val) / max_code + 1e-6f;
+          ASSERT_LE(std::fabs(output[i + 1] - weight[i]), bound)
+            << "bits " << num_bits << ", block size " << block_size << ", size " << size << ", index " << i;
+        }
+      }
+    }
+  }
+}
+
+/// Feature: Min max quantization of the downloaded model, in blocks of 256 elements for 4 and 2 bits.
+/// Description: Quantize a weight to 8 bits without blocks, which is the QUANT layout of the existing clients.
+/// Expectation: The codes are stored minus 128 as int8, and the min and max values map to -128 and 127.
+TEST_F(TestQuantization, Quant8BitLayout) {
+  std::vector<float> weight = {-2.0f, 0.0f, 3.0f, 0.5f};
+  CompressWeight compress_weight;
+  ASSERT_TRUE(QuantizeMinMax(weight.data(), weight.size(), kQuantBitsPerByte, 0, &compress_weight));
+  ASSERT_EQ(compress_weight.compress_data.size(), weight.size());
+  EXPECT_EQ(compress_weight.compress_data[0], -128);
+  EXPECT_EQ(compress_weight.compress_data[2], 127);
+  EXPECT_EQ(compress_weight.min_val, -2.0f);
+  EXPECT_EQ(compress_weight.max_val, 3.0f);
+}
+
+/// Feature: Min max quantization of the downloaded model, in blocks of 256 elements for 4 and 2 bits.
+/// Description: Quantize with unsupported bits, a block size which is not a multiple of the codes per byte and an
+/// empty weight, and dequantize blocks which are not aligned to bytes, too few block ranges and too short data.
+/// Expectation: Quantization and dequantization fail, and the output is unchanged.
+TEST_F(TestQuantization, InvalidInput) {
+  std::vector<float> weight(300, 1.0f);
+  CompressWeight compress_weight;
+  EXPECT_FALSE(QuantizeMinMax(weight.data(), weight.size(), 0, 0, &compress_weight));
+  EXPECT_FALSE(QuantizeMinMax(weight.data(), weight.size(), 3, 0, &compress_weight));
+  EXPECT_FALSE(QuantizeMinMax(weight.data(), weight.size(), 4, 255, &compress_weight));
+  EXPECT_FALSE(QuantizeMinMax(weight.data(), weight.size(), 2, 6, &compress_weight));
+  EXPECT_FALSE(QuantizeMinMax(weight.data(), 0, 4, kQuantBlockSize, &compress_weight));
+  EXPECT_FALSE(QuantizeMinMax(nullptr, weight.size(), 4, kQuantBlockSize, &compress_weight));
+
+  ASSERT_TRUE(QuantizeMinMax(weight.data(), weight.size(), 2, kQuantBlockSize, &compress_weight));
+  std::vector<float> output;
+  auto feature_map = ToFeatureMap(compress_weight, true);
+  feature_map.block_size = 6;
+  EXPECT_FALSE(DequantizeMinMax(feature_map, 2, &output));
+  feature_map = ToFeatureMap(compress_weight, true);
+  feature_map.block_min_vals.pop_back();
+  EXPECT_FALSE(DequantizeMinMax(feature_map, 2, &output));
+  feature_map = ToFeatureMap(compress_weight, true);
+  feature_map.compress_data.pop_back();
+  EXPECT_FALSE(DequantizeMinMax(feature_map, 2, &output));
+  EXPECT_FALSE(DequantizeMinMax(ToFeatureMap(compress_weight, true), 3, &output));
+  EXPECT_TRUE(output.empty());
+}
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
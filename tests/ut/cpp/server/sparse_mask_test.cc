@@ -0,0 +1,123 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+#include "gtest/gtest.h"
+#include "compression/sparse_mask.h"
+
+namespace mindspore {
+namespace fl {
+namespace compression {
+class TestSparseMask : public testing::Test {
+ public:
+  struct MaskCase {
+    int seed;
+    float upload_sparse_rate;
+    size_t param_num;
+    // Retained indices of the mask of EncodeExecutor.constructMaskArray of the Java client.
+    std::vector<size_t> retained;
+  };
+
+  static std::vector<size_t> Retained(const SparseMask &mask) {
+    std::vector<size_t> retained;
+    for (size_t i = 0; i < mask.param_num(); i++) {
+      if (mask.Get(i)) {
+        retained.push_back(i);
+      }
+    }
+    return retained;
+  }
+};
+
+/// Feature: Random sparse mask of the upload compression, which the server constructs the same as the client.
+/// Description: Construct Lehmer masks with a positive, a negative and the maximum seed, where the Java int arithmetic
+/// of the client wraps around.
+/// Expectation: The retained indices are the same as the ones of the Java client.
+TEST_F(TestSparseMask, LehmerMatchesClient) {
+  std::vector<MaskCase> cases = {
+    {1, 0.3f, 40, {5, 7, 10, 16, 18, 19, 20, 21, 22, 24, 25, 29}},
+    {-7, 0.5f, 40, {3, 4, 5, 12, 13, 15, 16, 17, 22, 25, 26, 29, 30, 31, 32, 33, 34, 37, 38, 39}},
+    {2147483647, 0.1f, 40, {15, 21, 33, 39}},
+  };
+  for (auto &mask_case : cases) {
+    auto mask = ConstructSparseMask(kSparseMaskLehmer, mask_case.seed, mask_case.upload_sparse_rate,
+                                    mask_case.param_num);
+    ASSERT_NE(mask, nullptr);
+    EXPECT_EQ(Retained(*mask), mask_case.retained) << "seed " << mask_case.seed;
+    EXPECT_EQ(mask->Count(), mask_case.retained.size());
+  }
+}
+
+/// Feature: Random sparse mask of the upload compression, which the server constructs the same as the client.
+/// Description: Construct counter based masks with a positive, a negative and the maximum seed.
+/// Expectation: The retained indices are the same as the ones of the Java client.
+TEST_F(TestSparseMask, CounterMatchesClient) {
+  std::vector<MaskCase> cases = {
+    {1, 0.3f, 40, {4, 7, 13, 14, 16, 20, 24, 27, 29}},
+    {-7, 0.5f, 40, {0, 2, 4, 6, 8, 12, 14, 17, 18, 20, 23, 24, 32, 35, 36, 38}},
+    {2147483647, 0.1f, 40, {2, 9, 19, 28}},
+  };
+  for (auto &mask_case : cases) {
+    auto mask = ConstructSparseMask(kSparseMaskCounter, mask_case.seed, mask_case.upload_sparse_rate,
+                                    mask_case.param_num);
+    ASSERT_NE(mask, nullptr);
+    EXPECT_EQ(Retained(*mask), mask_case.retained) << "seed " << mask_case.seed;
+    EXPECT_EQ(mask->Count(), mask_case.retained.size());
+  }
+}
+
+/// Feature: Random sparse mask of the upload compression, which the server constructs the same as the client.
+/// Description: Construct a Lehmer mask of 100K parameters, and a counter based mask of 300K parameters which is
+/// generated by several threads.
+/// Expectation: The number, the sum and the first and last of the retained indices are the same as the ones of the
+/// Java client.
+TEST_F(TestSparseMask, LargeMasksMatchClient) {
+  struct LargeCase {
+    int version;
+    size_t param_num;
+    size_t count;
+    uint64_t sum;
+    std::vector<size_t> first;
+    std::vector<size_t> last;
+  };
+  std::vector<LargeCase> cases = {
+    {kSparseMaskLehmer, 100000, 8000, 402937275ULL, {17, 19, 43, 76}, {99967, 99992}},
+    {kSparseMaskCounter, 300000, 24008, 3596815311ULL, {15, 38, 39, 51}, {299992, 299999}},
+  };
+  for (auto &large_case : cases) {
+    auto mask = ConstructSparseMask(large_case.version, 12345, 0.08f, large_case.param_num);
+    ASSERT_NE(mask, nullptr);
+    auto retained = Retained(*mask);
+    ASSERT_EQ(retained.size(), large_case.count) << "version " << large_case.version;
+    uint64_t sum = 0;
+    for (auto index : retained) {
+      sum += index;
+    }
+    EXPECT_EQ(sum, large_case.sum);
+    EXPECT_EQ(std::vector<size_t>(retained.begin(), retained.begin() + 4), large_case.first);
+    EXPECT_EQ(std::vector<size_t>(retained.end() - 2, retained.end()), large_case.last);
+    EXPECT_EQ(mask->Count(), large_case.count);
+  }
+}
+
+/// Feature: Random sparse mask of the upload compression, which the server constructs the same as the client.
+/// Description: Construct a mask of an unknown version.
+/// Expectation: No mask is constructed.
+TEST_F(TestSparseMask, UnsupportedVersion) { EXPECT_EQ(ConstructSparseMask(2, 1, 0.5f, 10), nullptr); }
+}  // namespace compression
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,72 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+#include "gtest/gtest.h"
+#include "vertical/communicator/message_queue.h"
+
+namespace mindspore {
+namespace fl {
+class TestMessageQueue : public testing::Test {};
+
+/// Feature: Bounded message queue of vertical federated learning.
+/// Description: Push move only messages into a queue of capacity 2 from another thread and pop them.
+/// Expectation: The producer blocks while the queue is full and the messages are popped in order.
+TEST_F(TestMessageQueue, BoundedPushPop) {
+  MessageQueue<std::unique_ptr<int>> queue(2);
+  std::atomic<int> pushed(0);
+  std::thread producer([&queue, &pushed]() {
+    for (int i = 0; i < 4; i++) {
+      EXPECT_TRUE(queue.push(std::make_unique<int>(i)));
+      pushed++;
+    }
+  });
+  while (pushed < 2) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(pushed, 2);
+  for (int i = 0; i < 4; i++) {
+    auto message = queue.pop();
+    ASSERT_NE(message, nullptr);
+    EXPECT_EQ(*message, i);
+  }
+  producer.join();
+  EXPECT_EQ(pushed, 4);
+}
+
+/// Feature: Bounded message queue of vertical federated learning.
+/// Description: Push into a full queue with a timeout of 100 milliseconds.
+/// Expectation: The push fails after the timeout, well before the request timeout of the peer, and the queued message
+/// is kept.
+TEST_F(TestMessageQueue, PushTimeout) {
+  MessageQueue<std::unique_ptr<int>> queue(1);
+  EXPECT_TRUE(queue.push(std::make_unique<int>(1), 100));
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(queue.push(std::make_unique<int>(2), 100));
+  auto cost = std::chrono::steady_clock::now() - start;
+  EXPECT_GE(cost, std::chrono::milliseconds(100));
+  EXPECT_LT(cost, std::chrono::seconds(1));
+  auto message = queue.pop();
+  ASSERT_NE(message, nullptr);
+  EXPECT_EQ(*message, 1);
+}
+}  // namespace fl
+}  // namespace mindspore
@@ -0,0 +1,172 @@
+/**
+ * Copyright 2022 Huawei Technologies Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "vertical/utils/tensor_utils.h"
+
+namespace mindspore {
+namespace fl {
+class TestTensorUtils : public testing::Test {
+ public:
+  static TensorItemPy MakeTensor(const std::string &ref_key, size_t elem_num) {
+    TensorItemPy tensor;
+    tensor.set_ref_key(ref_key);
+    tensor.set_dtype("float32");
+    tensor.set_shape({elem_num / 2, 2});
+    std::vector<float> data(elem_num);
+    for (size_t i = 0; i < elem_num; i++) {
+      data[i] = static_cast<float>(i) * 0.5f - 3.0f;
+    }
+    auto bytes = reinterpret_cast<const uint8_t *>(data.data());
+    tensor.set_raw_data(std::vector<uint8_t>(bytes, bytes + data.size() * sizeof(float)));
+    return tensor;
+  }
+
+  static std::vector<float> FloatData(const TensorItemPy &tensor) {
+    const auto &raw_data = tensor.raw_data();
+    std::vector<float> data(raw_data.size() / sizeof(float));
+    (void)memcpy(data.data(), raw_data.data(), data.size() * sizeof(float));
+    return data;
+  }
+};
+
+/// Feature: Tensor list exchange of vertical federated learning.
+/// Description: Create the proto of a nested tensor list, serialize, parse and convert it back.
+/// Expectation: The data is carried by raw_data and the parsed tensors are the same as the sent ones.
+TEST_F(TestTensorUtils, RawDataRoundTrip) {
+  TensorListItemPy sub_list;
+  sub_list.set_name("grad");
+  sub_list.add_tensor(MakeTensor("b", 6));
+  TensorListItemPy tensor_list;
+  tensor_list.set_name("embedding");
+  tensor_list.add_tensor(MakeTensor("a", 1000));
+  tensor_list.add_tensor_list_item(sub_list);
+
+  TensorListProto proto;
+  CreateTensorListProto(&proto, tensor_list);
+  ASSERT_EQ(proto.tensors_size(), 1);
+  EXPECT_EQ(proto.tensors(0).float_data_size(), 0);
+  EXPECT_EQ(proto.tensors(0).raw_data().size(), 1000 * sizeof(float));
+
+  TensorListProto received;
+  ASSERT_TRUE(received.ParseFromString(proto.SerializeAsString()));
+  auto parsed = ParseTensorListProto(received);
+  EXPECT_EQ(parsed.name(), "embedding");
+  ASSERT_EQ(parsed.tensors().size(), 1);
+  EXPECT_EQ(parsed.tensors()[0].ref_key(), "a");
+  EXPECT_EQ(parsed.tensors()[0].shape(), tensor_list.tensors()[0].shape());
+  EXPECT_EQ(parsed.tensors()[0].dtype(), "float32");
+  EXPECT_EQ(parsed.tensors()[0].raw_data(), tensor_list.tensors()[0].raw_data());
+  ASSERT_EQ(parsed.tensorListItems().size(), 1);
+  EXPECT_EQ(parsed.tensorListItems()[0].name(), "grad");
+  EXPECT_EQ(parsed.tensorListItems()[0].tensors()[0].raw_data(), sub_list.tensors()[0].raw_data());
+}
+
+/// Feature: Tensor list exchange of vertical federated learning.
+/// Description: Parse a tensor proto which carries its data in float_data.
+/// Expectation: The parsed data is the same as float_data.
+TEST_F(TestTensorUtils, ParseFloatData) {
+  TensorListProto proto;
+  proto.set_name("legacy");
+  auto tensor_proto = proto.add_tensors();
+  tensor_proto->set_ref_key("a");
+  tensor_proto->add_dims(3);
+  std::vector<float> expect = {1.0f, -2.5f, 3.25f};
+  for (auto value : expect) {
+    tensor_proto->add_float_data(value);
+  }
+  auto parsed = ParseTensorListProto(proto);
+  ASSERT_EQ(parsed.tensors().size(), 1);
+  EXPECT_EQ(FloatData(parsed.tensors()[0]), expect);
+  EXPECT_EQ(parsed.tensors()[0].shape(), std::vector<size_t>{3});
+}
+
+/// Feature: Tensor list exchange of vertical federated learning.
+/// Description: Send tensors of float16, int8 and int64, and a tensor whose data doesn't match its dtype.
+/// Expectation: The data type and bytes are kept, and the mismatched tensor is rejected.
+TEST_F(TestTensorUtils, OtherDtypes) {
+  const std::vector<std::pair<std::string, size_t>> dtypes = {{"float16", 2}, {"int8", 1}, {"int64", 8}};
+  TensorListItemPy tensor_list;
+  for (auto &dtype : dtypes) {
+    TensorItemPy tensor;
+    tensor.set_ref_key(dtype.first);
+    tensor.set_dtype(dtype.first);
+    tensor.set_shape({3});
+    std::vector<uint8_t> data(3 * dtype.second);
+    for (size_t i = 0; i < data.size(); i++) {
+      data[i] = static_cast<uint8_t>(i * 7);
+    }
+    tensor.set_raw_data(data);
+    tensor_list.add_tensor(tensor);
+  }
+  TensorListProto proto;
+  CreateTensorListProto(&proto, tensor_list);
+  EXPECT_EQ(proto.tensors(0).data_type(), DataType::FLOAT16);
+  EXPECT_EQ(proto.tensors(0).raw_data().size(), 6);
+  auto parsed = ParseTensorListProto(proto);
+  ASSERT_EQ(parsed.tensors().size(), dtypes.size());
+  for (size_t i = 0; i < dtypes.size(); i++) {
+    EXPECT_EQ(parsed.tensors()[i].dtype(), dtypes[i].first);
+    EXPECT_EQ(parsed.tensors()[i].raw_data(), tensor_list.tensors()[i].raw_data());
+  }
+
+  TensorItemPy mismatched;
+  mismatched.set_dtype("float32");
+  mismatched.set_raw_data(std::vector<uint8_t>(6));
+  TensorProto tensor_proto;
+  EXPECT_ANY_THROW(CreateTensorProto(&tensor_proto, mismatched, "bad"));
+  mismatched.set_dtype("complex256");
+  mismatched.set_raw_data(std::vector<uint8_t>(8));
+  EXPECT_ANY_THROW(CreateTensorProto(&tensor_proto, mismatched, "bad"));
+}
+
+/// Feature: Tensor list exchange of vertical federated learning.
+/// Description: Measure send and receive conversion of 10MB to 100MB activations.
+/// It is disabled by default, run it with --gtest_also_run_disabled_tests.
+/// Expectation: Both directions produce a positive throughput, which is printed as bytes per second.
+TEST_F(TestTensorUtils, DISABLED_Benchmark) {
+  const std::vector<size_t> bench_bytes = {10 << 20, 50 << 20, 100 << 20};
+  for (auto bytes : bench_bytes) {
+    TensorListItemPy tensor_list;
+    tensor_list.set_name("activation");
+    tensor_list.add_tensor(MakeTensor("a", bytes / sizeof(float)));
+
+    auto start = std::chrono::steady_clock::now();
+    TensorListProto proto;
+    CreateTensorListProto(&proto, tensor_list);
+    std::string message = proto.SerializeAsString();
+    auto send_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    TensorListProto received;
+    ASSERT_TRUE(received.ParseFromArray(message.data(), static_cast<int>(message.size())));
+    auto parsed = ParseTensorListProto(received);
+    auto receive_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(parsed.tensors()[0].raw_data().size(), bytes);
+    std::cout << "bytes: " << bytes << ", send: " << bytes / send_cost / (1 << 30)
+              << " GB/s, receive: " << bytes / receive_cost / (1 << 30) << " GB/s" << std::endl;
+    EXPECT_GT(send_cost, 0);
+    EXPECT_GT(receive_cost, 0);
+  }
+}
+}  // namespace fl
+}  // namespace mindspore
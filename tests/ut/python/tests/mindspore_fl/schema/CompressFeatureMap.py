@@ -76,7 +76,75 @@ class CompressFeatureMap(object):
             return self._tab.Get(flatbuffers.number_types.Float32Flags, o + self._tab.Pos)
         return 0.0
 
-def Start(builder): builder.StartObject(4)
+    # CompressFeatureMap
+    def DataSize(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(12))
+        if o != 0:
+            return self._tab.Get(flatbuffers.number_types.Int32Flags, o + self._tab.Pos)
+        return 0
+
+    # CompressFeatureMap
+    def BlockSize(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(14))
+        if o != 0:
+            return self._tab.Get(flatbuffers.number_types.Int32Flags, o + self._tab.Pos)
+        return 0
+
+    # CompressFeatureMap
+    def BlockMinVal(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(16))
+        if o != 0:
+            a = self._tab.Vector(o)
+            return self._tab.Get(flatbuffers.number_types.Float32Flags, a + flatbuffers.number_types.UOffsetTFlags.py_type(j * 4))
+        return 0
+
+    # CompressFeatureMap
+    def BlockMinValAsNumpy(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(16))
+        if o != 0:
+            return self._tab.GetVectorAsNumpy(flatbuffers.number_types.Float32Flags, o)
+        return 0
+
+    # CompressFeatureMap
+    def BlockMinValLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(16))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+    # CompressFeatureMap
+    def BlockMinValIsNone(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(16))
+        return o == 0
+
+    # CompressFeatureMap
+    def BlockMaxVal(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(18))
+        if o != 0:
+            a = self._tab.Vector(o)
+            return self._tab.Get(flatbuffers.number_types.Float32Flags, a + flatbuffers.number_types.UOffsetTFlags.py_type(j * 4))
+        return 0
+
+    # CompressFeatureMap
+    def BlockMaxValAsNumpy(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(18))
+        if o != 0:
+            return self._tab.GetVectorAsNumpy(flatbuffers.number_types.Float32Flags, o)
+        return 0
+
+    # CompressFeatureMap
+    def BlockMaxValLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(18))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+    # CompressFeatureMap
+    def BlockMaxValIsNone(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(18))
+        return o == 0
+
+def Start(builder): builder.StartObject(8)
 def CompressFeatureMapStart(builder):
     """This method is deprecated. Please switch to Start."""
     return Start(builder)
@@ -100,6 +168,30 @@ def AddMaxVal(builder, maxVal): builder.PrependFloat32Slot(3, maxVal, 0.0)
 def CompressFeatureMapAddMaxVal(builder, maxVal):
     """This method is deprecated. Please switch to AddMaxVal."""
     return AddMaxVal(builder, maxVal)
+def AddDataSize(builder, dataSize): builder.PrependInt32Slot(4, dataSize, 0)
+def CompressFeatureMapAddDataSize(builder, dataSize):
+    """This method is deprecated. Please switch to AddDataSize."""
+    return AddDataSize(builder, dataSize)
+def AddBlockSize(builder, blockSize): builder.PrependInt32Slot(5, blockSize, 0)
+def CompressFeatureMapAddBlockSize(builder, blockSize):
+    """This method is deprecated. Please switch to AddBlockSize."""
+    return AddBlockSize(builder, blockSize)
+def AddBlockMinVal(builder, blockMinVal): builder.PrependUOffsetTRelativeSlot(6, flatbuffers.number_types.UOffsetTFlags.py_type(blockMinVal), 0)
+def CompressFeatureMapAddBlockMinVal(builder, blockMinVal):
+    """This method is deprecated. Please switch to AddBlockMinVal."""
+    return AddBlockMinVal(builder, blockMinVal)
+def StartBlockMinValVector(builder, numElems): return builder.StartVector(4, numElems, 4)
+def CompressFeatureMapStartBlockMinValVector(builder, numElems):
+    """This method is deprecated. Please switch to Start."""
+    return StartBlockMinValVector(builder, numElems)
+def AddBlockMaxVal(builder, blockMaxVal): builder.PrependUOffsetTRelativeSlot(7, flatbuffers.number_types.UOffsetTFlags.py_type(blockMaxVal), 0)
+def CompressFeatureMapAddBlockMaxVal(builder, blockMaxVal):
+    """This method is deprecated. Please switch to AddBlockMaxVal."""
+    return AddBlockMaxVal(builder, blockMaxVal)
+def StartBlockMaxValVector(builder, numElems): return builder.StartVector(4, numElems, 4)
+def CompressFeatureMapStartBlockMaxValVector(builder, numElems):
+    """This method is deprecated. Please switch to Start."""
+    return StartBlockMaxValVector(builder, numElems)
 def End(builder): return builder.EndObject()
 def CompressFeatureMapEnd(builder):
     """This method is deprecated. Please switch to End."""
@@ -6,4 +6,6 @@ class CompressType(object):
     NO_COMPRESS = 0
     DIFF_SPARSE_QUANT = 1
     QUANT = 2
+    QUANT_4BIT = 3
+    QUANT_2BIT = 4
 
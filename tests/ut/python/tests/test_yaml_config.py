@@ -650,7 +650,7 @@ def test_yaml_config_invalid_compression_config_val_range_failed():
     except RuntimeError as e:
         assert "The value of parameter 'compression.upload_compress_type' can be only one of" in str(e)
 
-    # NO_COMPRESS, QUANT
+    # NO_COMPRESS, QUANT, QUANT_4BIT, QUANT_2BIT
     try:
         make_yaml_config(fl_name, {"compression.download_compress_type": "DIFF_SPARSE_QUANT"},
                          output_yaml_file=yaml_config_file)